@@ -466,6 +466,22 @@ static inline struct d3d11_device_context *impl_from_ID3D11DeviceContext1(ID3D11
     return CONTAINING_RECORD(iface, struct d3d11_device_context, ID3D11DeviceContext1_iface);
 }
 
+/* The state of a deferred context is only accessed by the thread recording
+ * into it, and holds references to the objects bound to it. Getters on
+ * deferred contexts therefore don't need to serialise on the global wined3d
+ * lock, which would otherwise be contended by every recording thread. */
+static void d3d11_device_context_lock(struct d3d11_device_context *context)
+{
+    if (context->type == D3D11_DEVICE_CONTEXT_IMMEDIATE)
+        wined3d_mutex_lock();
+}
+
+static void d3d11_device_context_unlock(struct d3d11_device_context *context)
+{
+    if (context->type == D3D11_DEVICE_CONTEXT_IMMEDIATE)
+        wined3d_mutex_unlock();
+}
+
 static HRESULT STDMETHODCALLTYPE d3d11_device_context_QueryInterface(ID3D11DeviceContext1 *iface,
         REFIID iid, void **out)
 {
@@ -539,7 +555,7 @@ static void d3d11_device_context_get_constant_buffers(ID3D11DeviceContext1 *ifac
     struct d3d11_device_context *context = impl_from_ID3D11DeviceContext1(iface);
     unsigned int i;
 
-    wined3d_mutex_lock();
+    d3d11_device_context_lock(context);
     for (i = 0; i < buffer_count; ++i)
     {
         struct wined3d_constant_buffer_state state;
@@ -562,7 +578,7 @@ static void d3d11_device_context_get_constant_buffers(ID3D11DeviceContext1 *ifac
         buffers[i] = &buffer_impl->ID3D11Buffer_iface;
         ID3D11Buffer_AddRef(buffers[i]);
     }
-    wined3d_mutex_unlock();
+    d3d11_device_context_unlock(context);
 }
 
 static void d3d11_device_context_set_constant_buffers(ID3D11DeviceContext1 *iface, enum wined3d_shader_type type,
@@ -1700,7 +1716,7 @@ static void STDMETHODCALLTYPE d3d11_device_context_PSGetShaderResources(ID3D11De
     TRACE("iface %p, start_slot %u, view_count %u, views %p.\n",
             iface, start_slot, view_count, views);
 
-    wined3d_mutex_lock();
+    d3d11_device_context_lock(context);
     for (i = 0; i < view_count; ++i)
     {
         struct wined3d_shader_resource_view *wined3d_view;
@@ -1717,7 +1733,7 @@ static void STDMETHODCALLTYPE d3d11_device_context_PSGetShaderResources(ID3D11De
         views[i] = &view_impl->ID3D11ShaderResourceView_iface;
         ID3D11ShaderResourceView_AddRef(views[i]);
     }
-    wined3d_mutex_unlock();
+    d3d11_device_context_unlock(context);
 }
 
 static void STDMETHODCALLTYPE d3d11_device_context_PSGetShader(ID3D11DeviceContext1 *iface,
@@ -1735,16 +1751,16 @@ static void STDMETHODCALLTYPE d3d11_device_context_PSGetShader(ID3D11DeviceConte
     if (class_instance_count)
         *class_instance_count = 0;
 
-    wined3d_mutex_lock();
+    d3d11_device_context_lock(context);
     if (!(wined3d_shader = wined3d_device_context_get_shader(context->wined3d_context, WINED3D_SHADER_TYPE_PIXEL)))
     {
-        wined3d_mutex_unlock();
+        d3d11_device_context_unlock(context);
         *shader = NULL;
         return;
     }
 
     shader_impl = wined3d_shader_get_parent(wined3d_shader);
-    wined3d_mutex_unlock();
+    d3d11_device_context_unlock(context);
     *shader = &shader_impl->ID3D11PixelShader_iface;
     ID3D11PixelShader_AddRef(*shader);
 }
@@ -1758,7 +1774,7 @@ static void STDMETHODCALLTYPE d3d11_device_context_PSGetSamplers(ID3D11DeviceCon
     TRACE("iface %p, start_slot %u, sampler_count %u, samplers %p.\n",
             iface, start_slot, sampler_count, samplers);
 
-    wined3d_mutex_lock();
+    d3d11_device_context_lock(context);
     for (i = 0; i < sampler_count; ++i)
     {
         struct wined3d_sampler *wined3d_sampler;
@@ -1775,7 +1791,7 @@ static void STDMETHODCALLTYPE d3d11_device_context_PSGetSamplers(ID3D11DeviceCon
         samplers[i] = &sampler_impl->ID3D11SamplerState_iface;
         ID3D11SamplerState_AddRef(samplers[i]);
     }
-    wined3d_mutex_unlock();
+    d3d11_device_context_unlock(context);
 }
 
 static void STDMETHODCALLTYPE d3d11_device_context_VSGetShader(ID3D11DeviceContext1 *iface,
@@ -1793,16 +1809,16 @@ static void STDMETHODCALLTYPE d3d11_device_context_VSGetShader(ID3D11DeviceConte
     if (class_instance_count)
         *class_instance_count = 0;
 
-    wined3d_mutex_lock();
+    d3d11_device_context_lock(context);
     if (!(wined3d_shader = wined3d_device_context_get_shader(context->wined3d_context, WINED3D_SHADER_TYPE_VERTEX)))
     {
-        wined3d_mutex_unlock();
+        d3d11_device_context_unlock(context);
         *shader = NULL;
         return;
     }
 
     shader_impl = wined3d_shader_get_parent(wined3d_shader);
-    wined3d_mutex_unlock();
+    d3d11_device_context_unlock(context);
     *shader = &shader_impl->ID3D11VertexShader_iface;
     ID3D11VertexShader_AddRef(*shader);
 }
@@ -1826,16 +1842,16 @@ static void STDMETHODCALLTYPE d3d11_device_context_IAGetInputLayout(ID3D11Device
 
     TRACE("iface %p, input_layout %p.\n", iface, input_layout);
 
-    wined3d_mutex_lock();
+    d3d11_device_context_lock(context);
     if (!(wined3d_declaration = wined3d_device_context_get_vertex_declaration(context->wined3d_context)))
     {
-        wined3d_mutex_unlock();
+        d3d11_device_context_unlock(context);
         *input_layout = NULL;
         return;
     }
 
     input_layout_impl = wined3d_vertex_declaration_get_parent(wined3d_declaration);
-    wined3d_mutex_unlock();
+    d3d11_device_context_unlock(context);
     *input_layout = &input_layout_impl->ID3D11InputLayout_iface;
     ID3D11InputLayout_AddRef(*input_layout);
 }
@@ -1849,7 +1865,7 @@ static void STDMETHODCALLTYPE d3d11_device_context_IAGetVertexBuffers(ID3D11Devi
     TRACE("iface %p, start_slot %u, buffer_count %u, buffers %p, strides %p, offsets %p.\n",
             iface, start_slot, buffer_count, buffers, strides, offsets);
 
-    wined3d_mutex_lock();
+    d3d11_device_context_lock(context);
     for (i = 0; i < buffer_count; ++i)
     {
         struct wined3d_buffer *wined3d_buffer = NULL;
@@ -1874,7 +1890,7 @@ static void STDMETHODCALLTYPE d3d11_device_context_IAGetVertexBuffers(ID3D11Devi
         buffer_impl = wined3d_buffer_get_parent(wined3d_buffer);
         ID3D11Buffer_AddRef(buffers[i] = &buffer_impl->ID3D11Buffer_iface);
     }
-    wined3d_mutex_unlock();
+    d3d11_device_context_unlock(context);
 }
 
 static void STDMETHODCALLTYPE d3d11_device_context_IAGetIndexBuffer(ID3D11DeviceContext1 *iface,
@@ -1887,18 +1903,18 @@ static void STDMETHODCALLTYPE d3d11_device_context_IAGetIndexBuffer(ID3D11Device
 
     TRACE("iface %p, buffer %p, format %p, offset %p.\n", iface, buffer, format, offset);
 
-    wined3d_mutex_lock();
+    d3d11_device_context_lock(context);
     wined3d_buffer = wined3d_device_context_get_index_buffer(context->wined3d_context, &wined3d_format, offset);
     *format = dxgi_format_from_wined3dformat(wined3d_format);
     if (!wined3d_buffer)
     {
-        wined3d_mutex_unlock();
+        d3d11_device_context_unlock(context);
         *buffer = NULL;
         return;
     }
 
     buffer_impl = wined3d_buffer_get_parent(wined3d_buffer);
-    wined3d_mutex_unlock();
+    d3d11_device_context_unlock(context);
     ID3D11Buffer_AddRef(*buffer = &buffer_impl->ID3D11Buffer_iface);
 }
 
@@ -1927,16 +1943,16 @@ static void STDMETHODCALLTYPE d3d11_device_context_GSGetShader(ID3D11DeviceConte
     if (class_instance_count)
         *class_instance_count = 0;
 
-    wined3d_mutex_lock();
+    d3d11_device_context_lock(context);
     if (!(wined3d_shader = wined3d_device_context_get_shader(context->wined3d_context, WINED3D_SHADER_TYPE_GEOMETRY)))
     {
-        wined3d_mutex_unlock();
+        d3d11_device_context_unlock(context);
         *shader = NULL;
         return;
     }
 
     shader_impl = wined3d_shader_get_parent(wined3d_shader);
-    wined3d_mutex_unlock();
+    d3d11_device_context_unlock(context);
     *shader = &shader_impl->ID3D11GeometryShader_iface;
     ID3D11GeometryShader_AddRef(*shader);
 }
@@ -1950,9 +1966,9 @@ static void STDMETHODCALLTYPE d3d11_device_context_IAGetPrimitiveTopology(ID3D11
 
     TRACE("iface %p, topology %p.\n", iface, topology);
 
-    wined3d_mutex_lock();
+    d3d11_device_context_lock(context);
     wined3d_device_context_get_primitive_type(context->wined3d_context, &primitive_type, &patch_vertex_count);
-    wined3d_mutex_unlock();
+    d3d11_device_context_unlock(context);
 
     d3d11_primitive_topology_from_wined3d_primitive_type(primitive_type, patch_vertex_count, topology);
 }
@@ -1965,7 +1981,7 @@ static void STDMETHODCALLTYPE d3d11_device_context_VSGetShaderResources(ID3D11De
 
     TRACE("iface %p, start_slot %u, view_count %u, views %p.\n", iface, start_slot, view_count, views);
 
-    wined3d_mutex_lock();
+    d3d11_device_context_lock(context);
     for (i = 0; i < view_count; ++i)
     {
         struct wined3d_shader_resource_view *wined3d_view;
@@ -1982,7 +1998,7 @@ static void STDMETHODCALLTYPE d3d11_device_context_VSGetShaderResources(ID3D11De
         views[i] = &view_impl->ID3D11ShaderResourceView_iface;
         ID3D11ShaderResourceView_AddRef(views[i]);
     }
-    wined3d_mutex_unlock();
+    d3d11_device_context_unlock(context);
 }
 
 static void STDMETHODCALLTYPE d3d11_device_context_VSGetSamplers(ID3D11DeviceContext1 *iface,
@@ -1994,7 +2010,7 @@ static void STDMETHODCALLTYPE d3d11_device_context_VSGetSamplers(ID3D11DeviceCon
     TRACE("iface %p, start_slot %u, sampler_count %u, samplers %p.\n",
             iface, start_slot, sampler_count, samplers);
 
-    wined3d_mutex_lock();
+    d3d11_device_context_lock(context);
     for (i = 0; i < sampler_count; ++i)
     {
         struct wined3d_sampler *wined3d_sampler;
@@ -2011,7 +2027,7 @@ static void STDMETHODCALLTYPE d3d11_device_context_VSGetSamplers(ID3D11DeviceCon
         samplers[i] = &sampler_impl->ID3D11SamplerState_iface;
         ID3D11SamplerState_AddRef(samplers[i]);
     }
-    wined3d_mutex_unlock();
+    d3d11_device_context_unlock(context);
 }
 
 static void STDMETHODCALLTYPE d3d11_device_context_GetPredication(ID3D11DeviceContext1 *iface,
@@ -2023,16 +2039,16 @@ static void STDMETHODCALLTYPE d3d11_device_context_GetPredication(ID3D11DeviceCo
 
     TRACE("iface %p, predicate %p, value %p.\n", iface, predicate, value);
 
-    wined3d_mutex_lock();
+    d3d11_device_context_lock(context);
     if (!(wined3d_predicate = wined3d_device_context_get_predication(context->wined3d_context, value)))
     {
-        wined3d_mutex_unlock();
+        d3d11_device_context_unlock(context);
         *predicate = NULL;
         return;
     }
 
     predicate_impl = wined3d_query_get_parent(wined3d_predicate);
-    wined3d_mutex_unlock();
+    d3d11_device_context_unlock(context);
     *predicate = (ID3D11Predicate *)&predicate_impl->ID3D11Query_iface;
     ID3D11Predicate_AddRef(*predicate);
 }
@@ -2045,7 +2061,7 @@ static void STDMETHODCALLTYPE d3d11_device_context_GSGetShaderResources(ID3D11De
 
     TRACE("iface %p, start_slot %u, view_count %u, views %p.\n", iface, start_slot, view_count, views);
 
-    wined3d_mutex_lock();
+    d3d11_device_context_lock(context);
     for (i = 0; i < view_count; ++i)
     {
         struct wined3d_shader_resource_view *wined3d_view;
@@ -2062,7 +2078,7 @@ static void STDMETHODCALLTYPE d3d11_device_context_GSGetShaderResources(ID3D11De
         views[i] = &view_impl->ID3D11ShaderResourceView_iface;
         ID3D11ShaderResourceView_AddRef(views[i]);
     }
-    wined3d_mutex_unlock();
+    d3d11_device_context_unlock(context);
 }
 
 static void STDMETHODCALLTYPE d3d11_device_context_GSGetSamplers(ID3D11DeviceContext1 *iface,
@@ -2074,7 +2090,7 @@ static void STDMETHODCALLTYPE d3d11_device_context_GSGetSamplers(ID3D11DeviceCon
     TRACE("iface %p, start_slot %u, sampler_count %u, samplers %p.\n",
             iface, start_slot, sampler_count, samplers);
 
-    wined3d_mutex_lock();
+    d3d11_device_context_lock(context);
     for (i = 0; i < sampler_count; ++i)
     {
         struct d3d_sampler_state *sampler_impl;
@@ -2091,7 +2107,7 @@ static void STDMETHODCALLTYPE d3d11_device_context_GSGetSamplers(ID3D11DeviceCon
         samplers[i] = &sampler_impl->ID3D11SamplerState_iface;
         ID3D11SamplerState_AddRef(samplers[i]);
     }
-    wined3d_mutex_unlock();
+    d3d11_device_context_unlock(context);
 }
 
 static void STDMETHODCALLTYPE d3d11_device_context_OMGetRenderTargets(ID3D11DeviceContext1 *iface,
@@ -2104,7 +2120,7 @@ static void STDMETHODCALLTYPE d3d11_device_context_OMGetRenderTargets(ID3D11Devi
     TRACE("iface %p, render_target_view_count %u, render_target_views %p, depth_stencil_view %p.\n",
             iface, render_target_view_count, render_target_views, depth_stencil_view);
 
-    wined3d_mutex_lock();
+    d3d11_device_context_lock(context);
     if (render_target_views)
     {
         struct d3d_rendertarget_view *view_impl;
@@ -2139,7 +2155,7 @@ static void STDMETHODCALLTYPE d3d11_device_context_OMGetRenderTargets(ID3D11Devi
             ID3D11DepthStencilView_AddRef(*depth_stencil_view);
         }
     }
-    wined3d_mutex_unlock();
+    d3d11_device_context_unlock(context);
 }
 
 static void STDMETHODCALLTYPE d3d11_device_context_OMGetRenderTargetsAndUnorderedAccessViews(
@@ -2166,7 +2182,7 @@ static void STDMETHODCALLTYPE d3d11_device_context_OMGetRenderTargetsAndUnordere
 
     if (unordered_access_views)
     {
-        wined3d_mutex_lock();
+        d3d11_device_context_lock(context);
         for (i = 0; i < unordered_access_view_count; ++i)
         {
             if (!(wined3d_view = wined3d_device_context_get_unordered_access_view(context->wined3d_context,
@@ -2180,7 +2196,7 @@ static void STDMETHODCALLTYPE d3d11_device_context_OMGetRenderTargetsAndUnordere
             unordered_access_views[i] = &view_impl->ID3D11UnorderedAccessView_iface;
             ID3D11UnorderedAccessView_AddRef(unordered_access_views[i]);
         }
-        wined3d_mutex_unlock();
+        d3d11_device_context_unlock(context);
     }
 }
 
@@ -2196,7 +2212,7 @@ static void STDMETHODCALLTYPE d3d11_device_context_OMGetBlendState(ID3D11DeviceC
     TRACE("iface %p, blend_state %p, blend_factor %p, sample_mask %p.\n",
             iface, blend_state, blend_factor, sample_mask);
 
-    wined3d_mutex_lock();
+    d3d11_device_context_lock(context);
     if (!blend_factor) blend_factor = tmp_blend_factor;
     if (!sample_mask) sample_mask = &tmp_sample_mask;
     wined3d_state = wined3d_device_context_get_blend_state(context->wined3d_context,
@@ -2211,7 +2227,7 @@ static void STDMETHODCALLTYPE d3d11_device_context_OMGetBlendState(ID3D11DeviceC
         else
             *blend_state = NULL;
     }
-    wined3d_mutex_unlock();
+    d3d11_device_context_unlock(context);
 }
 
 static void STDMETHODCALLTYPE d3d11_device_context_OMGetDepthStencilState(ID3D11DeviceContext1 *iface,
@@ -2225,7 +2241,7 @@ static void STDMETHODCALLTYPE d3d11_device_context_OMGetDepthStencilState(ID3D11
     TRACE("iface %p, depth_stencil_state %p, stencil_ref %p.\n",
             iface, depth_stencil_state, stencil_ref);
 
-    wined3d_mutex_lock();
+    d3d11_device_context_lock(context);
     if (!stencil_ref) stencil_ref = &stencil_ref_tmp;
     wined3d_state = wined3d_device_context_get_depth_stencil_state(context->wined3d_context, stencil_ref);
     if (depth_stencil_state)
@@ -2240,7 +2256,7 @@ static void STDMETHODCALLTYPE d3d11_device_context_OMGetDepthStencilState(ID3D11
             *depth_stencil_state = NULL;
         }
     }
-    wined3d_mutex_unlock();
+    d3d11_device_context_unlock(context);
 }
 
 static void STDMETHODCALLTYPE d3d11_device_context_SOGetTargets(ID3D11DeviceContext1 *iface,
@@ -2251,7 +2267,7 @@ static void STDMETHODCALLTYPE d3d11_device_context_SOGetTargets(ID3D11DeviceCont
 
     TRACE("iface %p, buffer_count %u, buffers %p.\n", iface, buffer_count, buffers);
 
-    wined3d_mutex_lock();
+    d3d11_device_context_lock(context);
     for (i = 0; i < buffer_count; ++i)
     {
         struct wined3d_buffer *wined3d_buffer;
@@ -2267,7 +2283,7 @@ static void STDMETHODCALLTYPE d3d11_device_context_SOGetTargets(ID3D11DeviceCont
         buffers[i] = &buffer_impl->ID3D11Buffer_iface;
         ID3D11Buffer_AddRef(buffers[i]);
     }
-    wined3d_mutex_unlock();
+    d3d11_device_context_unlock(context);
 }
 
 static void STDMETHODCALLTYPE d3d11_device_context_RSGetState(ID3D11DeviceContext1 *iface,
@@ -2279,7 +2295,7 @@ static void STDMETHODCALLTYPE d3d11_device_context_RSGetState(ID3D11DeviceContex
 
     TRACE("iface %p, rasterizer_state %p.\n", iface, rasterizer_state);
 
-    wined3d_mutex_lock();
+    d3d11_device_context_lock(context);
     if ((wined3d_state = wined3d_device_context_get_rasterizer_state(context->wined3d_context)))
     {
         rasterizer_state_impl = wined3d_rasterizer_state_get_parent(wined3d_state);
@@ -2289,7 +2305,7 @@ static void STDMETHODCALLTYPE d3d11_device_context_RSGetState(ID3D11DeviceContex
     {
         *rasterizer_state = NULL;
     }
-    wined3d_mutex_unlock();
+    d3d11_device_context_unlock(context);
 }
 
 static void STDMETHODCALLTYPE d3d11_device_context_RSGetViewports(ID3D11DeviceContext1 *iface,
@@ -2304,9 +2320,9 @@ static void STDMETHODCALLTYPE d3d11_device_context_RSGetViewports(ID3D11DeviceCo
     if (!viewport_count)
         return;
 
-    wined3d_mutex_lock();
+    d3d11_device_context_lock(context);
     wined3d_device_context_get_viewports(context->wined3d_context, &actual_count, viewports ? wined3d_vp : NULL);
-    wined3d_mutex_unlock();
+    d3d11_device_context_unlock(context);
 
     if (!viewports)
     {
@@ -2342,9 +2358,9 @@ static void STDMETHODCALLTYPE d3d11_device_context_RSGetScissorRects(ID3D11Devic
 
     actual_count = *rect_count;
 
-    wined3d_mutex_lock();
+    d3d11_device_context_lock(context);
     wined3d_device_context_get_scissor_rects(context->wined3d_context, &actual_count, rects);
-    wined3d_mutex_unlock();
+    d3d11_device_context_unlock(context);
 
     if (rects && *rect_count > actual_count)
         memset(&rects[actual_count], 0, (*rect_count - actual_count) * sizeof(*rects));
@@ -2359,7 +2375,7 @@ static void STDMETHODCALLTYPE d3d11_device_context_HSGetShaderResources(ID3D11De
 
     TRACE("iface %p, start_slot %u, view_count %u, views %p.\n", iface, start_slot, view_count, views);
 
-    wined3d_mutex_lock();
+    d3d11_device_context_lock(context);
     for (i = 0; i < view_count; ++i)
     {
         struct wined3d_shader_resource_view *wined3d_view;
@@ -2375,7 +2391,7 @@ static void STDMETHODCALLTYPE d3d11_device_context_HSGetShaderResources(ID3D11De
         view_impl = wined3d_shader_resource_view_get_parent(wined3d_view);
         ID3D11ShaderResourceView_AddRef(views[i] = &view_impl->ID3D11ShaderResourceView_iface);
     }
-    wined3d_mutex_unlock();
+    d3d11_device_context_unlock(context);
 }
 
 static void STDMETHODCALLTYPE d3d11_device_context_HSGetShader(ID3D11DeviceContext1 *iface,
@@ -2393,16 +2409,16 @@ static void STDMETHODCALLTYPE d3d11_device_context_HSGetShader(ID3D11DeviceConte
     if (class_instance_count)
         *class_instance_count = 0;
 
-    wined3d_mutex_lock();
+    d3d11_device_context_lock(context);
     if (!(wined3d_shader = wined3d_device_context_get_shader(context->wined3d_context, WINED3D_SHADER_TYPE_HULL)))
     {
-        wined3d_mutex_unlock();
+        d3d11_device_context_unlock(context);
         *shader = NULL;
         return;
     }
 
     shader_impl = wined3d_shader_get_parent(wined3d_shader);
-    wined3d_mutex_unlock();
+    d3d11_device_context_unlock(context);
     ID3D11HullShader_AddRef(*shader = &shader_impl->ID3D11HullShader_iface);
 }
 
@@ -2415,7 +2431,7 @@ static void STDMETHODCALLTYPE d3d11_device_context_HSGetSamplers(ID3D11DeviceCon
     TRACE("iface %p, start_slot %u, sampler_count %u, samplers %p.\n",
             iface, start_slot, sampler_count, samplers);
 
-    wined3d_mutex_lock();
+    d3d11_device_context_lock(context);
     for (i = 0; i < sampler_count; ++i)
     {
         struct wined3d_sampler *wined3d_sampler;
@@ -2431,7 +2447,7 @@ static void STDMETHODCALLTYPE d3d11_device_context_HSGetSamplers(ID3D11DeviceCon
         sampler_impl = wined3d_sampler_get_parent(wined3d_sampler);
         ID3D11SamplerState_AddRef(samplers[i] = &sampler_impl->ID3D11SamplerState_iface);
     }
-    wined3d_mutex_unlock();
+    d3d11_device_context_unlock(context);
 }
 
 static void STDMETHODCALLTYPE d3d11_device_context_HSGetConstantBuffers(ID3D11DeviceContext1 *iface,
@@ -2453,7 +2469,7 @@ static void STDMETHODCALLTYPE d3d11_device_context_DSGetShaderResources(ID3D11De
     TRACE("iface %p, start_slot %u, view_count %u, views %p.\n",
             iface, start_slot, view_count, views);
 
-    wined3d_mutex_lock();
+    d3d11_device_context_lock(context);
     for (i = 0; i < view_count; ++i)
     {
         struct wined3d_shader_resource_view *wined3d_view;
@@ -2469,7 +2485,7 @@ static void STDMETHODCALLTYPE d3d11_device_context_DSGetShaderResources(ID3D11De
         view_impl = wined3d_shader_resource_view_get_parent(wined3d_view);
         ID3D11ShaderResourceView_AddRef(views[i] = &view_impl->ID3D11ShaderResourceView_iface);
     }
-    wined3d_mutex_unlock();
+    d3d11_device_context_unlock(context);
 }
 
 static void STDMETHODCALLTYPE d3d11_device_context_DSGetShader(ID3D11DeviceContext1 *iface,
@@ -2487,16 +2503,16 @@ static void STDMETHODCALLTYPE d3d11_device_context_DSGetShader(ID3D11DeviceConte
     if (class_instance_count)
         *class_instance_count = 0;
 
-    wined3d_mutex_lock();
+    d3d11_device_context_lock(context);
     if (!(wined3d_shader = wined3d_device_context_get_shader(context->wined3d_context, WINED3D_SHADER_TYPE_DOMAIN)))
     {
-        wined3d_mutex_unlock();
+        d3d11_device_context_unlock(context);
         *shader = NULL;
         return;
     }
 
     shader_impl = wined3d_shader_get_parent(wined3d_shader);
-    wined3d_mutex_unlock();
+    d3d11_device_context_unlock(context);
     ID3D11DomainShader_AddRef(*shader = &shader_impl->ID3D11DomainShader_iface);
 }
 
@@ -2509,7 +2525,7 @@ static void STDMETHODCALLTYPE d3d11_device_context_DSGetSamplers(ID3D11DeviceCon
     TRACE("iface %p, start_slot %u, sampler_count %u, samplers %p.\n",
             iface, start_slot, sampler_count, samplers);
 
-    wined3d_mutex_lock();
+    d3d11_device_context_lock(context);
     for (i = 0; i < sampler_count; ++i)
     {
         struct wined3d_sampler *wined3d_sampler;
@@ -2525,7 +2541,7 @@ static void STDMETHODCALLTYPE d3d11_device_context_DSGetSamplers(ID3D11DeviceCon
         sampler_impl = wined3d_sampler_get_parent(wined3d_sampler);
         ID3D11SamplerState_AddRef(samplers[i] = &sampler_impl->ID3D11SamplerState_iface);
     }
-    wined3d_mutex_unlock();
+    d3d11_device_context_unlock(context);
 }
 
 static void STDMETHODCALLTYPE d3d11_device_context_DSGetConstantBuffers(ID3D11DeviceContext1 *iface,
@@ -2546,7 +2562,7 @@ static void STDMETHODCALLTYPE d3d11_device_context_CSGetShaderResources(ID3D11De
 
     TRACE("iface %p, start_slot %u, view_count %u, views %p.\n", iface, start_slot, view_count, views);
 
-    wined3d_mutex_lock();
+    d3d11_device_context_lock(context);
     for (i = 0; i < view_count; ++i)
     {
         struct wined3d_shader_resource_view *wined3d_view;
@@ -2562,7 +2578,7 @@ static void STDMETHODCALLTYPE d3d11_device_context_CSGetShaderResources(ID3D11De
         view_impl = wined3d_shader_resource_view_get_parent(wined3d_view);
         ID3D11ShaderResourceView_AddRef(views[i] = &view_impl->ID3D11ShaderResourceView_iface);
     }
-    wined3d_mutex_unlock();
+    d3d11_device_context_unlock(context);
 }
 
 static void STDMETHODCALLTYPE d3d11_device_context_CSGetUnorderedAccessViews(ID3D11DeviceContext1 *iface,
@@ -2573,7 +2589,7 @@ static void STDMETHODCALLTYPE d3d11_device_context_CSGetUnorderedAccessViews(ID3
 
     TRACE("iface %p, start_slot %u, view_count %u, views %p.\n", iface, start_slot, view_count, views);
 
-    wined3d_mutex_lock();
+    d3d11_device_context_lock(context);
     for (i = 0; i < view_count; ++i)
     {
         struct wined3d_unordered_access_view *wined3d_view;
@@ -2589,7 +2605,7 @@ static void STDMETHODCALLTYPE d3d11_device_context_CSGetUnorderedAccessViews(ID3
         view_impl = wined3d_unordered_access_view_get_parent(wined3d_view);
         ID3D11UnorderedAccessView_AddRef(views[i] = &view_impl->ID3D11UnorderedAccessView_iface);
     }
-    wined3d_mutex_unlock();
+    d3d11_device_context_unlock(context);
 }
 
 static void STDMETHODCALLTYPE d3d11_device_context_CSGetShader(ID3D11DeviceContext1 *iface,
@@ -2607,16 +2623,16 @@ static void STDMETHODCALLTYPE d3d11_device_context_CSGetShader(ID3D11DeviceConte
     if (class_instance_count)
         *class_instance_count = 0;
 
-    wined3d_mutex_lock();
+    d3d11_device_context_lock(context);
     if (!(wined3d_shader = wined3d_device_context_get_shader(context->wined3d_context, WINED3D_SHADER_TYPE_COMPUTE)))
     {
-        wined3d_mutex_unlock();
+        d3d11_device_context_unlock(context);
         *shader = NULL;
         return;
     }
 
     shader_impl = wined3d_shader_get_parent(wined3d_shader);
-    wined3d_mutex_unlock();
+    d3d11_device_context_unlock(context);
     ID3D11ComputeShader_AddRef(*shader = &shader_impl->ID3D11ComputeShader_iface);
 }
 
@@ -2629,7 +2645,7 @@ static void STDMETHODCALLTYPE d3d11_device_context_CSGetSamplers(ID3D11DeviceCon
     TRACE("iface %p, start_slot %u, sampler_count %u, samplers %p.\n",
             iface, start_slot, sampler_count, samplers);
 
-    wined3d_mutex_lock();
+    d3d11_device_context_lock(context);
     for (i = 0; i < sampler_count; ++i)
     {
         struct wined3d_sampler *wined3d_sampler;
@@ -2645,7 +2661,7 @@ static void STDMETHODCALLTYPE d3d11_device_context_CSGetSamplers(ID3D11DeviceCon
         sampler_impl = wined3d_sampler_get_parent(wined3d_sampler);
         ID3D11SamplerState_AddRef(samplers[i] = &sampler_impl->ID3D11SamplerState_iface);
     }
-    wined3d_mutex_unlock();
+    d3d11_device_context_unlock(context);
 }
 
 static void STDMETHODCALLTYPE d3d11_device_context_CSGetConstantBuffers(ID3D11DeviceContext1 *iface,
@@ -33152,6 +33152,107 @@ static void test_deferred_context_queries(void)
     release_test_context(&test_context);
 }
 
+struct deferred_submission_thread
+{
+    struct d3d11_test_context *test_context;
+    ID3D11DeviceContext *deferred;
+    ID3D11CommandList *list;
+    unsigned int draw_count;
+};
+
+static DWORD WINAPI deferred_submission_thread_proc(void *param)
+{
+    struct deferred_submission_thread *thread = param;
+    struct d3d11_test_context *test_context = thread->test_context;
+    ID3D11DeviceContext *deferred = thread->deferred;
+    unsigned int stride, offset, mismatch_count, i;
+    ID3D11Buffer *cb;
+    HRESULT hr;
+
+    ID3D11DeviceContext_OMSetRenderTargets(deferred, 1, &test_context->backbuffer_rtv, NULL);
+    set_viewport(deferred, 0.0f, 0.0f, 640.0f, 480.0f, 0.0f, 1.0f);
+    ID3D11DeviceContext_IASetInputLayout(deferred, test_context->input_layout);
+    ID3D11DeviceContext_IASetPrimitiveTopology(deferred, D3D11_PRIMITIVE_TOPOLOGY_TRIANGLESTRIP);
+    stride = sizeof(struct vec3);
+    offset = 0;
+    ID3D11DeviceContext_IASetVertexBuffers(deferred, 0, 1, &test_context->vb, &stride, &offset);
+    ID3D11DeviceContext_VSSetShader(deferred, test_context->vs, NULL, 0);
+    ID3D11DeviceContext_PSSetShader(deferred, test_context->ps, NULL, 0);
+
+    for (i = 0, mismatch_count = 0; i < thread->draw_count; ++i)
+    {
+        /* Query the state before every draw, like applications without their
+         * own state cache do. */
+        ID3D11DeviceContext_PSSetConstantBuffers(deferred, 0, 1, &test_context->ps_cb);
+        ID3D11DeviceContext_PSGetConstantBuffers(deferred, 0, 1, &cb);
+        if (cb != test_context->ps_cb)
+            ++mismatch_count;
+        if (cb)
+            ID3D11Buffer_Release(cb);
+        ID3D11DeviceContext_Draw(deferred, 4, 0);
+    }
+    ok(!mismatch_count, "Got %u unexpected constant buffers.\n", mismatch_count);
+
+    hr = ID3D11DeviceContext_FinishCommandList(deferred, FALSE, &thread->list);
+    ok(hr == S_OK, "Failed to create command list, hr %#x.\n", hr);
+
+    return 0;
+}
+
+static void test_deferred_context_multithreaded_submission(void)
+{
+    struct deferred_submission_thread threads[4];
+    struct d3d11_test_context test_context;
+    unsigned int thread_count, i;
+    HANDLE handles[4];
+    SYSTEM_INFO si;
+    DWORD color;
+    HRESULT hr;
+
+    static const struct vec4 green = {0.0f, 1.0f, 0.0f, 1.0f};
+    static const float red[] = {1.0f, 0.0f, 0.0f, 1.0f};
+
+    if (!init_test_context(&test_context, NULL))
+        return;
+
+    /* Create the shaders, input layout and buffers used by the threads. */
+    draw_color_quad(&test_context, &green);
+    ID3D11DeviceContext_ClearRenderTargetView(test_context.immediate_context, test_context.backbuffer_rtv, red);
+
+    GetSystemInfo(&si);
+    thread_count = min(si.dwNumberOfProcessors, ARRAY_SIZE(threads));
+
+    for (i = 0; i < thread_count; ++i)
+    {
+        hr = ID3D11Device_CreateDeferredContext(test_context.device, 0, &threads[i].deferred);
+        ok(hr == S_OK, "Failed to create deferred context, hr %#x.\n", hr);
+        threads[i].test_context = &test_context;
+        threads[i].list = NULL;
+        threads[i].draw_count = 500;
+    }
+
+    for (i = 0; i < thread_count; ++i)
+    {
+        handles[i] = CreateThread(NULL, 0, deferred_submission_thread_proc, &threads[i], 0, NULL);
+        ok(!!handles[i], "Failed to create thread %u.\n", i);
+    }
+    WaitForMultipleObjects(thread_count, handles, TRUE, INFINITE);
+
+    for (i = 0; i < thread_count; ++i)
+        ID3D11DeviceContext_ExecuteCommandList(test_context.immediate_context, threads[i].list, FALSE);
+    color = get_texture_color(test_context.backbuffer, 320, 240);
+    ok(color == 0xff00ff00, "Got unexpected color %#08x.\n", color);
+
+    for (i = 0; i < thread_count; ++i)
+    {
+        CloseHandle(handles[i]);
+        if (threads[i].list)
+            ID3D11CommandList_Release(threads[i].list);
+        ID3D11DeviceContext_Release(threads[i].deferred);
+    }
+    release_test_context(&test_context);
+}
+
 static void test_deferred_context_map(void)
 {
     ID3D11DeviceContext *immediate, *deferred;
@@ -33939,6 +34040,151 @@ static void test_dynamic_map_synchronization(void)
     release_test_context(&test_context);
 }
 
+static void test_dynamic_map_wraparound(void)
+{
+    static const struct vec4 magenta = {1.0f, 0.0f, 1.0f, 1.0f};
+    unsigned int i, pass, column_count, expected;
+    struct d3d11_test_context test_context;
+    D3D11_MAPPED_SUBRESOURCE map_desc;
+    D3D11_BUFFER_DESC buffer_desc;
+    struct resource_readback rb;
+    ID3D11DeviceContext *context;
+    struct vec4 color;
+    ID3D11Buffer *cb;
+    DWORD value;
+    HRESULT hr;
+
+    if (!init_test_context(&test_context, NULL))
+        return;
+    context = test_context.immediate_context;
+
+    /* Create the pixel shader. */
+    draw_color_quad(&test_context, &magenta);
+
+    /* Use the largest constant buffer size, so that the draws below go
+     * through a lot of discarded buffer memory without waiting for the GPU. */
+    buffer_desc.ByteWidth = D3D11_REQ_CONSTANT_BUFFER_ELEMENT_COUNT * sizeof(struct vec4);
+    buffer_desc.Usage = D3D11_USAGE_DYNAMIC;
+    buffer_desc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
+    buffer_desc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+    buffer_desc.MiscFlags = 0;
+    buffer_desc.StructureByteStride = 0;
+    hr = ID3D11Device_CreateBuffer(test_context.device, &buffer_desc, NULL, &cb);
+    ok(hr == S_OK, "Failed to create constant buffer, hr %#x.\n", hr);
+    ID3D11DeviceContext_PSSetConstantBuffers(context, 0, 1, &cb);
+
+    /* Every column is drawn with its own color from a freshly discarded
+     * buffer, which is then immediately discarded again and overwritten.
+     * Handing out memory still read by draws in flight shows up as wrong
+     * columns. */
+    column_count = 640;
+    for (pass = 0; pass < 2; ++pass)
+    {
+        for (i = 0; i < column_count; ++i)
+        {
+            set_viewport(context, i, 0.0f, 1.0f, 480.0f, 0.0f, 1.0f);
+
+            color.x = (i & 0xff) / 255.0f;
+            color.y = (i >> 8) / 255.0f;
+            color.z = (pass + 1) / 255.0f;
+            color.w = 1.0f;
+            hr = ID3D11DeviceContext_Map(context, (ID3D11Resource *)cb, 0, D3D11_MAP_WRITE_DISCARD, 0, &map_desc);
+            ok(hr == S_OK, "Failed to map buffer, hr %#x.\n", hr);
+            memcpy(map_desc.pData, &color, sizeof(color));
+            ID3D11DeviceContext_Unmap(context, (ID3D11Resource *)cb, 0);
+
+            draw_quad(&test_context);
+
+            hr = ID3D11DeviceContext_Map(context, (ID3D11Resource *)cb, 0, D3D11_MAP_WRITE_DISCARD, 0, &map_desc);
+            ok(hr == S_OK, "Failed to map buffer, hr %#x.\n", hr);
+            memcpy(map_desc.pData, &magenta, sizeof(magenta));
+            ID3D11DeviceContext_Unmap(context, (ID3D11Resource *)cb, 0);
+        }
+    }
+
+    get_texture_readback(test_context.backbuffer, 0, &rb);
+    for (i = 0; i < column_count; ++i)
+    {
+        expected = 0xff000000 | 2 << 16 | (i >> 8) << 8 | (i & 0xff);
+        value = get_readback_color(&rb, i, 240, 0);
+        ok(compare_color(value, expected, 1), "Column %u: got %08x, expected %08x.\n", i, value, expected);
+        if (!compare_color(value, expected, 1))
+            break;
+    }
+    release_resource_readback(&rb);
+
+    ID3D11Buffer_Release(cb);
+    release_test_context(&test_context);
+}
+
+static void test_update_subresource_streaming(void)
+{
+    unsigned int i, j, x, y, block_idx, iteration_count;
+    D3D11_TEXTURE2D_DESC texture_desc;
+    struct d3d11_test_context test_context;
+    struct resource_readback rb;
+    ID3D11DeviceContext *context;
+    ID3D11Texture2D *texture;
+    DWORD data[16 * 16];
+    D3D11_BOX box;
+    DWORD color;
+    HRESULT hr;
+
+    if (!init_test_context(&test_context, NULL))
+        return;
+    context = test_context.immediate_context;
+
+    texture_desc.Width = 64;
+    texture_desc.Height = 64;
+    texture_desc.MipLevels = 1;
+    texture_desc.ArraySize = 1;
+    texture_desc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+    texture_desc.SampleDesc.Count = 1;
+    texture_desc.SampleDesc.Quality = 0;
+    texture_desc.Usage = D3D11_USAGE_DEFAULT;
+    texture_desc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+    texture_desc.CPUAccessFlags = 0;
+    texture_desc.MiscFlags = 0;
+    hr = ID3D11Device_CreateTexture2D(test_context.device, &texture_desc, NULL, &texture);
+    ok(hr == S_OK, "Failed to create texture, hr %#x.\n", hr);
+
+    /* Repeatedly overwrite the 16 blocks of the texture, reusing the same
+     * source array. The staging memory of an earlier update must not be
+     * reused before the GPU has consumed it, and updates must land in
+     * order. */
+    iteration_count = 16 * 64;
+    for (i = 0; i < iteration_count; ++i)
+    {
+        block_idx = i % 16;
+        for (j = 0; j < ARRAY_SIZE(data); ++j)
+            data[j] = 0xff000000 | (i << 8) | block_idx;
+        set_box(&box, (block_idx % 4) * 16, (block_idx / 4) * 16, 0,
+                (block_idx % 4) * 16 + 16, (block_idx / 4) * 16 + 16, 1);
+        ID3D11DeviceContext_UpdateSubresource(context, (ID3D11Resource *)texture, 0, &box,
+                data, 16 * sizeof(*data), 0);
+    }
+    get_texture_readback(texture, 0, &rb);
+
+    for (y = 0; y < 64; ++y)
+    {
+        for (x = 0; x < 64; ++x)
+        {
+            block_idx = (y / 16) * 4 + x / 16;
+            i = iteration_count - 16 + block_idx;
+            color = get_readback_color(&rb, x, y, 0);
+            if (color != (0xff000000 | (i << 8) | block_idx))
+                break;
+        }
+        if (x != 64)
+            break;
+    }
+    ok(y == 64, "Got unexpected color 0x%08x at (%u, %u).\n", color, x, y);
+    release_resource_readback(&rb);
+
+    ID3D11Texture2D_Release(texture);
+    release_test_context(&test_context);
+}
+
 START_TEST(d3d11)
 {
     unsigned int argc, i;
@@ -34109,10 +34355,13 @@ START_TEST(d3d11)
     queue_test(test_deferred_context_rendering);
     queue_test(test_deferred_context_map);
     queue_test(test_deferred_context_queries);
+    queue_test(test_deferred_context_multithreaded_submission);
     queue_test(test_unbound_streams);
     queue_test(test_texture_compressed_3d);
     queue_test(test_constant_buffer_offset);
     queue_test(test_dynamic_map_synchronization);
+    queue_test(test_dynamic_map_wraparound);
+    queue_test(test_update_subresource_streaming);
 
     run_queued_tests();
 
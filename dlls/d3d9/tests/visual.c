@@ -27902,6 +27902,395 @@ static void test_filling_convention(void)
     DestroyWindow(window);
 }
 
+static void test_shader_program_reuse(void)
+{
+    IDirect3DVertexShader9 *vertex_shader;
+    IDirect3DPixelShader9 *pixel_shader;
+    IDirect3DDevice9 *device;
+    IDirect3D9 *d3d;
+    D3DCOLOR colour;
+    unsigned int i;
+    ULONG refcount;
+    D3DCAPS9 caps;
+    HWND window;
+    HRESULT hr;
+
+    static const struct vec3 quad[] =
+    {
+        {-1.0f, -1.0f, 0.1f},
+        {-1.0f,  1.0f, 0.1f},
+        { 1.0f, -1.0f, 0.1f},
+        { 1.0f,  1.0f, 0.1f},
+    };
+    static const DWORD vs_code[] =
+    {
+        0xfffe0200,                                     /* vs_2_0                 */
+        0x0200001f, 0x80000000, 0x900f0000,             /* dcl_position v0        */
+        0x02000001, 0xc00f0000, 0x90e40000,             /* mov oPos, v0           */
+        0x0000ffff,                                     /* end                    */
+    };
+    static const DWORD ps_code[] =
+    {
+        0xffff0200,                                     /* ps_2_0                 */
+        0x02000001, 0x800f0800, 0xa0e40000,             /* mov oC0, c0            */
+        0x0000ffff,                                     /* end                    */
+    };
+    static const struct
+    {
+        struct vec4 c0;
+        D3DCOLOR expected_colour;
+    }
+    tests[] =
+    {
+        {{1.0f, 0.0f, 0.0f, 1.0f}, 0x00ff0000},
+        {{0.0f, 1.0f, 0.0f, 1.0f}, 0x0000ff00},
+        {{0.0f, 0.0f, 1.0f, 1.0f}, 0x000000ff},
+    };
+
+    /* Each device links the same program again. Implementations may reuse
+     * program binaries from earlier links, which must not affect uniform
+     * handling. */
+    for (i = 0; i < ARRAY_SIZE(tests); ++i)
+    {
+        window = create_window();
+        ok(!!window, "Failed to create a window.\n");
+
+        d3d = Direct3DCreate9(D3D_SDK_VERSION);
+        ok(!!d3d, "Failed to create a D3D object.\n");
+        if (!(device = create_device(d3d, window, window, TRUE)))
+        {
+            skip("Failed to create a D3D device, skipping tests.\n");
+            IDirect3D9_Release(d3d);
+            DestroyWindow(window);
+            return;
+        }
+
+        hr = IDirect3DDevice9_GetDeviceCaps(device, &caps);
+        ok(hr == D3D_OK, "Got unexpected hr %#x.\n", hr);
+        if (caps.PixelShaderVersion < D3DPS_VERSION(2, 0) || caps.VertexShaderVersion < D3DVS_VERSION(2, 0))
+        {
+            skip("No shader model 2 support, skipping tests.\n");
+            IDirect3DDevice9_Release(device);
+            IDirect3D9_Release(d3d);
+            DestroyWindow(window);
+            return;
+        }
+
+        hr = IDirect3DDevice9_SetRenderState(device, D3DRS_ZENABLE, FALSE);
+        ok(hr == D3D_OK, "Got unexpected hr %#x.\n", hr);
+        hr = IDirect3DDevice9_SetRenderState(device, D3DRS_CULLMODE, D3DCULL_NONE);
+        ok(hr == D3D_OK, "Got unexpected hr %#x.\n", hr);
+        hr = IDirect3DDevice9_SetFVF(device, D3DFVF_XYZ);
+        ok(hr == D3D_OK, "Got unexpected hr %#x.\n", hr);
+        hr = IDirect3DDevice9_CreateVertexShader(device, vs_code, &vertex_shader);
+        ok(hr == D3D_OK, "Got unexpected hr %#x.\n", hr);
+        hr = IDirect3DDevice9_SetVertexShader(device, vertex_shader);
+        ok(hr == D3D_OK, "Got unexpected hr %#x.\n", hr);
+        hr = IDirect3DDevice9_CreatePixelShader(device, ps_code, &pixel_shader);
+        ok(hr == D3D_OK, "Got unexpected hr %#x.\n", hr);
+        hr = IDirect3DDevice9_SetPixelShader(device, pixel_shader);
+        ok(hr == D3D_OK, "Got unexpected hr %#x.\n", hr);
+        hr = IDirect3DDevice9_SetPixelShaderConstantF(device, 0, &tests[i].c0.x, 1);
+        ok(hr == D3D_OK, "Got unexpected hr %#x.\n", hr);
+
+        hr = IDirect3DDevice9_BeginScene(device);
+        ok(hr == D3D_OK, "Got unexpected hr %#x.\n", hr);
+        hr = IDirect3DDevice9_Clear(device, 0, NULL, D3DCLEAR_TARGET, 0x80808080, 0.0f, 0);
+        ok(hr == D3D_OK, "Got unexpected hr %#x.\n", hr);
+        hr = IDirect3DDevice9_DrawPrimitiveUP(device, D3DPT_TRIANGLESTRIP, 2, quad, sizeof(*quad));
+        ok(hr == D3D_OK, "Got unexpected hr %#x.\n", hr);
+        hr = IDirect3DDevice9_EndScene(device);
+        ok(hr == D3D_OK, "Got unexpected hr %#x.\n", hr);
+
+        colour = getPixelColor(device, 320, 240);
+        ok(color_match(colour, tests[i].expected_colour, 1), "Test %u: got unexpected colour 0x%08x.\n", i, colour);
+
+        IDirect3DPixelShader9_Release(pixel_shader);
+        IDirect3DVertexShader9_Release(vertex_shader);
+        refcount = IDirect3DDevice9_Release(device);
+        ok(!refcount, "Device has %u references left.\n", refcount);
+        IDirect3D9_Release(d3d);
+        DestroyWindow(window);
+    }
+}
+
+static void test_shader_constant_file_switch(void)
+{
+    IDirect3DPixelShader9 *shaders[4];
+    IDirect3DDevice9 *device;
+    IDirect3D9 *d3d;
+    D3DCOLOR colour;
+    unsigned int i;
+    ULONG refcount;
+    D3DCAPS9 caps;
+    HWND window;
+    HRESULT hr;
+
+    static const struct vec3 quad[] =
+    {
+        {-1.0f, -1.0f, 0.1f},
+        {-1.0f,  1.0f, 0.1f},
+        { 1.0f, -1.0f, 0.1f},
+        { 1.0f,  1.0f, 0.1f},
+    };
+    static const DWORD ps_c0_code[] =
+    {
+        0xffff0200,                                     /* ps_2_0                 */
+        0x02000001, 0x800f0800, 0xa0e40000,             /* mov oC0, c0            */
+        0x0000ffff,                                     /* end                    */
+    };
+    static const DWORD ps_def_code[] =
+    {
+        0xffff0200,                                                             /* ps_2_0                   */
+        0x05000051, 0xa00f0000, 0x00000000, 0x3f800000, 0x00000000, 0x3f800000, /* def c0, 0.0, 1.0, 0.0, 1.0 */
+        0x02000001, 0x800f0800, 0xa0e40000,                                     /* mov oC0, c0              */
+        0x0000ffff,                                                             /* end                      */
+    };
+    static const DWORD ps_add_code[] =
+    {
+        0xffff0200,                                     /* ps_2_0                 */
+        0x03000002, 0x800f0000, 0xa0e40001, 0xa0e40002, /* add r0, c1, c2         */
+        0x02000001, 0x800f0800, 0x80e40000,             /* mov oC0, r0            */
+        0x0000ffff,                                     /* end                    */
+    };
+    static const DWORD ps_1_1_add_code[] =
+    {
+        0xffff0101,                                     /* ps_1_1                 */
+        0x00000002, 0x800f0000, 0xa0e40001, 0xa0e40002, /* add r0, c1, c2         */
+        0x0000ffff,                                     /* end                    */
+    };
+    static const struct vec4 constants[] =
+    {
+        {1.0f, 0.0f, 0.0f, 1.0f},
+        {2.0f, 2.0f, 2.0f, 1.0f},
+        {-0.5f, -0.5f, -0.5f, 0.0f},
+    };
+    static const struct vec4 blue = {0.0f, 0.0f, 1.0f, 1.0f};
+    static const struct
+    {
+        unsigned int shader;
+        D3DCOLOR expected_colour;
+    }
+    tests[] =
+    {
+        {0, 0x00ff0000},
+        {1, 0x0000ff00},
+        {0, 0x00ff0000},
+        {3, 0x00808080},
+        {2, 0x00ffffff},
+        {3, 0x00808080},
+        {1, 0x0000ff00},
+        {0, 0x00ff0000},
+    };
+
+    window = create_window();
+    d3d = Direct3DCreate9(D3D_SDK_VERSION);
+    ok(!!d3d, "Failed to create a D3D object.\n");
+    if (!(device = create_device(d3d, window, window, TRUE)))
+    {
+        skip("Failed to create a D3D device, skipping tests.\n");
+        IDirect3D9_Release(d3d);
+        DestroyWindow(window);
+        return;
+    }
+
+    hr = IDirect3DDevice9_GetDeviceCaps(device, &caps);
+    ok(hr == D3D_OK, "Got unexpected hr %#x.\n", hr);
+    if (caps.PixelShaderVersion < D3DPS_VERSION(2, 0))
+    {
+        skip("No ps_2_0 support, skipping tests.\n");
+        IDirect3DDevice9_Release(device);
+        IDirect3D9_Release(d3d);
+        DestroyWindow(window);
+        return;
+    }
+
+    hr = IDirect3DDevice9_CreatePixelShader(device, ps_c0_code, &shaders[0]);
+    ok(hr == D3D_OK, "Got unexpected hr %#x.\n", hr);
+    hr = IDirect3DDevice9_CreatePixelShader(device, ps_def_code, &shaders[1]);
+    ok(hr == D3D_OK, "Got unexpected hr %#x.\n", hr);
+    hr = IDirect3DDevice9_CreatePixelShader(device, ps_add_code, &shaders[2]);
+    ok(hr == D3D_OK, "Got unexpected hr %#x.\n", hr);
+    hr = IDirect3DDevice9_CreatePixelShader(device, ps_1_1_add_code, &shaders[3]);
+    ok(hr == D3D_OK, "Got unexpected hr %#x.\n", hr);
+
+    hr = IDirect3DDevice9_SetRenderState(device, D3DRS_ZENABLE, FALSE);
+    ok(hr == D3D_OK, "Got unexpected hr %#x.\n", hr);
+    hr = IDirect3DDevice9_SetRenderState(device, D3DRS_LIGHTING, FALSE);
+    ok(hr == D3D_OK, "Got unexpected hr %#x.\n", hr);
+    hr = IDirect3DDevice9_SetFVF(device, D3DFVF_XYZ);
+    ok(hr == D3D_OK, "Got unexpected hr %#x.\n", hr);
+    hr = IDirect3DDevice9_SetPixelShaderConstantF(device, 0, &constants[0].x, ARRAY_SIZE(constants));
+    ok(hr == D3D_OK, "Got unexpected hr %#x.\n", hr);
+
+    /* Local constants of one shader must not leak into the application
+     * constants seen by the next, and ps_1_x clamping must only apply to
+     * ps_1_x shaders, regardless of how the constants are stored. */
+    for (i = 0; i < ARRAY_SIZE(tests); ++i)
+    {
+        hr = IDirect3DDevice9_SetPixelShader(device, shaders[tests[i].shader]);
+        ok(hr == D3D_OK, "Got unexpected hr %#x.\n", hr);
+
+        hr = IDirect3DDevice9_BeginScene(device);
+        ok(hr == D3D_OK, "Got unexpected hr %#x.\n", hr);
+        hr = IDirect3DDevice9_DrawPrimitiveUP(device, D3DPT_TRIANGLESTRIP, 2, quad, sizeof(*quad));
+        ok(hr == D3D_OK, "Got unexpected hr %#x.\n", hr);
+        hr = IDirect3DDevice9_EndScene(device);
+        ok(hr == D3D_OK, "Got unexpected hr %#x.\n", hr);
+
+        colour = getPixelColor(device, 320, 240);
+        ok(color_match(colour, tests[i].expected_colour, 1), "Test %u: got unexpected colour 0x%08x.\n", i, colour);
+    }
+
+    hr = IDirect3DDevice9_SetPixelShaderConstantF(device, 0, &blue.x, 1);
+    ok(hr == D3D_OK, "Got unexpected hr %#x.\n", hr);
+    hr = IDirect3DDevice9_BeginScene(device);
+    ok(hr == D3D_OK, "Got unexpected hr %#x.\n", hr);
+    hr = IDirect3DDevice9_DrawPrimitiveUP(device, D3DPT_TRIANGLESTRIP, 2, quad, sizeof(*quad));
+    ok(hr == D3D_OK, "Got unexpected hr %#x.\n", hr);
+    hr = IDirect3DDevice9_EndScene(device);
+    ok(hr == D3D_OK, "Got unexpected hr %#x.\n", hr);
+    colour = getPixelColor(device, 320, 240);
+    ok(color_match(colour, 0x000000ff, 1), "Got unexpected colour 0x%08x.\n", colour);
+
+    for (i = 0; i < ARRAY_SIZE(shaders); ++i)
+        IDirect3DPixelShader9_Release(shaders[i]);
+    refcount = IDirect3DDevice9_Release(device);
+    ok(!refcount, "Device has %u references left.\n", refcount);
+    IDirect3D9_Release(d3d);
+    DestroyWindow(window);
+}
+
+static void test_redundant_shader_constants(void)
+{
+    IDirect3DPixelShader9 *shader;
+    IDirect3DDevice9 *device;
+    struct vec4 constants[4];
+    IDirect3D9 *d3d;
+    D3DCOLOR colour;
+    unsigned int i;
+    ULONG refcount;
+    D3DCAPS9 caps;
+    HWND window;
+    HRESULT hr;
+
+    static const struct vec3 quad[] =
+    {
+        {-1.0f, -1.0f, 0.1f},
+        {-1.0f,  1.0f, 0.1f},
+        { 1.0f, -1.0f, 0.1f},
+        { 1.0f,  1.0f, 0.1f},
+    };
+    static const DWORD ps_code[] =
+    {
+        0xffff0200,                                     /* ps_2_0                 */
+        0x03000002, 0x800f0000, 0xa0e40001, 0xa0e40002, /* add r0, c1, c2         */
+        0x02000001, 0x800f0800, 0x80e40000,             /* mov oC0, r0            */
+        0x0000ffff,                                     /* end                    */
+    };
+    static const struct vec4 initial_constants[] =
+    {
+        {0.0f, 0.0f, 0.0f, 0.0f},
+        {1.0f, 0.0f, 0.0f, 0.0f},
+        {0.0f, 1.0f, 0.0f, 1.0f},
+        {0.0f, 0.0f, 0.0f, 0.0f},
+    };
+    static const struct vec4 blue = {0.0f, 0.0f, 1.0f, 1.0f};
+    static const struct vec4 black = {0.0f, 0.0f, 0.0f, 0.0f};
+    static const struct
+    {
+        unsigned int start, count;
+        unsigned int changed;
+        const struct vec4 *value;
+        D3DCOLOR expected_colour;
+    }
+    tests[] =
+    {
+        /* Setting the same values again must not disturb the constants. */
+        {0, 4, ~0u, NULL,   0x00ffff00},
+        {1, 2, ~0u, NULL,   0x00ffff00},
+        /* Only the middle of the range changes, the unchanged constants at
+         * either end must keep their values. */
+        {0, 4, 2,   &blue,  0x00ff00ff},
+        {1, 2, 1,   &black, 0x000000ff},
+        {0, 4, ~0u, NULL,   0x000000ff},
+    };
+
+    window = create_window();
+    d3d = Direct3DCreate9(D3D_SDK_VERSION);
+    ok(!!d3d, "Failed to create a D3D object.\n");
+    if (!(device = create_device(d3d, window, window, TRUE)))
+    {
+        skip("Failed to create a D3D device, skipping tests.\n");
+        IDirect3D9_Release(d3d);
+        DestroyWindow(window);
+        return;
+    }
+
+    hr = IDirect3DDevice9_GetDeviceCaps(device, &caps);
+    ok(hr == D3D_OK, "Got unexpected hr %#x.\n", hr);
+    if (caps.PixelShaderVersion < D3DPS_VERSION(2, 0))
+    {
+        skip("No ps_2_0 support, skipping tests.\n");
+        IDirect3DDevice9_Release(device);
+        IDirect3D9_Release(d3d);
+        DestroyWindow(window);
+        return;
+    }
+
+    hr = IDirect3DDevice9_CreatePixelShader(device, ps_code, &shader);
+    ok(hr == D3D_OK, "Got unexpected hr %#x.\n", hr);
+
+    hr = IDirect3DDevice9_SetRenderState(device, D3DRS_ZENABLE, FALSE);
+    ok(hr == D3D_OK, "Got unexpected hr %#x.\n", hr);
+    hr = IDirect3DDevice9_SetRenderState(device, D3DRS_LIGHTING, FALSE);
+    ok(hr == D3D_OK, "Got unexpected hr %#x.\n", hr);
+    hr = IDirect3DDevice9_SetFVF(device, D3DFVF_XYZ);
+    ok(hr == D3D_OK, "Got unexpected hr %#x.\n", hr);
+    hr = IDirect3DDevice9_SetPixelShader(device, shader);
+    ok(hr == D3D_OK, "Got unexpected hr %#x.\n", hr);
+
+    memcpy(constants, initial_constants, sizeof(constants));
+    hr = IDirect3DDevice9_SetPixelShaderConstantF(device, 0, &constants[0].x, ARRAY_SIZE(constants));
+    ok(hr == D3D_OK, "Got unexpected hr %#x.\n", hr);
+
+    hr = IDirect3DDevice9_BeginScene(device);
+    ok(hr == D3D_OK, "Got unexpected hr %#x.\n", hr);
+    hr = IDirect3DDevice9_DrawPrimitiveUP(device, D3DPT_TRIANGLESTRIP, 2, quad, sizeof(*quad));
+    ok(hr == D3D_OK, "Got unexpected hr %#x.\n", hr);
+    hr = IDirect3DDevice9_EndScene(device);
+    ok(hr == D3D_OK, "Got unexpected hr %#x.\n", hr);
+    colour = getPixelColor(device, 320, 240);
+    ok(color_match(colour, 0x00ffff00, 1), "Got unexpected colour 0x%08x.\n", colour);
+
+    for (i = 0; i < ARRAY_SIZE(tests); ++i)
+    {
+        if (tests[i].value)
+            constants[tests[i].changed] = *tests[i].value;
+        hr = IDirect3DDevice9_SetPixelShaderConstantF(device, tests[i].start,
+                &constants[tests[i].start].x, tests[i].count);
+        ok(hr == D3D_OK, "Test %u: got unexpected hr %#x.\n", i, hr);
+
+        hr = IDirect3DDevice9_Clear(device, 0, NULL, D3DCLEAR_TARGET, 0xff808080, 0.0f, 0);
+        ok(hr == D3D_OK, "Test %u: got unexpected hr %#x.\n", i, hr);
+        hr = IDirect3DDevice9_BeginScene(device);
+        ok(hr == D3D_OK, "Test %u: got unexpected hr %#x.\n", i, hr);
+        hr = IDirect3DDevice9_DrawPrimitiveUP(device, D3DPT_TRIANGLESTRIP, 2, quad, sizeof(*quad));
+        ok(hr == D3D_OK, "Test %u: got unexpected hr %#x.\n", i, hr);
+        hr = IDirect3DDevice9_EndScene(device);
+        ok(hr == D3D_OK, "Test %u: got unexpected hr %#x.\n", i, hr);
+
+        colour = getPixelColor(device, 320, 240);
+        ok(color_match(colour, tests[i].expected_colour, 1), "Test %u: got unexpected colour 0x%08x.\n", i, colour);
+    }
+
+    IDirect3DPixelShader9_Release(shader);
+    refcount = IDirect3DDevice9_Release(device);
+    ok(!refcount, "Device has %u references left.\n", refcount);
+    IDirect3D9_Release(d3d);
+    DestroyWindow(window);
+}
+
 START_TEST(visual)
 {
     D3DADAPTER_IDENTIFIER9 identifier;
@@ -28053,4 +28442,7 @@ START_TEST(visual)
     test_sample_mask();
     test_dynamic_map_synchronization();
     test_filling_convention();
+    test_shader_program_reuse();
+    test_shader_constant_file_switch();
+    test_redundant_shader_constants();
 }
@@ -3529,11 +3529,331 @@ static void test_simple_graphics(void)
     DeleteDC(mem_dc);
 }
 
+static HBITMAP create_test_dib(HDC hdc, int width, int height, int bpp, DWORD compression,
+                                const DWORD *masks, void **bits)
+{
+    char bmibuf[sizeof(BITMAPINFO) + 256 * sizeof(RGBQUAD)];
+    BITMAPINFO *bmi = (BITMAPINFO *)bmibuf;
+    HBITMAP dib;
+
+    memset(bmibuf, 0, sizeof(bmibuf));
+    bmi->bmiHeader.biSize = sizeof(bmi->bmiHeader);
+    bmi->bmiHeader.biWidth = width;
+    bmi->bmiHeader.biHeight = -height;
+    bmi->bmiHeader.biPlanes = 1;
+    bmi->bmiHeader.biBitCount = bpp;
+    bmi->bmiHeader.biCompression = compression;
+    if (compression == BI_BITFIELDS) memcpy(bmi->bmiColors, masks, 3 * sizeof(DWORD));
+    else if (bpp <= 8)
+    {
+        int i;
+        for (i = 0; i < (1 << bpp); i++)
+        {
+            bmi->bmiColors[i].rgbRed = i * 37;
+            bmi->bmiColors[i].rgbGreen = i * 59;
+            bmi->bmiColors[i].rgbBlue = i * 83;
+        }
+    }
+    dib = CreateDIBSection(hdc, bmi, DIB_RGB_COLORS, bits, NULL, 0);
+    ok(dib != NULL, "CreateDIBSection failed for %u bpp\n", bpp);
+    return dib;
+}
+
+static BYTE ref_blend_color(BYTE dst, BYTE src, DWORD alpha)
+{
+    return (src * alpha + dst * (255 - alpha) + 127) / 255;
+}
+
+static DWORD ref_blend_argb(DWORD dst, DWORD src, DWORD const_alpha)
+{
+    DWORD b = ((BYTE)src         * const_alpha + 127) / 255;
+    DWORD g = ((BYTE)(src >> 8)  * const_alpha + 127) / 255;
+    DWORD r = ((BYTE)(src >> 16) * const_alpha + 127) / 255;
+    DWORD alpha = ((BYTE)(src >> 24) * const_alpha + 127) / 255;
+
+    return ((b     + ((BYTE)dst         * (255 - alpha) + 127) / 255) |
+            (g     + ((BYTE)(dst >> 8)  * (255 - alpha) + 127) / 255) << 8 |
+            (r     + ((BYTE)(dst >> 16) * (255 - alpha) + 127) / 255) << 16 |
+            (alpha + ((BYTE)(dst >> 24) * (255 - alpha) + 127) / 255) << 24);
+}
+
+static void test_alpha_blend_exact(void)
+{
+    static const BYTE const_alphas[] = { 255, 128, 1, 200 };
+    static const int widths[] = { 1, 3, 4, 7, 8, 15, 17, 31, 33, 67 };
+    HDC src_dc = CreateCompatibleDC(NULL), dst_dc = CreateCompatibleDC(NULL);
+    HBITMAP src_dib, dst_dib, old_src, old_dst;
+    DWORD *src_bits, *dst_bits, *orig, expect;
+    int i, j, k, x, height = 5, errors;
+    BLENDFUNCTION blend;
+
+    src_dib = create_test_dib(src_dc, 67, height, 32, BI_RGB, NULL, (void **)&src_bits);
+    dst_dib = create_test_dib(dst_dc, 67, height, 32, BI_RGB, NULL, (void **)&dst_bits);
+    old_src = SelectObject(src_dc, src_dib);
+    old_dst = SelectObject(dst_dc, dst_dib);
+    orig = HeapAlloc(GetProcessHeap(), 0, 67 * height * sizeof(DWORD));
+
+    for (i = 0; i < ARRAY_SIZE(const_alphas); i++)
+    {
+        for (j = 0; j < ARRAY_SIZE(widths); j++)
+        {
+            for (k = 0; k < 2; k++)
+            {
+                for (x = 0; x < 67 * height; x++)
+                {
+                    DWORD alpha = rand() & 0xff;
+                    src_bits[x] = alpha << 24 | (rand() % (alpha + 1)) << 16 |
+                                  (rand() % (alpha + 1)) << 8 | (rand() % (alpha + 1));
+                    orig[x] = dst_bits[x] = rand() ^ (rand() << 16);
+                }
+                blend.BlendOp = AC_SRC_OVER;
+                blend.BlendFlags = 0;
+                blend.SourceConstantAlpha = const_alphas[i];
+                blend.AlphaFormat = k ? AC_SRC_ALPHA : 0;
+                GdiAlphaBlend(dst_dc, 0, 0, widths[j], height, src_dc, 0, 0, widths[j], height, blend);
+                GdiFlush();
+
+                for (x = errors = 0; x < 67 * height; x++)
+                {
+                    if (x % 67 >= widths[j]) expect = orig[x];
+                    else if (k) expect = ref_blend_argb(orig[x], src_bits[x], const_alphas[i]);
+                    else expect = ref_blend_color(orig[x], src_bits[x], const_alphas[i]) |
+                                  ref_blend_color(orig[x] >> 8, src_bits[x] >> 8, const_alphas[i]) << 8 |
+                                  ref_blend_color(orig[x] >> 16, src_bits[x] >> 16, const_alphas[i]) << 16 |
+                                  ref_blend_color(orig[x] >> 24, src_bits[x] >> 24, const_alphas[i]) << 24;
+                    if (dst_bits[x] != expect && !errors++)
+                        ok(0, "alpha %u width %d format %d pixel %d: got %08x expected %08x\n",
+                           const_alphas[i], widths[j], k, x, dst_bits[x], expect);
+                }
+            }
+        }
+    }
+
+    HeapFree(GetProcessHeap(), 0, orig);
+    SelectObject(src_dc, old_src);
+    SelectObject(dst_dc, old_dst);
+    DeleteObject(src_dib);
+    DeleteObject(dst_dib);
+    DeleteDC(src_dc);
+    DeleteDC(dst_dc);
+}
+
+static void test_large_blits(void)
+{
+    static const struct
+    {
+        int src_width, src_height, dst_width, dst_height, mode;
+    } stretches[] =
+    {
+        { 256, 200, 1024, 1024, COLORONCOLOR },
+        { 1000, 300, 1024, 1000, COLORONCOLOR },
+        { 1024, 2000, 1024, 600, COLORONCOLOR },
+        { 1024, 2000, 1024, 600, BLACKONWHITE },
+        { 2000, 1500, 777, 700, WHITEONBLACK },
+    };
+    HDC src_dc = CreateCompatibleDC(NULL), dst_dc = CreateCompatibleDC(NULL);
+    HBITMAP src_dib, dst_dib, old_src, old_dst;
+    DWORD *src_bits, *dst_bits, *expect;
+    BLENDFUNCTION blend;
+    HRGN rgn;
+    int i, x, y, size, band = 16;
+
+    src_dib = create_test_dib(src_dc, 2000, 2000, 32, BI_RGB, NULL, (void **)&src_bits);
+    dst_dib = create_test_dib(dst_dc, 1024, 1024, 32, BI_RGB, NULL, (void **)&dst_bits);
+    old_src = SelectObject(src_dc, src_dib);
+    old_dst = SelectObject(dst_dc, dst_dib);
+    size = 1024 * 1024 * sizeof(DWORD);
+    expect = HeapAlloc(GetProcessHeap(), 0, size);
+
+    for (x = 0; x < 2000 * 2000; x++) src_bits[x] = rand() ^ (rand() << 16);
+
+    /* large operations may be split in tiles, the result must match small clipped ones */
+    for (i = 0; i < ARRAY_SIZE(stretches); i++)
+    {
+        SetStretchBltMode(dst_dc, stretches[i].mode);
+        memset(dst_bits, 0x55, size);
+        for (y = 0; y < 1024; y += band)
+        {
+            rgn = CreateRectRgn(0, y, 1024, y + band);
+            SelectClipRgn(dst_dc, rgn);
+            DeleteObject(rgn);
+            StretchBlt(dst_dc, 0, 0, stretches[i].dst_width, stretches[i].dst_height,
+                       src_dc, 0, 0, stretches[i].src_width, stretches[i].src_height, SRCCOPY);
+        }
+        SelectClipRgn(dst_dc, NULL);
+        memcpy(expect, dst_bits, size);
+
+        memset(dst_bits, 0x55, size);
+        StretchBlt(dst_dc, 0, 0, stretches[i].dst_width, stretches[i].dst_height,
+                   src_dc, 0, 0, stretches[i].src_width, stretches[i].src_height, SRCCOPY);
+        ok(!memcmp(dst_bits, expect, size), "%d: StretchBlt %dx%d -> %dx%d differs from clipped result\n", i,
+           stretches[i].src_width, stretches[i].src_height, stretches[i].dst_width, stretches[i].dst_height);
+    }
+
+    for (x = 0; x < 2000 * 2000; x++)
+    {
+        DWORD alpha = rand() & 0xff;
+        src_bits[x] = alpha << 24 | (rand() % (alpha + 1)) << 16 | (rand() % (alpha + 1)) << 8 | (rand() % (alpha + 1));
+    }
+    for (i = 0; i < 2; i++)
+    {
+        blend.BlendOp = AC_SRC_OVER;
+        blend.BlendFlags = 0;
+        blend.SourceConstantAlpha = i ? 200 : 128;
+        blend.AlphaFormat = i ? AC_SRC_ALPHA : 0;
+
+        for (x = 0; x < 1024 * 1024; x++) expect[x] = x * 0x9e3779b1;
+        memcpy(dst_bits, expect, size);
+        for (y = 0; y < 1000; y += band)
+            GdiAlphaBlend(dst_dc, 3, y, 1017, min(band, 1000 - y), src_dc, 5, y + 7, 1017, min(band, 1000 - y), blend);
+        GdiFlush();
+        memcpy(expect, dst_bits, size);
+
+        for (x = 0; x < 1024 * 1024; x++) dst_bits[x] = x * 0x9e3779b1;
+        GdiAlphaBlend(dst_dc, 3, 0, 1017, 1000, src_dc, 5, 7, 1017, 1000, blend);
+        GdiFlush();
+        ok(!memcmp(dst_bits, expect, size), "%d: AlphaBlend differs from banded result\n", i);
+    }
+
+    HeapFree(GetProcessHeap(), 0, expect);
+    SelectObject(src_dc, old_src);
+    SelectObject(dst_dc, old_dst);
+    DeleteObject(src_dib);
+    DeleteObject(dst_dib);
+    DeleteDC(src_dc);
+    DeleteDC(dst_dc);
+}
+
+static void test_convert_555_exact(void)
+{
+    static const int widths[] = { 1, 7, 8, 9, 15, 16, 17, 33, 67, 256 };
+    char bmibuf[sizeof(BITMAPINFO) + 256 * sizeof(RGBQUAD)];
+    BITMAPINFO *bmi = (BITMAPINFO *)bmibuf;
+    HDC hdc = CreateCompatibleDC(NULL);
+    int i, x, y, height, stride, errors;
+    DWORD *dst_bits, expect;
+    HBITMAP dib;
+    WORD *src, v;
+
+    src = HeapAlloc(GetProcessHeap(), 0, 256 * 128 * sizeof(WORD));
+
+    memset(bmibuf, 0, sizeof(bmibuf));
+    bmi->bmiHeader.biSize = sizeof(bmi->bmiHeader);
+    bmi->bmiHeader.biPlanes = 1;
+    bmi->bmiHeader.biBitCount = 16;
+    bmi->bmiHeader.biCompression = BI_RGB;
+
+    /* odd widths leave a scalar tail in each row, the widest rows cover all 555 values */
+    for (i = 0; i < ARRAY_SIZE(widths); i++)
+    {
+        height = min(128, (0x8000 + widths[i] - 1) / widths[i]);
+        stride = (widths[i] + 1) & ~1;
+        for (y = 0; y < height; y++)
+            for (x = 0; x < widths[i]; x++)
+                src[y * stride + x] = ((y * widths[i] + x) * 0x4e35 + i) & 0x7fff;
+        bmi->bmiHeader.biWidth = widths[i];
+        bmi->bmiHeader.biHeight = -height;
+
+        dib = create_test_dib(hdc, widths[i], height, 32, BI_RGB, NULL, (void **)&dst_bits);
+        memset(dst_bits, 0xcc, widths[i] * height * sizeof(DWORD));
+        SetDIBits(hdc, dib, 0, height, src, bmi, DIB_RGB_COLORS);
+
+        for (y = errors = 0; y < height; y++)
+        {
+            for (x = 0; x < widths[i]; x++)
+            {
+                v = src[y * stride + x];
+                expect = ((v << 9) & 0xf80000) | ((v << 4) & 0x070000) |
+                         ((v << 6) & 0x00f800) | ((v << 1) & 0x000700) |
+                         ((v << 3) & 0x0000f8) | ((v >> 2) & 0x000007);
+                if (dst_bits[y * widths[i] + x] != expect && !errors++)
+                    ok(0, "width %d pixel %d,%d: got %08x expected %08x for %04x\n", widths[i], x, y,
+                       dst_bits[y * widths[i] + x], expect, v);
+            }
+        }
+        DeleteObject(dib);
+    }
+
+    HeapFree(GetProcessHeap(), 0, src);
+    DeleteDC(hdc);
+}
+
+static void test_glyph_exact(void)
+{
+    static const DWORD masks_bgr[3] = { 0x0000ff, 0x00ff00, 0xff0000 };
+    static const char text[] = "EFHILT_=-|#";
+    HDC dc_8888 = CreateCompatibleDC(NULL), dc_bgr = CreateCompatibleDC(NULL);
+    HBITMAP dib_8888, dib_bgr, old_8888, old_bgr;
+    DWORD *bits_8888, *bits_bgr, swapped;
+    HFONT font, old_font_8888, old_font_bgr;
+    int i, j, x, errors;
+    LOGFONTA lf;
+
+    /* 32-bit BGR DIBs use the generic 32-bit glyph code, 8888 ones the vectorized one */
+    dib_8888 = create_test_dib(dc_8888, 640, 160, 32, BI_RGB, NULL, (void **)&bits_8888);
+    dib_bgr = create_test_dib(dc_bgr, 640, 160, 32, BI_BITFIELDS, masks_bgr, (void **)&bits_bgr);
+    old_8888 = SelectObject(dc_8888, dib_8888);
+    old_bgr = SelectObject(dc_bgr, dib_bgr);
+    SetBkMode(dc_8888, TRANSPARENT);
+    SetBkMode(dc_bgr, TRANSPARENT);
+    SetTextColor(dc_8888, RGB(0x20, 0x40, 0x80));
+    SetTextColor(dc_bgr, RGB(0x20, 0x40, 0x80));
+
+    memset(&lf, 0, sizeof(lf));
+    lf.lfQuality = ANTIALIASED_QUALITY;
+    lf.lfWeight = FW_BOLD;
+    strcpy(lf.lfFaceName, "Arial");
+
+    /* edges of horizontal strokes give long runs of partially covered pixels at some sizes and angles */
+    for (i = 0; i < 48; i++)
+    {
+        lf.lfHeight = -(40 + i * 2);
+        lf.lfEscapement = lf.lfOrientation = (i % 4) * 5;
+        font = CreateFontIndirectA(&lf);
+        old_font_8888 = SelectObject(dc_8888, font);
+        old_font_bgr = SelectObject(dc_bgr, font);
+
+        for (x = 0; x < 640 * 160; x++)
+        {
+            bits_8888[x] = (x * 0x9e3779b1) & 0xffffff;
+            bits_bgr[x] = (bits_8888[x] & 0x00ff00) | (bits_8888[x] >> 16 & 0xff) | (bits_8888[x] & 0xff) << 16;
+        }
+        for (j = 0; j < 3; j++)
+        {
+            ExtTextOutA(dc_8888, j * 3 + 1, 10 + j * 40, 0, NULL, text, strlen(text), NULL);
+            ExtTextOutA(dc_bgr, j * 3 + 1, 10 + j * 40, 0, NULL, text, strlen(text), NULL);
+        }
+
+        for (x = errors = 0; x < 640 * 160; x++)
+        {
+            swapped = (bits_bgr[x] & 0x00ff00) | (bits_bgr[x] >> 16 & 0xff) | (bits_bgr[x] & 0xff) << 16;
+            if (bits_8888[x] != swapped && !errors++)
+                ok(0, "height %d angle %d pixel %d,%d: got %08x expected %08x\n", lf.lfHeight, lf.lfEscapement,
+                   x % 640, x / 640, bits_8888[x], swapped);
+        }
+
+        SelectObject(dc_8888, old_font_8888);
+        SelectObject(dc_bgr, old_font_bgr);
+        DeleteObject(font);
+    }
+
+    SelectObject(dc_8888, old_8888);
+    SelectObject(dc_bgr, old_bgr);
+    DeleteObject(dib_8888);
+    DeleteObject(dib_bgr);
+    DeleteDC(dc_8888);
+    DeleteDC(dc_bgr);
+}
+
 START_TEST(dib)
 {
     CryptAcquireContextW(&crypt_prov, NULL, NULL, PROV_RSA_FULL, CRYPT_VERIFYCONTEXT);
 
     test_simple_graphics();
+    test_alpha_blend_exact();
+    test_large_blits();
+    test_convert_555_exact();
+    test_glyph_exact();
 
     CryptReleaseContext(crypt_prov, 0);
 }
@@ -7651,6 +7651,67 @@ static void test_GetOutlineTextMetrics_subst(void)
     ReleaseDC(0, hdc);
 }
 
+static INT CALLBACK count_fonts_proc(const LOGFONTA *lf, const TEXTMETRICA *tm, DWORD type, LPARAM lparam)
+{
+    (*(int *)lparam)++;
+    return 1;
+}
+
+static void test_font_selection_cache(void)
+{
+    static const char *names[] = { "Arial", "Tahoma", "Times New Roman", "Courier New", "Marlett", "Nonexistent" };
+    int i, j, found[ARRAY_SIZE(names)], total;
+    HFONT hfont, old_font;
+    TEXTMETRICA tm[2];
+    LOGFONTA lf;
+    HDC hdc;
+
+    hdc = CreateCompatibleDC(0);
+    memset(tm, 0, sizeof(tm));
+
+    /* many distinct logical fonts, each selected twice so that the second one comes from the cache */
+    for (i = 0; i < 256 * (ARRAY_SIZE(names) - 1); i++)
+    {
+        memset(&lf, 0, sizeof(lf));
+        lf.lfHeight = -(8 + i % 64);
+        lf.lfWeight = (i / 64) % 2 ? FW_BOLD : FW_NORMAL;
+        lf.lfItalic = (i / 128) % 2;
+        lf.lfCharSet = DEFAULT_CHARSET;
+        strcpy(lf.lfFaceName, names[i / 256]);
+        for (j = 0; j < 2; j++)
+        {
+            hfont = CreateFontIndirectA(&lf);
+            old_font = SelectObject(hdc, hfont);
+            ok(GetTextMetricsA(hdc, &tm[j]), "GetTextMetrics failed for %s %d\n", lf.lfFaceName, lf.lfHeight);
+            SelectObject(hdc, old_font);
+            DeleteObject(hfont);
+        }
+        ok(!memcmp(&tm[0], &tm[1], sizeof(tm[0])), "%s %d: got different metrics from the cached font\n",
+           lf.lfFaceName, lf.lfHeight);
+    }
+
+    /* enumeration by name must return the same fonts every time */
+    memset(&lf, 0, sizeof(lf));
+    lf.lfCharSet = DEFAULT_CHARSET;
+    for (i = 0; i < ARRAY_SIZE(names); i++)
+    {
+        strcpy(lf.lfFaceName, names[i]);
+        found[i] = 0;
+        EnumFontFamiliesExA(hdc, &lf, count_fonts_proc, (LPARAM)&found[i], 0);
+    }
+    ok(!found[ARRAY_SIZE(names) - 1], "got %d fonts for a nonexistent name\n", found[ARRAY_SIZE(names) - 1]);
+
+    for (i = 0; i < ARRAY_SIZE(names); i++)
+    {
+        strcpy(lf.lfFaceName, names[i]);
+        total = 0;
+        EnumFontFamiliesExA(hdc, &lf, count_fonts_proc, (LPARAM)&total, 0);
+        ok(total == found[i], "%s: got %d fonts, expected %d\n", names[i], total, found[i]);
+    }
+
+    DeleteDC(hdc);
+}
+
 START_TEST(font)
 {
     static const char *test_names[] =
@@ -7739,6 +7800,7 @@ START_TEST(font)
     test_lang_names();
     test_char_width();
     test_select_object();
+    test_font_selection_cache();
 
     /* These tests should be last test until RemoveFontResource
      * is properly implemented.
@@ -27,11 +27,13 @@
 #include "wine/test.h"
 
 static NTSTATUS (WINAPI *pNtAlertThreadByThreadId)( HANDLE );
+static NTSTATUS (WINAPI *pNtCancelTimer)( HANDLE, BOOLEAN * );
 static NTSTATUS (WINAPI *pNtClose)( HANDLE );
 static NTSTATUS (WINAPI *pNtCreateEvent) ( PHANDLE, ACCESS_MASK, const OBJECT_ATTRIBUTES *, EVENT_TYPE, BOOLEAN);
 static NTSTATUS (WINAPI *pNtCreateKeyedEvent)( HANDLE *, ACCESS_MASK, const OBJECT_ATTRIBUTES *, ULONG );
 static NTSTATUS (WINAPI *pNtCreateMutant)( HANDLE *, ACCESS_MASK, const OBJECT_ATTRIBUTES *, BOOLEAN );
 static NTSTATUS (WINAPI *pNtCreateSemaphore)( HANDLE *, ACCESS_MASK, const OBJECT_ATTRIBUTES *, LONG, LONG );
+static NTSTATUS (WINAPI *pNtCreateTimer)( HANDLE *, ACCESS_MASK, const OBJECT_ATTRIBUTES *, TIMER_TYPE );
 static NTSTATUS (WINAPI *pNtOpenEvent)( HANDLE *, ACCESS_MASK, const OBJECT_ATTRIBUTES * );
 static NTSTATUS (WINAPI *pNtOpenKeyedEvent)( HANDLE *, ACCESS_MASK, const OBJECT_ATTRIBUTES * );
 static NTSTATUS (WINAPI *pNtPulseEvent)( HANDLE, LONG * );
@@ -44,8 +46,10 @@ static NTSTATUS (WINAPI *pNtReleaseMutant)( HANDLE, LONG * );
 static NTSTATUS (WINAPI *pNtReleaseSemaphore)( HANDLE, ULONG, ULONG * );
 static NTSTATUS (WINAPI *pNtResetEvent)( HANDLE, LONG * );
 static NTSTATUS (WINAPI *pNtSetEvent)( HANDLE, LONG * );
+static NTSTATUS (WINAPI *pNtSetTimer)( HANDLE, const LARGE_INTEGER *, PTIMER_APC_ROUTINE, void *, BOOLEAN, ULONG, BOOLEAN * );
 static NTSTATUS (WINAPI *pNtWaitForAlertByThreadId)( void *, const LARGE_INTEGER * );
 static NTSTATUS (WINAPI *pNtWaitForKeyedEvent)( HANDLE, const void *, BOOLEAN, const LARGE_INTEGER * );
+static NTSTATUS (WINAPI *pNtWaitForSingleObject)( HANDLE, BOOLEAN, const LARGE_INTEGER * );
 static BOOLEAN  (WINAPI *pRtlAcquireResourceExclusive)( RTL_RWLOCK *, BOOLEAN );
 static BOOLEAN  (WINAPI *pRtlAcquireResourceShared)( RTL_RWLOCK *, BOOLEAN );
 static void     (WINAPI *pRtlDeleteResource)( RTL_RWLOCK * );
@@ -901,6 +905,65 @@ static void test_close_io_completion(void)
     CloseHandle( thread );
 }
 
+static void test_many_timers(void)
+{
+    LARGE_INTEGER now, when;
+    HANDLE *timers;
+    NTSTATUS status;
+    int count, i;
+
+    if (!pNtCreateTimer || !pNtSetTimer || !pNtCancelTimer || !pNtWaitForSingleObject)
+    {
+        win_skip( "NtCreateTimer not available\n" );
+        return;
+    }
+
+    count = 2000;
+
+    timers = HeapAlloc( GetProcessHeap(), HEAP_ZERO_MEMORY, count * sizeof(*timers) );
+    ok( timers != NULL, "HeapAlloc failed\n" );
+
+    for (i = 0; i < count; i++)
+    {
+        status = pNtCreateTimer( &timers[i], TIMER_ALL_ACCESS, NULL, NotificationTimer );
+        ok( !status, "NtCreateTimer failed %08x\n", status );
+    }
+
+    pNtQuerySystemTime( &now );
+
+    /* every 64th timer expires soon, the other ones are spread over the next hours;
+     * both groups alternate between absolute and relative timeouts */
+    for (i = 0; i < count; i++)
+    {
+        when.QuadPart = (i % 64) ? (LONGLONG)((i * 7919) % 10000 + 1) * 10000000 : 50 * 10000;
+        if (((i % 64) ? i : i / 64) % 2) when.QuadPart = -when.QuadPart;
+        else when.QuadPart += now.QuadPart;
+        status = pNtSetTimer( timers[i], &when, NULL, NULL, FALSE, 0, NULL );
+        ok( !status, "NtSetTimer failed %08x\n", status );
+    }
+
+    for (i = 0; i < count; i += 64)
+    {
+        status = pNtWaitForSingleObject( timers[i], FALSE, NULL );
+        ok( !status, "NtWaitForSingleObject returned %08x\n", status );
+    }
+    for (i = 1; i < min( count, 64 ); i++)
+    {
+        status = WaitForSingleObject( timers[i], 0 );
+        ok( status == WAIT_TIMEOUT, "WaitForSingleObject returned %08x\n", status );
+    }
+
+    for (i = 0; i < count; i++)
+    {
+        status = pNtCancelTimer( timers[i], NULL );
+        ok( !status, "NtCancelTimer failed %08x\n", status );
+    }
+
+    for (i = 0; i < count; i++)
+        pNtClose( timers[i] );
+    HeapFree( GetProcessHeap(), 0, timers );
+}
+
 START_TEST(sync)
 {
     HMODULE module = GetModuleHandleA("ntdll.dll");
@@ -912,11 +975,13 @@ START_TEST(sync)
     if (argc > 2) return;
 
     pNtAlertThreadByThreadId        = (void *)GetProcAddress(module, "NtAlertThreadByThreadId");
+    pNtCancelTimer                  = (void *)GetProcAddress(module, "NtCancelTimer");
     pNtClose                        = (void *)GetProcAddress(module, "NtClose");
     pNtCreateEvent                  = (void *)GetProcAddress(module, "NtCreateEvent");
     pNtCreateKeyedEvent             = (void *)GetProcAddress(module, "NtCreateKeyedEvent");
     pNtCreateMutant                 = (void *)GetProcAddress(module, "NtCreateMutant");
     pNtCreateSemaphore              = (void *)GetProcAddress(module, "NtCreateSemaphore");
+    pNtCreateTimer                  = (void *)GetProcAddress(module, "NtCreateTimer");
     pNtOpenEvent                    = (void *)GetProcAddress(module, "NtOpenEvent");
     pNtOpenKeyedEvent               = (void *)GetProcAddress(module, "NtOpenKeyedEvent");
     pNtPulseEvent                   = (void *)GetProcAddress(module, "NtPulseEvent");
@@ -929,8 +994,10 @@ START_TEST(sync)
     pNtReleaseSemaphore             = (void *)GetProcAddress(module, "NtReleaseSemaphore");
     pNtResetEvent                   = (void *)GetProcAddress(module, "NtResetEvent");
     pNtSetEvent                     = (void *)GetProcAddress(module, "NtSetEvent");
+    pNtSetTimer                     = (void *)GetProcAddress(module, "NtSetTimer");
     pNtWaitForAlertByThreadId       = (void *)GetProcAddress(module, "NtWaitForAlertByThreadId");
     pNtWaitForKeyedEvent            = (void *)GetProcAddress(module, "NtWaitForKeyedEvent");
+    pNtWaitForSingleObject          = (void *)GetProcAddress(module, "NtWaitForSingleObject");
     pRtlAcquireResourceExclusive    = (void *)GetProcAddress(module, "RtlAcquireResourceExclusive");
     pRtlAcquireResourceShared       = (void *)GetProcAddress(module, "RtlAcquireResourceShared");
     pRtlDeleteResource              = (void *)GetProcAddress(module, "RtlDeleteResource");
@@ -949,4 +1016,5 @@ START_TEST(sync)
     test_resource();
     test_tid_alert( argv );
     test_close_io_completion();
+    test_many_timers();
 }
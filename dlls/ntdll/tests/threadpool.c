@@ -811,6 +811,112 @@ static void test_tp_work_scheduler(void)
     pTpReleasePool(pool);
 }
 
+static void CALLBACK concurrent_post_simple_cb(TP_CALLBACK_INSTANCE *instance, void *userdata)
+{
+    InterlockedIncrement((LONG *)userdata);
+}
+
+static void CALLBACK concurrent_post_work_cb(TP_CALLBACK_INSTANCE *instance, void *userdata, TP_WORK *work)
+{
+    InterlockedIncrement((LONG *)userdata);
+}
+
+struct concurrent_post_params
+{
+    TP_CALLBACK_ENVIRON *environment;
+    TP_WORK *work;
+    HANDLE start_event;
+    LONG *executed;
+    LONG failed;
+    int count;
+};
+
+static DWORD WINAPI concurrent_post_thread(void *arg)
+{
+    struct concurrent_post_params *params = arg;
+    NTSTATUS status;
+    int i;
+
+    WaitForSingleObject(params->start_event, INFINITE);
+    for (i = 0; i < params->count; i++)
+    {
+        if (params->work)
+            pTpPostWork(params->work);
+        else if ((status = pTpSimpleTryPost(concurrent_post_simple_cb, params->executed, params->environment)))
+            InterlockedIncrement(&params->failed);
+    }
+    return 0;
+}
+
+static void test_tp_concurrent_post(void)
+{
+    static const int num_threads[] = {1, 2, 4, 8, 16, 32, 64};
+    struct concurrent_post_params params;
+    TP_CALLBACK_ENVIRON environment;
+    HANDLE threads[64];
+    TP_CLEANUP_GROUP *group;
+    NTSTATUS status;
+    TP_POOL *pool;
+    LONG executed;
+    int use_work, i, j;
+
+    pool = NULL;
+    status = pTpAllocPool(&pool, NULL);
+    ok(!status, "TpAllocPool failed with status %x\n", status);
+    ok(pool != NULL, "expected pool != NULL\n");
+
+    group = NULL;
+    status = pTpAllocCleanupGroup(&group);
+    ok(!status, "TpAllocCleanupGroup failed with status %x\n", status);
+    ok(group != NULL, "expected group != NULL\n");
+
+    memset(&environment, 0, sizeof(environment));
+    environment.Version = 1;
+    environment.Pool = pool;
+    environment.CleanupGroup = group;
+
+    for (use_work = 0; use_work < 2; use_work++)
+    {
+        for (i = 0; i < ARRAY_SIZE(num_threads); i++)
+        {
+            executed = 0;
+            memset(&params, 0, sizeof(params));
+            params.environment = &environment;
+            params.executed = &executed;
+            params.count = 100;
+            params.start_event = CreateEventA(NULL, TRUE, FALSE, NULL);
+            ok(params.start_event != NULL, "CreateEventA failed %u\n", GetLastError());
+
+            if (use_work)
+            {
+                status = pTpAllocWork(&params.work, concurrent_post_work_cb, &executed, &environment);
+                ok(!status, "TpAllocWork failed with status %x\n", status);
+            }
+
+            for (j = 0; j < num_threads[i]; j++)
+            {
+                threads[j] = CreateThread(NULL, 0, concurrent_post_thread, &params, 0, NULL);
+                ok(threads[j] != NULL, "CreateThread failed %u\n", GetLastError());
+            }
+
+            SetEvent(params.start_event);
+            WaitForMultipleObjects(num_threads[i], threads, TRUE, INFINITE);
+            pTpReleaseCleanupGroupMembers(group, FALSE, NULL);
+
+            ok(!params.failed, "TpSimpleTryPost failed %d times\n", params.failed);
+            ok(executed == params.count * num_threads[i], "expected %d callbacks, got %d\n",
+               params.count * num_threads[i], executed);
+
+            for (j = 0; j < num_threads[i]; j++)
+                CloseHandle(threads[j]);
+            CloseHandle(params.start_event);
+        }
+    }
+
+    pTpReleaseCleanupGroup(group);
+    pTpReleasePool(pool);
+}
+
 static void CALLBACK simple_release_cb(TP_CALLBACK_INSTANCE *instance, void *userdata)
 {
     HANDLE *semaphores = userdata;
@@ -1606,6 +1712,106 @@ static void test_tp_window_length(void)
     CloseHandle(semaphore);
 }
 
+static void CALLBACK many_timers_cb(TP_CALLBACK_INSTANCE *instance, void *userdata, TP_TIMER *timer)
+{
+    InterlockedIncrement((LONG *)userdata);
+}
+
+static void CALLBACK rtl_many_timers_cb(void *userdata, BOOLEAN timeout)
+{
+    InterlockedIncrement((LONG *)userdata);
+}
+
+static void test_tp_many_timers(void)
+{
+    LARGE_INTEGER when;
+    TP_CALLBACK_ENVIRON environment;
+    HANDLE queue, *rtl_timers;
+    TP_TIMER **timers;
+    NTSTATUS status;
+    TP_POOL *pool;
+    LONG executed;
+    int count, i;
+    DWORD ticks;
+
+    count = 2000;
+
+    timers = HeapAlloc(GetProcessHeap(), HEAP_ZERO_MEMORY, count * sizeof(*timers));
+    rtl_timers = HeapAlloc(GetProcessHeap(), HEAP_ZERO_MEMORY, count * sizeof(*rtl_timers));
+    ok(timers != NULL && rtl_timers != NULL, "HeapAlloc failed\n");
+
+    pool = NULL;
+    status = pTpAllocPool(&pool, NULL);
+    ok(!status, "TpAllocPool failed with status %x\n", status);
+    ok(pool != NULL, "expected pool != NULL\n");
+
+    memset(&environment, 0, sizeof(environment));
+    environment.Version = 1;
+    environment.Pool = pool;
+
+    /* every 16th timer expires soon, all others are spread over the next hours */
+    executed = 0;
+    for (i = 0; i < count; i++)
+    {
+        status = pTpAllocTimer(&timers[i], many_timers_cb, &executed, &environment);
+        ok(!status, "TpAllocTimer failed with status %x\n", status);
+    }
+
+    for (i = 0; i < count; i++)
+    {
+        when.QuadPart = (i % 16) ? -(LONGLONG)(i % 7919 + 1) * 10000000 : -100 * 10000;
+        pTpSetTimer(timers[i], &when, 0, (i % 3) * 10);
+    }
+    for (i = 0; i < count; i++)
+    {
+        if (!(i % 16)) continue;
+        when.QuadPart = -(LONGLONG)((i * 31) % 7919 + 1) * 10000000;
+        pTpSetTimer(timers[i], &when, 0, 0);
+    }
+
+    ticks = GetTickCount();
+    while (executed < (count + 15) / 16 && GetTickCount() - ticks < 5000)
+        Sleep(10);
+    ok(executed == (count + 15) / 16, "expected %d callbacks, got %d\n", (count + 15) / 16, executed);
+
+    for (i = 0; i < count; i++)
+    {
+        pTpSetTimer(timers[i], NULL, 0, 0);
+        pTpWaitForTimer(timers[i], TRUE);
+        pTpReleaseTimer(timers[i]);
+    }
+
+    /* the same for the timer queue timers */
+    status = RtlCreateTimerQueue(&queue);
+    ok(!status, "RtlCreateTimerQueue failed with status %x\n", status);
+
+    executed = 0;
+    for (i = 0; i < count; i++)
+    {
+        status = RtlCreateTimer(queue, &rtl_timers[i], rtl_many_timers_cb, &executed,
+                                (i % 16) ? (i % 7919 + 1) * 1000 : 100, 0, WT_EXECUTEINTIMERTHREAD);
+        ok(!status, "RtlCreateTimer failed with status %x\n", status);
+    }
+
+    ticks = GetTickCount();
+    while (executed < (count + 15) / 16 && GetTickCount() - ticks < 5000)
+        Sleep(10);
+    ok(executed == (count + 15) / 16, "expected %d callbacks, got %d\n", (count + 15) / 16, executed);
+
+    for (i = 0; i < count; i++)
+    {
+        status = RtlDeleteTimer(queue, rtl_timers[i], INVALID_HANDLE_VALUE);
+        ok(!status, "RtlDeleteTimer failed with status %x\n", status);
+    }
+
+    status = RtlDeleteTimerQueueEx(queue, INVALID_HANDLE_VALUE);
+    ok(!status, "RtlDeleteTimerQueueEx failed with status %x\n", status);
+
+    pTpReleasePool(pool);
+    HeapFree(GetProcessHeap(), 0, rtl_timers);
+    HeapFree(GetProcessHeap(), 0, timers);
+}
+
 struct wait_info
 {
     HANDLE semaphore;
@@ -2370,12 +2576,14 @@ START_TEST(threadpool)
     test_tp_simple();
     test_tp_work();
     test_tp_work_scheduler();
+    test_tp_concurrent_post();
     test_tp_group_wait();
     test_tp_group_cancel();
     test_tp_instance();
     test_tp_disassociate();
     test_tp_timer();
     test_tp_window_length();
+    test_tp_many_timers();
     test_tp_wait();
     test_tp_multi_wait();
     test_tp_io();
@@ -22,6 +22,7 @@
 #include <assert.h>
 #include <stdarg.h>
 #include <limits.h>
+#include <stdlib.h>
 
 #define NONAMELESSUNION
 #include "ntstatus.h"
@@ -48,6 +49,33 @@ struct rtl_work_item
 #define EXPIRE_NEVER       (~(ULONGLONG)0)
 #define TIMER_QUEUE_MAGIC  0x516d6954   /* TimQ */
 
+/*
+ * Hierarchical timer wheel, shared by timer queues and threadpool timers
+ */
+
+#define TIMER_WHEEL_BITS   6
+#define TIMER_WHEEL_SLOTS  (1 << TIMER_WHEEL_BITS)
+#define TIMER_WHEEL_MASK   (TIMER_WHEEL_SLOTS - 1)
+#define TIMER_WHEEL_LEVELS 4
+
+struct timer_wheel_entry
+{
+    struct list entry;
+    ULONGLONG expire;           /* absolute expiration time, in units of the wheel */
+};
+
+struct timer_wheel
+{
+    ULONGLONG resolution;       /* time units per tick */
+    ULONGLONG current;          /* current tick, all earlier ticks have been expired */
+    ULONGLONG overflow_base;    /* value of current >> top level shift when overflow was sorted */
+    unsigned int count;
+    /* Level 0 holds timers of the current 64 ticks, level n timers which differ
+     * from the current tick in the n-th group of TIMER_WHEEL_BITS bits. */
+    struct list slots[TIMER_WHEEL_LEVELS][TIMER_WHEEL_SLOTS];
+    struct list overflow;       /* timers beyond the range of the highest level */
+};
+
 static RTL_CRITICAL_SECTION_DEBUG critsect_compl_debug;
 
 static struct
@@ -73,12 +101,12 @@ struct queue_timer
 {
     struct timer_queue *q;
     struct list entry;
+    struct timer_wheel_entry wheel_entry; /* only in the wheel if expire != EXPIRE_NEVER */
     ULONG runcount;             /* number of callbacks pending execution */
     RTL_WAITORTIMERCALLBACKFUNC callback;
     PVOID param;
     DWORD period;
     ULONG flags;
-    ULONGLONG expire;
     BOOL destroy;               /* timer should be deleted; once set, never unset */
     HANDLE event;               /* removal event */
 };
@@ -87,7 +115,9 @@ struct timer_queue
 {
     DWORD magic;
     RTL_CRITICAL_SECTION cs;
-    struct list timers;         /* sorted by expiration time */
+    struct list timers;         /* all timers of the queue */
+    struct timer_wheel wheel;   /* pending timers, sorted by expiration time */
+    ULONGLONG wakeup;           /* expiration time the timer thread waits for */
     BOOL quit;                  /* queue should be deleted; once set, never unset */
     HANDLE event;
     HANDLE thread;
@@ -103,22 +133,38 @@ struct timer_queue
 /* internal threadpool representation */
 struct threadpool
 {
+    /* Lock-free submission queues, order matches TP_CALLBACK_PRIORITY - high, normal, low.
+     * Worker threads move submitted objects in batches to their local queues. */
+    SLIST_HEADER            submissions[3];
     LONG                    refcount;
     LONG                    objcount;
     BOOL                    shutdown;
     CRITICAL_SECTION        cs;
-    /* Pools of work items, locked via .cs, order matches TP_CALLBACK_PRIORITY - high, normal, low. */
-    struct list             pools[3];
+    /* list of worker threads (struct threadpool_worker), locked via .cs */
+    struct list             workers;
     RTL_CONDITION_VARIABLE  update_event;
-    /* information about worker threads, locked via .cs */
+    /* information about worker threads, modified via .cs or interlocked functions */
     int                     max_workers;
     int                     min_workers;
-    int                     num_workers;
-    int                     num_busy_workers;
+    LONG                    num_workers;
+    LONG                    num_busy_workers;
+    LONG                    num_idle_workers;
     HANDLE                  compl_port;
     TP_POOL_STACK_INFORMATION stack_info;
 };
 
+/* internal threadpool worker representation, lives on the stack of the worker thread */
+struct threadpool_worker
+{
+    struct list             entry;
+    struct threadpool       *pool;
+    /* Local queues of work items, locked via .lock, same order as threadpool.submissions.
+     * Only the owning thread adds items, other workers may steal from them. */
+    RTL_SRWLOCK             lock;
+    struct list             queues[3];
+    LONG                    num_queued;
+};
+
 enum threadpool_objtype
 {
     TP_OBJECT_TYPE_SIMPLE,
@@ -153,8 +199,11 @@ struct threadpool_object
     /* information about the group, locked via .group->cs */
     struct list             group_entry;
     BOOL                    is_group_member;
-    /* information about the pool, locked via .pool->cs */
+    /* information about the pending callbacks, locked via .lock */
+    RTL_SRWLOCK             lock;
+    BOOL                    queued;
     struct list             pool_entry;
+    SLIST_ENTRY             submission_entry;
     RTL_CONDITION_VARIABLE  finished_event;
     RTL_CONDITION_VARIABLE  group_finished_event;
     HANDLE                  completed_event;
@@ -178,9 +227,8 @@ struct threadpool_object
             /* information about the timer, locked via timerqueue.cs */
             BOOL            timer_initialized;
             BOOL            timer_pending;
-            struct list     timer_entry;
+            struct timer_wheel_entry timer_entry;
             BOOL            timer_set;
-            ULONGLONG       timeout;
             LONG            period;
             LONG            window_length;
         } timer;
@@ -200,7 +248,7 @@ struct threadpool_object
         struct
         {
             PTP_IO_CALLBACK callback;
-            /* locked via .pool->cs */
+            /* locked via .lock */
             unsigned int    pending_count, skipped_count, completion_count, completion_max;
             BOOL            shutting_down;
             struct io_completion *completions;
@@ -244,16 +292,19 @@ static struct
     CRITICAL_SECTION        cs;
     LONG                    objcount;
     BOOL                    thread_running;
-    struct list             pending_timers;
     RTL_CONDITION_VARIABLE  update_event;
+    /* pending timers, initialized when the first timer object is created */
+    struct timer_wheel      wheel;
+    ULONGLONG               wakeup;
+    struct timer_wheel_entry **window_timers;
+    unsigned int            window_timers_size;
 }
 timerqueue =
 {
     { &timerqueue_debug, -1, 0, 0, 0, 0 },      /* cs */
     0,                                          /* objcount */
     FALSE,                                      /* thread_running */
-    LIST_INIT( timerqueue.pending_timers ),     /* pending_timers */
-    RTL_CONDITION_VARIABLE_INIT                 /* update_event */
+    RTL_CONDITION_VARIABLE_INIT,                /* update_event */
 };
 
 static RTL_CRITICAL_SECTION_DEBUG timerqueue_debug =
@@ -547,6 +598,214 @@ static inline PLARGE_INTEGER get_nt_timeout( PLARGE_INTEGER pTime, ULONG timeout
 }
 
 
+/************************** Timer Wheel Impl **************************/
+
+static void timer_wheel_init( struct timer_wheel *wheel, ULONGLONG resolution, ULONGLONG now )
+{
+    unsigned int level, slot;
+
+    wheel->resolution    = resolution;
+    wheel->current       = now / resolution;
+    wheel->overflow_base = wheel->current >> (TIMER_WHEEL_LEVELS * TIMER_WHEEL_BITS);
+    wheel->count         = 0;
+    for (level = 0; level < TIMER_WHEEL_LEVELS; level++)
+        for (slot = 0; slot < TIMER_WHEEL_SLOTS; slot++)
+            list_init( &wheel->slots[level][slot] );
+    list_init( &wheel->overflow );
+}
+
+static void timer_wheel_place( struct timer_wheel *wheel, struct timer_wheel_entry *timer )
+{
+    ULONGLONG tick = timer->expire / wheel->resolution;
+    unsigned int level, shift;
+
+    /* Timers which are already expired go to the current slot. */
+    if (tick < wheel->current) tick = wheel->current;
+
+    /* Use the lowest level where all more significant bits match the current tick. */
+    for (level = 0; level < TIMER_WHEEL_LEVELS; level++)
+    {
+        shift = level * TIMER_WHEEL_BITS;
+        if ((tick >> (shift + TIMER_WHEEL_BITS)) == (wheel->current >> (shift + TIMER_WHEEL_BITS)))
+        {
+            list_add_tail( &wheel->slots[level][(tick >> shift) & TIMER_WHEEL_MASK], &timer->entry );
+            return;
+        }
+    }
+
+    list_add_tail( &wheel->overflow, &timer->entry );
+}
+
+static void timer_wheel_add( struct timer_wheel *wheel, struct timer_wheel_entry *timer )
+{
+    timer_wheel_place( wheel, timer );
+    wheel->count++;
+}
+
+static void timer_wheel_remove( struct timer_wheel *wheel, struct timer_wheel_entry *timer )
+{
+    assert( wheel->count );
+    list_remove( &timer->entry );
+    wheel->count--;
+}
+
+/* Redistributes timers of the higher level slots the current tick has reached. */
+static void timer_wheel_cascade( struct timer_wheel *wheel )
+{
+    struct timer_wheel_entry *timer, *next;
+    struct list pending = LIST_INIT( pending );
+    unsigned int level;
+    struct list *slot;
+
+    if ((wheel->current >> (TIMER_WHEEL_LEVELS * TIMER_WHEEL_BITS)) != wheel->overflow_base)
+    {
+        wheel->overflow_base = wheel->current >> (TIMER_WHEEL_LEVELS * TIMER_WHEEL_BITS);
+        list_move_tail( &pending, &wheel->overflow );
+    }
+
+    for (level = TIMER_WHEEL_LEVELS - 1; level > 0; level--)
+    {
+        slot = &wheel->slots[level][(wheel->current >> (level * TIMER_WHEEL_BITS)) & TIMER_WHEEL_MASK];
+        list_move_tail( &pending, slot );
+    }
+
+    LIST_FOR_EACH_ENTRY_SAFE( timer, next, &pending, struct timer_wheel_entry, entry )
+    {
+        list_remove( &timer->entry );
+        timer_wheel_place( wheel, timer );
+    }
+}
+
+/* Returns the first non-empty slot of a higher level, and the tick when it has to be cascaded. */
+static struct list *timer_wheel_next_cascade( struct timer_wheel *wheel, ULONGLONG *tick )
+{
+    unsigned int level, slot, shift;
+
+    for (level = 1; level < TIMER_WHEEL_LEVELS; level++)
+    {
+        shift = level * TIMER_WHEEL_BITS;
+        for (slot = ((wheel->current >> shift) & TIMER_WHEEL_MASK) + 1; slot < TIMER_WHEEL_SLOTS; slot++)
+        {
+            if (list_empty( &wheel->slots[level][slot] )) continue;
+            *tick = (((wheel->current >> (shift + TIMER_WHEEL_BITS)) << TIMER_WHEEL_BITS) | slot) << shift;
+            return &wheel->slots[level][slot];
+        }
+    }
+
+    if (list_empty( &wheel->overflow )) return NULL;
+    *tick = (wheel->overflow_base + 1) << (TIMER_WHEEL_LEVELS * TIMER_WHEEL_BITS);
+    return &wheel->overflow;
+}
+
+/* Moves all timers expiring at or before 'now' to the 'expired' list. */
+static void timer_wheel_expire( struct timer_wheel *wheel, ULONGLONG now, struct list *expired )
+{
+    ULONGLONG tick, end = now / wheel->resolution;
+    struct timer_wheel_entry *timer, *next;
+    unsigned int slot;
+    struct list *ptr;
+
+    while (wheel->count && wheel->current <= end)
+    {
+        /* Expire the timers of the current revolution of the lowest level. */
+        for (slot = wheel->current & TIMER_WHEEL_MASK; slot < TIMER_WHEEL_SLOTS; slot++)
+        {
+            tick = (wheel->current & ~(ULONGLONG)TIMER_WHEEL_MASK) | slot;
+            if (tick > end) break;
+
+            ptr = &wheel->slots[0][slot];
+            if (list_empty( ptr )) continue;
+            wheel->current = tick;
+
+            LIST_FOR_EACH_ENTRY_SAFE( timer, next, ptr, struct timer_wheel_entry, entry )
+            {
+                if (timer->expire > now) continue;
+                list_remove( &timer->entry );
+                list_add_tail( expired, &timer->entry );
+                wheel->count--;
+            }
+
+            /* Remaining timers expire later during the current tick. */
+            if (!list_empty( ptr )) return;
+        }
+        if (tick > end) break;
+
+        /* Skip to the next tick where timers of a higher level have to be cascaded. */
+        if (!timer_wheel_next_cascade( wheel, &tick ) || tick > end) break;
+        wheel->current = tick;
+        timer_wheel_cascade( wheel );
+    }
+
+    if (wheel->current < end)
+    {
+        wheel->current = end;
+        timer_wheel_cascade( wheel );
+    }
+}
+
+/* Returns the timer with the lowest expiration time. */
+static struct timer_wheel_entry *timer_wheel_next( struct timer_wheel *wheel )
+{
+    struct timer_wheel_entry *timer, *first = NULL;
+    struct list *slot = NULL;
+    unsigned int i;
+    ULONGLONG tick;
+
+    if (!wheel->count) return NULL;
+
+    for (i = wheel->current & TIMER_WHEEL_MASK; i < TIMER_WHEEL_SLOTS; i++)
+    {
+        if (list_empty( &wheel->slots[0][i] )) continue;
+        slot = &wheel->slots[0][i];
+        break;
+    }
+
+    if (!slot && !(slot = timer_wheel_next_cascade( wheel, &tick )))
+        return NULL;
+
+    LIST_FOR_EACH_ENTRY( timer, slot, struct timer_wheel_entry, entry )
+        if (!first || timer->expire < first->expire) first = timer;
+
+    return first;
+}
+
+static BOOL timer_wheel_collect( struct list *slot, ULONGLONG end, struct timer_wheel_entry ***timers,
+                                 unsigned int *size, unsigned int *count )
+{
+    struct timer_wheel_entry *timer;
+
+    LIST_FOR_EACH_ENTRY( timer, slot, struct timer_wheel_entry, entry )
+    {
+        if (timer->expire >= end) continue;
+        if (!array_reserve( (void **)timers, size, *count + 1, sizeof(**timers) )) return FALSE;
+        (*timers)[(*count)++] = timer;
+    }
+    return TRUE;
+}
+
+/* Collects all timers expiring before 'end', in unspecified order. */
+static unsigned int timer_wheel_find( struct timer_wheel *wheel, ULONGLONG end,
+                                      struct timer_wheel_entry ***timers, unsigned int *size )
+{
+    ULONGLONG end_tick = end / wheel->resolution, tick;
+    unsigned int level, slot, shift, count = 0;
+
+    for (level = 0; level < TIMER_WHEEL_LEVELS; level++)
+    {
+        shift = level * TIMER_WHEEL_BITS;
+        for (slot = (wheel->current >> shift) & TIMER_WHEEL_MASK; slot < TIMER_WHEEL_SLOTS; slot++)
+        {
+            tick = (((wheel->current >> (shift + TIMER_WHEEL_BITS)) << TIMER_WHEEL_BITS) | slot) << shift;
+            if (tick > end_tick) return count;
+            if (!timer_wheel_collect( &wheel->slots[level][slot], end, timers, size, &count )) return count;
+        }
+    }
+
+    tick = (wheel->overflow_base + 1) << (TIMER_WHEEL_LEVELS * TIMER_WHEEL_BITS);
+    if (tick <= end_tick) timer_wheel_collect( &wheel->overflow, end, timers, size, &count );
+    return count;
+}
+
 /************************** Timer Queue Impl **************************/
 
 static void queue_remove_timer(struct queue_timer *t)
@@ -559,6 +818,8 @@ static void queue_remove_timer(struct queue_timer *t)
     assert(t->runcount == 0);
     assert(t->destroy);
 
+    if (t->wheel_entry.expire != EXPIRE_NEVER)
+        timer_wheel_remove(&q->wheel, &t->wheel_entry);
     list_remove(&t->entry);
     if (t->event)
         NtSetEvent(t->event, NULL);
@@ -602,65 +863,74 @@ static void queue_add_timer(struct queue_timer *t, ULONGLONG time,
 {
     /* We MUST hold the queue cs while calling this function.  */
     struct timer_queue *q = t->q;
-    struct list *ptr = &q->timers;
 
     assert(!q->quit || (t->destroy && time == EXPIRE_NEVER));
 
-    if (time != EXPIRE_NEVER)
-        LIST_FOR_EACH(ptr, &q->timers)
-        {
-            struct queue_timer *cur = LIST_ENTRY(ptr, struct queue_timer, entry);
-            if (time < cur->expire)
-                break;
-        }
-    list_add_before(ptr, &t->entry);
+    t->wheel_entry.expire = time;
+    if (time == EXPIRE_NEVER)
+        return;
 
-    t->expire = time;
+    timer_wheel_add(&q->wheel, &t->wheel_entry);
 
-    /* If we insert at the head of the list, we need to expire sooner
-       than expected.  */
-    if (set_event && &t->entry == list_head(&q->timers))
+    /* If the timer expires before the one the timer thread is waiting
+       for, we need to expire sooner than expected.  */
+    if (set_event && time < q->wakeup)
+    {
+        q->wakeup = time;
         NtSetEvent(q->event, NULL);
+    }
 }
 
 static inline void queue_move_timer(struct queue_timer *t, ULONGLONG time,
                                     BOOL set_event)
 {
     /* We MUST hold the queue cs while calling this function.  */
-    list_remove(&t->entry);
+    if (t->wheel_entry.expire != EXPIRE_NEVER)
+        timer_wheel_remove(&t->q->wheel, &t->wheel_entry);
     queue_add_timer(t, time, set_event);
 }
 
 static void queue_timer_expire(struct timer_queue *q)
 {
-    struct queue_timer *t = NULL;
+    struct queue_timer *timers[64], *t, *next_timer;
+    struct list expired = LIST_INIT(expired);
+    unsigned int i, count = 0;
+    ULONGLONG now, next;
 
     RtlEnterCriticalSection(&q->cs);
-    if (list_head(&q->timers))
+    now = queue_current_time();
+    timer_wheel_expire(&q->wheel, now, &expired);
+    LIST_FOR_EACH_ENTRY_SAFE(t, next_timer, &expired, struct queue_timer, wheel_entry.entry)
     {
-        ULONGLONG now, next;
-        t = LIST_ENTRY(list_head(&q->timers), struct queue_timer, entry);
-        if (!t->destroy && t->expire <= ((now = queue_current_time())))
+        list_remove(&t->wheel_entry.entry);
+        assert(!t->destroy);
+
+        /* Leave timers beyond the batch size expired, the timer thread
+           comes back for them immediately.  */
+        if (count == ARRAY_SIZE(timers))
         {
-            ++t->runcount;
-            if (t->period)
-            {
-                next = t->expire + t->period;
-                /* avoid trigger cascade if overloaded / hibernated */
-                if (next < now)
-                    next = now + t->period;
-            }
-            else
-                next = EXPIRE_NEVER;
-            queue_move_timer(t, next, FALSE);
+            timer_wheel_add(&q->wheel, &t->wheel_entry);
+            continue;
+        }
+
+        ++t->runcount;
+        if (t->period)
+        {
+            next = t->wheel_entry.expire + t->period;
+            /* avoid trigger cascade if overloaded / hibernated */
+            if (next < now)
+                next = now + t->period;
         }
         else
-            t = NULL;
+            next = EXPIRE_NEVER;
+        queue_add_timer(t, next, FALSE);
+        timers[count++] = t;
     }
     RtlLeaveCriticalSection(&q->cs);
 
-    if (t)
+    for (i = 0; i < count; i++)
     {
+        t = timers[i];
         if (t->flags & WT_EXECUTEINTIMERTHREAD)
             timer_callback_wrapper(t);
         else
@@ -678,20 +948,16 @@ static void queue_timer_expire(struct timer_queue *q)
 
 static ULONG queue_get_timeout(struct timer_queue *q)
 {
-    struct queue_timer *t;
+    struct timer_wheel_entry *next;
     ULONG timeout = INFINITE;
 
     RtlEnterCriticalSection(&q->cs);
-    if (list_head(&q->timers))
+    q->wakeup = EXPIRE_NEVER;
+    if ((next = timer_wheel_next(&q->wheel)))
     {
-        t = LIST_ENTRY(list_head(&q->timers), struct queue_timer, entry);
-        assert(!t->destroy || t->expire == EXPIRE_NEVER);
-
-        if (t->expire != EXPIRE_NEVER)
-        {
-            ULONGLONG time = queue_current_time();
-            timeout = t->expire < time ? 0 : t->expire - time;
-        }
+        ULONGLONG time = queue_current_time();
+        q->wakeup = next->expire;
+        timeout = next->expire < time ? 0 : min(next->expire - time, INFINITE - 1);
     }
     RtlLeaveCriticalSection(&q->cs);
 
@@ -750,8 +1016,7 @@ static void queue_destroy_timer(struct queue_timer *t)
            cleanup wrapper.  */
         queue_remove_timer(t);
     else
-        /* Make sure no destroyed timer masks an active timer at the head
-           of the sorted list.  */
+        /* Make sure a destroyed timer doesn't fire anymore.  */
         queue_move_timer(t, EXPIRE_NEVER, FALSE);
 }
 
@@ -776,6 +1041,8 @@ NTSTATUS WINAPI RtlCreateTimerQueue(PHANDLE NewTimerQueue)
 
     RtlInitializeCriticalSection(&q->cs);
     list_init(&q->timers);
+    timer_wheel_init(&q->wheel, 1, queue_current_time());
+    q->wakeup = EXPIRE_NEVER;
     q->quit = FALSE;
     q->magic = TIMER_QUEUE_MAGIC;
     status = NtCreateEvent(&q->event, EVENT_ALL_ACCESS, NULL, SynchronizationEvent, FALSE);
@@ -936,7 +1203,10 @@ NTSTATUS WINAPI RtlCreateTimer(HANDLE TimerQueue, HANDLE *NewTimer,
     if (q->quit)
         status = STATUS_INVALID_HANDLE;
     else
+    {
+        list_add_tail(&q->timers, &t->entry);
         queue_add_timer(t, queue_current_time() + DueTime, TRUE);
+    }
     RtlLeaveCriticalSection(&q->cs);
 
     if (status == STATUS_SUCCESS)
@@ -973,7 +1243,7 @@ NTSTATUS WINAPI RtlUpdateTimer(HANDLE TimerQueue, HANDLE Timer,
 
     RtlEnterCriticalSection(&q->cs);
     /* Can't change a timer if it was once-only or destroyed.  */
-    if (t->expire != EXPIRE_NEVER)
+    if (t->wheel_entry.expire != EXPIRE_NEVER)
     {
         t->period = Period;
         queue_move_timer(t, queue_current_time() + DueTime, TRUE);
@@ -1041,15 +1311,68 @@ NTSTATUS WINAPI RtlDeleteTimer(HANDLE TimerQueue, HANDLE Timer,
     return status;
 }
 
+static int __cdecl timer_expire_compare( const void *a, const void *b )
+{
+    const struct timer_wheel_entry *timer1 = *(const struct timer_wheel_entry **)a;
+    const struct timer_wheel_entry *timer2 = *(const struct timer_wheel_entry **)b;
+
+    if (timer1->expire < timer2->expire) return -1;
+    return timer1->expire > timer2->expire;
+}
+
+/***********************************************************************
+ *           timerqueue_next_timeout    (internal)
+ *
+ * Determines the next wakeup time of the timer thread and uses the window
+ * length to coalesce timers expiring close to each other. Only timers expiring
+ * within the window of the first timer have to be considered.
+ * timerqueue.cs has to be held.
+ */
+static ULONGLONG timerqueue_next_timeout(void)
+{
+    ULONGLONG timeout_lower, timeout_upper, new_timeout;
+    struct threadpool_object *timer;
+    struct timer_wheel_entry *next;
+    unsigned int i, count;
+
+    if (!(next = timer_wheel_next( &timerqueue.wheel )))
+        return MAXLONGLONG;
+
+    timer = CONTAINING_RECORD( next, struct threadpool_object, u.timer.timer_entry );
+    assert( timer->type == TP_OBJECT_TYPE_TIMER );
+    timeout_lower = next->expire;
+    timeout_upper = next->expire + (ULONGLONG)timer->u.timer.window_length * 10000;
+    if (timeout_upper == timeout_lower)
+        return timeout_lower;
+
+    count = timer_wheel_find( &timerqueue.wheel, timeout_upper,
+                              &timerqueue.window_timers, &timerqueue.window_timers_size );
+    qsort( timerqueue.window_timers, count, sizeof(*timerqueue.window_timers), timer_expire_compare );
+
+    for (i = 0; i < count; i++)
+    {
+        timer = CONTAINING_RECORD( timerqueue.window_timers[i], struct threadpool_object, u.timer.timer_entry );
+        assert( timer->type == TP_OBJECT_TYPE_TIMER );
+        if (timer->u.timer.timer_entry.expire >= timeout_upper)
+            break;
+
+        timeout_lower = timer->u.timer.timer_entry.expire;
+        new_timeout   = timeout_lower + (ULONGLONG)timer->u.timer.window_length * 10000;
+        if (new_timeout < timeout_upper)
+            timeout_upper = new_timeout;
+    }
+
+    return timeout_lower;
+}
+
 /***********************************************************************
  *           timerqueue_thread_proc    (internal)
  */
 static void CALLBACK timerqueue_thread_proc( void *param )
 {
-    ULONGLONG timeout_lower, timeout_upper, new_timeout;
-    struct threadpool_object *other_timer;
+    struct threadpool_object *timer, *next;
+    struct list expired = LIST_INIT( expired );
     LARGE_INTEGER now, timeout;
-    struct list *ptr;
 
     TRACE( "starting timer queue thread\n" );
 
@@ -1059,58 +1382,36 @@ static void CALLBACK timerqueue_thread_proc( void *param )
         NtQuerySystemTime( &now );
 
         /* Check for expired timers. */
-        while ((ptr = list_head( &timerqueue.pending_timers )))
+        timer_wheel_expire( &timerqueue.wheel, now.QuadPart, &expired );
+        LIST_FOR_EACH_ENTRY_SAFE( timer, next, &expired, struct threadpool_object, u.timer.timer_entry.entry )
         {
-            struct threadpool_object *timer = LIST_ENTRY( ptr, struct threadpool_object, u.timer.timer_entry );
             assert( timer->type == TP_OBJECT_TYPE_TIMER );
             assert( timer->u.timer.timer_pending );
-            if (timer->u.timer.timeout > now.QuadPart)
-                break;
 
             /* Queue a new callback in one of the worker threads. */
-            list_remove( &timer->u.timer.timer_entry );
+            list_remove( &timer->u.timer.timer_entry.entry );
             timer->u.timer.timer_pending = FALSE;
             tp_object_submit( timer, FALSE );
 
             /* Insert the timer back into the queue, except it's marked for shutdown. */
             if (timer->u.timer.period && !timer->shutdown)
             {
-                timer->u.timer.timeout += (ULONGLONG)timer->u.timer.period * 10000;
-                if (timer->u.timer.timeout <= now.QuadPart)
-                    timer->u.timer.timeout = now.QuadPart + 1;
+                timer->u.timer.timer_entry.expire += (ULONGLONG)timer->u.timer.period * 10000;
+                if (timer->u.timer.timer_entry.expire <= now.QuadPart)
+                    timer->u.timer.timer_entry.expire = now.QuadPart + 1;
 
-                LIST_FOR_EACH_ENTRY( other_timer, &timerqueue.pending_timers,
-                                     struct threadpool_object, u.timer.timer_entry )
-                {
-                    assert( other_timer->type == TP_OBJECT_TYPE_TIMER );
-                    if (timer->u.timer.timeout < other_timer->u.timer.timeout)
-                        break;
-                }
-                list_add_before( &other_timer->u.timer.timer_entry, &timer->u.timer.timer_entry );
+                timer_wheel_add( &timerqueue.wheel, &timer->u.timer.timer_entry );
                 timer->u.timer.timer_pending = TRUE;
             }
         }
 
-        timeout_lower = timeout_upper = MAXLONGLONG;
-
         /* Determine next timeout and use the window length to optimize wakeup times. */
-        LIST_FOR_EACH_ENTRY( other_timer, &timerqueue.pending_timers,
-                             struct threadpool_object, u.timer.timer_entry )
-        {
-            assert( other_timer->type == TP_OBJECT_TYPE_TIMER );
-            if (other_timer->u.timer.timeout >= timeout_upper)
-                break;
-
-            timeout_lower = other_timer->u.timer.timeout;
-            new_timeout   = timeout_lower + (ULONGLONG)other_timer->u.timer.window_length * 10000;
-            if (new_timeout < timeout_upper)
-                timeout_upper = new_timeout;
-        }
+        timerqueue.wakeup = timerqueue_next_timeout();
 
         /* Wait for timer update events or until the next timer expires. */
         if (timerqueue.objcount)
         {
-            timeout.QuadPart = timeout_lower;
+            timeout.QuadPart = timerqueue.wakeup;
             RtlSleepConditionVariableCS( &timerqueue.update_event, &timerqueue.cs, &timeout );
             continue;
         }
@@ -1135,7 +1436,8 @@ static void CALLBACK timerqueue_thread_proc( void *param )
 /***********************************************************************
  *           tp_new_worker_thread    (internal)
  *
- * Create and account a new worker thread for the desired pool.
+ * Create and account a new worker thread for the desired pool,
+ * pool->cs has to be held.
  */
 static NTSTATUS tp_new_worker_thread( struct threadpool *pool )
 {
@@ -1147,7 +1449,7 @@ static NTSTATUS tp_new_worker_thread( struct threadpool *pool )
     if (status == STATUS_SUCCESS)
     {
         InterlockedIncrement( &pool->refcount );
-        pool->num_workers++;
+        InterlockedIncrement( &pool->num_workers );
         NtClose( thread );
     }
     return status;
@@ -1167,12 +1469,21 @@ static NTSTATUS tp_timerqueue_lock( struct threadpool_object *timer )
     timer->u.timer.timer_initialized    = FALSE;
     timer->u.timer.timer_pending        = FALSE;
     timer->u.timer.timer_set            = FALSE;
-    timer->u.timer.timeout              = 0;
+    timer->u.timer.timer_entry.expire   = 0;
     timer->u.timer.period               = 0;
     timer->u.timer.window_length        = 0;
 
     RtlEnterCriticalSection( &timerqueue.cs );
 
+    /* The wheel is empty when no timer objects exist, restart it at the current time. */
+    if (!timerqueue.objcount)
+    {
+        LARGE_INTEGER now;
+        NtQuerySystemTime( &now );
+        timer_wheel_init( &timerqueue.wheel, 10000, now.QuadPart );
+        timerqueue.wakeup = MAXLONGLONG;
+    }
+
     /* Make sure that the timerqueue thread is running. */
     if (!timerqueue.thread_running)
     {
@@ -1211,14 +1522,14 @@ static void tp_timerqueue_unlock( struct threadpool_object *timer )
         /* If timer was pending, remove it. */
         if (timer->u.timer.timer_pending)
         {
-            list_remove( &timer->u.timer.timer_entry );
+            timer_wheel_remove( &timerqueue.wheel, &timer->u.timer.timer_entry );
             timer->u.timer.timer_pending = FALSE;
         }
 
         /* If the last timer object was destroyed, then wake up the thread. */
         if (!--timerqueue.objcount)
         {
-            assert( list_empty( &timerqueue.pending_timers ) );
+            assert( !timerqueue.wheel.count );
             RtlWakeAllConditionVariable( &timerqueue.update_event );
         }
 
@@ -1265,10 +1576,10 @@ static void CALLBACK waitqueue_thread_proc( void *param )
                 if ((wait->u.wait.flags & (WT_EXECUTEINWAITTHREAD | WT_EXECUTEINIOTHREAD)))
                 {
                     InterlockedIncrement( &wait->refcount );
+                    RtlAcquireSRWLockExclusive( &wait->lock );
                     wait->num_pending_callbacks++;
-                    RtlEnterCriticalSection( &wait->pool->cs );
                     tp_object_execute( wait, TRUE );
-                    RtlLeaveCriticalSection( &wait->pool->cs );
+                    RtlReleaseSRWLockExclusive( &wait->lock );
                     tp_object_release( wait );
                 }
                 else tp_object_submit( wait, FALSE );
@@ -1321,11 +1632,11 @@ static void CALLBACK waitqueue_thread_proc( void *param )
                     }
                     if ((wait->u.wait.flags & (WT_EXECUTEINWAITTHREAD | WT_EXECUTEINIOTHREAD)))
                     {
+                        RtlAcquireSRWLockExclusive( &wait->lock );
                         wait->u.wait.signaled++;
                         wait->num_pending_callbacks++;
-                        RtlEnterCriticalSection( &wait->pool->cs );
                         tp_object_execute( wait, TRUE );
-                        RtlLeaveCriticalSection( &wait->pool->cs );
+                        RtlReleaseSRWLockExclusive( &wait->lock );
                     }
                     else tp_object_submit( wait, TRUE );
                 }
@@ -1507,7 +1818,7 @@ static void CALLBACK ioqueue_thread_proc( void *param )
     struct threadpool_object *io;
     IO_STATUS_BLOCK iosb;
     ULONG_PTR key, value;
-    BOOL destroy, skip;
+    BOOL destroy, skip, submit;
     NTSTATUS status;
 
     TRACE( "starting I/O completion thread\n" );
@@ -1521,14 +1832,14 @@ static void CALLBACK ioqueue_thread_proc( void *param )
             ERR("NtRemoveIoCompletion failed, status %#x.\n", status);
         RtlEnterCriticalSection( &ioqueue.cs );
 
-        destroy = skip = FALSE;
+        destroy = skip = submit = FALSE;
         io = (struct threadpool_object *)key;
 
         TRACE( "io %p, iosb.Status %#x.\n", io, iosb.u.Status );
 
         if (io && (io->shutdown || io->u.io.shutting_down))
         {
-            RtlEnterCriticalSection( &io->pool->cs );
+            RtlAcquireSRWLockExclusive( &io->lock );
             if (!io->u.io.pending_count)
             {
                 if (io->u.io.skipped_count)
@@ -1539,7 +1850,7 @@ static void CALLBACK ioqueue_thread_proc( void *param )
                 else
                     destroy = TRUE;
             }
-            RtlLeaveCriticalSection( &io->pool->cs );
+            RtlReleaseSRWLockExclusive( &io->lock );
             if (skip) continue;
         }
 
@@ -1552,7 +1863,7 @@ static void CALLBACK ioqueue_thread_proc( void *param )
         }
         else if (io)
         {
-            RtlEnterCriticalSection( &io->pool->cs );
+            RtlAcquireSRWLockExclusive( &io->lock );
 
             TRACE( "pending_count %u.\n", io->u.io.pending_count );
 
@@ -1563,17 +1874,18 @@ static void CALLBACK ioqueue_thread_proc( void *param )
                         io->u.io.completion_count + 1, sizeof(*io->u.io.completions)))
                 {
                     ERR( "Failed to allocate memory.\n" );
-                    RtlLeaveCriticalSection( &io->pool->cs );
+                    RtlReleaseSRWLockExclusive( &io->lock );
                     continue;
                 }
 
                 completion = &io->u.io.completions[io->u.io.completion_count++];
                 completion->iosb = iosb;
                 completion->cvalue = value;
-
-                tp_object_submit( io, FALSE );
+                submit = TRUE;
             }
-            RtlLeaveCriticalSection( &io->pool->cs );
+            RtlReleaseSRWLockExclusive( &io->lock );
+
+            if (submit) tp_object_submit( io, FALSE );
         }
 
         if (!ioqueue.objcount)
@@ -1666,14 +1978,16 @@ static NTSTATUS tp_threadpool_alloc( struct threadpool **out )
     RtlInitializeCriticalSection( &pool->cs );
     pool->cs.DebugInfo->Spare[0] = (DWORD_PTR)(__FILE__ ": threadpool.cs");
 
-    for (i = 0; i < ARRAY_SIZE(pool->pools); ++i)
-        list_init( &pool->pools[i] );
+    for (i = 0; i < ARRAY_SIZE(pool->submissions); ++i)
+        RtlInitializeSListHead( &pool->submissions[i] );
+    list_init( &pool->workers );
     RtlInitializeConditionVariable( &pool->update_event );
 
     pool->max_workers             = 500;
     pool->min_workers             = 0;
     pool->num_workers             = 0;
     pool->num_busy_workers        = 0;
+    pool->num_idle_workers        = 0;
     pool->stack_info.StackReserve = nt->OptionalHeader.SizeOfStackReserve;
     pool->stack_info.StackCommit  = nt->OptionalHeader.SizeOfStackCommit;
 
@@ -1714,8 +2028,9 @@ static BOOL tp_threadpool_release( struct threadpool *pool )
 
     assert( pool->shutdown );
     assert( !pool->objcount );
-    for (i = 0; i < ARRAY_SIZE(pool->pools); ++i)
-        assert( list_empty( &pool->pools[i] ) );
+    assert( list_empty( &pool->workers ) );
+    for (i = 0; i < ARRAY_SIZE(pool->submissions); ++i)
+        assert( !RtlFirstEntrySList( &pool->submissions[i] ) );
 
     pool->cs.DebugInfo->Spare[0] = 0;
     RtlDeleteCriticalSection( &pool->cs );
@@ -1775,24 +2090,28 @@ static NTSTATUS tp_threadpool_lock( struct threadpool **out, TP_CALLBACK_ENVIRON
         pool = default_threadpool;
     }
 
-    RtlEnterCriticalSection( &pool->cs );
+    /* Keep a reference, and increment objcount to ensure that the
+     * last thread doesn't terminate. Worker threads decrement num_workers
+     * before checking objcount, so the pool lock is only needed when the
+     * last thread has already terminated. */
+    InterlockedIncrement( &pool->refcount );
+    InterlockedIncrement( &pool->objcount );
 
     /* Make sure that the threadpool has at least one thread. */
     if (!pool->num_workers)
-        status = tp_new_worker_thread( pool );
-
-    /* Keep a reference, and increment objcount to ensure that the
-     * last thread doesn't terminate. */
-    if (status == STATUS_SUCCESS)
     {
-        InterlockedIncrement( &pool->refcount );
-        pool->objcount++;
+        RtlEnterCriticalSection( &pool->cs );
+        if (!pool->num_workers)
+            status = tp_new_worker_thread( pool );
+        RtlLeaveCriticalSection( &pool->cs );
     }
 
-    RtlLeaveCriticalSection( &pool->cs );
-
     if (status != STATUS_SUCCESS)
+    {
+        InterlockedDecrement( &pool->objcount );
+        InterlockedDecrement( &pool->refcount );
         return status;
+    }
 
     *out = pool;
     return STATUS_SUCCESS;
@@ -1805,9 +2124,7 @@ static NTSTATUS tp_threadpool_lock( struct threadpool **out, TP_CALLBACK_ENVIRON
  */
 static void tp_threadpool_unlock( struct threadpool *pool )
 {
-    RtlEnterCriticalSection( &pool->cs );
-    pool->objcount--;
-    RtlLeaveCriticalSection( &pool->cs );
+    InterlockedDecrement( &pool->objcount );
     tp_threadpool_release( pool );
 }
 
@@ -1895,7 +2212,10 @@ static void tp_object_initialize( struct threadpool_object *object, struct threa
     memset( &object->group_entry, 0, sizeof(object->group_entry) );
     object->is_group_member         = FALSE;
 
+    RtlInitializeSRWLock( &object->lock );
+    object->queued                  = FALSE;
     memset( &object->pool_entry, 0, sizeof(object->pool_entry) );
+    memset( &object->submission_entry, 0, sizeof(object->submission_entry) );
     RtlInitializeConditionVariable( &object->finished_event );
     RtlInitializeConditionVariable( &object->group_finished_event );
     object->completed_event         = NULL;
@@ -1918,7 +2238,7 @@ static void tp_object_initialize( struct threadpool_object *object, struct threa
             TP_CALLBACK_ENVIRON_V3 *environment_v3 = (TP_CALLBACK_ENVIRON_V3 *)environment;
 
             object->priority = environment_v3->CallbackPriority;
-            assert( object->priority < ARRAY_SIZE(pool->pools) );
+            assert( object->priority < ARRAY_SIZE(pool->submissions) );
         }
 
         if (environment->ActivationContext)
@@ -1955,10 +2275,66 @@ static void tp_object_initialize( struct threadpool_object *object, struct threa
         tp_object_release( object );
 }
 
-static void tp_object_prio_queue( struct threadpool_object *object )
+/***********************************************************************
+ *           tp_threadpool_wake    (internal)
+ *
+ * Makes sure that newly queued work items are picked up. The pool lock
+ * is only taken when a new worker thread has to be started, or when an
+ * idle worker thread has to be woken up.
+ */
+static void tp_threadpool_wake( struct threadpool *pool )
+{
+    NTSTATUS status = STATUS_UNSUCCESSFUL;
+
+    if (!pool->num_idle_workers && (pool->num_busy_workers < pool->num_workers ||
+        pool->num_workers >= pool->max_workers))
+        return;
+
+    RtlEnterCriticalSection( &pool->cs );
+
+    /* Start new worker threads if required. */
+    if (pool->num_busy_workers >= pool->num_workers &&
+        pool->num_workers < pool->max_workers)
+        status = tp_new_worker_thread( pool );
+
+    /* No new thread started - wake up one existing thread. */
+    if (status != STATUS_SUCCESS)
+    {
+        assert( pool->num_workers > 0 );
+        RtlWakeConditionVariable( &pool->update_event );
+    }
+
+    RtlLeaveCriticalSection( &pool->cs );
+}
+
+/***********************************************************************
+ *           tp_object_prio_queue    (internal)
+ *
+ * Adds a threadpool object to a work queue, object->lock has to be held.
+ * Objects requeued by a worker thread are added to its local queue, all
+ * other objects are pushed to the lock-free submission queue of the pool.
+ */
+static void tp_object_prio_queue( struct threadpool_object *object, struct threadpool_worker *worker )
 {
-    ++object->pool->num_busy_workers;
-    list_add_tail( &object->pool->pools[object->priority], &object->pool_entry );
+    struct threadpool *pool = object->pool;
+
+    assert( !object->queued );
+    object->queued = TRUE;
+
+    /* The queue keeps its own reference, entries of cancelled objects
+     * are only skipped when they are dequeued. */
+    InterlockedIncrement( &object->refcount );
+    InterlockedIncrement( &pool->num_busy_workers );
+
+    if (worker)
+    {
+        RtlAcquireSRWLockExclusive( &worker->lock );
+        list_add_tail( &worker->queues[object->priority], &object->pool_entry );
+        RtlReleaseSRWLockExclusive( &worker->lock );
+        InterlockedIncrement( &worker->num_queued );
+    }
+    else
+        RtlInterlockedPushEntrySList( &pool->submissions[object->priority], &object->submission_entry );
 }
 
 /***********************************************************************
@@ -1970,35 +2346,28 @@ static void tp_object_prio_queue( struct threadpool_object *object )
 static void tp_object_submit( struct threadpool_object *object, BOOL signaled )
 {
     struct threadpool *pool = object->pool;
-    NTSTATUS status = STATUS_UNSUCCESSFUL;
+    BOOL queued = FALSE;
 
     assert( !object->shutdown );
     assert( !pool->shutdown );
 
-    RtlEnterCriticalSection( &pool->cs );
-
-    /* Start new worker threads if required. */
-    if (pool->num_busy_workers >= pool->num_workers &&
-        pool->num_workers < pool->max_workers)
-        status = tp_new_worker_thread( pool );
+    RtlAcquireSRWLockExclusive( &object->lock );
 
     /* Queue work item and increment refcount. */
     InterlockedIncrement( &object->refcount );
-    if (!object->num_pending_callbacks++)
-        tp_object_prio_queue( object );
+    if (!object->num_pending_callbacks++ && !object->queued)
+    {
+        tp_object_prio_queue( object, NULL );
+        queued = TRUE;
+    }
 
     /* Count how often the object was signaled. */
     if (object->type == TP_OBJECT_TYPE_WAIT && signaled)
         object->u.wait.signaled++;
 
-    /* No new thread started - wake up one existing thread. */
-    if (status != STATUS_SUCCESS)
-    {
-        assert( pool->num_workers > 0 );
-        RtlWakeConditionVariable( &pool->update_event );
-    }
+    RtlReleaseSRWLockExclusive( &object->lock );
 
-    RtlLeaveCriticalSection( &pool->cs );
+    if (queued) tp_threadpool_wake( pool );
 }
 
 /***********************************************************************
@@ -2008,15 +2377,14 @@ static void tp_object_submit( struct threadpool_object *object, BOOL signaled )
  */
 static void tp_object_cancel( struct threadpool_object *object )
 {
-    struct threadpool *pool = object->pool;
     LONG pending_callbacks = 0;
 
-    RtlEnterCriticalSection( &pool->cs );
+    RtlAcquireSRWLockExclusive( &object->lock );
     if (object->num_pending_callbacks)
     {
+        /* The object stays queued, it is skipped when a worker dequeues it. */
         pending_callbacks = object->num_pending_callbacks;
         object->num_pending_callbacks = 0;
-        list_remove( &object->pool_entry );
 
         if (object->type == TP_OBJECT_TYPE_WAIT)
             object->u.wait.signaled = 0;
@@ -2026,7 +2394,7 @@ static void tp_object_cancel( struct threadpool_object *object )
         object->u.io.skipped_count += object->u.io.pending_count;
         object->u.io.pending_count = 0;
     }
-    RtlLeaveCriticalSection( &pool->cs );
+    RtlReleaseSRWLockExclusive( &object->lock );
 
     while (pending_callbacks--)
         tp_object_release( object );
@@ -2053,17 +2421,15 @@ static BOOL object_is_finished( struct threadpool_object *object, BOOL group )
  */
 static void tp_object_wait( struct threadpool_object *object, BOOL group_wait )
 {
-    struct threadpool *pool = object->pool;
-
-    RtlEnterCriticalSection( &pool->cs );
+    RtlAcquireSRWLockExclusive( &object->lock );
     while (!object_is_finished( object, group_wait ))
     {
         if (group_wait)
-            RtlSleepConditionVariableCS( &object->group_finished_event, &pool->cs, NULL );
+            RtlSleepConditionVariableSRW( &object->group_finished_event, &object->lock, NULL, 0 );
         else
-            RtlSleepConditionVariableCS( &object->finished_event, &pool->cs, NULL );
+            RtlSleepConditionVariableSRW( &object->finished_event, &object->lock, NULL, 0 );
     }
-    RtlLeaveCriticalSection( &pool->cs );
+    RtlReleaseSRWLockExclusive( &object->lock );
 }
 
 static void tp_ioqueue_unlock( struct threadpool_object *io )
@@ -2140,24 +2506,10 @@ static BOOL tp_object_release( struct threadpool_object *object )
     return TRUE;
 }
 
-static struct list *threadpool_get_next_item( const struct threadpool *pool )
-{
-    struct list *ptr;
-    unsigned int i;
-
-    for (i = 0; i < ARRAY_SIZE(pool->pools); ++i)
-    {
-        if ((ptr = list_head( &pool->pools[i] )))
-            break;
-    }
-
-    return ptr;
-}
-
 /***********************************************************************
  *           tp_object_execute    (internal)
  *
- * Executes a threadpool object callback, object->pool->cs has to be
+ * Executes a threadpool object callback, object->lock has to be
  * held.
  */
 static void tp_object_execute( struct threadpool_object *object, BOOL wait_thread )
@@ -2165,7 +2517,6 @@ static void tp_object_execute( struct threadpool_object *object, BOOL wait_threa
     TP_CALLBACK_INSTANCE *callback_instance;
     struct threadpool_instance instance;
     struct io_completion completion;
-    struct threadpool *pool = object->pool;
     TP_WAIT_RESULT wait_result = 0;
     NTSTATUS status;
 
@@ -2186,7 +2537,7 @@ static void tp_object_execute( struct threadpool_object *object, BOOL wait_threa
     /* Leave critical section and do the actual callback. */
     object->num_associated_callbacks++;
     object->num_running_callbacks++;
-    RtlLeaveCriticalSection( &pool->cs );
+    RtlReleaseSRWLockExclusive( &object->lock );
     if (wait_thread) RtlLeaveCriticalSection( &waitqueue.cs );
 
     /* Initialize threadpool instance struct. */
@@ -2292,7 +2643,7 @@ static void tp_object_execute( struct threadpool_object *object, BOOL wait_threa
 
 skip_cleanup:
     if (wait_thread) RtlEnterCriticalSection( &waitqueue.cs );
-    RtlEnterCriticalSection( &pool->cs );
+    RtlAcquireSRWLockExclusive( &object->lock );
 
     /* Simple callbacks are automatically shutdown after execution. */
     if (object->type == TP_OBJECT_TYPE_SIMPLE)
@@ -2313,42 +2664,258 @@ skip_cleanup:
     }
 }
 
+/***********************************************************************
+ *           tp_worker_pop    (internal)
+ *
+ * Removes the oldest work item of the given priority from the local
+ * queue of a worker thread.
+ */
+static struct threadpool_object *tp_worker_pop( struct threadpool_worker *worker, unsigned int prio )
+{
+    struct list *ptr;
+
+    if (!worker->num_queued) return NULL;
+
+    RtlAcquireSRWLockExclusive( &worker->lock );
+    if ((ptr = list_head( &worker->queues[prio] )))
+        list_remove( ptr );
+    RtlReleaseSRWLockExclusive( &worker->lock );
+
+    if (!ptr) return NULL;
+    InterlockedDecrement( &worker->num_queued );
+    return LIST_ENTRY( ptr, struct threadpool_object, pool_entry );
+}
+
+/***********************************************************************
+ *           tp_worker_grab_submissions    (internal)
+ *
+ * Moves all submitted work items of the given priority to the local
+ * queue of a worker thread, and returns the oldest one.
+ */
+static struct threadpool_object *tp_worker_grab_submissions( struct threadpool_worker *worker, unsigned int prio )
+{
+    struct threadpool *pool = worker->pool;
+    struct threadpool_object *object;
+    SLIST_ENTRY *entry, *next, *head = NULL;
+    struct list batch = LIST_INIT( batch );
+    LONG count = 0;
+
+    if (!RtlFirstEntrySList( &pool->submissions[prio] )) return NULL;
+    if (!(entry = RtlInterlockedFlushSList( &pool->submissions[prio] ))) return NULL;
+
+    /* The submission queue is a stack, restore the submission order. */
+    while (entry)
+    {
+        next = entry->Next;
+        entry->Next = head;
+        head = entry;
+        entry = next;
+    }
+
+    for (entry = head->Next; entry; entry = entry->Next, count++)
+    {
+        object = CONTAINING_RECORD( entry, struct threadpool_object, submission_entry );
+        list_add_tail( &batch, &object->pool_entry );
+    }
+
+    if (count)
+    {
+        RtlAcquireSRWLockExclusive( &worker->lock );
+        list_move_tail( &worker->queues[prio], &batch );
+        RtlReleaseSRWLockExclusive( &worker->lock );
+        InterlockedExchangeAdd( &worker->num_queued, count );
+
+        /* Let idle workers steal the remaining items. */
+        if (pool->num_idle_workers)
+        {
+            RtlEnterCriticalSection( &pool->cs );
+            RtlWakeAllConditionVariable( &pool->update_event );
+            RtlLeaveCriticalSection( &pool->cs );
+        }
+    }
+
+    return CONTAINING_RECORD( head, struct threadpool_object, submission_entry );
+}
+
+/***********************************************************************
+ *           tp_worker_steal    (internal)
+ *
+ * Steals half of the work items of the highest available priority from
+ * another worker thread, pool->cs has to be held.
+ */
+static struct threadpool_object *tp_worker_steal( struct threadpool_worker *worker )
+{
+    struct threadpool *pool = worker->pool;
+    struct threadpool_worker *victim;
+    struct list stolen, *ptr;
+    unsigned int prio;
+    LONG count, max_count;
+
+    for (prio = 0; prio < ARRAY_SIZE(worker->queues); ++prio)
+    {
+        LIST_FOR_EACH_ENTRY( victim, &pool->workers, struct threadpool_worker, entry )
+        {
+            if (victim == worker || !victim->num_queued) continue;
+
+            list_init( &stolen );
+            count = 0;
+            max_count = (victim->num_queued + 1) / 2;
+
+            RtlAcquireSRWLockExclusive( &victim->lock );
+            while (count < max_count && (ptr = list_head( &victim->queues[prio] )))
+            {
+                list_remove( ptr );
+                list_add_tail( &stolen, ptr );
+                count++;
+            }
+            RtlReleaseSRWLockExclusive( &victim->lock );
+
+            if (!count) continue;
+            InterlockedExchangeAdd( &victim->num_queued, -count );
+
+            ptr = list_head( &stolen );
+            list_remove( ptr );
+            if (--count)
+            {
+                RtlAcquireSRWLockExclusive( &worker->lock );
+                list_move_tail( &worker->queues[prio], &stolen );
+                RtlReleaseSRWLockExclusive( &worker->lock );
+                InterlockedExchangeAdd( &worker->num_queued, count );
+            }
+
+            TRACE( "worker %p stole %d items from worker %p\n", worker, count + 1, victim );
+            return LIST_ENTRY( ptr, struct threadpool_object, pool_entry );
+        }
+    }
+
+    return NULL;
+}
+
+/***********************************************************************
+ *           tp_worker_next_object    (internal)
+ *
+ * Returns the next work item for a worker thread, checking the local
+ * queue and the submission queue for each priority.
+ */
+static struct threadpool_object *tp_worker_next_object( struct threadpool_worker *worker )
+{
+    struct threadpool_object *object;
+    unsigned int prio;
+
+    for (prio = 0; prio < ARRAY_SIZE(worker->queues); ++prio)
+    {
+        if ((object = tp_worker_pop( worker, prio )))
+            return object;
+        if ((object = tp_worker_grab_submissions( worker, prio )))
+            return object;
+    }
+
+    return NULL;
+}
+
+/***********************************************************************
+ *           tp_pool_has_work    (internal)
+ *
+ * Checks whether there are queued work items, pool->cs has to be held.
+ */
+static BOOL tp_pool_has_work( struct threadpool *pool )
+{
+    struct threadpool_worker *worker;
+    unsigned int i;
+
+    for (i = 0; i < ARRAY_SIZE(pool->submissions); ++i)
+        if (RtlFirstEntrySList( &pool->submissions[i] )) return TRUE;
+
+    LIST_FOR_EACH_ENTRY( worker, &pool->workers, struct threadpool_worker, entry )
+        if (worker->num_queued) return TRUE;
+
+    return FALSE;
+}
+
+/***********************************************************************
+ *           tp_worker_execute    (internal)
+ *
+ * Executes a dequeued work item. Items of cancelled objects are skipped.
+ */
+static void tp_worker_execute( struct threadpool_worker *worker, struct threadpool_object *object )
+{
+    struct threadpool *pool = worker->pool;
+
+    RtlAcquireSRWLockExclusive( &object->lock );
+    assert( object->queued );
+    object->queued = FALSE;
+
+    if (object->num_pending_callbacks)
+    {
+        /* If further pending callbacks are queued, move the work item to
+         * the end of the local queue. */
+        if (object->num_pending_callbacks > 1)
+            tp_object_prio_queue( object, worker );
+
+        tp_object_execute( object, FALSE );
+        RtlReleaseSRWLockExclusive( &object->lock );
+        tp_object_release( object );
+    }
+    else RtlReleaseSRWLockExclusive( &object->lock );
+
+    assert( pool->num_busy_workers );
+    InterlockedDecrement( &pool->num_busy_workers );
+
+    /* Release the reference of the queue entry. */
+    tp_object_release( object );
+}
+
 /***********************************************************************
  *           threadpool_worker_proc    (internal)
  */
 static void CALLBACK threadpool_worker_proc( void *param )
 {
     struct threadpool *pool = param;
+    struct threadpool_worker worker;
+    struct threadpool_object *object;
     LARGE_INTEGER timeout;
-    struct list *ptr;
+    NTSTATUS status;
+    unsigned int i;
 
     TRACE( "starting worker thread for pool %p\n", pool );
 
+    worker.pool = pool;
+    RtlInitializeSRWLock( &worker.lock );
+    for (i = 0; i < ARRAY_SIZE(worker.queues); ++i)
+        list_init( &worker.queues[i] );
+    worker.num_queued = 0;
+
     RtlEnterCriticalSection( &pool->cs );
+    list_add_tail( &pool->workers, &worker.entry );
     for (;;)
     {
-        while ((ptr = threadpool_get_next_item( pool )))
-        {
-            struct threadpool_object *object = LIST_ENTRY( ptr, struct threadpool_object, pool_entry );
-            assert( object->num_pending_callbacks > 0 );
-
-            /* If further pending callbacks are queued, move the work item to
-             * the end of the pool list. Otherwise remove it from the pool. */
-            list_remove( &object->pool_entry );
-            if (object->num_pending_callbacks > 1)
-                tp_object_prio_queue( object );
+        RtlLeaveCriticalSection( &pool->cs );
+        while ((object = tp_worker_next_object( &worker )))
+            tp_worker_execute( &worker, object );
+        RtlEnterCriticalSection( &pool->cs );
 
-            tp_object_execute( object, FALSE );
+        /* Mark the thread as idle before checking for new tasks again, so
+         * that lock-free submissions either see it or their items are found. */
+        InterlockedIncrement( &pool->num_idle_workers );
 
-            assert(pool->num_busy_workers);
-            pool->num_busy_workers--;
+        if ((object = tp_worker_steal( &worker )) || tp_pool_has_work( pool ))
+        {
+            InterlockedDecrement( &pool->num_idle_workers );
+            if (!object) continue;
 
-            tp_object_release( object );
+            RtlLeaveCriticalSection( &pool->cs );
+            tp_worker_execute( &worker, object );
+            RtlEnterCriticalSection( &pool->cs );
+            continue;
         }
 
         /* Shutdown worker thread if requested. */
         if (pool->shutdown)
+        {
+            InterlockedDecrement( &pool->num_idle_workers );
+            InterlockedDecrement( &pool->num_workers );
             break;
+        }
 
         /* Wait for new tasks or until the timeout expires. A thread only terminates
          * when no new tasks are available, and the number of threads can be
@@ -2356,14 +2923,22 @@ static void CALLBACK threadpool_worker_proc( void *param )
          * min_workers == 0, then objcount is used to detect if the last thread
          * can be terminated. */
         timeout.QuadPart = (ULONGLONG)THREADPOOL_WORKER_TIMEOUT * -10000;
-        if (RtlSleepConditionVariableCS( &pool->update_event, &pool->cs, &timeout ) == STATUS_TIMEOUT &&
-            !threadpool_get_next_item( pool ) && (pool->num_workers > max( pool->min_workers, 1 ) ||
-            (!pool->min_workers && !pool->objcount)))
+        status = RtlSleepConditionVariableCS( &pool->update_event, &pool->cs, &timeout );
+        InterlockedDecrement( &pool->num_idle_workers );
+
+        if (status == STATUS_TIMEOUT && !tp_pool_has_work( pool ) &&
+            (pool->num_workers > max( pool->min_workers, 1 ) || (!pool->min_workers && !pool->objcount)))
         {
-            break;
+            /* Check again after the thread is no longer accounted, work items
+             * and objects can be added without holding the pool lock. */
+            InterlockedDecrement( &pool->num_workers );
+            if (!tp_pool_has_work( pool ) && (pool->num_workers >= max( pool->min_workers, 1 ) ||
+                (!pool->min_workers && !pool->objcount)))
+                break;
+            InterlockedIncrement( &pool->num_workers );
         }
     }
-    pool->num_workers--;
+    list_remove( &worker.entry );
     RtlLeaveCriticalSection( &pool->cs );
 
     TRACE( "terminating worker thread for pool %p\n", pool );
@@ -2564,7 +3139,7 @@ void WINAPI TpCancelAsyncIoOperation( TP_IO *io )
 
     TRACE( "%p\n", io );
 
-    RtlEnterCriticalSection( &this->pool->cs );
+    RtlAcquireSRWLockExclusive( &this->lock );
 
     TRACE("pending_count %u.\n", this->u.io.pending_count);
 
@@ -2574,7 +3149,7 @@ void WINAPI TpCancelAsyncIoOperation( TP_IO *io )
     if (object_is_finished( this, FALSE ))
         RtlWakeAllConditionVariable( &this->finished_event );
 
-    RtlLeaveCriticalSection( &this->pool->cs );
+    RtlReleaseSRWLockExclusive( &this->lock );
 }
 
 /***********************************************************************
@@ -2694,7 +3269,6 @@ VOID WINAPI TpDisassociateCallback( TP_CALLBACK_INSTANCE *instance )
 {
     struct threadpool_instance *this = impl_from_TP_CALLBACK_INSTANCE( instance );
     struct threadpool_object *object = this->object;
-    struct threadpool *pool;
 
     TRACE( "%p\n", instance );
 
@@ -2707,14 +3281,13 @@ VOID WINAPI TpDisassociateCallback( TP_CALLBACK_INSTANCE *instance )
     if (!this->associated)
         return;
 
-    pool = object->pool;
-    RtlEnterCriticalSection( &pool->cs );
+    RtlAcquireSRWLockExclusive( &object->lock );
 
     object->num_associated_callbacks--;
     if (object_is_finished( object, FALSE ))
         RtlWakeAllConditionVariable( &object->finished_event );
 
-    RtlLeaveCriticalSection( &pool->cs );
+    RtlReleaseSRWLockExclusive( &object->lock );
     this->associated = FALSE;
 }
 
@@ -2838,10 +3411,10 @@ void WINAPI TpReleaseIoCompletion( TP_IO *io )
 
     TRACE( "%p\n", io );
 
-    RtlEnterCriticalSection( &this->pool->cs );
+    RtlAcquireSRWLockExclusive( &this->lock );
     this->u.io.shutting_down = TRUE;
     can_destroy = !this->u.io.pending_count && !this->u.io.skipped_count;
-    RtlLeaveCriticalSection( &this->pool->cs );
+    RtlReleaseSRWLockExclusive( &this->lock );
 
     if (can_destroy)
     {
@@ -2956,7 +3529,6 @@ BOOL WINAPI TpSetPoolMinThreads( TP_POOL *pool, DWORD minimum )
 VOID WINAPI TpSetTimer( TP_TIMER *timer, LARGE_INTEGER *timeout, LONG period, LONG window_length )
 {
     struct threadpool_object *this = impl_from_TP_TIMER( timer );
-    struct threadpool_object *other_timer;
     BOOL submit_timer = FALSE;
     ULONGLONG timestamp;
 
@@ -2995,29 +3567,25 @@ VOID WINAPI TpSetTimer( TP_TIMER *timer, LARGE_INTEGER *timeout, LONG period, LO
     /* First remove existing timeout. */
     if (this->u.timer.timer_pending)
     {
-        list_remove( &this->u.timer.timer_entry );
+        timer_wheel_remove( &timerqueue.wheel, &this->u.timer.timer_entry );
         this->u.timer.timer_pending = FALSE;
     }
 
     /* If the timer was enabled, then add it back to the queue. */
     if (timeout)
     {
-        this->u.timer.timeout       = timestamp;
-        this->u.timer.period        = period;
-        this->u.timer.window_length = window_length;
+        this->u.timer.timer_entry.expire = timestamp;
+        this->u.timer.period             = period;
+        this->u.timer.window_length      = window_length;
 
-        LIST_FOR_EACH_ENTRY( other_timer, &timerqueue.pending_timers,
-                             struct threadpool_object, u.timer.timer_entry )
-        {
-            assert( other_timer->type == TP_OBJECT_TYPE_TIMER );
-            if (this->u.timer.timeout < other_timer->u.timer.timeout)
-                break;
-        }
-        list_add_before( &other_timer->u.timer.timer_entry, &this->u.timer.timer_entry );
+        timer_wheel_add( &timerqueue.wheel, &this->u.timer.timer_entry );
 
         /* Wake up the timer thread when the timeout has to be updated. */
-        if (list_head( &timerqueue.pending_timers ) == &this->u.timer.timer_entry )
+        if (timestamp < timerqueue.wakeup)
+        {
+            timerqueue.wakeup = timestamp;
             RtlWakeAllConditionVariable( &timerqueue.update_event );
+        }
 
         this->u.timer.timer_pending = TRUE;
     }
@@ -3119,11 +3687,11 @@ void WINAPI TpStartAsyncIoOperation( TP_IO *io )
 
     TRACE( "%p\n", io );
 
-    RtlEnterCriticalSection( &this->pool->cs );
+    RtlAcquireSRWLockExclusive( &this->lock );
 
     this->u.io.pending_count++;
 
-    RtlLeaveCriticalSection( &this->pool->cs );
+    RtlReleaseSRWLockExclusive( &this->lock );
 }
 
 /***********************************************************************
@@ -3315,11 +3883,11 @@ NTSTATUS WINAPI RtlDeregisterWaitEx( HANDLE handle, HANDLE event )
         object->completed_event = event;
     }
 
-    RtlEnterCriticalSection( &object->pool->cs );
+    RtlAcquireSRWLockExclusive( &object->lock );
     if (object->num_pending_callbacks + object->num_running_callbacks
         + object->num_associated_callbacks) status = STATUS_PENDING;
     else status = STATUS_SUCCESS;
-    RtlLeaveCriticalSection( &object->pool->cs );
+    RtlReleaseSRWLockExclusive( &object->lock );
 
     TpReleaseWait( (TP_WAIT *)object );
     return status;
@@ -898,19 +898,22 @@ union fd_cache_entry
     struct
     {
         int fd;
-        enum server_fd_type type : 5;
+        enum server_fd_type type : 4;
         unsigned int        access : 3;
         unsigned int        options : 24;
+        unsigned int        local_io : 1;  /* socket has a local I/O serial, see server_set_fd_local_io */
     } s;
 };
 
 C_ASSERT( sizeof(union fd_cache_entry) == sizeof(LONG64) );
+C_ASSERT( FD_TYPE_NB_TYPES <= 16 );
 
 #define FD_CACHE_BLOCK_SIZE  (65536 / sizeof(union fd_cache_entry))
 #define FD_CACHE_ENTRIES     128
 
 static union fd_cache_entry *fd_cache[FD_CACHE_ENTRIES];
 static union fd_cache_entry fd_cache_initial_block[FD_CACHE_BLOCK_SIZE];
+static LONG64 *fd_cache_local_io[FD_CACHE_ENTRIES];
 
 static inline unsigned int handle_to_index( HANDLE handle, unsigned int *entry )
 {
@@ -954,6 +957,7 @@ static BOOL add_fd_to_cache( HANDLE handle, int fd, enum server_fd_type type,
     cache.s.type = type;
     cache.s.access = access;
     cache.s.options = options;
+    cache.s.local_io = 0;
     cache.data = interlocked_xchg64( &fd_cache[entry][idx].data, cache.data );
     assert( !cache.s.fd );
     return TRUE;
@@ -1004,6 +1008,69 @@ static int remove_fd_from_cache( HANDLE handle )
 }
 
 
+/***********************************************************************
+ *           server_get_fd_local_io
+ *
+ * Retrieve the local I/O serial of a socket, see server_set_fd_local_io.
+ */
+BOOL server_get_fd_local_io( HANDLE handle, unsigned int *index, unsigned int *serial )
+{
+    unsigned int entry, idx = handle_to_index( handle, &entry );
+    union fd_cache_entry cache;
+    LONG64 local_io;
+
+    if (entry >= FD_CACHE_ENTRIES || !fd_cache[entry] || !fd_cache_local_io[entry]) return FALSE;
+
+    cache.data = InterlockedCompareExchange64( &fd_cache[entry][idx].data, 0, 0 );
+    if (!cache.data || cache.s.type != FD_TYPE_SOCKET || !cache.s.local_io) return FALSE;
+
+    local_io = InterlockedCompareExchange64( &fd_cache_local_io[entry][idx], 0, 0 );
+    if (!local_io) return FALSE;
+    *index = local_io >> 32;
+    *serial = (unsigned int)local_io;
+    return TRUE;
+}
+
+
+/***********************************************************************
+ *           server_set_fd_local_io
+ *
+ * Remember in the fd cache the local I/O serial index and serial the server
+ * returned for a socket, or forget them if index is 0. The client may complete
+ * recv and send calls by itself as long as the serial in the shared memory is
+ * unchanged. The serial goes away together with the cached fd.
+ */
+void server_set_fd_local_io( HANDLE handle, unsigned int index, unsigned int serial )
+{
+    unsigned int entry, idx = handle_to_index( handle, &entry );
+    union fd_cache_entry cache, prev;
+
+    if (entry >= FD_CACHE_ENTRIES || !fd_cache[entry]) return;
+
+    if (index)
+    {
+        if (!fd_cache_local_io[entry])  /* do we need to allocate a new block of serials? */
+        {
+            void *ptr = anon_mmap_alloc( FD_CACHE_BLOCK_SIZE * sizeof(LONG64), PROT_READ | PROT_WRITE );
+            if (ptr == MAP_FAILED) return;
+            if (InterlockedCompareExchangePointer( (void **)&fd_cache_local_io[entry], ptr, NULL ))
+                munmap( ptr, FD_CACHE_BLOCK_SIZE * sizeof(LONG64) );
+        }
+        /* store the serial before setting the flag which makes it valid */
+        interlocked_xchg64( &fd_cache_local_io[entry][idx], ((LONG64)index << 32) | serial );
+    }
+
+    do
+    {
+        prev.data = InterlockedCompareExchange64( &fd_cache[entry][idx].data, 0, 0 );
+        if (!prev.data || prev.s.type != FD_TYPE_SOCKET || prev.s.local_io == !!index) return;
+        cache.data = prev.data;
+        cache.s.local_io = !!index;
+    }
+    while (InterlockedCompareExchange64( &fd_cache[entry][idx].data, cache.data, prev.data ) != prev.data);
+}
+
+
 /***********************************************************************
  *           server_get_unix_fd
  *
@@ -567,6 +567,68 @@ static int wow64_translate_control( const WSABUF *control64, struct afd_wsabuf_3
     return 1;
 }
 
+/* Serials of the socket states in the server, see sock_complete_locally. */
+static const volatile unsigned int *local_io_serials;
+
+static const volatile unsigned int *get_local_io_serials(void)
+{
+    static const WCHAR nameW[] = {'\\','K','e','r','n','e','l','O','b','j','e','c','t','s','\\',
+        '_','_','w','i','n','e','_','t','h','r','e','a','d','_','m','a','p','p','i','n','g','s','\\',
+        's','o','c','k','e','t','s',0};
+    UNICODE_STRING name;
+    OBJECT_ATTRIBUTES attr;
+    HANDLE section;
+    SIZE_T size = 0;
+    void *ptr = NULL;
+
+    if (local_io_serials) return local_io_serials;
+
+    init_unicode_string( &name, nameW );
+    InitializeObjectAttributes( &attr, &name, 0, 0, NULL );
+    if (NtOpenSection( &section, SECTION_MAP_READ, &attr )) return NULL;
+    if (!NtMapViewOfSection( section, GetCurrentProcess(), &ptr, 0, 0, NULL, &size, ViewShare, 0, PAGE_READONLY ) &&
+        InterlockedCompareExchangePointer( (void **)&local_io_serials, ptr, NULL ))
+        NtUnmapViewOfSection( GetCurrentProcess(), ptr );
+    NtClose( section );
+    return local_io_serials;
+}
+
+/* Remember the local I/O serial the server returned for the socket handle. */
+static void set_sock_local_io( HANDLE handle, unsigned int index, unsigned int serial )
+{
+    if (index > MAX_SOCKET_LOCAL_IO_SERIALS || (index && !get_local_io_serials())) index = 0;
+    server_set_fd_local_io( handle, index, serial );
+}
+
+/* Synchronous recv and send calls on nonblocking sockets without selected events
+ * only clear events in the server, which nobody observes, and complete the async
+ * right away. Skip the server call if the server told us so before, and hasn't
+ * changed the serial of the socket since, which it does when any handle to the
+ * socket changes its state. Calls with an APC or completion still go through the
+ * server. */
+static BOOL sock_complete_locally( HANDLE handle, PIO_APC_ROUTINE apc, void *apc_user, int force_async )
+{
+    unsigned int index, serial;
+
+    if (force_async || apc || apc_user || !local_io_serials) return FALSE;
+    if (!server_get_fd_local_io( handle, &index, &serial )) return FALSE;
+    return local_io_serials[index - 1] == serial;
+}
+
+static NTSTATUS sock_local_result( HANDLE event, IO_STATUS_BLOCK *io, NTSTATUS status, ULONG_PTR information )
+{
+    if (NT_ERROR(status))
+    {
+        if (event) NtResetEvent( event, NULL );
+        return status;
+    }
+
+    io->Status = status;
+    io->Information = information;
+    if (event) NtSetEvent( event, NULL );
+    return status;
+}
+
 static NTSTATUS try_recv( int fd, struct async_recv_ioctl *async, ULONG_PTR *size )
 {
 #ifndef HAVE_STRUCT_MSGHDR_MSG_ACCRIGHTS
@@ -687,6 +749,7 @@ static NTSTATUS sock_recv( HANDLE handle, HANDLE event, PIO_APC_ROUTINE apc, voi
     NTSTATUS status;
     unsigned int i;
     ULONG options;
+    unsigned int local_io, serial;
 
     if (unix_flags & MSG_OOB)
     {
@@ -745,6 +808,12 @@ static NTSTATUS sock_recv( HANDLE handle, HANDLE event, PIO_APC_ROUTINE apc, voi
         return status;
     }
 
+    if (!(unix_flags & MSG_OOB) && sock_complete_locally( handle, apc, apc_user, force_async ))
+    {
+        release_fileio( &async->io );
+        return sock_local_result( event, io, status, information );
+    }
+
     if (status == STATUS_DEVICE_NOT_READY && force_async)
         status = STATUS_PENDING;
 
@@ -757,6 +826,8 @@ static NTSTATUS sock_recv( HANDLE handle, HANDLE event, PIO_APC_ROUTINE apc, voi
         status = wine_server_call( req );
         wait_handle = wine_server_ptr_handle( reply->wait );
         options     = reply->options;
+        local_io    = reply->local_io;
+        serial      = reply->local_io_serial;
         if ((!NT_ERROR(status) || wait_handle) && status != STATUS_PENDING)
         {
             io->Status = status;
@@ -765,6 +836,8 @@ static NTSTATUS sock_recv( HANDLE handle, HANDLE event, PIO_APC_ROUTINE apc, voi
     }
     SERVER_END_REQ;
 
+    set_sock_local_io( handle, local_io, serial );
+
     if (status != STATUS_PENDING) release_fileio( &async->io );
 
     if (wait_handle) status = wait_async( wait_handle, options & FILE_SYNCHRONOUS_IO_ALERT );
@@ -872,6 +945,7 @@ static NTSTATUS sock_send( HANDLE handle, HANDLE event, PIO_APC_ROUTINE apc, voi
     NTSTATUS status;
     unsigned int i;
     ULONG options;
+    unsigned int local_io, serial;
 
     async_size = offsetof( struct async_send_ioctl, iov[count] );
 
@@ -927,6 +1001,16 @@ static NTSTATUS sock_send( HANDLE handle, HANDLE event, PIO_APC_ROUTINE apc, voi
         return status;
     }
 
+    if (sock_complete_locally( handle, apc, apc_user, force_async ))
+    {
+        ULONG_PTR information = async->sent_len;
+
+        /* short writes on nonblocking sockets are reported as success */
+        if (status == STATUS_DEVICE_NOT_READY && information) status = STATUS_SUCCESS;
+        release_fileio( &async->io );
+        return sock_local_result( event, io, status, information );
+    }
+
     if (status == STATUS_DEVICE_NOT_READY && force_async)
         status = STATUS_PENDING;
 
@@ -938,6 +1022,8 @@ static NTSTATUS sock_send( HANDLE handle, HANDLE event, PIO_APC_ROUTINE apc, voi
         status = wine_server_call( req );
         wait_handle = wine_server_ptr_handle( reply->wait );
         options     = reply->options;
+        local_io    = reply->local_io;
+        serial      = reply->local_io_serial;
         if ((!NT_ERROR(status) || wait_handle) && status != STATUS_PENDING)
         {
             io->Status = status;
@@ -946,6 +1032,8 @@ static NTSTATUS sock_send( HANDLE handle, HANDLE event, PIO_APC_ROUTINE apc, voi
     }
     SERVER_END_REQ;
 
+    set_sock_local_io( handle, local_io, serial );
+
     if (status != STATUS_PENDING) release_fileio( &async->io );
 
     if (wait_handle) status = wait_async( wait_handle, options & FILE_SYNCHRONOUS_IO_ALERT );
@@ -467,6 +467,8 @@ SHORT WINAPI DECLSPEC_HOTPATCH GetAsyncKeyState( INT key )
  */
 DWORD WINAPI GetQueueStatus( UINT flags )
 {
+    volatile struct queue_shared_memory *shared;
+    BOOL skip = FALSE;
     DWORD ret;
 
     if (flags & ~(QS_ALLINPUT | QS_ALLPOSTMESSAGE | QS_SMRESULT))
@@ -477,6 +479,19 @@ DWORD WINAPI GetQueueStatus( UINT flags )
 
     check_for_events( flags );
 
+    /* the server only needs to be called if some changed bits must be cleared */
+    if ((shared = get_queue_shared_memory()))
+    {
+        SHARED_READ_BEGIN( &shared->seq )
+        {
+            if (!shared->created) ret = 0;
+            else ret = MAKELONG( 0, shared->wake_bits & flags );
+            skip = !shared->created || !(shared->changed_bits & flags);
+        }
+        SHARED_READ_END( &shared->seq );
+        if (skip) return ret;
+    }
+
     SERVER_START_REQ( get_queue_status )
     {
         req->clear_bits = flags;
@@ -493,10 +508,21 @@ DWORD WINAPI GetQueueStatus( UINT flags )
  */
 BOOL WINAPI GetInputState(void)
 {
+    volatile struct queue_shared_memory *shared;
     DWORD ret;
 
     check_for_events( QS_INPUT );
 
+    if ((shared = get_queue_shared_memory()))
+    {
+        SHARED_READ_BEGIN( &shared->seq )
+        {
+            ret = shared->created ? shared->wake_bits & (QS_KEY | QS_MOUSEBUTTON) : 0;
+        }
+        SHARED_READ_END( &shared->seq );
+        return ret;
+    }
+
     SERVER_START_REQ( get_queue_status )
     {
         req->clear_bits = 0;
@@ -662,10 +662,11 @@ typedef struct
  */
 UINT WINAPI DECLSPEC_HOTPATCH GetRawInputBuffer(RAWINPUT *data, UINT *data_size, UINT header_size)
 {
+    volatile struct input_shared_memory *shared;
     struct hardware_msg_data *msg_data;
     struct rawinput_thread_data *thread_data;
     RAWINPUT *rawinput;
-    UINT count = 0, remaining, rawinput_size, next_size, overhead;
+    UINT count = 0, remaining, rawinput_size, next_size, overhead, pending = ~0U, dropped = 0;
     BOOL is_wow64;
     int i;
 
@@ -688,6 +689,33 @@ UINT WINAPI DECLSPEC_HOTPATCH GetRawInputBuffer(RAWINPUT *data, UINT *data_size,
         return ~0U;
     }
 
+    /* don't call the server if there's no pending WM_INPUT message */
+    if ((shared = get_input_shared_memory()))
+    {
+        SHARED_READ_BEGIN( &shared->seq )
+        {
+            if (shared->created)
+            {
+                pending = shared->rawinput_count;
+                dropped = shared->rawinput_dropped;
+            }
+        }
+        SHARED_READ_END( &shared->seq );
+    }
+
+    if (pending != ~0U && (thread_data = rawinput_thread_data()) && thread_data->dropped != dropped)
+    {
+        if (dropped > thread_data->dropped)
+            WARN("%u rawinput messages dropped because of queue overflow\n", dropped - thread_data->dropped);
+        thread_data->dropped = dropped;
+    }
+
+    if (!pending)
+    {
+        *data_size = 0;
+        return 0;
+    }
+
     if (!data)
     {
         TRACE("data %p, data_size %p (%u), header_size %u\n", data, data_size, *data_size, header_size);
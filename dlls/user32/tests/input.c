@@ -2354,6 +2354,57 @@ static void test_GetRawInputBuffer(void)
     DestroyWindow(hwnd);
 }
 
+static void test_GetRawInputBuffer_bursts(void)
+{
+    RAWINPUTDEVICE raw_devices[1];
+    char buffer[64 * sizeof(RAWINPUT64)];
+    UINT i, size, count, sent, received, total = 2000;
+    HWND hwnd;
+    BOOL ret;
+
+    hwnd = CreateWindowA("static", "static", WS_VISIBLE | WS_POPUP,
+                         100, 100, 100, 100, 0, NULL, NULL, NULL);
+    ok(hwnd != 0, "CreateWindow failed\n");
+    empty_message_queue();
+
+    raw_devices[0].usUsagePage = 0x01;
+    raw_devices[0].usUsage = 0x02;
+    raw_devices[0].dwFlags = RIDEV_INPUTSINK;
+    raw_devices[0].hwndTarget = hwnd;
+    ret = RegisterRawInputDevices(raw_devices, ARRAY_SIZE(raw_devices), sizeof(RAWINPUTDEVICE));
+    ok(ret, "RegisterRawInputDevices failed\n");
+
+    size = sizeof(buffer);
+    count = GetRawInputBuffer((RAWINPUT *)buffer, &size, sizeof(RAWINPUTHEADER));
+    ok(count == 0, "GetRawInputBuffer returned %u\n", count);
+
+    /* inject synthetic mouse motion in bursts and drain it */
+    sent = received = 0;
+    while (sent < total)
+    {
+        for (i = 0; i < 32 && sent < total; i++, sent++) mouse_event(MOUSEEVENTF_MOVE, 1, 0, 0, 0);
+
+        for (;;)
+        {
+            size = sizeof(buffer);
+            count = GetRawInputBuffer((RAWINPUT *)buffer, &size, sizeof(RAWINPUTHEADER));
+            if (!count || count == ~0U) break;
+            received += count;
+        }
+        ok(count == 0, "GetRawInputBuffer returned %u, error %u\n", count, GetLastError());
+        if (count) break;
+    }
+    ok(received == sent, "received %u of %u rawinput messages\n", received, sent);
+
+    raw_devices[0].dwFlags = RIDEV_REMOVE;
+    raw_devices[0].hwndTarget = 0;
+    ret = RegisterRawInputDevices(raw_devices, ARRAY_SIZE(raw_devices), sizeof(RAWINPUTDEVICE));
+    ok(ret, "RegisterRawInputDevices failed\n");
+
+    DestroyWindow(hwnd);
+    empty_message_queue();
+}
+
 static BOOL rawinput_test_received_legacy;
 static BOOL rawinput_test_received_raw;
 static BOOL rawinput_test_received_rawfg;
@@ -4820,6 +4871,7 @@ START_TEST(input)
     test_OemKeyScan();
     test_GetRawInputData();
     test_GetRawInputBuffer();
+    test_GetRawInputBuffer_bursts();
     test_RegisterRawInputDevices();
     test_rawinput(argv[0]);
     test_GetKeyboardLayoutList();
@@ -12961,6 +12961,36 @@ static void test_PeekMessage3(void)
     flush_events();
 }
 
+static void test_PeekMessage_empty_queue(void)
+{
+    DWORD status;
+    BOOL ret;
+    MSG msg;
+
+    flush_events();
+
+    ret = PeekMessageA(&msg, NULL, 0, 0, PM_REMOVE);
+    ok(!ret, "got message %04x\n", msg.message);
+    status = GetQueueStatus(QS_ALLINPUT);
+    ok(!status, "got status %08x\n", status);
+    ret = GetInputState();
+    ok(!ret, "got input state %d\n", ret);
+
+    /* the changed bits must still be reported and cleared once */
+    ret = PostThreadMessageA(GetCurrentThreadId(), WM_USER, 0, 0);
+    ok(ret, "PostThreadMessage failed, error %u\n", GetLastError());
+    status = GetQueueStatus(QS_POSTMESSAGE);
+    ok(status == MAKELONG(QS_POSTMESSAGE, QS_POSTMESSAGE), "got status %08x\n", status);
+    status = GetQueueStatus(QS_POSTMESSAGE);
+    ok(status == MAKELONG(0, QS_POSTMESSAGE), "got status %08x\n", status);
+    ret = PeekMessageA(&msg, NULL, 0, 0, PM_REMOVE);
+    ok(ret && msg.message == WM_USER, "got ret %d, message %04x\n", ret, msg.message);
+    ret = PeekMessageA(&msg, NULL, 0, 0, PM_REMOVE);
+    ok(!ret, "got message %04x\n", msg.message);
+    status = GetQueueStatus(QS_POSTMESSAGE);
+    ok(!status, "got status %08x\n", status);
+}
+
 static INT_PTR CALLBACK wm_quit_dlg_proc(HWND hwnd, UINT message, WPARAM wp, LPARAM lp)
 {
     struct recvd_message msg;
@@ -18811,6 +18841,7 @@ START_TEST(msg)
     test_PeekMessage();
     test_PeekMessage2();
     test_PeekMessage3();
+    test_PeekMessage_empty_queue();
     test_WaitForInputIdle( test_argv[0] );
     test_scrollwindowex();
     test_messages();
@@ -10879,6 +10879,126 @@ todo_wine
     ok(ret, "got %d\n", ret);
 }
 
+static int defer_changing_count, defer_changed_count, defer_changed_early;
+
+static LRESULT WINAPI defer_child_proc(HWND hwnd, UINT msg, WPARAM wparam, LPARAM lparam)
+{
+    switch (msg)
+    {
+    case WM_WINDOWPOSCHANGING:
+        defer_changing_count++;
+        break;
+    case WM_WINDOWPOSCHANGED:
+        /* all the windows get WM_WINDOWPOSCHANGING before any of them is moved */
+        if (defer_changing_count < 64) defer_changed_early++;
+        defer_changed_count++;
+        break;
+    }
+    return DefWindowProcA(hwnd, msg, wparam, lparam);
+}
+
+static void test_deferwindowpos_children(HWND parent)
+{
+    int i;
+    HWND children[64];
+    WNDCLASSA cls;
+    HDWP hdwp;
+    RECT rect;
+    BOOL ret;
+
+    memset(&cls, 0, sizeof(cls));
+    cls.lpfnWndProc = defer_child_proc;
+    cls.hInstance = GetModuleHandleA(NULL);
+    cls.lpszClassName = "defer_child_class";
+    RegisterClassA(&cls);
+
+    for (i = 0; i < ARRAY_SIZE(children); i++)
+    {
+        children[i] = CreateWindowExA(0, "defer_child_class", NULL, WS_CHILD | WS_VISIBLE,
+                                      0, 0, 10, 10, parent, 0, cls.hInstance, NULL);
+        ok(children[i] != NULL, "CreateWindowEx failed, error %u\n", GetLastError());
+    }
+
+    defer_changing_count = defer_changed_count = defer_changed_early = 0;
+    hdwp = BeginDeferWindowPos(ARRAY_SIZE(children));
+    for (i = 0; i < ARRAY_SIZE(children); i++)
+    {
+        hdwp = DeferWindowPos(hdwp, children[i], NULL, i, 2 * i, 20 + i, 30, SWP_NOZORDER | SWP_NOACTIVATE);
+        ok(hdwp != NULL, "DeferWindowPos failed, error %u\n", GetLastError());
+    }
+    ret = EndDeferWindowPos(hdwp);
+    ok(ret, "EndDeferWindowPos failed, error %u\n", GetLastError());
+    ok(defer_changing_count == ARRAY_SIZE(children), "got %d WM_WINDOWPOSCHANGING\n", defer_changing_count);
+    ok(defer_changed_count == ARRAY_SIZE(children), "got %d WM_WINDOWPOSCHANGED\n", defer_changed_count);
+    ok(!defer_changed_early, "got %d WM_WINDOWPOSCHANGED before the last WM_WINDOWPOSCHANGING\n",
+       defer_changed_early);
+
+    for (i = 0; i < ARRAY_SIZE(children); i++)
+    {
+        GetWindowRect(children[i], &rect);
+        MapWindowPoints(0, parent, (POINT *)&rect, 2);
+        ok(rect.left == i && rect.top == 2 * i && rect.right == 20 + 2 * i && rect.bottom == 2 * i + 30,
+           "child %d: got %s\n", i, wine_dbgstr_rect(&rect));
+    }
+
+    for (i = 0; i < ARRAY_SIZE(children); i++) DestroyWindow(children[i]);
+    UnregisterClassA("defer_child_class", cls.hInstance);
+}
+
+static BOOL is_point_visible(HWND hwnd, HWND parent, int x, int y)
+{
+    HRGN rgn = CreateRectRgn(0, 0, 0, 0);
+    POINT pt = { x, y };
+    HDC hdc = GetDC(hwnd);
+    BOOL ret;
+
+    ok(GetRandomRgn(hdc, rgn, SYSRGN) == 1, "GetRandomRgn failed\n");
+    ClientToScreen(parent, &pt);
+    ret = PtInRegion(rgn, pt.x, pt.y);
+    ReleaseDC(hwnd, hdc);
+    DeleteObject(rgn);
+    return ret;
+}
+
+static void test_visible_region_cache(void)
+{
+    HWND container, top, bottom;
+
+    container = CreateWindowExA(0, "MainWindowClass", NULL, WS_POPUP | WS_VISIBLE | WS_CLIPCHILDREN,
+                                100, 100, 400, 400, 0, 0, GetModuleHandleA(NULL), NULL);
+    ok(container != NULL, "CreateWindowEx failed, error %u\n", GetLastError());
+
+    /* the cached region of a window must follow its siblings */
+    top = CreateWindowExA(0, "static", NULL, WS_CHILD | WS_VISIBLE | WS_CLIPSIBLINGS,
+                          0, 0, 100, 100, container, 0, GetModuleHandleA(NULL), NULL);
+    bottom = CreateWindowExA(0, "static", NULL, WS_CHILD | WS_VISIBLE | WS_CLIPSIBLINGS,
+                             50, 50, 100, 100, container, 0, GetModuleHandleA(NULL), NULL);
+    SetWindowPos(top, HWND_TOP, 0, 0, 0, 0, SWP_NOMOVE | SWP_NOSIZE | SWP_NOACTIVATE);
+
+    ok(!is_point_visible(bottom, container, 60, 60), "point should be clipped by the sibling\n");
+    ok(is_point_visible(bottom, container, 120, 120), "point should be visible\n");
+    ok(!is_point_visible(bottom, container, 60, 60), "point should still be clipped by the sibling\n");
+
+    SetWindowPos(top, 0, 200, 200, 0, 0, SWP_NOSIZE | SWP_NOZORDER | SWP_NOACTIVATE);
+    ok(is_point_visible(bottom, container, 60, 60), "point should be visible after moving the sibling\n");
+
+    ShowWindow(top, SW_HIDE);
+    SetWindowPos(top, HWND_TOP, 0, 0, 0, 0, SWP_NOSIZE | SWP_NOACTIVATE);
+    ok(is_point_visible(bottom, container, 60, 60), "point should be visible with the sibling hidden\n");
+    ShowWindow(top, SW_SHOWNA);
+    ok(!is_point_visible(bottom, container, 60, 60), "point should be clipped once the sibling is shown\n");
+
+    /* the parent client area clips its children */
+    SetWindowPos(container, 0, 0, 0, 100, 100, SWP_NOMOVE | SWP_NOZORDER | SWP_NOACTIVATE);
+    ok(!is_point_visible(bottom, container, 120, 120), "point should be clipped by the parent\n");
+    SetWindowPos(container, 0, 0, 0, 400, 400, SWP_NOMOVE | SWP_NOZORDER | SWP_NOACTIVATE);
+    ok(is_point_visible(bottom, container, 120, 120), "point should be visible again\n");
+
+    DestroyWindow(top);
+    DestroyWindow(bottom);
+    DestroyWindow(container);
+}
+
 static void test_LockWindowUpdate(HWND parent)
 {
     typedef struct
@@ -12290,7 +12410,8 @@ static void other_process_proc(HWND hwnd)
 {
     HANDLE window_ready_event, test_done_event;
     WINDOWPLACEMENT wp = {0};
-    DWORD ret;
+    DWORD ret, style, tid, pid;
+    RECT rect;
 
     window_ready_event = OpenEventA(EVENT_ALL_ACCESS, FALSE, "test_opw_window");
     ok(!!window_ready_event, "OpenEvent failed.\n");
@@ -12304,6 +12425,19 @@ static void other_process_proc(HWND hwnd)
     ok(ret, "Unexpected ret %#x.\n", ret);
     ok(wp.showCmd == SW_SHOWNORMAL, "Unexpected showCmd %#x.\n", wp.showCmd);
     ok(!wp.flags, "Unexpected flags %#x.\n", wp.flags);
+    ok(IsWindow(hwnd), "IsWindow failed.\n");
+    ok(IsWindowVisible(hwnd), "IsWindowVisible failed.\n");
+    style = GetWindowLongA(hwnd, GWL_STYLE);
+    ok(style == (WS_POPUP | WS_VISIBLE), "Unexpected style %#x.\n", style);
+    tid = GetWindowThreadProcessId(hwnd, &pid);
+    ok(tid && tid != GetCurrentThreadId(), "Unexpected tid %#x.\n", tid);
+    ok(pid && pid != GetCurrentProcessId(), "Unexpected pid %#x.\n", pid);
+    GetWindowRect(hwnd, &rect);
+    ok(rect.left == 100 && rect.top == 100 && rect.right == 200 && rect.bottom == 200,
+       "Unexpected window rect %s.\n", wine_dbgstr_rect(&rect));
+    GetClientRect(hwnd, &rect);
+    ok(rect.left == 0 && rect.top == 0 && rect.right == 100 && rect.bottom == 100,
+       "Unexpected client rect %s.\n", wine_dbgstr_rect(&rect));
     SetEvent(test_done_event);
 
     /* SW_SHOWMAXIMIZED */
@@ -12649,6 +12783,8 @@ START_TEST(win)
     test_activateapp(hwndMain);
     test_winproc_handles(argv[0]);
     test_deferwindowpos();
+    test_deferwindowpos_children(hwndMain);
+    test_visible_region_cache();
     test_LockWindowUpdate(hwndMain);
     test_desktop();
     test_display_affinity(hwndMain);
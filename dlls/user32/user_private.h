@@ -117,6 +117,7 @@ struct wm_char_mapping_data
 struct rawinput_thread_data
 {
     UINT     hw_id;     /* current rawinput message id */
+    UINT     dropped;   /* last seen count of dropped rawinput messages */
     RAWINPUT buffer[1]; /* rawinput message data buffer */
 };
 
@@ -215,6 +216,7 @@ extern volatile struct desktop_shared_memory *get_desktop_shared_memory( void )
 extern volatile struct queue_shared_memory *get_queue_shared_memory( void ) DECLSPEC_HIDDEN;
 extern volatile struct input_shared_memory *get_input_shared_memory( void ) DECLSPEC_HIDDEN;
 extern volatile struct input_shared_memory *get_foreground_shared_memory( void ) DECLSPEC_HIDDEN;
+extern volatile struct window_shared_memory *get_window_shared_memory( HWND hwnd ) DECLSPEC_HIDDEN;
 
 /* kernel callbacks */
 
@@ -960,6 +960,122 @@ ULONG WIN_SetStyle( HWND hwnd, ULONG set_bits, ULONG clear_bits )
 }
 
 
+/***********************************************************************
+ *           get_shared_window_info
+ *
+ * Read the server shared state of a window, typically one belonging to another process.
+ */
+static BOOL get_shared_window_info( HWND hwnd, struct window_shared_memory *info )
+{
+    volatile struct window_shared_memory *shared;
+    user_handle_t handle = wine_server_user_handle( hwnd );
+    BOOL ret = FALSE;
+
+    if (!(shared = get_window_shared_memory( hwnd ))) return FALSE;
+
+    SHARED_READ_BEGIN( &shared->seq )
+    {
+        /* like the server, accept handles without a generation */
+        ret = shared->handle && (shared->handle == handle || !HIWORD(handle) || HIWORD(handle) == 0xffff);
+        if (ret)
+        {
+            info->handle      = shared->handle;
+            info->parent      = shared->parent;
+            info->tid         = shared->tid;
+            info->pid         = shared->pid;
+            info->style       = shared->style;
+            info->ex_style    = shared->ex_style;
+            info->dpi         = shared->dpi;
+            info->window_rect = shared->window_rect;
+            info->client_rect = shared->client_rect;
+        }
+    }
+    SHARED_READ_END( &shared->seq );
+    return ret;
+}
+
+
+/***********************************************************************
+ *           get_shared_monitor_dpi
+ *
+ * Same as the server get_monitor_dpi, return the DPI of the desktop of a shared window.
+ */
+static UINT get_shared_monitor_dpi( const struct window_shared_memory *info )
+{
+    struct window_shared_memory parent = *info;
+
+    while (parent.parent)
+        if (!get_shared_window_info( wine_server_ptr_handle( parent.parent ), &parent )) return 0;
+    return parent.dpi ? parent.dpi : USER_DEFAULT_SCREEN_DPI;
+}
+
+
+/***********************************************************************
+ *           get_shared_rectangles
+ *
+ * Get the window and client rectangles from the server shared memory.
+ */
+static BOOL get_shared_rectangles( HWND hwnd, enum coords_relative relative, RECT *rectWindow, RECT *rectClient )
+{
+    struct window_shared_memory info, parent;
+    RECT window_rect, client_rect, rect;
+    UINT dpi_from, dpi_to, monitor_dpi;
+
+    if (!get_shared_window_info( hwnd, &info )) return FALSE;
+
+    SetRect( &window_rect, info.window_rect.left, info.window_rect.top,
+             info.window_rect.right, info.window_rect.bottom );
+    SetRect( &client_rect, info.client_rect.left, info.client_rect.top,
+             info.client_rect.right, info.client_rect.bottom );
+
+    switch (relative)
+    {
+    case COORDS_CLIENT:
+        rect = client_rect;
+        OffsetRect( &window_rect, -rect.left, -rect.top );
+        OffsetRect( &client_rect, -rect.left, -rect.top );
+        if (info.ex_style & WS_EX_LAYOUTRTL) mirror_rect( &rect, &window_rect );
+        break;
+    case COORDS_WINDOW:
+        rect = window_rect;
+        OffsetRect( &window_rect, -rect.left, -rect.top );
+        OffsetRect( &client_rect, -rect.left, -rect.top );
+        if (info.ex_style & WS_EX_LAYOUTRTL) mirror_rect( &rect, &client_rect );
+        break;
+    case COORDS_PARENT:
+        if (!info.parent) break;
+        if (!get_shared_window_info( wine_server_ptr_handle( info.parent ), &parent )) return FALSE;
+        if (parent.ex_style & WS_EX_LAYOUTRTL)
+        {
+            SetRect( &rect, parent.client_rect.left, parent.client_rect.top,
+                     parent.client_rect.right, parent.client_rect.bottom );
+            mirror_rect( &rect, &window_rect );
+            mirror_rect( &rect, &client_rect );
+        }
+        break;
+    case COORDS_SCREEN:
+        for (parent = info; parent.parent;)
+        {
+            if (!get_shared_window_info( wine_server_ptr_handle( parent.parent ), &parent )) return FALSE;
+            if (!parent.parent) break;  /* desktop window */
+            OffsetRect( &window_rect, parent.client_rect.left, parent.client_rect.top );
+            OffsetRect( &client_rect, parent.client_rect.left, parent.client_rect.top );
+        }
+        break;
+    default:
+        return FALSE;
+    }
+
+    if (!(monitor_dpi = get_shared_monitor_dpi( &info ))) return FALSE;
+    dpi_from = info.dpi ? info.dpi : monitor_dpi;
+    dpi_to = get_thread_dpi();
+    if (!dpi_to) dpi_to = monitor_dpi;
+    if (rectWindow) *rectWindow = map_dpi_rect( window_rect, dpi_from, dpi_to );
+    if (rectClient) *rectClient = map_dpi_rect( client_rect, dpi_from, dpi_to );
+    return TRUE;
+}
+
+
 /***********************************************************************
  *           WIN_GetRectangles
  *
@@ -1067,6 +1183,8 @@ BOOL WIN_GetRectangles( HWND hwnd, enum coords_relative relative, RECT *rectWind
     }
 
 other_process:
+    if (get_shared_rectangles( hwnd, relative, rectWindow, rectClient )) return TRUE;
+
     SERVER_START_REQ( get_window_rectangles )
     {
         req->handle = wine_server_user_handle( hwnd );
@@ -2495,11 +2613,16 @@ static LONG_PTR WIN_GetWindowLong( HWND hwnd, INT offset, UINT size, BOOL unicod
 
     if (wndPtr == WND_OTHER_PROCESS)
     {
+        struct window_shared_memory info;
+
         if (offset == GWLP_WNDPROC)
         {
             SetLastError( ERROR_ACCESS_DENIED );
             return 0;
         }
+        if ((offset == GWL_STYLE || offset == GWL_EXSTYLE) && get_shared_window_info( hwnd, &info ))
+            return offset == GWL_STYLE ? info.style : info.ex_style;
+
         SERVER_START_REQ( set_window_info )
         {
             req->handle = wine_server_user_handle( hwnd );
@@ -3171,6 +3294,7 @@ INT WINAPI GetWindowTextLengthW( HWND hwnd )
  */
 BOOL WINAPI IsWindow( HWND hwnd )
 {
+    struct window_shared_memory info;
     WND *ptr;
     BOOL ret;
 
@@ -3184,6 +3308,8 @@ BOOL WINAPI IsWindow( HWND hwnd )
     }
 
     /* check other processes */
+    if (get_shared_window_info( hwnd, &info )) return TRUE;
+
     SERVER_START_REQ( get_window_info )
     {
         req->handle = wine_server_user_handle( hwnd );
@@ -3199,6 +3325,7 @@ BOOL WINAPI IsWindow( HWND hwnd )
  */
 DWORD WINAPI GetWindowThreadProcessId( HWND hwnd, LPDWORD process )
 {
+    struct window_shared_memory info;
     WND *ptr;
     DWORD tid = 0;
 
@@ -3218,6 +3345,12 @@ DWORD WINAPI GetWindowThreadProcessId( HWND hwnd, LPDWORD process )
     }
 
     /* check other processes */
+    if (ptr == WND_OTHER_PROCESS && get_shared_window_info( hwnd, &info ) && info.tid)
+    {
+        if (process) *process = info.pid;
+        return info.tid;
+    }
+
     SERVER_START_REQ( get_window_info )
     {
         req->handle = wine_server_user_handle( hwnd );
@@ -3467,10 +3600,25 @@ BOOL WINAPI IsChild( HWND parent, HWND child )
  */
 BOOL WINAPI IsWindowVisible( HWND hwnd )
 {
+    struct window_shared_memory info;
     HWND *list;
     BOOL retval = TRUE;
     int i;
 
+    /* walk the parents in the server shared memory first */
+    if (get_shared_window_info( hwnd, &info ))
+    {
+        if (!(info.style & WS_VISIBLE)) return FALSE;
+        while (info.parent)
+        {
+            HWND parent = wine_server_ptr_handle( info.parent );
+            if (!get_shared_window_info( parent, &info )) break;
+            if (!info.parent) return parent == GetDesktopWindow();  /* top message window isn't visible */
+            if (!(info.style & WS_VISIBLE)) return FALSE;
+        }
+        if (!info.parent) return TRUE;
+    }
+
     if (!(GetWindowLongW( hwnd, GWL_STYLE ) & WS_VISIBLE)) return FALSE;
     if (!(list = list_window_parents( hwnd ))) return TRUE;
     if (list[0])
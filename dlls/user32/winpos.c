@@ -2167,194 +2167,414 @@ done:
 }
 
 
+/* state of a window position change between the driver, server and message stages */
+struct window_pos_update
+{
+    WINDOWPOS             *winpos;
+    UINT                   orig_flags;
+    DPI_AWARENESS_CONTEXT  context;
+    HWND                   hwnd;
+    HWND                   insert_after;
+    UINT                   swp_flags;
+    RECT                   window_rect;
+    RECT                   client_rect;
+    RECT                   valid_rects[2];
+    const RECT            *valid;
+    RECT                   visible_rect;
+    RECT                   old_visible_rect;
+    RECT                   old_window_rect;
+    RECT                   old_client_rect;
+    struct window_surface *old_surface;
+    struct window_surface *new_surface;
+    HWND                   surface_win;
+    BOOL                   needs_update;
+    BOOL                   driver_ret;
+    BOOL                   ret;
+    WND                   *win;
+};
+
+/* maximum number of windows updated with a single set_window_pos_list request */
+#define MAX_WINDOW_POS_BATCH 256
+
+
 /***********************************************************************
- *		set_window_pos
+ *		init_window_pos_update
+ */
+static void init_window_pos_update( struct window_pos_update *upd, HWND hwnd, HWND insert_after,
+                                    UINT swp_flags, const RECT *window_rect, const RECT *client_rect,
+                                    const RECT *valid_rects )
+{
+    upd->hwnd         = hwnd;
+    upd->insert_after = insert_after;
+    upd->swp_flags    = swp_flags;
+    upd->window_rect  = *window_rect;
+    upd->client_rect  = *client_rect;
+    upd->valid        = NULL;
+    upd->old_surface  = NULL;
+    upd->new_surface  = NULL;
+    upd->surface_win  = 0;
+    upd->needs_update = FALSE;
+    upd->ret          = FALSE;
+    upd->win          = NULL;
+    if (valid_rects && !IsRectEmpty( &valid_rects[0] ))
+    {
+        upd->valid_rects[0] = valid_rects[0];
+        upd->valid_rects[1] = valid_rects[1];
+        upd->valid = upd->valid_rects;
+    }
+}
+
+
+/***********************************************************************
+ *		window_pos_changing
  *
- * Backend implementation of SetWindowPos.
+ * Let the driver compute the visible rectangle and surface of the window.
  */
-BOOL set_window_pos( HWND hwnd, HWND insert_after, UINT swp_flags,
-                     const RECT *window_rect, const RECT *client_rect, const RECT *valid_rects )
+static void window_pos_changing( struct window_pos_update *upd )
 {
-    WND *win;
-    HWND surface_win = 0, parent = GetAncestor( hwnd, GA_PARENT );
-    BOOL ret, needs_update = FALSE;
-    RECT visible_rect, old_visible_rect, old_window_rect, old_client_rect, extra_rects[3];
-    struct window_surface *old_surface, *new_surface = NULL;
+    HWND parent = GetAncestor( upd->hwnd, GA_PARENT );
 
     if (!parent || parent == GetDesktopWindow())
     {
-        new_surface = &dummy_surface;  /* provide a default surface for top-level windows */
-        window_surface_add_ref( new_surface );
+        upd->new_surface = &dummy_surface;  /* provide a default surface for top-level windows */
+        window_surface_add_ref( upd->new_surface );
     }
-    visible_rect = *window_rect;
-    if (!(ret = USER_Driver->pWindowPosChanging( hwnd, insert_after, swp_flags,
-                                                 window_rect, client_rect, &visible_rect, &new_surface )))
+    upd->visible_rect = upd->window_rect;
+    if (!(upd->driver_ret = USER_Driver->pWindowPosChanging( upd->hwnd, upd->insert_after, upd->swp_flags,
+                                                             &upd->window_rect, &upd->client_rect,
+                                                             &upd->visible_rect, &upd->new_surface )))
     {
-        if (IsRectEmpty( window_rect )) visible_rect = *window_rect;
+        if (IsRectEmpty( &upd->window_rect )) upd->visible_rect = upd->window_rect;
         else
         {
-            visible_rect = get_virtual_screen_rect();
-            IntersectRect( &visible_rect, &visible_rect, window_rect );
+            upd->visible_rect = get_virtual_screen_rect();
+            IntersectRect( &upd->visible_rect, &upd->visible_rect, &upd->window_rect );
         }
     }
 
-    WIN_GetRectangles( hwnd, COORDS_SCREEN, &old_window_rect, NULL );
-    if (IsRectEmpty( &valid_rects[0] )) valid_rects = NULL;
+    WIN_GetRectangles( upd->hwnd, COORDS_SCREEN, &upd->old_window_rect, NULL );
+}
+
 
-    if (!(win = WIN_GetPtr( hwnd )) || win == WND_DESKTOP || win == WND_OTHER_PROCESS)
+/***********************************************************************
+ *		lock_window_pos
+ *
+ * Lock the window and pick its new surface. On success the window
+ * stays locked until unlock_window_pos.
+ */
+static BOOL lock_window_pos( struct window_pos_update *upd )
+{
+    WND *win;
+
+    if (!(win = WIN_GetPtr( upd->hwnd )) || win == WND_DESKTOP || win == WND_OTHER_PROCESS)
     {
-        if (new_surface) window_surface_release( new_surface );
+        if (upd->new_surface) window_surface_release( upd->new_surface );
+        upd->new_surface = NULL;
         return FALSE;
     }
 
     /* create or update window surface for top-level windows if the driver doesn't implement WindowPosChanging */
-    if (!ret && new_surface && !IsRectEmpty( &visible_rect ) &&
-        (!(GetWindowLongW( hwnd, GWL_EXSTYLE ) & WS_EX_LAYERED) ||
-           NtUserGetLayeredWindowAttributes( hwnd, NULL, NULL, NULL )))
+    if (!upd->driver_ret && upd->new_surface && !IsRectEmpty( &upd->visible_rect ) &&
+        (!(GetWindowLongW( upd->hwnd, GWL_EXSTYLE ) & WS_EX_LAYERED) ||
+           NtUserGetLayeredWindowAttributes( upd->hwnd, NULL, NULL, NULL )))
     {
-        window_surface_release( new_surface );
-        if ((new_surface = win->surface)) window_surface_add_ref( new_surface );
-        create_offscreen_window_surface( &visible_rect, &new_surface );
+        window_surface_release( upd->new_surface );
+        if ((upd->new_surface = win->surface)) window_surface_add_ref( upd->new_surface );
+        create_offscreen_window_surface( &upd->visible_rect, &upd->new_surface );
     }
 
-    old_visible_rect = win->visible_rect;
-    old_client_rect = win->client_rect;
-    old_surface = win->surface;
-    if (old_surface != new_surface) swp_flags |= SWP_FRAMECHANGED;  /* force refreshing non-client area */
-    if (new_surface == &dummy_surface) swp_flags |= SWP_NOREDRAW;
-    else if (old_surface == &dummy_surface)
+    upd->old_visible_rect = win->visible_rect;
+    upd->old_client_rect = win->client_rect;
+    upd->old_surface = win->surface;
+    if (upd->old_surface != upd->new_surface) upd->swp_flags |= SWP_FRAMECHANGED;  /* force refreshing non-client area */
+    if (upd->new_surface == &dummy_surface) upd->swp_flags |= SWP_NOREDRAW;
+    else if (upd->old_surface == &dummy_surface)
     {
-        swp_flags |= SWP_NOCOPYBITS;
-        valid_rects = NULL;
+        upd->swp_flags |= SWP_NOCOPYBITS;
+        upd->valid = NULL;
     }
+    upd->win = win;
+    return TRUE;
+}
 
-    SERVER_START_REQ( set_window_pos )
+
+/***********************************************************************
+ *		fill_window_pos
+ *
+ * Fill the server request data for a locked window.
+ */
+static void fill_window_pos( const struct window_pos_update *upd, window_pos_t *pos )
+{
+    memset( pos, 0, sizeof(*pos) );
+    pos->handle        = wine_server_user_handle( upd->hwnd );
+    pos->previous      = wine_server_user_handle( upd->insert_after );
+    pos->swp_flags     = upd->swp_flags;
+    pos->window.left   = upd->window_rect.left;
+    pos->window.top    = upd->window_rect.top;
+    pos->window.right  = upd->window_rect.right;
+    pos->window.bottom = upd->window_rect.bottom;
+    pos->client.left   = upd->client_rect.left;
+    pos->client.top    = upd->client_rect.top;
+    pos->client.right  = upd->client_rect.right;
+    pos->client.bottom = upd->client_rect.bottom;
+    if (!EqualRect( &upd->window_rect, &upd->visible_rect ) || upd->new_surface || upd->valid)
+    {
+        RECT extra_rects[3];
+
+        extra_rects[0] = extra_rects[1] = upd->visible_rect;
+        if (upd->new_surface)
+        {
+            extra_rects[1] = upd->new_surface->rect;
+            OffsetRect( &extra_rects[1], upd->visible_rect.left, upd->visible_rect.top );
+        }
+        if (upd->valid) extra_rects[2] = upd->valid[0];
+        else SetRectEmpty( &extra_rects[2] );
+        memcpy( pos->extra, extra_rects, sizeof(extra_rects) );
+        pos->rect_count = ARRAY_SIZE(extra_rects);
+    }
+    if (upd->new_surface) pos->paint_flags |= SET_WINPOS_PAINT_SURFACE;
+    if (upd->win->pixel_format) pos->paint_flags |= SET_WINPOS_PIXEL_FORMAT;
+}
+
+
+/***********************************************************************
+ *		update_window_pos
+ *
+ * Store the new position in a locked window once the server accepted it.
+ */
+static void update_window_pos( struct window_pos_update *upd, const window_pos_result_t *result )
+{
+    WND *win = upd->win;
+
+    win->dwStyle      = result->new_style;
+    win->dwExStyle    = result->new_ex_style;
+    win->window_rect  = upd->window_rect;
+    win->client_rect  = upd->client_rect;
+    win->visible_rect = upd->visible_rect;
+    win->surface      = upd->new_surface;
+    upd->surface_win  = wine_server_ptr_handle( result->surface_win );
+    upd->needs_update = result->needs_update;
+    if (GetWindowLongW( win->parent, GWL_EXSTYLE ) & WS_EX_LAYOUTRTL)
     {
-        req->handle        = wine_server_user_handle( hwnd );
-        req->previous      = wine_server_user_handle( insert_after );
-        req->swp_flags     = swp_flags;
-        req->window.left   = window_rect->left;
-        req->window.top    = window_rect->top;
-        req->window.right  = window_rect->right;
-        req->window.bottom = window_rect->bottom;
-        req->client.left   = client_rect->left;
-        req->client.top    = client_rect->top;
-        req->client.right  = client_rect->right;
-        req->client.bottom = client_rect->bottom;
-        if (!EqualRect( window_rect, &visible_rect ) || new_surface || valid_rects)
-        {
-            extra_rects[0] = extra_rects[1] = visible_rect;
-            if (new_surface)
-            {
-                extra_rects[1] = new_surface->rect;
-                OffsetRect( &extra_rects[1], visible_rect.left, visible_rect.top );
-            }
-            if (valid_rects) extra_rects[2] = valid_rects[0];
-            else SetRectEmpty( &extra_rects[2] );
-            wine_server_add_data( req, extra_rects, sizeof(extra_rects) );
-        }
-        if (new_surface) req->paint_flags |= SET_WINPOS_PAINT_SURFACE;
-        if (win->pixel_format) req->paint_flags |= SET_WINPOS_PIXEL_FORMAT;
-
-        if ((ret = !wine_server_call( req )))
-        {
-            win->dwStyle    = reply->new_style;
-            win->dwExStyle  = reply->new_ex_style;
-            win->window_rect  = *window_rect;
-            win->client_rect  = *client_rect;
-            win->visible_rect = visible_rect;
-            win->surface      = new_surface;
-            surface_win       = wine_server_ptr_handle( reply->surface_win );
-            needs_update      = reply->needs_update;
-            if (GetWindowLongW( win->parent, GWL_EXSTYLE ) & WS_EX_LAYOUTRTL)
-            {
-                RECT client;
-                GetClientRect( win->parent, &client );
-                mirror_rect( &client, &win->window_rect );
-                mirror_rect( &client, &win->client_rect );
-                mirror_rect( &client, &win->visible_rect );
-            }
-            /* if an RTL window is resized the children have moved */
-            if (win->dwExStyle & WS_EX_LAYOUTRTL &&
-                client_rect->right - client_rect->left != old_client_rect.right - old_client_rect.left)
-                win->flags |= WIN_CHILDREN_MOVED;
-        }
-    }
-    SERVER_END_REQ;
+        RECT client;
+        GetClientRect( win->parent, &client );
+        mirror_rect( &client, &win->window_rect );
+        mirror_rect( &client, &win->client_rect );
+        mirror_rect( &client, &win->visible_rect );
+    }
+    /* if an RTL window is resized the children have moved */
+    if (win->dwExStyle & WS_EX_LAYOUTRTL &&
+        upd->client_rect.right - upd->client_rect.left != upd->old_client_rect.right - upd->old_client_rect.left)
+        win->flags |= WIN_CHILDREN_MOVED;
+    upd->ret = TRUE;
+}
 
-    if (ret)
+
+/***********************************************************************
+ *		unlock_window_pos
+ */
+static void unlock_window_pos( struct window_pos_update *upd )
+{
+    if (upd->ret)
     {
-        if (needs_update) update_surface_region( surface_win );
+        UINT swp_flags = upd->swp_flags;
+
+        if (upd->needs_update) update_surface_region( upd->surface_win );
         if (((swp_flags & SWP_AGG_NOPOSCHANGE) != SWP_AGG_NOPOSCHANGE) ||
             (swp_flags & (SWP_HIDEWINDOW | SWP_SHOWWINDOW | SWP_STATECHANGED | SWP_FRAMECHANGED)))
-            invalidate_dce( win, &old_window_rect );
+            invalidate_dce( upd->win, &upd->old_window_rect );
     }
 
-    WIN_ReleasePtr( win );
+    WIN_ReleasePtr( upd->win );
+    upd->win = NULL;
+}
 
-    if (ret)
+
+/***********************************************************************
+ *		window_pos_changed
+ *
+ * Move the window bits and notify the driver once the window is unlocked.
+ */
+static void window_pos_changed( struct window_pos_update *upd )
+{
+    const RECT *valid_rects = upd->valid;
+    const RECT *window_rect = &upd->window_rect, *client_rect = &upd->client_rect;
+    const RECT *visible_rect = &upd->visible_rect, *old_visible_rect = &upd->old_visible_rect;
+    const RECT *old_client_rect = &upd->old_client_rect;
+    struct window_surface *old_surface = upd->old_surface, *new_surface = upd->new_surface;
+    HWND hwnd = upd->hwnd, surface_win = upd->surface_win;
+
+    if (!upd->ret)
     {
-        TRACE( "win %p surface %p -> %p\n", hwnd, old_surface, new_surface );
-        register_window_surface( old_surface, new_surface );
-        if (old_surface)
+        if (new_surface) window_surface_release( new_surface );
+        return;
+    }
+
+    TRACE( "win %p surface %p -> %p\n", hwnd, old_surface, new_surface );
+    register_window_surface( old_surface, new_surface );
+    if (old_surface)
+    {
+        if (valid_rects)
         {
-            if (valid_rects)
-            {
-                move_window_bits( hwnd, old_surface, new_surface, &visible_rect,
-                                  &old_visible_rect, window_rect, valid_rects );
-                valid_rects = NULL;  /* prevent the driver from trying to also move the bits */
-            }
-            window_surface_release( old_surface );
+            move_window_bits( hwnd, old_surface, new_surface, visible_rect,
+                              old_visible_rect, window_rect, valid_rects );
+            valid_rects = NULL;  /* prevent the driver from trying to also move the bits */
         }
-        else if (surface_win && surface_win != hwnd)
+        window_surface_release( old_surface );
+    }
+    else if (surface_win && surface_win != hwnd)
+    {
+        if (valid_rects)
         {
-            if (valid_rects)
+            RECT rects[2];
+            int x_offset = old_visible_rect->left - visible_rect->left;
+            int y_offset = old_visible_rect->top - visible_rect->top;
+
+            /* if all that happened is that the whole window moved, copy everything */
+            if (!(upd->swp_flags & SWP_FRAMECHANGED) &&
+                old_visible_rect->right - visible_rect->right  == x_offset &&
+                old_visible_rect->bottom - visible_rect->bottom == y_offset &&
+                old_client_rect->left   - client_rect->left   == x_offset &&
+                old_client_rect->right  - client_rect->right  == x_offset &&
+                old_client_rect->top    - client_rect->top    == y_offset &&
+                old_client_rect->bottom - client_rect->bottom == y_offset &&
+                EqualRect( &valid_rects[0], client_rect ))
             {
-                RECT rects[2];
-                int x_offset = old_visible_rect.left - visible_rect.left;
-                int y_offset = old_visible_rect.top - visible_rect.top;
-
-                /* if all that happened is that the whole window moved, copy everything */
-                if (!(swp_flags & SWP_FRAMECHANGED) &&
-                    old_visible_rect.right  - visible_rect.right  == x_offset &&
-                    old_visible_rect.bottom - visible_rect.bottom == y_offset &&
-                    old_client_rect.left    - client_rect->left   == x_offset &&
-                    old_client_rect.right   - client_rect->right  == x_offset &&
-                    old_client_rect.top     - client_rect->top    == y_offset &&
-                    old_client_rect.bottom  - client_rect->bottom == y_offset &&
-                    EqualRect( &valid_rects[0], client_rect ))
-                {
-                    rects[0] = visible_rect;
-                    rects[1] = old_visible_rect;
-                    valid_rects = rects;
-                }
-                move_window_bits_parent( hwnd, surface_win, window_rect, valid_rects );
-                valid_rects = NULL;  /* prevent the driver from trying to also move the bits */
+                rects[0] = *visible_rect;
+                rects[1] = *old_visible_rect;
+                valid_rects = rects;
             }
+            move_window_bits_parent( hwnd, surface_win, window_rect, valid_rects );
+            valid_rects = NULL;  /* prevent the driver from trying to also move the bits */
         }
+    }
+
+    USER_Driver->pWindowPosChanged( hwnd, upd->insert_after, upd->swp_flags, window_rect,
+                                    client_rect, visible_rect, valid_rects, new_surface );
+}
+
+
+/***********************************************************************
+ *		set_window_pos
+ *
+ * Backend implementation of SetWindowPos.
+ */
+BOOL set_window_pos( HWND hwnd, HWND insert_after, UINT swp_flags,
+                     const RECT *window_rect, const RECT *client_rect, const RECT *valid_rects )
+{
+    struct window_pos_update upd;
+    window_pos_result_t result;
+    window_pos_t pos;
 
-        USER_Driver->pWindowPosChanged( hwnd, insert_after, swp_flags, window_rect,
-                                        client_rect, &visible_rect, valid_rects, new_surface );
+    init_window_pos_update( &upd, hwnd, insert_after, swp_flags, window_rect, client_rect, valid_rects );
+    window_pos_changing( &upd );
+    if (!lock_window_pos( &upd )) return FALSE;
+
+    fill_window_pos( &upd, &pos );
+    SERVER_START_REQ( set_window_pos )
+    {
+        req->handle      = pos.handle;
+        req->previous    = pos.previous;
+        req->swp_flags   = pos.swp_flags;
+        req->paint_flags = pos.paint_flags;
+        req->window      = pos.window;
+        req->client      = pos.client;
+        if (pos.rect_count) wine_server_add_data( req, pos.extra, pos.rect_count * sizeof(pos.extra[0]) );
+        if (!wine_server_call( req ))
+        {
+            result.new_style    = reply->new_style;
+            result.new_ex_style = reply->new_ex_style;
+            result.surface_win  = reply->surface_win;
+            result.needs_update = reply->needs_update;
+            update_window_pos( &upd, &result );
+        }
     }
-    else if (new_surface) window_surface_release( new_surface );
+    SERVER_END_REQ;
 
-    return ret;
+    unlock_window_pos( &upd );
+    window_pos_changed( &upd );
+    return upd.ret;
 }
 
 
 /***********************************************************************
- *		USER_SetWindowPos
+ *		set_window_pos_list
  *
- *     User32 internal function
+ * Backend implementation of EndDeferWindowPos: apply the new positions
+ * of several windows of the current thread with a single server call.
+ * The entries must have gone through begin_window_pos.
  */
-BOOL USER_SetWindowPos( WINDOWPOS * winpos, int parent_x, int parent_y )
+static void set_window_pos_list( struct window_pos_update *upd, UINT count )
+{
+    window_pos_result_t *results = NULL;
+    window_pos_t *pos = NULL;
+    DPI_AWARENESS_CONTEXT context;
+    UINT i, locked = 0;
+    NTSTATUS status = STATUS_NO_MEMORY;
+
+    for (i = 0; i < count; i++)
+    {
+        context = SetThreadDpiAwarenessContext( upd[i].context );
+        window_pos_changing( &upd[i] );
+        SetThreadDpiAwarenessContext( context );
+    }
+
+    if ((pos = HeapAlloc( GetProcessHeap(), 0, count * sizeof(*pos) )) &&
+        (results = HeapAlloc( GetProcessHeap(), 0, count * sizeof(*results) )))
+    {
+        for (i = 0; i < count; i++)
+            if (lock_window_pos( &upd[i] )) fill_window_pos( &upd[i], &pos[locked++] );
+
+        SERVER_START_REQ( set_window_pos_list )
+        {
+            wine_server_add_data( req, pos, locked * sizeof(*pos) );
+            wine_server_set_reply( req, results, locked * sizeof(*results) );
+            status = wine_server_call( req );
+        }
+        SERVER_END_REQ;
+
+        for (i = locked = 0; i < count; i++)
+        {
+            if (!upd[i].win) continue;
+            if (!status && !results[locked].status) update_window_pos( &upd[i], &results[locked] );
+            locked++;
+        }
+        for (i = 0; i < count; i++) if (upd[i].win) unlock_window_pos( &upd[i] );
+    }
+    else for (i = 0; i < count; i++)
+    {
+        if (upd[i].new_surface) window_surface_release( upd[i].new_surface );
+        upd[i].new_surface = NULL;
+    }
+
+    for (i = 0; i < count; i++)
+    {
+        context = SetThreadDpiAwarenessContext( upd[i].context );
+        window_pos_changed( &upd[i] );
+        SetThreadDpiAwarenessContext( context );
+    }
+
+    HeapFree( GetProcessHeap(), 0, results );
+    HeapFree( GetProcessHeap(), 0, pos );
+}
+
+
+/***********************************************************************
+ *		begin_window_pos
+ *
+ * First stage of USER_SetWindowPos: validate the arguments, send
+ * WM_WINDOWPOSCHANGING and WM_NCCALCSIZE and compute the new rectangles.
+ * Returns FALSE if there is nothing to change, with the result in upd->ret.
+ */
+static BOOL begin_window_pos( WINDOWPOS *winpos, int parent_x, int parent_y, struct window_pos_update *upd )
 {
     RECT old_window_rect, old_client_rect, new_window_rect, new_client_rect, valid_rects[2];
-    UINT orig_flags;
-    BOOL ret = FALSE;
     DPI_AWARENESS_CONTEXT context;
+    BOOL ret = FALSE;
 
-    orig_flags = winpos->flags;
+    upd->ret = FALSE;
+    upd->winpos = winpos;
+    upd->orig_flags = winpos->flags;
 
     /* First, check z-order arguments.  */
     if (!(winpos->flags & SWP_NOZORDER))
@@ -2373,7 +2593,11 @@ BOOL USER_SetWindowPos( WINDOWPOS * winpos, int parent_x, int parent_y )
 
             /* hwndInsertAfter must be a sibling of the window */
             if (!insertafter_parent) return FALSE;
-            if (insertafter_parent != parent) return TRUE;
+            if (insertafter_parent != parent)
+            {
+                upd->ret = TRUE;
+                return FALSE;
+            }
         }
     }
 
@@ -2393,7 +2617,8 @@ BOOL USER_SetWindowPos( WINDOWPOS * winpos, int parent_x, int parent_y )
         else if (winpos->cy > 32767) winpos->cy = 32767;
     }
 
-    context = SetThreadDpiAwarenessContext( GetWindowDpiAwarenessContext( winpos->hwnd ));
+    upd->context = GetWindowDpiAwarenessContext( winpos->hwnd );
+    context = SetThreadDpiAwarenessContext( upd->context );
 
     if (!SWP_DoWinPosChanging( winpos, &old_window_rect, &old_client_rect,
                                &new_window_rect, &new_client_rect )) goto done;
@@ -2412,10 +2637,26 @@ BOOL USER_SetWindowPos( WINDOWPOS * winpos, int parent_x, int parent_y )
     SWP_DoNCCalcSize( winpos, &old_window_rect, &old_client_rect,
                       &new_window_rect, &new_client_rect, valid_rects, parent_x, parent_y );
 
-    if (!set_window_pos( winpos->hwnd, winpos->hwndInsertAfter, winpos->flags,
-                         &new_window_rect, &new_client_rect, valid_rects ))
-        goto done;
+    init_window_pos_update( upd, winpos->hwnd, winpos->hwndInsertAfter, winpos->flags,
+                            &new_window_rect, &new_client_rect, valid_rects );
+    ret = TRUE;
+done:
+    SetThreadDpiAwarenessContext( context );
+    return ret;
+}
+
 
+/***********************************************************************
+ *		end_window_pos
+ *
+ * Last stage of USER_SetWindowPos, once the server has the new position:
+ * update the caret and activation, erase and send WM_WINDOWPOSCHANGED.
+ */
+static void end_window_pos( struct window_pos_update *upd )
+{
+    WINDOWPOS *winpos = upd->winpos;
+    UINT orig_flags = upd->orig_flags;
+    DPI_AWARENESS_CONTEXT context = SetThreadDpiAwarenessContext( upd->context );
 
     if( winpos->flags & SWP_HIDEWINDOW )
         HideCaret(winpos->hwnd);
@@ -2461,18 +2702,40 @@ BOOL USER_SetWindowPos( WINDOWPOS * winpos, int parent_x, int parent_y )
         /* WM_WINDOWPOSCHANGED is sent even if SWP_NOSENDCHANGING is set
            and always contains final window position.
          */
-        winpos->x  = new_window_rect.left;
-        winpos->y  = new_window_rect.top;
-        winpos->cx = new_window_rect.right - new_window_rect.left;
-        winpos->cy = new_window_rect.bottom - new_window_rect.top;
+        winpos->x  = upd->window_rect.left;
+        winpos->y  = upd->window_rect.top;
+        winpos->cx = upd->window_rect.right - upd->window_rect.left;
+        winpos->cy = upd->window_rect.bottom - upd->window_rect.top;
         SendMessageW( winpos->hwnd, WM_WINDOWPOSCHANGED, 0, (LPARAM)winpos );
     }
-    ret = TRUE;
-done:
     SetThreadDpiAwarenessContext( context );
-    return ret;
 }
 
+
+/***********************************************************************
+ *		USER_SetWindowPos
+ *
+ *     User32 internal function
+ */
+BOOL USER_SetWindowPos( WINDOWPOS * winpos, int parent_x, int parent_y )
+{
+    struct window_pos_update upd;
+    DPI_AWARENESS_CONTEXT context;
+    BOOL ret;
+
+    if (!begin_window_pos( winpos, parent_x, parent_y, &upd )) return upd.ret;
+
+    context = SetThreadDpiAwarenessContext( upd.context );
+    ret = set_window_pos( upd.hwnd, upd.insert_after, upd.swp_flags,
+                          &upd.window_rect, &upd.client_rect, upd.valid );
+    SetThreadDpiAwarenessContext( context );
+    if (!ret) return FALSE;
+
+    end_window_pos( &upd );
+    return TRUE;
+}
+
+
 /***********************************************************************
  *		SetWindowPos (USER32.@)
  */
@@ -2631,14 +2894,33 @@ END:
 }
 
 
+/***********************************************************************
+ *		end_deferred_window_pos
+ *
+ * Apply a batch of deferred window positions of the current thread. Like
+ * on Windows, WM_WINDOWPOSCHANGING has been sent to all the windows before
+ * any of them is moved, and WM_WINDOWPOSCHANGED is sent once all of them
+ * have been moved.
+ */
+static void end_deferred_window_pos( struct window_pos_update *upd, UINT count )
+{
+    UINT i;
+
+    if (!count) return;
+    set_window_pos_list( upd, count );
+    for (i = 0; i < count; i++) if (upd[i].ret) end_window_pos( &upd[i] );
+}
+
+
 /***********************************************************************
  *		EndDeferWindowPos (USER32.@)
  */
 BOOL WINAPI EndDeferWindowPos( HDWP hdwp )
 {
+    struct window_pos_update *upd;
     DWP *pDWP;
     WINDOWPOS *winpos;
-    int i;
+    int i, count = 0;
 
     TRACE("%p\n", hdwp);
 
@@ -2649,17 +2931,36 @@ BOOL WINAPI EndDeferWindowPos( HDWP hdwp )
         return FALSE;
     }
 
+    upd = HeapAlloc( GetProcessHeap(), 0, min( pDWP->actualCount, MAX_WINDOW_POS_BATCH ) * sizeof(*upd) );
+
     for (i = 0, winpos = pDWP->winPos; i < pDWP->actualCount; i++, winpos++)
     {
         TRACE("hwnd %p, after %p, %d,%d (%dx%d), flags %08x\n",
                winpos->hwnd, winpos->hwndInsertAfter, winpos->x, winpos->y,
                winpos->cx, winpos->cy, winpos->flags);
 
-        if (WIN_IsCurrentThread( winpos->hwnd ))
+        if (!WIN_IsCurrentThread( winpos->hwnd ))
+        {
+            /* keep the requested order relative to windows of other threads */
+            end_deferred_window_pos( upd, count );
+            count = 0;
+            SendMessageW( winpos->hwnd, WM_WINE_SETWINDOWPOS, 0, (LPARAM)winpos );
+        }
+        else if (!upd)
             USER_SetWindowPos( winpos, 0, 0 );
         else
-            SendMessageW( winpos->hwnd, WM_WINE_SETWINDOWPOS, 0, (LPARAM)winpos );
+        {
+            if (begin_window_pos( winpos, 0, 0, &upd[count] )) count++;
+            if (count == MAX_WINDOW_POS_BATCH)
+            {
+                end_deferred_window_pos( upd, count );
+                count = 0;
+            }
+        }
     }
+    end_deferred_window_pos( upd, count );
+
+    HeapFree( GetProcessHeap(), 0, upd );
     HeapFree( GetProcessHeap(), 0, pDWP->winPos );
     HeapFree( GetProcessHeap(), 0, pDWP );
     return TRUE;
@@ -226,6 +226,29 @@ volatile struct input_shared_memory *get_foreground_shared_memory( void )
 }
 
 
+volatile struct window_shared_memory *get_window_shared_memory( HWND hwnd )
+{
+    static struct window_shared_memory *window_shared;
+    WORD index = LOWORD(hwnd);
+    struct window_shared_memory *ptr;
+    HANDLE handle;
+
+    if (index < FIRST_USER_HANDLE || index > LAST_USER_HANDLE) return NULL;
+
+    if (!window_shared)
+    {
+        map_shared_memory_section( L"\\KernelObjects\\__wine_thread_mappings\\windows",
+                                   MAX_WINDOW_SHARED_ENTRIES * sizeof(*window_shared), NULL,
+                                   &handle, (void **)&ptr );
+        if (!ptr) return NULL;
+        CloseHandle( handle );
+        if (InterlockedCompareExchangePointer( (void **)&window_shared, ptr, NULL ))
+            UnmapViewOfFile( ptr );
+    }
+    return &window_shared[(index - FIRST_USER_HANDLE) >> 1];
+}
+
+
 /***********************************************************************
  *              CreateWindowStationA  (USER32.@)
  */
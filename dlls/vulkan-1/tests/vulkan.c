@@ -877,6 +877,185 @@ static void test_external_memory(VkInstance vk_instance, VkPhysicalDevice vk_phy
     vkDestroyDevice(vk_device, NULL);
 }
 
+static const char *test_debug_utils_extensions[] =
+{
+    "VK_EXT_debug_utils",
+};
+
+struct debug_utils_data
+{
+    const VkCommandBuffer *cmd_buffers;
+    unsigned int first;
+    unsigned int count;
+    unsigned int calls;
+    unsigned int mismatches;
+};
+
+static VkBool32 VKAPI_PTR debug_utils_callback(VkDebugUtilsMessageSeverityFlagBitsEXT severity,
+        VkDebugUtilsMessageTypeFlagsEXT message_types, const VkDebugUtilsMessengerCallbackDataEXT *data,
+        void *user_data)
+{
+    struct debug_utils_data *test = user_data;
+    unsigned int i;
+
+    test->calls++;
+    if (data->objectCount != test->count)
+    {
+        test->mismatches++;
+        return VK_FALSE;
+    }
+    for (i = 0; i < data->objectCount; i++)
+    {
+        if (data->pObjects[i].objectHandle != (uint64_t)(uintptr_t)test->cmd_buffers[test->first + i])
+            test->mismatches++;
+    }
+    return VK_FALSE;
+}
+
+static void test_debug_utils_handle_mapping(VkInstance vk_instance, VkPhysicalDevice vk_physical_device)
+{
+    PFN_vkCreateDebugUtilsMessengerEXT pfn_vkCreateDebugUtilsMessengerEXT;
+    PFN_vkDestroyDebugUtilsMessengerEXT pfn_vkDestroyDebugUtilsMessengerEXT;
+    PFN_vkSubmitDebugUtilsMessageEXT pfn_vkSubmitDebugUtilsMessageEXT;
+    unsigned int i, count = 1024, batch = 16;
+    VkDebugUtilsMessengerCreateInfoEXT messenger_info;
+    VkDebugUtilsMessengerCallbackDataEXT callback_data;
+    VkDebugUtilsObjectNameInfoEXT objects[16];
+    VkCommandBufferAllocateInfo allocate_info;
+    VkDebugUtilsMessengerEXT vk_messenger;
+    VkCommandPoolCreateInfo pool_info;
+    struct debug_utils_data test;
+    uint32_t queue_family_index;
+    VkCommandBuffer *cmd_buffers;
+    VkCommandPool vk_cmd_pool;
+    VkDevice vk_device;
+    VkResult vr;
+
+    pfn_vkCreateDebugUtilsMessengerEXT = (void *)vkGetInstanceProcAddr(vk_instance, "vkCreateDebugUtilsMessengerEXT");
+    pfn_vkDestroyDebugUtilsMessengerEXT = (void *)vkGetInstanceProcAddr(vk_instance, "vkDestroyDebugUtilsMessengerEXT");
+    pfn_vkSubmitDebugUtilsMessageEXT = (void *)vkGetInstanceProcAddr(vk_instance, "vkSubmitDebugUtilsMessageEXT");
+    ok(pfn_vkCreateDebugUtilsMessengerEXT && pfn_vkDestroyDebugUtilsMessengerEXT && pfn_vkSubmitDebugUtilsMessageEXT,
+            "Failed to get debug utils functions.\n");
+
+    if ((vr = create_device(vk_physical_device, 0, NULL, NULL, &vk_device)) < 0)
+    {
+        skip("Failed to create device, vr %d.\n", vr);
+        return;
+    }
+
+    find_queue_family(vk_physical_device, VK_QUEUE_GRAPHICS_BIT, &queue_family_index);
+    pool_info.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+    pool_info.pNext = NULL;
+    pool_info.flags = 0;
+    pool_info.queueFamilyIndex = queue_family_index;
+    vr = vkCreateCommandPool(vk_device, &pool_info, NULL, &vk_cmd_pool);
+    ok(vr == VK_SUCCESS, "Got unexpected VkResult %d.\n", vr);
+
+    memset(&test, 0, sizeof(test));
+    messenger_info.sType = VK_STRUCTURE_TYPE_DEBUG_UTILS_MESSENGER_CREATE_INFO_EXT;
+    messenger_info.pNext = NULL;
+    messenger_info.flags = 0;
+    messenger_info.messageSeverity = VK_DEBUG_UTILS_MESSAGE_SEVERITY_INFO_BIT_EXT;
+    messenger_info.messageType = VK_DEBUG_UTILS_MESSAGE_TYPE_GENERAL_BIT_EXT;
+    messenger_info.pfnUserCallback = debug_utils_callback;
+    messenger_info.pUserData = &test;
+    vr = pfn_vkCreateDebugUtilsMessengerEXT(vk_instance, &messenger_info, NULL, &vk_messenger);
+    ok(vr == VK_SUCCESS, "Got unexpected VkResult %d.\n", vr);
+
+    /* every command buffer is a wrapped handle with a native handle mapping */
+    cmd_buffers = heap_calloc(count, sizeof(*cmd_buffers));
+    allocate_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+    allocate_info.pNext = NULL;
+    allocate_info.commandPool = vk_cmd_pool;
+    allocate_info.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+    allocate_info.commandBufferCount = count;
+    vr = vkAllocateCommandBuffers(vk_device, &allocate_info, cmd_buffers);
+    ok(vr == VK_SUCCESS, "Got unexpected VkResult %d.\n", vr);
+
+    memset(&callback_data, 0, sizeof(callback_data));
+    callback_data.sType = VK_STRUCTURE_TYPE_DEBUG_UTILS_MESSENGER_CALLBACK_DATA_EXT;
+    callback_data.pMessage = "test";
+    callback_data.objectCount = batch;
+    callback_data.pObjects = objects;
+    test.cmd_buffers = cmd_buffers;
+    test.count = batch;
+
+    /* resolve all the handles back to their wrappers from the callbacks */
+    for (test.first = 0; test.first + batch <= count; test.first += batch)
+    {
+        for (i = 0; i < batch; i++)
+        {
+            objects[i].sType = VK_STRUCTURE_TYPE_DEBUG_UTILS_OBJECT_NAME_INFO_EXT;
+            objects[i].pNext = NULL;
+            objects[i].objectType = VK_OBJECT_TYPE_COMMAND_BUFFER;
+            objects[i].objectHandle = (uint64_t)(uintptr_t)cmd_buffers[test.first + i];
+            objects[i].pObjectName = NULL;
+        }
+        pfn_vkSubmitDebugUtilsMessageEXT(vk_instance, VK_DEBUG_UTILS_MESSAGE_SEVERITY_INFO_BIT_EXT,
+                VK_DEBUG_UTILS_MESSAGE_TYPE_GENERAL_BIT_EXT, &callback_data);
+    }
+    ok(test.calls == count / batch, "Got %u callbacks, expected %u.\n", test.calls, count / batch);
+    ok(!test.mismatches, "Got %u mismatched handles.\n", test.mismatches);
+
+    vkFreeCommandBuffers(vk_device, vk_cmd_pool, count, cmd_buffers);
+    heap_free(cmd_buffers);
+    pfn_vkDestroyDebugUtilsMessengerEXT(vk_instance, vk_messenger, NULL);
+    vkDestroyCommandPool(vk_device, vk_cmd_pool, NULL);
+    vkDestroyDevice(vk_device, NULL);
+}
+
+static void test_submit_batches(VkPhysicalDevice vk_physical_device)
+{
+    static const unsigned int batch_sizes[] = {1, 4, 64};
+    VkSubmitInfo submits[64];
+    VkFenceCreateInfo fence_info;
+    uint32_t queue_family_index;
+    VkDevice vk_device;
+    VkFence vk_fence;
+    VkQueue vk_queue;
+    unsigned int i;
+    VkResult vr;
+
+    if ((vr = create_device(vk_physical_device, 0, NULL, NULL, &vk_device)) < 0)
+    {
+        skip("Failed to create device, vr %d.\n", vr);
+        return;
+    }
+
+    find_queue_family(vk_physical_device, VK_QUEUE_GRAPHICS_BIT, &queue_family_index);
+    vkGetDeviceQueue(vk_device, queue_family_index, 0, &vk_queue);
+
+    fence_info.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+    fence_info.pNext = NULL;
+    fence_info.flags = 0;
+    vr = vkCreateFence(vk_device, &fence_info, NULL, &vk_fence);
+    ok(vr == VK_SUCCESS, "Got unexpected VkResult %d.\n", vr);
+
+    /* empty submits still go through the VkSubmitInfo array conversion,
+     * the largest batch doesn't fit in the on-stack conversion buffer */
+    memset(submits, 0, sizeof(submits));
+    for (i = 0; i < ARRAY_SIZE(submits); i++)
+        submits[i].sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+
+    for (i = 0; i < ARRAY_SIZE(batch_sizes); i++)
+    {
+        vr = vkQueueSubmit(vk_queue, batch_sizes[i], submits, vk_fence);
+        ok(vr == VK_SUCCESS, "Got unexpected VkResult %d.\n", vr);
+        vr = vkWaitForFences(vk_device, 1, &vk_fence, VK_TRUE, ~(uint64_t)0);
+        ok(vr == VK_SUCCESS, "Got unexpected VkResult %d.\n", vr);
+        vr = vkGetFenceStatus(vk_device, vk_fence);
+        ok(vr == VK_SUCCESS, "Got unexpected VkResult %d.\n", vr);
+        vr = vkResetFences(vk_device, 1, &vk_fence);
+        ok(vr == VK_SUCCESS, "Got unexpected VkResult %d.\n", vr);
+    }
+
+    vr = vkQueueWaitIdle(vk_queue);
+    ok(vr == VK_SUCCESS, "Got unexpected VkResult %d.\n", vr);
+
+    vkDestroyFence(vk_device, vk_fence, NULL);
+    vkDestroyDevice(vk_device, NULL);
+}
+
 static void for_each_device_instance(uint32_t extension_count, const char * const *enabled_extensions,
         void (*test_func_instance)(VkInstance, VkPhysicalDevice), void (*test_func)(VkPhysicalDevice))
 {
@@ -946,4 +1125,6 @@ START_TEST(vulkan)
     for_each_device(test_private_data);
     for_each_device_instance(ARRAY_SIZE(test_null_hwnd_extensions), test_null_hwnd_extensions, test_null_hwnd, NULL);
     for_each_device_instance(ARRAY_SIZE(test_external_memory_extensions), test_external_memory_extensions, test_external_memory, NULL);
+    for_each_device_instance(ARRAY_SIZE(test_debug_utils_extensions), test_debug_utils_extensions, test_debug_utils_handle_mapping, NULL);
+    for_each_device(test_submit_batches);
 }
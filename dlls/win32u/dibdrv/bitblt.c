@@ -23,6 +23,9 @@
 #endif
 
 #include <assert.h>
+#include <pthread.h>
+#include <signal.h>
+#include <unistd.h>
 
 #include "ntgdi_private.h"
 #include "dibdrv.h"
@@ -585,17 +588,184 @@ static void mask_rect( dib_info *dst, const RECT *dst_rect, const dib_info *src,
     }
 }
 
+/* operations covering at least this many pixels are split across the worker threads */
+#define TILE_MIN_PIXELS   (512 * 512)
+#define TILE_MIN_ROWS     32
+#define TILE_MAX_WORKERS  3
+#define TILE_MAX_COUNT    16
+
+/* a set of independent tiles processed by the calling thread and the workers */
+struct tile_job
+{
+    void (*func)( struct tile_job *job, int tile );
+    int   count;    /* number of tiles */
+    LONG  next;     /* next tile to process */
+    LONG  done;     /* number of processed tiles */
+    int   users;    /* number of workers using the job, protected by tile_mutex */
+};
+
+static pthread_mutex_t tile_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t tile_cond = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t tile_done_cond = PTHREAD_COND_INITIALIZER;
+static pthread_once_t tile_once = PTHREAD_ONCE_INIT;
+static struct tile_job *tile_job;
+static int tile_workers;
+
+static void process_tiles( struct tile_job *job )
+{
+    int tile;
+
+    while ((tile = InterlockedIncrement( &job->next ) - 1) < job->count)
+    {
+        job->func( job, tile );
+        InterlockedIncrement( &job->done );
+    }
+}
+
+static void *tile_worker( void *arg )
+{
+    struct tile_job *job;
+
+    pthread_mutex_lock( &tile_mutex );
+    for (;;)
+    {
+        while (!(job = tile_job) || job->next >= job->count) pthread_cond_wait( &tile_cond, &tile_mutex );
+        job->users++;
+        pthread_mutex_unlock( &tile_mutex );
+
+        process_tiles( job );
+
+        pthread_mutex_lock( &tile_mutex );
+        if (!--job->users) pthread_cond_broadcast( &tile_done_cond );
+    }
+    return NULL;
+}
+
+static void init_tile_workers(void)
+{
+    long cpus = sysconf( _SC_NPROCESSORS_ONLN );
+    sigset_t sigset, old_sigset;
+    pthread_attr_t attr;
+    pthread_t thread;
+    int i;
+
+    /* the workers only run pixel loops, keep all signals on the Wine threads */
+    sigfillset( &sigset );
+    pthread_sigmask( SIG_SETMASK, &sigset, &old_sigset );
+    pthread_attr_init( &attr );
+    pthread_attr_setdetachstate( &attr, PTHREAD_CREATE_DETACHED );
+    for (i = 0; i < min( cpus - 1, TILE_MAX_WORKERS ); i++)
+    {
+        if (pthread_create( &thread, &attr, tile_worker, NULL )) break;
+        tile_workers++;
+    }
+    pthread_attr_destroy( &attr );
+    pthread_sigmask( SIG_SETMASK, &old_sigset, NULL );
+    TRACE( "using %d worker threads\n", tile_workers );
+}
+
+/***********************************************************************
+ *           get_tile_count
+ *
+ * Number of tiles to split an operation into, 0 if it's not worth it.
+ */
+static int get_tile_count( int width, int height )
+{
+    if ((LONGLONG)width * height < TILE_MIN_PIXELS || height < 2 * TILE_MIN_ROWS) return 0;
+    pthread_once( &tile_once, init_tile_workers );
+    if (!tile_workers) return 0;
+    return min( min( (tile_workers + 1) * 4, TILE_MAX_COUNT ), height / TILE_MIN_ROWS );
+}
+
+/***********************************************************************
+ *           run_tile_job
+ *
+ * Process all the tiles of a job and wait for the workers to be done
+ * with it. Only one job is shared with the workers at a time, other
+ * callers process their tiles on their own.
+ */
+static void run_tile_job( struct tile_job *job )
+{
+    BOOL shared = FALSE;
+
+    job->next = job->done = job->users = 0;
+
+    pthread_mutex_lock( &tile_mutex );
+    if (!tile_job)
+    {
+        tile_job = job;
+        shared = TRUE;
+        pthread_cond_broadcast( &tile_cond );
+    }
+    pthread_mutex_unlock( &tile_mutex );
+
+    process_tiles( job );
+    if (!shared) return;
+
+    pthread_mutex_lock( &tile_mutex );
+    while (job->done < job->count || job->users) pthread_cond_wait( &tile_done_cond, &tile_mutex );
+    tile_job = NULL;
+    pthread_mutex_unlock( &tile_mutex );
+}
+
+struct blend_tile_job
+{
+    struct tile_job              job;
+    dib_info                    *dst;
+    const dib_info              *src;
+    const struct clipped_rects  *clipped_rects;
+    const POINT                 *offset;
+    BLENDFUNCTION                blend;
+    int                          top;
+    int                          band;
+};
+
+static void blend_tile( struct tile_job *job, int tile )
+{
+    struct blend_tile_job *blend = CONTAINING_RECORD( job, struct blend_tile_job, job );
+    int i, top = blend->top + tile * blend->band;
+    RECT rect;
+
+    for (i = 0; i < blend->clipped_rects->count; i++)
+    {
+        rect = blend->clipped_rects->rects[i];
+        rect.top = max( rect.top, top );
+        if (tile < job->count - 1) rect.bottom = min( rect.bottom, top + blend->band );
+        if (rect.top >= rect.bottom) continue;
+        blend->dst->funcs->blend_rects( blend->dst, 1, &rect, blend->src, blend->offset, blend->blend );
+    }
+}
+
 static DWORD blend_rect( dib_info *dst, const RECT *dst_rect, const dib_info *src, const RECT *src_rect,
                          HRGN clip, BLENDFUNCTION blend )
 {
     POINT offset;
     struct clipped_rects clipped_rects;
+    int count;
 
     if (!get_clipped_rects( dst, dst_rect, clip, &clipped_rects )) return ERROR_SUCCESS;
 
     offset.x = src_rect->left - dst_rect->left;
     offset.y = src_rect->top  - dst_rect->top;
-    dst->funcs->blend_rects( dst, clipped_rects.count, clipped_rects.rects, src, &offset, blend );
+
+    /* the blended pixels are independent, so horizontal bands can be processed in parallel */
+    if (src->bits.ptr != dst->bits.ptr &&
+        (count = get_tile_count( dst_rect->right - dst_rect->left, dst_rect->bottom - dst_rect->top )))
+    {
+        struct blend_tile_job job;
+
+        job.job.func = blend_tile;
+        job.job.count = count;
+        job.dst = dst;
+        job.src = src;
+        job.clipped_rects = &clipped_rects;
+        job.offset = &offset;
+        job.blend = blend;
+        job.top = dst_rect->top;
+        job.band = (dst_rect->bottom - dst_rect->top) / count;
+        run_tile_job( &job.job );
+    }
+    else dst->funcs->blend_rects( dst, clipped_rects.count, clipped_rects.rects, src, &offset, blend );
 
     free_clipped_rects( &clipped_rects );
     return ERROR_SUCCESS;
@@ -1198,6 +1368,142 @@ static DWORD calc_1d_stretch_params( INT dst_start, INT dst_length, INT dst_vis_
 }
 
 
+typedef void (*stretch_row_fn)(const dib_info *dst_dib, const POINT *dst_start,
+                               const dib_info *src_dib, const POINT *src_start,
+                               const struct stretch_params *params, int mode, BOOL keep_dst);
+
+/* state of the vertical stretch loop at a given iteration */
+struct stretch_rows
+{
+    POINT dst_start;
+    POINT src_start;
+    int   err;
+    int   length;   /* remaining iterations */
+};
+
+struct stretch_tile_job
+{
+    struct tile_job               job;
+    dib_info                     *dst_dib;
+    const dib_info               *src_dib;
+    const struct stretch_params  *v_params;
+    const struct stretch_params  *h_params;
+    stretch_row_fn                row_fn;
+    BOOL                          vstretch;
+    int                           mode;
+    int                           width;
+    struct stretch_rows           rows[TILE_MAX_COUNT];
+};
+
+static void stretch_rows( const struct stretch_tile_job *job, const struct stretch_rows *rows )
+{
+    const struct stretch_params *v_params = job->v_params;
+    POINT dst_start = rows->dst_start, src_start = rows->src_start;
+    int err = rows->err, length = rows->length;
+
+    if (job->vstretch)
+    {
+        BOOL need_row = TRUE;
+        RECT last_row, this_row;
+        last_row.left = 0;
+        last_row.right = job->width;
+
+        while (length--)
+        {
+            if (need_row)
+            {
+                job->row_fn( job->dst_dib, &dst_start, job->src_dib, &src_start, job->h_params, job->mode, FALSE );
+                need_row = FALSE;
+            }
+            else
+            {
+                last_row.top = dst_start.y - v_params->dst_inc;
+                last_row.bottom = last_row.top + 1;
+                this_row = last_row;
+                offset_rect( &this_row, 0, v_params->dst_inc );
+                copy_rect( job->dst_dib, &this_row, job->dst_dib, &last_row, NULL, R2_COPYPEN );
+            }
+
+            if (err > 0)
+            {
+                src_start.y += v_params->src_inc;
+                need_row = TRUE;
+                err += v_params->err_add_1;
+            }
+            else err += v_params->err_add_2;
+            dst_start.y += v_params->dst_inc;
+        }
+    }
+    else
+    {
+        int merged_rows = 0;
+
+        while (length--)
+        {
+            if (job->mode != STRETCH_DELETESCANS || !merged_rows)
+                job->row_fn( job->dst_dib, &dst_start, job->src_dib, &src_start, job->h_params, job->mode,
+                             merged_rows != 0 );
+            merged_rows++;
+
+            if (err > 0)
+            {
+                dst_start.y += v_params->dst_inc;
+                merged_rows = 0;
+                err += v_params->err_add_1;
+            }
+            else err += v_params->err_add_2;
+            src_start.y += v_params->src_inc;
+        }
+    }
+}
+
+static void stretch_tile( struct tile_job *job, int tile )
+{
+    struct stretch_tile_job *stretch = CONTAINING_RECORD( job, struct stretch_tile_job, job );
+
+    stretch_rows( stretch, &stretch->rows[tile] );
+}
+
+/***********************************************************************
+ *           split_stretch_rows
+ *
+ * Step through the vertical loop to find the state at the start of each
+ * tile. When stretching, a tile starting on a duplicated row simply
+ * recomputes it from the same source row. When shrinking, tiles may
+ * only start on a new destination row so that merged rows never span
+ * two tiles. Either way the result is identical to a single pass.
+ */
+static int split_stretch_rows( struct stretch_tile_job *job, const struct stretch_rows *rows, int count )
+{
+    const struct stretch_params *v_params = job->v_params;
+    struct stretch_rows state = *rows;
+    BOOL new_row = TRUE;
+    int i, n = 0;
+
+    for (i = 0; i < rows->length && n < count; i++)
+    {
+        if ((job->vstretch || new_row) && i >= (LONGLONG)rows->length * n / count)
+        {
+            job->rows[n] = state;
+            job->rows[n].length = rows->length - i;
+            if (n) job->rows[n - 1].length -= job->rows[n].length;
+            n++;
+        }
+
+        new_row = state.err > 0;
+        if (state.err > 0)
+        {
+            if (job->vstretch) state.src_start.y += v_params->src_inc;
+            else state.dst_start.y += v_params->dst_inc;
+            state.err += v_params->err_add_1;
+        }
+        else state.err += v_params->err_add_2;
+        if (job->vstretch) state.dst_start.y += v_params->dst_inc;
+        else state.src_start.y += v_params->src_inc;
+    }
+    return n;
+}
+
 DWORD stretch_bitmapinfo( const BITMAPINFO *src_info, void *src_bits, struct bitblt_coords *src,
                           const BITMAPINFO *dst_info, void *dst_bits, struct bitblt_coords *dst,
                           INT mode )
@@ -1207,11 +1513,10 @@ DWORD stretch_bitmapinfo( const BITMAPINFO *src_info, void *src_bits, struct bit
     RECT rect;
     BOOL hstretch, vstretch;
     struct stretch_params v_params, h_params;
-    int err;
+    struct stretch_tile_job job;
+    struct stretch_rows rows;
+    int count;
     DWORD ret;
-    void (* row_fn)(const dib_info *dst_dib, const POINT *dst_start,
-                    const dib_info *src_dib, const POINT *src_start,
-                    const struct stretch_params *params, int mode, BOOL keep_dst);
 
     TRACE("dst %d, %d - %d x %d visrect %s src %d, %d - %d x %d visrect %s\n",
           dst->x, dst->y, dst->width, dst->height, wine_dbgstr_rect(&dst->visrect),
@@ -1251,64 +1556,30 @@ DWORD stretch_bitmapinfo( const BITMAPINFO *src_info, void *src_bits, struct bit
     dst_start.x -= dst->visrect.left;
     dst_start.y -= dst->visrect.top;
 
-    err = v_params.err_start;
-
-    row_fn = hstretch ? dst_dib.funcs->stretch_row : dst_dib.funcs->shrink_row;
-
-    if (vstretch)
+    job.dst_dib = &dst_dib;
+    job.src_dib = &src_dib;
+    job.v_params = &v_params;
+    job.h_params = &h_params;
+    job.row_fn = hstretch ? dst_dib.funcs->stretch_row : dst_dib.funcs->shrink_row;
+    job.vstretch = vstretch;
+    job.mode = (vstretch && hstretch) ? STRETCH_DELETESCANS : mode;
+    job.width = dst->visrect.right - dst->visrect.left;
+
+    rows.dst_start = dst_start;
+    rows.src_start = src_start;
+    rows.err = v_params.err_start;
+    rows.length = v_params.length;
+
+    /* source and destination rows must not overlap when processed out of order */
+    if (src_bits != dst_bits &&
+        (count = get_tile_count( job.width, dst->visrect.bottom - dst->visrect.top )) &&
+        (count = split_stretch_rows( &job, &rows, count )) > 1)
     {
-        BOOL need_row = TRUE;
-        RECT last_row, this_row;
-        if (hstretch) mode = STRETCH_DELETESCANS;
-        last_row.left = 0;
-        last_row.right = dst->visrect.right - dst->visrect.left;
-
-        while (v_params.length--)
-        {
-            if (need_row)
-            {
-                row_fn( &dst_dib, &dst_start, &src_dib, &src_start, &h_params, mode, FALSE );
-                need_row = FALSE;
-            }
-            else
-            {
-                last_row.top = dst_start.y - v_params.dst_inc;
-                last_row.bottom = last_row.top + 1;
-                this_row = last_row;
-                offset_rect( &this_row, 0, v_params.dst_inc );
-                copy_rect( &dst_dib, &this_row, &dst_dib, &last_row, NULL, R2_COPYPEN );
-            }
-
-            if (err > 0)
-            {
-                src_start.y += v_params.src_inc;
-                need_row = TRUE;
-                err += v_params.err_add_1;
-            }
-            else err += v_params.err_add_2;
-            dst_start.y += v_params.dst_inc;
-        }
-    }
-    else
-    {
-        int merged_rows = 0;
-
-        while (v_params.length--)
-        {
-            if (mode != STRETCH_DELETESCANS || !merged_rows)
-                row_fn( &dst_dib, &dst_start, &src_dib, &src_start, &h_params, mode, merged_rows != 0 );
-            merged_rows++;
-
-            if (err > 0)
-            {
-                dst_start.y += v_params.dst_inc;
-                merged_rows = 0;
-                err += v_params.err_add_1;
-            }
-            else err += v_params.err_add_2;
-            src_start.y += v_params.src_inc;
-        }
+        job.job.func = stretch_tile;
+        job.job.count = count;
+        run_tile_job( &job.job );
     }
+    else stretch_rows( &job, &rows );
 
 done:
     /* update coordinates, the destination rectangle is always stored at 0,0 */
@@ -223,6 +223,19 @@ extern const primitive_funcs funcs_4    DECLSPEC_HIDDEN;
 extern const primitive_funcs funcs_1    DECLSPEC_HIDDEN;
 extern const primitive_funcs funcs_null DECLSPEC_HIDDEN;
 
+/* vectorized row kernels, they return the number of pixels processed */
+struct dib_simd_funcs
+{
+    const char *name;
+    int (*blend_argb)( DWORD *dst, const DWORD *src, int len );
+    int (*blend_argb_alpha)( DWORD *dst, const DWORD *src, int len, DWORD alpha );
+    int (*blend_constant_alpha)( DWORD *dst, const DWORD *src, int len, DWORD alpha, DWORD src_or );
+    int (*convert_555_to_8888)( DWORD *dst, const WORD *src, int len );
+    int (*glyph_span)( DWORD *dst, const BYTE *glyph, int len, DWORD text_pixel );
+};
+
+extern struct dib_simd_funcs dib_simd DECLSPEC_HIDDEN;
+
 struct rop_codes
 {
     DWORD a1, a2, x1, x2;
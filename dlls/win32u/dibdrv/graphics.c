@@ -58,9 +58,22 @@ struct cached_font
     struct cached_glyph **glyphs[GLYPH_NBTYPES][GLYPH_CACHE_PAGES];
 };
 
-static struct list font_cache = LIST_INIT( font_cache );
+/* the font cache is split in shards selected by the font hash, each with its own lock */
+#define FONT_CACHE_SHARDS  16
+#define FONT_CACHE_UNUSED  2   /* number of unused fonts kept around per shard */
 
-static pthread_mutex_t font_cache_lock = PTHREAD_MUTEX_INITIALIZER;
+struct font_cache_shard
+{
+    pthread_mutex_t lock;
+    struct list     fonts;   /* most-recently used first */
+};
+
+static struct font_cache_shard font_cache[FONT_CACHE_SHARDS];
+static pthread_once_t font_cache_once = PTHREAD_ONCE_INIT;
+
+/* statistics, only maintained when tracing */
+static LONG font_cache_hits, font_cache_misses;
+static LONG glyph_cache_hits, glyph_cache_misses;
 
 
 static BOOL brush_rect( dibdrv_physdev *pdev, dib_brush *brush, const RECT *rect, HRGN clip )
@@ -631,10 +644,55 @@ static int font_cache_cmp( const struct cached_font *p1, const struct cached_fon
     return ret;
 }
 
+static void init_font_cache(void)
+{
+    int i;
+
+    for (i = 0; i < FONT_CACHE_SHARDS; i++)
+    {
+        pthread_mutex_init( &font_cache[i].lock, NULL );
+        list_init( &font_cache[i].fonts );
+    }
+}
+
+static struct font_cache_shard *get_font_cache_shard( DWORD hash )
+{
+    pthread_once( &font_cache_once, init_font_cache );
+    /* the hash is a plain xor of the font fields, mix it before using the top bits */
+    return &font_cache[(hash * 0x9e3779b1) >> 28];
+}
+
+static void dump_glyph_cache_stats(void)
+{
+    LONG font_hits = font_cache_hits, font_misses = font_cache_misses;
+    LONG glyph_hits = glyph_cache_hits, glyph_misses = glyph_cache_misses;
+
+    TRACE( "fonts %d hits %d misses (%u%%), glyphs %d hits %d misses (%u%%)\n",
+           font_hits, font_misses, font_hits * 100u / max( 1, font_hits + font_misses ),
+           glyph_hits, glyph_misses, (UINT)((ULONGLONG)glyph_hits * 100 / max( 1, glyph_hits + glyph_misses )) );
+}
+
+static void free_cached_glyphs( struct cached_font *font )
+{
+    UINT i, j, k;
+
+    for (i = 0; i < GLYPH_NBTYPES; i++)
+    {
+        for (j = 0; j < GLYPH_CACHE_PAGES; j++)
+        {
+            if (!font->glyphs[i][j]) continue;
+            for (k = 0; k < GLYPH_CACHE_PAGE_SIZE; k++)
+                free( font->glyphs[i][j][k] );
+            free( font->glyphs[i][j] );
+        }
+    }
+}
+
 static struct cached_font *add_cached_font( DC *dc, HFONT hfont, UINT aa_flags )
 {
     struct cached_font font, *ptr, *last_unused = NULL;
-    UINT i = 0, j, k;
+    struct font_cache_shard *shard;
+    UINT i = 0;
 
     NtGdiExtGetObjectW( hfont, sizeof(font.lf), &font.lf );
     font.xform = dc->xformWorld2Vport;
@@ -648,14 +706,16 @@ static struct cached_font *add_cached_font( DC *dc, HFONT hfont, UINT aa_flags )
     font.lf.lfWidth = abs( font.lf.lfWidth );
     font.aa_flags = aa_flags;
     font.hash = font_cache_hash( &font );
+    shard = get_font_cache_shard( font.hash );
 
-    pthread_mutex_lock( &font_cache_lock );
-    LIST_FOR_EACH_ENTRY( ptr, &font_cache, struct cached_font, entry )
+    pthread_mutex_lock( &shard->lock );
+    LIST_FOR_EACH_ENTRY( ptr, &shard->fonts, struct cached_font, entry )
     {
         if (!font_cache_cmp( &font, ptr ))
         {
             InterlockedIncrement( &ptr->ref );
             list_remove( &ptr->entry );
+            if (TRACE_ON(dib)) InterlockedIncrement( &font_cache_hits );
             goto done;
         }
         if (!ptr->ref)
@@ -665,24 +725,17 @@ static struct cached_font *add_cached_font( DC *dc, HFONT hfont, UINT aa_flags )
         }
     }
 
-    if (i > 5)  /* keep at least 5 of the most-recently used fonts around */
+    if (TRACE_ON(dib) && !(InterlockedIncrement( &font_cache_misses ) % 64)) dump_glyph_cache_stats();
+
+    if (i > FONT_CACHE_UNUSED)  /* keep some of the most-recently used fonts around */
     {
         ptr = last_unused;
-        for (i = 0; i < GLYPH_NBTYPES; i++)
-        {
-            for (j = 0; j < GLYPH_CACHE_PAGES; j++)
-            {
-                if (!ptr->glyphs[i][j]) continue;
-                for (k = 0; k < GLYPH_CACHE_PAGE_SIZE; k++)
-                    free( ptr->glyphs[i][j][k] );
-                free( ptr->glyphs[i][j] );
-            }
-        }
+        free_cached_glyphs( ptr );
         list_remove( &ptr->entry );
     }
     else if (!(ptr = malloc( sizeof(*ptr) )))
     {
-        pthread_mutex_unlock( &font_cache_lock );
+        pthread_mutex_unlock( &shard->lock );
         return NULL;
     }
 
@@ -690,8 +743,8 @@ static struct cached_font *add_cached_font( DC *dc, HFONT hfont, UINT aa_flags )
     ptr->ref = 1;
     memset( ptr->glyphs, 0, sizeof(ptr->glyphs) );
 done:
-    list_add_head( &font_cache, &ptr->entry );
-    pthread_mutex_unlock( &font_cache_lock );
+    list_add_head( &shard->fonts, &ptr->entry );
+    pthread_mutex_unlock( &shard->lock );
     TRACE( "%d %s -> %p\n", ptr->lf.lfHeight, debugstr_w(ptr->lf.lfFaceName), ptr );
     return ptr;
 }
@@ -912,8 +965,15 @@ static void render_string( DC *dc, dib_info *dib, struct cached_font *font, INT
 
     for (i = 0; i < count; i++)
     {
-        if (!(glyph = get_cached_glyph( font, str[i], flags )) &&
-            !(glyph = cache_glyph_bitmap( dc, font, str[i], flags ))) continue;
+        if ((glyph = get_cached_glyph( font, str[i], flags )))
+        {
+            if (TRACE_ON(dib)) InterlockedIncrement( &glyph_cache_hits );
+        }
+        else
+        {
+            if (TRACE_ON(dib) && !(InterlockedIncrement( &glyph_cache_misses ) % 1024)) dump_glyph_cache_stats();
+            if (!(glyph = cache_glyph_bitmap( dc, font, str[i], flags ))) continue;
+        }
 
         glyph_dib.width       = glyph->metrics.gmBlackBoxX;
         glyph_dib.height      = glyph->metrics.gmBlackBoxY;
@@ -2314,9 +2314,10 @@ static void convert_to_8888(dib_info *dst, const dib_info *src, const RECT *src_
         {
             for(y = src_rect->top; y < src_rect->bottom; y++)
             {
-                dst_pixel = dst_start;
-                src_pixel = src_start;
-                for(x = src_rect->left; x < src_rect->right; x++)
+                int done = dib_simd.convert_555_to_8888(dst_start, src_start, src_rect->right - src_rect->left);
+                dst_pixel = dst_start + done;
+                src_pixel = src_start + done;
+                for(x = src_rect->left + done; x < src_rect->right; x++)
                 {
                     src_val = *src_pixel++;
                     *dst_pixel++ = ((src_val << 9) & 0xf80000) | ((src_val << 4) & 0x070000) |
@@ -4691,25 +4692,29 @@ static void blend_rects_8888(const dib_info *dst, int num, const RECT *rc,
     {
         DWORD *src_ptr = get_pixel_ptr_32( src, rc->left + offset->x, rc->top + offset->y );
         DWORD *dst_ptr = get_pixel_ptr_32( dst, rc->left, rc->top );
+        int width = rc->right - rc->left;
 
         if (blend.AlphaFormat & AC_SRC_ALPHA)
         {
             if (blend.SourceConstantAlpha == 255)
                 for (y = rc->top; y < rc->bottom; y++, dst_ptr += dst->stride / 4, src_ptr += src->stride / 4)
-                    for (x = 0; x < rc->right - rc->left; x++)
+                    for (x = dib_simd.blend_argb( dst_ptr, src_ptr, width ); x < width; x++)
                         dst_ptr[x] = blend_argb( dst_ptr[x], src_ptr[x] );
             else
                 for (y = rc->top; y < rc->bottom; y++, dst_ptr += dst->stride / 4, src_ptr += src->stride / 4)
-                    for (x = 0; x < rc->right - rc->left; x++)
+                    for (x = dib_simd.blend_argb_alpha( dst_ptr, src_ptr, width, blend.SourceConstantAlpha );
+                         x < width; x++)
                         dst_ptr[x] = blend_argb_alpha( dst_ptr[x], src_ptr[x], blend.SourceConstantAlpha );
         }
         else if (src->compression == BI_RGB)
             for (y = rc->top; y < rc->bottom; y++, dst_ptr += dst->stride / 4, src_ptr += src->stride / 4)
-                for (x = 0; x < rc->right - rc->left; x++)
+                for (x = dib_simd.blend_constant_alpha( dst_ptr, src_ptr, width, blend.SourceConstantAlpha, 0 );
+                     x < width; x++)
                     dst_ptr[x] = blend_argb_constant_alpha( dst_ptr[x], src_ptr[x], blend.SourceConstantAlpha );
         else
             for (y = rc->top; y < rc->bottom; y++, dst_ptr += dst->stride / 4, src_ptr += src->stride / 4)
-                for (x = 0; x < rc->right - rc->left; x++)
+                for (x = dib_simd.blend_constant_alpha( dst_ptr, src_ptr, width, blend.SourceConstantAlpha, 0xff000000 );
+                     x < width; x++)
                     dst_ptr[x] = blend_argb_no_src_alpha( dst_ptr[x], src_ptr[x], blend.SourceConstantAlpha );
     }
 }
@@ -6138,15 +6143,20 @@ static void draw_glyph_8888( const dib_info *dib, const RECT *rect, const dib_in
 {
     DWORD *dst_ptr = get_pixel_ptr_32( dib, rect->left, rect->top );
     const BYTE *glyph_ptr = get_pixel_ptr_8( glyph, origin->x, origin->y );
-    int x, y;
+    int x, y, end, width = rect->right - rect->left;
 
     for (y = rect->top; y < rect->bottom; y++)
     {
-        for (x = 0; x < rect->right - rect->left; x++)
+        for (x = 0; x < width; )
         {
-            if (glyph_ptr[x] <= 1) continue;
-            if (glyph_ptr[x] >= 16) { dst_ptr[x] = text_pixel; continue; }
-            dst_ptr[x] = aa_rgb( dst_ptr[x] >> 16, dst_ptr[x] >> 8, dst_ptr[x], text_pixel, ranges + glyph_ptr[x] );
+            /* the vector code handles fully transparent or opaque spans, we do the rest */
+            x += dib_simd.glyph_span( dst_ptr + x, glyph_ptr + x, width - x, text_pixel );
+            for (end = min( x + 16, width ); x < end; x++)
+            {
+                if (glyph_ptr[x] <= 1) continue;
+                if (glyph_ptr[x] >= 16) { dst_ptr[x] = text_pixel; continue; }
+                dst_ptr[x] = aa_rgb( dst_ptr[x] >> 16, dst_ptr[x] >> 8, dst_ptr[x], text_pixel, ranges + glyph_ptr[x] );
+            }
         }
         dst_ptr += dib->stride / 4;
         glyph_ptr += glyph->stride;
@@ -0,0 +1,497 @@
+/*
+ * DIB driver vectorized primitives.
+ *
+ * Copyright (C) the Wine project
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
+ */
+
+#if 0
+#pragma makedep unix
+#endif
+
+#include "ntgdi_private.h"
+#include "dibdrv.h"
+
+#include "wine/debug.h"
+
+WINE_DEFAULT_DEBUG_CHANNEL(dib);
+
+/*
+ * The row kernels below process as many pixels as they can and return that
+ * count; the callers in primitives.c finish the row with the scalar code.
+ * All of them must produce exactly the same bits as the scalar versions.
+ *
+ * Divisions by 255 use the identity t / 255 == (t + 1 + (t >> 8)) >> 8,
+ * which holds for 0 <= t <= 65152, i.e. for all 255 * 255 + 127 products.
+ *
+ * blend_argb() combines the channels with OR rather than with masking, so
+ * when the source isn't properly premultiplied bit 8 of a channel sum ends
+ * up in bit 0 of the next channel. The vector code reproduces this by
+ * shifting the per-channel carries into the next 16-bit lane.
+ */
+
+static int blend_argb_none( DWORD *dst, const DWORD *src, int len )
+{
+    return 0;
+}
+
+static int blend_argb_alpha_none( DWORD *dst, const DWORD *src, int len, DWORD alpha )
+{
+    return 0;
+}
+
+static int blend_constant_alpha_none( DWORD *dst, const DWORD *src, int len, DWORD alpha, DWORD src_or )
+{
+    return 0;
+}
+
+static int convert_555_to_8888_none( DWORD *dst, const WORD *src, int len )
+{
+    return 0;
+}
+
+static int glyph_span_none( DWORD *dst, const BYTE *glyph, int len, DWORD text_pixel )
+{
+    return 0;
+}
+
+struct dib_simd_funcs dib_simd =
+{
+    "none",
+    blend_argb_none,
+    blend_argb_alpha_none,
+    blend_constant_alpha_none,
+    convert_555_to_8888_none,
+    glyph_span_none,
+};
+
+#if defined(__i386__) || defined(__x86_64__)
+
+#include <immintrin.h>
+
+#define SSE2_FUNC __attribute__((target("sse2")))
+#define AVX2_FUNC __attribute__((target("avx2")))
+
+static inline SSE2_FUNC __m128i div255_sse2( __m128i t )
+{
+    return _mm_srli_epi16( _mm_add_epi16( _mm_add_epi16( t, _mm_set1_epi16( 1 )), _mm_srli_epi16( t, 8 )), 8 );
+}
+
+/* dst * (255 - src_alpha) / 255 + src on two unpacked pixels */
+static inline SSE2_FUNC __m128i blend_argb_sse2( __m128i d, __m128i s )
+{
+    __m128i alpha = _mm_shufflehi_epi16( _mm_shufflelo_epi16( s, 0xff ), 0xff );
+    __m128i t = _mm_mullo_epi16( d, _mm_sub_epi16( _mm_set1_epi16( 255 ), alpha ));
+    __m128i sum = _mm_add_epi16( s, div255_sse2( _mm_add_epi16( t, _mm_set1_epi16( 127 ))));
+    __m128i carry = _mm_slli_epi64( _mm_srli_epi16( sum, 8 ), 16 );
+    return _mm_or_si128( _mm_and_si128( sum, _mm_set1_epi16( 0xff )), carry );
+}
+
+static inline SSE2_FUNC __m128i scale_sse2( __m128i s, __m128i alpha )
+{
+    return div255_sse2( _mm_add_epi16( _mm_mullo_epi16( s, alpha ), _mm_set1_epi16( 127 )));
+}
+
+static inline SSE2_FUNC __m128i blend_constant_sse2( __m128i d, __m128i s, __m128i alpha, __m128i inv_alpha )
+{
+    __m128i t = _mm_add_epi16( _mm_mullo_epi16( s, alpha ), _mm_mullo_epi16( d, inv_alpha ));
+    return div255_sse2( _mm_add_epi16( t, _mm_set1_epi16( 127 )));
+}
+
+static SSE2_FUNC int blend_argb_sse2_row( DWORD *dst, const DWORD *src, int len )
+{
+    const __m128i zero = _mm_setzero_si128();
+    int x;
+
+    for (x = 0; x + 4 <= len; x += 4)
+    {
+        __m128i s = _mm_loadu_si128( (const __m128i *)(src + x) );
+        __m128i d = _mm_loadu_si128( (const __m128i *)(dst + x) );
+        __m128i lo = blend_argb_sse2( _mm_unpacklo_epi8( d, zero ), _mm_unpacklo_epi8( s, zero ));
+        __m128i hi = blend_argb_sse2( _mm_unpackhi_epi8( d, zero ), _mm_unpackhi_epi8( s, zero ));
+        _mm_storeu_si128( (__m128i *)(dst + x), _mm_packus_epi16( lo, hi ));
+    }
+    return x;
+}
+
+static SSE2_FUNC int blend_argb_alpha_sse2_row( DWORD *dst, const DWORD *src, int len, DWORD alpha )
+{
+    const __m128i zero = _mm_setzero_si128(), a = _mm_set1_epi16( alpha );
+    int x;
+
+    for (x = 0; x + 4 <= len; x += 4)
+    {
+        __m128i s = _mm_loadu_si128( (const __m128i *)(src + x) );
+        __m128i d = _mm_loadu_si128( (const __m128i *)(dst + x) );
+        __m128i lo = blend_argb_sse2( _mm_unpacklo_epi8( d, zero ), scale_sse2( _mm_unpacklo_epi8( s, zero ), a ));
+        __m128i hi = blend_argb_sse2( _mm_unpackhi_epi8( d, zero ), scale_sse2( _mm_unpackhi_epi8( s, zero ), a ));
+        _mm_storeu_si128( (__m128i *)(dst + x), _mm_packus_epi16( lo, hi ));
+    }
+    return x;
+}
+
+static SSE2_FUNC int blend_constant_alpha_sse2_row( DWORD *dst, const DWORD *src, int len,
+                                                    DWORD alpha, DWORD src_or )
+{
+    const __m128i zero = _mm_setzero_si128(), opaque = _mm_set1_epi32( src_or );
+    const __m128i a = _mm_set1_epi16( alpha ), inv_a = _mm_set1_epi16( 255 - alpha );
+    int x;
+
+    for (x = 0; x + 4 <= len; x += 4)
+    {
+        __m128i s = _mm_or_si128( _mm_loadu_si128( (const __m128i *)(src + x) ), opaque );
+        __m128i d = _mm_loadu_si128( (const __m128i *)(dst + x) );
+        __m128i lo = blend_constant_sse2( _mm_unpacklo_epi8( d, zero ), _mm_unpacklo_epi8( s, zero ), a, inv_a );
+        __m128i hi = blend_constant_sse2( _mm_unpackhi_epi8( d, zero ), _mm_unpackhi_epi8( s, zero ), a, inv_a );
+        _mm_storeu_si128( (__m128i *)(dst + x), _mm_packus_epi16( lo, hi ));
+    }
+    return x;
+}
+
+static inline SSE2_FUNC __m128i convert_555_sse2( __m128i v )
+{
+    return _mm_or_si128(
+        _mm_or_si128( _mm_and_si128( _mm_slli_epi32( v, 9 ), _mm_set1_epi32( 0xf80000 )),
+                      _mm_and_si128( _mm_slli_epi32( v, 4 ), _mm_set1_epi32( 0x070000 ))),
+        _mm_or_si128(
+            _mm_or_si128( _mm_and_si128( _mm_slli_epi32( v, 6 ), _mm_set1_epi32( 0x00f800 )),
+                          _mm_and_si128( _mm_slli_epi32( v, 1 ), _mm_set1_epi32( 0x000700 ))),
+            _mm_or_si128( _mm_and_si128( _mm_slli_epi32( v, 3 ), _mm_set1_epi32( 0x0000f8 )),
+                          _mm_and_si128( _mm_srli_epi32( v, 2 ), _mm_set1_epi32( 0x000007 )))));
+}
+
+static SSE2_FUNC int convert_555_to_8888_sse2_row( DWORD *dst, const WORD *src, int len )
+{
+    const __m128i zero = _mm_setzero_si128();
+    int x;
+
+    for (x = 0; x + 8 <= len; x += 8)
+    {
+        __m128i v = _mm_loadu_si128( (const __m128i *)(src + x) );
+        _mm_storeu_si128( (__m128i *)(dst + x), convert_555_sse2( _mm_unpacklo_epi16( v, zero )));
+        _mm_storeu_si128( (__m128i *)(dst + x + 4), convert_555_sse2( _mm_unpackhi_epi16( v, zero )));
+    }
+    return x;
+}
+
+/* skip transparent (<= 1) and fill opaque (>= 16) glyph spans, stop at the first partially covered one */
+static SSE2_FUNC int glyph_span_sse2( DWORD *dst, const BYTE *glyph, int len, DWORD text_pixel )
+{
+    const __m128i zero = _mm_setzero_si128(), one = _mm_set1_epi8( 1 ), sixteen = _mm_set1_epi8( 16 );
+    const __m128i text = _mm_set1_epi32( text_pixel );
+    int x;
+
+    for (x = 0; x + 16 <= len; x += 16)
+    {
+        __m128i g = _mm_loadu_si128( (const __m128i *)(glyph + x) );
+
+        if (_mm_movemask_epi8( _mm_cmpeq_epi8( _mm_subs_epu8( g, one ), zero )) == 0xffff) continue;
+        if (_mm_movemask_epi8( _mm_cmpeq_epi8( _mm_subs_epu8( sixteen, g ), zero )) != 0xffff) break;
+        _mm_storeu_si128( (__m128i *)(dst + x), text );
+        _mm_storeu_si128( (__m128i *)(dst + x + 4), text );
+        _mm_storeu_si128( (__m128i *)(dst + x + 8), text );
+        _mm_storeu_si128( (__m128i *)(dst + x + 12), text );
+    }
+    return x;
+}
+
+static inline AVX2_FUNC __m256i div255_avx2( __m256i t )
+{
+    return _mm256_srli_epi16( _mm256_add_epi16( _mm256_add_epi16( t, _mm256_set1_epi16( 1 )),
+                                                _mm256_srli_epi16( t, 8 )), 8 );
+}
+
+static inline AVX2_FUNC __m256i blend_argb_avx2( __m256i d, __m256i s )
+{
+    __m256i alpha = _mm256_shufflehi_epi16( _mm256_shufflelo_epi16( s, 0xff ), 0xff );
+    __m256i t = _mm256_mullo_epi16( d, _mm256_sub_epi16( _mm256_set1_epi16( 255 ), alpha ));
+    __m256i sum = _mm256_add_epi16( s, div255_avx2( _mm256_add_epi16( t, _mm256_set1_epi16( 127 ))));
+    __m256i carry = _mm256_slli_epi64( _mm256_srli_epi16( sum, 8 ), 16 );
+    return _mm256_or_si256( _mm256_and_si256( sum, _mm256_set1_epi16( 0xff )), carry );
+}
+
+static inline AVX2_FUNC __m256i scale_avx2( __m256i s, __m256i alpha )
+{
+    return div255_avx2( _mm256_add_epi16( _mm256_mullo_epi16( s, alpha ), _mm256_set1_epi16( 127 )));
+}
+
+static inline AVX2_FUNC __m256i blend_constant_avx2( __m256i d, __m256i s, __m256i alpha, __m256i inv_alpha )
+{
+    __m256i t = _mm256_add_epi16( _mm256_mullo_epi16( s, alpha ), _mm256_mullo_epi16( d, inv_alpha ));
+    return div255_avx2( _mm256_add_epi16( t, _mm256_set1_epi16( 127 )));
+}
+
+/* the AVX2 unpack and pack instructions work within 128-bit lanes, so the pixel order is preserved */
+
+static AVX2_FUNC int blend_argb_avx2_row( DWORD *dst, const DWORD *src, int len )
+{
+    const __m256i zero = _mm256_setzero_si256();
+    int x;
+
+    for (x = 0; x + 8 <= len; x += 8)
+    {
+        __m256i s = _mm256_loadu_si256( (const __m256i *)(src + x) );
+        __m256i d = _mm256_loadu_si256( (const __m256i *)(dst + x) );
+        __m256i lo = blend_argb_avx2( _mm256_unpacklo_epi8( d, zero ), _mm256_unpacklo_epi8( s, zero ));
+        __m256i hi = blend_argb_avx2( _mm256_unpackhi_epi8( d, zero ), _mm256_unpackhi_epi8( s, zero ));
+        _mm256_storeu_si256( (__m256i *)(dst + x), _mm256_packus_epi16( lo, hi ));
+    }
+    return x + blend_argb_sse2_row( dst + x, src + x, len - x );
+}
+
+static AVX2_FUNC int blend_argb_alpha_avx2_row( DWORD *dst, const DWORD *src, int len, DWORD alpha )
+{
+    const __m256i zero = _mm256_setzero_si256(), a = _mm256_set1_epi16( alpha );
+    int x;
+
+    for (x = 0; x + 8 <= len; x += 8)
+    {
+        __m256i s = _mm256_loadu_si256( (const __m256i *)(src + x) );
+        __m256i d = _mm256_loadu_si256( (const __m256i *)(dst + x) );
+        __m256i lo = blend_argb_avx2( _mm256_unpacklo_epi8( d, zero ), scale_avx2( _mm256_unpacklo_epi8( s, zero ), a ));
+        __m256i hi = blend_argb_avx2( _mm256_unpackhi_epi8( d, zero ), scale_avx2( _mm256_unpackhi_epi8( s, zero ), a ));
+        _mm256_storeu_si256( (__m256i *)(dst + x), _mm256_packus_epi16( lo, hi ));
+    }
+    return x + blend_argb_alpha_sse2_row( dst + x, src + x, len - x, alpha );
+}
+
+static AVX2_FUNC int blend_constant_alpha_avx2_row( DWORD *dst, const DWORD *src, int len,
+                                                    DWORD alpha, DWORD src_or )
+{
+    const __m256i zero = _mm256_setzero_si256(), opaque = _mm256_set1_epi32( src_or );
+    const __m256i a = _mm256_set1_epi16( alpha ), inv_a = _mm256_set1_epi16( 255 - alpha );
+    int x;
+
+    for (x = 0; x + 8 <= len; x += 8)
+    {
+        __m256i s = _mm256_or_si256( _mm256_loadu_si256( (const __m256i *)(src + x) ), opaque );
+        __m256i d = _mm256_loadu_si256( (const __m256i *)(dst + x) );
+        __m256i lo = blend_constant_avx2( _mm256_unpacklo_epi8( d, zero ), _mm256_unpacklo_epi8( s, zero ), a, inv_a );
+        __m256i hi = blend_constant_avx2( _mm256_unpackhi_epi8( d, zero ), _mm256_unpackhi_epi8( s, zero ), a, inv_a );
+        _mm256_storeu_si256( (__m256i *)(dst + x), _mm256_packus_epi16( lo, hi ));
+    }
+    return x + blend_constant_alpha_sse2_row( dst + x, src + x, len - x, alpha, src_or );
+}
+
+static AVX2_FUNC int convert_555_to_8888_avx2_row( DWORD *dst, const WORD *src, int len )
+{
+    int x;
+
+    for (x = 0; x + 8 <= len; x += 8)
+    {
+        __m256i v = _mm256_cvtepu16_epi32( _mm_loadu_si128( (const __m128i *)(src + x) ));
+        __m256i res = _mm256_or_si256(
+            _mm256_or_si256( _mm256_and_si256( _mm256_slli_epi32( v, 9 ), _mm256_set1_epi32( 0xf80000 )),
+                             _mm256_and_si256( _mm256_slli_epi32( v, 4 ), _mm256_set1_epi32( 0x070000 ))),
+            _mm256_or_si256(
+                _mm256_or_si256( _mm256_and_si256( _mm256_slli_epi32( v, 6 ), _mm256_set1_epi32( 0x00f800 )),
+                                 _mm256_and_si256( _mm256_slli_epi32( v, 1 ), _mm256_set1_epi32( 0x000700 ))),
+                _mm256_or_si256( _mm256_and_si256( _mm256_slli_epi32( v, 3 ), _mm256_set1_epi32( 0x0000f8 )),
+                                 _mm256_and_si256( _mm256_srli_epi32( v, 2 ), _mm256_set1_epi32( 0x000007 )))));
+        _mm256_storeu_si256( (__m256i *)(dst + x), res );
+    }
+    return x;
+}
+
+static AVX2_FUNC int glyph_span_avx2( DWORD *dst, const BYTE *glyph, int len, DWORD text_pixel )
+{
+    const __m256i zero = _mm256_setzero_si256(), one = _mm256_set1_epi8( 1 ), sixteen = _mm256_set1_epi8( 16 );
+    const __m256i text = _mm256_set1_epi32( text_pixel );
+    int x;
+
+    for (x = 0; x + 32 <= len; x += 32)
+    {
+        __m256i g = _mm256_loadu_si256( (const __m256i *)(glyph + x) );
+
+        if (_mm256_movemask_epi8( _mm256_cmpeq_epi8( _mm256_subs_epu8( g, one ), zero )) == -1) continue;
+        if (_mm256_movemask_epi8( _mm256_cmpeq_epi8( _mm256_subs_epu8( sixteen, g ), zero )) != -1) break;
+        _mm256_storeu_si256( (__m256i *)(dst + x), text );
+        _mm256_storeu_si256( (__m256i *)(dst + x + 8), text );
+        _mm256_storeu_si256( (__m256i *)(dst + x + 16), text );
+        _mm256_storeu_si256( (__m256i *)(dst + x + 24), text );
+    }
+    return x + glyph_span_sse2( dst + x, glyph + x, len - x, text_pixel );
+}
+
+static const struct dib_simd_funcs dib_simd_sse2 =
+{
+    "sse2",
+    blend_argb_sse2_row,
+    blend_argb_alpha_sse2_row,
+    blend_constant_alpha_sse2_row,
+    convert_555_to_8888_sse2_row,
+    glyph_span_sse2,
+};
+
+static const struct dib_simd_funcs dib_simd_avx2 =
+{
+    "avx2",
+    blend_argb_avx2_row,
+    blend_argb_alpha_avx2_row,
+    blend_constant_alpha_avx2_row,
+    convert_555_to_8888_avx2_row,
+    glyph_span_avx2,
+};
+
+#elif defined(__aarch64__)
+
+#include <arm_neon.h>
+
+static inline uint16x8_t div255_neon( uint16x8_t t )
+{
+    return vshrq_n_u16( vaddq_u16( vaddq_u16( t, vdupq_n_u16( 1 )), vshrq_n_u16( t, 8 )), 8 );
+}
+
+static inline uint16x8_t blend_argb_neon( uint16x8_t d, uint16x8_t s )
+{
+    uint16x8_t alpha = vcombine_u16( vdup_lane_u16( vget_low_u16( s ), 3 ), vdup_lane_u16( vget_high_u16( s ), 3 ));
+    uint16x8_t t = vmulq_u16( d, vsubq_u16( vdupq_n_u16( 255 ), alpha ));
+    uint16x8_t sum = vaddq_u16( s, div255_neon( vaddq_u16( t, vdupq_n_u16( 127 ))));
+    uint16x8_t carry = vreinterpretq_u16_u64( vshlq_n_u64( vreinterpretq_u64_u16( vshrq_n_u16( sum, 8 )), 16 ));
+    return vorrq_u16( vandq_u16( sum, vdupq_n_u16( 0xff )), carry );
+}
+
+static inline uint16x8_t scale_neon( uint16x8_t s, uint16x8_t alpha )
+{
+    return div255_neon( vaddq_u16( vmulq_u16( s, alpha ), vdupq_n_u16( 127 )));
+}
+
+static inline uint16x8_t blend_constant_neon( uint16x8_t d, uint16x8_t s, uint16x8_t alpha, uint16x8_t inv_alpha )
+{
+    uint16x8_t t = vaddq_u16( vmulq_u16( s, alpha ), vmulq_u16( d, inv_alpha ));
+    return div255_neon( vaddq_u16( t, vdupq_n_u16( 127 )));
+}
+
+static int blend_argb_neon_row( DWORD *dst, const DWORD *src, int len )
+{
+    int x;
+
+    for (x = 0; x + 4 <= len; x += 4)
+    {
+        uint8x16_t s = vreinterpretq_u8_u32( vld1q_u32( (const uint32_t *)src + x ));
+        uint8x16_t d = vreinterpretq_u8_u32( vld1q_u32( (const uint32_t *)dst + x ));
+        uint16x8_t lo = blend_argb_neon( vmovl_u8( vget_low_u8( d )), vmovl_u8( vget_low_u8( s )));
+        uint16x8_t hi = blend_argb_neon( vmovl_u8( vget_high_u8( d )), vmovl_u8( vget_high_u8( s )));
+        vst1q_u32( (uint32_t *)dst + x, vreinterpretq_u32_u8( vcombine_u8( vmovn_u16( lo ), vmovn_u16( hi ))));
+    }
+    return x;
+}
+
+static int blend_argb_alpha_neon_row( DWORD *dst, const DWORD *src, int len, DWORD alpha )
+{
+    uint16x8_t a = vdupq_n_u16( alpha );
+    int x;
+
+    for (x = 0; x + 4 <= len; x += 4)
+    {
+        uint8x16_t s = vreinterpretq_u8_u32( vld1q_u32( (const uint32_t *)src + x ));
+        uint8x16_t d = vreinterpretq_u8_u32( vld1q_u32( (const uint32_t *)dst + x ));
+        uint16x8_t lo = blend_argb_neon( vmovl_u8( vget_low_u8( d )), scale_neon( vmovl_u8( vget_low_u8( s )), a ));
+        uint16x8_t hi = blend_argb_neon( vmovl_u8( vget_high_u8( d )), scale_neon( vmovl_u8( vget_high_u8( s )), a ));
+        vst1q_u32( (uint32_t *)dst + x, vreinterpretq_u32_u8( vcombine_u8( vmovn_u16( lo ), vmovn_u16( hi ))));
+    }
+    return x;
+}
+
+static int blend_constant_alpha_neon_row( DWORD *dst, const DWORD *src, int len, DWORD alpha, DWORD src_or )
+{
+    uint16x8_t a = vdupq_n_u16( alpha ), inv_a = vdupq_n_u16( 255 - alpha );
+    uint32x4_t opaque = vdupq_n_u32( src_or );
+    int x;
+
+    for (x = 0; x + 4 <= len; x += 4)
+    {
+        uint8x16_t s = vreinterpretq_u8_u32( vorrq_u32( vld1q_u32( (const uint32_t *)src + x ), opaque ));
+        uint8x16_t d = vreinterpretq_u8_u32( vld1q_u32( (const uint32_t *)dst + x ));
+        uint16x8_t lo = blend_constant_neon( vmovl_u8( vget_low_u8( d )), vmovl_u8( vget_low_u8( s )), a, inv_a );
+        uint16x8_t hi = blend_constant_neon( vmovl_u8( vget_high_u8( d )), vmovl_u8( vget_high_u8( s )), a, inv_a );
+        vst1q_u32( (uint32_t *)dst + x, vreinterpretq_u32_u8( vcombine_u8( vmovn_u16( lo ), vmovn_u16( hi ))));
+    }
+    return x;
+}
+
+static inline uint32x4_t convert_555_neon( uint32x4_t v )
+{
+    return vorrq_u32(
+        vorrq_u32( vandq_u32( vshlq_n_u32( v, 9 ), vdupq_n_u32( 0xf80000 )),
+                   vandq_u32( vshlq_n_u32( v, 4 ), vdupq_n_u32( 0x070000 ))),
+        vorrq_u32(
+            vorrq_u32( vandq_u32( vshlq_n_u32( v, 6 ), vdupq_n_u32( 0x00f800 )),
+                       vandq_u32( vshlq_n_u32( v, 1 ), vdupq_n_u32( 0x000700 ))),
+            vorrq_u32( vandq_u32( vshlq_n_u32( v, 3 ), vdupq_n_u32( 0x0000f8 )),
+                       vandq_u32( vshrq_n_u32( v, 2 ), vdupq_n_u32( 0x000007 )))));
+}
+
+static int convert_555_to_8888_neon_row( DWORD *dst, const WORD *src, int len )
+{
+    int x;
+
+    for (x = 0; x + 8 <= len; x += 8)
+    {
+        uint16x8_t v = vld1q_u16( (const uint16_t *)src + x );
+        vst1q_u32( (uint32_t *)dst + x, convert_555_neon( vmovl_u16( vget_low_u16( v ))));
+        vst1q_u32( (uint32_t *)dst + x + 4, convert_555_neon( vmovl_u16( vget_high_u16( v ))));
+    }
+    return x;
+}
+
+static int glyph_span_neon( DWORD *dst, const BYTE *glyph, int len, DWORD text_pixel )
+{
+    uint32x4_t text = vdupq_n_u32( text_pixel );
+    int x;
+
+    for (x = 0; x + 16 <= len; x += 16)
+    {
+        uint8x16_t g = vld1q_u8( glyph + x );
+
+        if (vmaxvq_u8( g ) <= 1) continue;
+        if (vminvq_u8( g ) < 16) break;
+        vst1q_u32( (uint32_t *)dst + x, text );
+        vst1q_u32( (uint32_t *)dst + x + 4, text );
+        vst1q_u32( (uint32_t *)dst + x + 8, text );
+        vst1q_u32( (uint32_t *)dst + x + 12, text );
+    }
+    return x;
+}
+
+static const struct dib_simd_funcs dib_simd_neon =
+{
+    "neon",
+    blend_argb_neon_row,
+    blend_argb_alpha_neon_row,
+    blend_constant_alpha_neon_row,
+    convert_555_to_8888_neon_row,
+    glyph_span_neon,
+};
+
+#endif
+
+/***********************************************************************
+ *           init_dib_simd
+ *
+ * Select the vectorized primitives supported by the host CPU.
+ */
+void init_dib_simd(void)
+{
+#if defined(__i386__) || defined(__x86_64__)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports( "avx2" )) dib_simd = dib_simd_avx2;
+    else if (__builtin_cpu_supports( "sse2" )) dib_simd = dib_simd_sse2;
+#elif defined(__aarch64__)
+    dib_simd = dib_simd_neon;
+#endif
+    TRACE( "using %s primitives\n", dib_simd.name );
+}
@@ -71,6 +71,7 @@ struct gdi_font_family
     WCHAR                   second_name[LF_FACESIZE];
     struct list             faces;
     struct gdi_font_family *replacement;
+    struct list             replacement_entry;  /* entry in replacement_families, if replacement is set */
 };
 
 struct gdi_font_face
@@ -92,6 +93,16 @@ struct gdi_font_face
     struct gdi_font_family    *family;
     struct gdi_font_enum_data *cached_enum_data;
     struct wine_rb_entry       full_name_entry;
+    struct face_name_index    *name_index;        /* set while the face is in a family list */
+    struct list                name_index_entry;
+};
+
+/* faces indexed by full name, truncated to the size of a LOGFONT face name */
+struct face_name_index
+{
+    struct wine_rb_entry entry;
+    struct list          faces;
+    WCHAR                name[LF_FACESIZE];
 };
 
 static const struct font_backend_funcs *font_funcs;
@@ -827,9 +838,17 @@ static int face_full_name_compare( const void *key, const struct wine_rb_entry *
     return facename_compare( (const WCHAR *)key, face->full_name, LF_FULLFACESIZE - 1 );
 }
 
+static int face_name_index_compare( const void *key, const struct wine_rb_entry *entry )
+{
+    const struct face_name_index *index = WINE_RB_ENTRY_VALUE( entry, const struct face_name_index, entry );
+    return facename_compare( (const WCHAR *)key, index->name, LF_FACESIZE - 1 );
+}
+
 static struct wine_rb_tree family_name_tree = { family_name_compare };
 static struct wine_rb_tree family_second_name_tree = { family_second_name_compare };
 static struct wine_rb_tree face_full_name_tree = { face_full_name_compare };
+static struct wine_rb_tree face_name_index_tree = { face_name_index_compare };
+static struct list replacement_families = LIST_INIT( replacement_families );
 
 static int face_is_in_full_name_tree( const struct gdi_font_face *face )
 {
@@ -861,10 +880,44 @@ static void release_family( struct gdi_font_family *family )
     assert( list_empty( &family->faces ));
     wine_rb_remove( &family_name_tree, &family->name_entry );
     if (family->second_name[0]) wine_rb_remove( &family_second_name_tree, &family->second_name_entry );
-    if (family->replacement) release_family( family->replacement );
+    if (family->replacement)
+    {
+        list_remove( &family->replacement_entry );
+        release_family( family->replacement );
+    }
     free( family );
 }
 
+static void add_face_to_name_index( struct gdi_font_face *face )
+{
+    struct face_name_index *index;
+    struct wine_rb_entry *entry;
+
+    if ((entry = wine_rb_get( &face_name_index_tree, face->full_name )))
+        index = WINE_RB_ENTRY_VALUE( entry, struct face_name_index, entry );
+    else
+    {
+        if (!(index = malloc( sizeof(*index) ))) return;
+        lstrcpynW( index->name, face->full_name, LF_FACESIZE );
+        list_init( &index->faces );
+        wine_rb_put( &face_name_index_tree, index->name, &index->entry );
+    }
+    list_add_tail( &index->faces, &face->name_index_entry );
+    face->name_index = index;
+}
+
+static void remove_face_from_name_index( struct gdi_font_face *face )
+{
+    struct face_name_index *index = face->name_index;
+
+    if (!index) return;
+    list_remove( &face->name_index_entry );
+    face->name_index = NULL;
+    if (!list_empty( &index->faces )) return;
+    wine_rb_remove( &face_name_index_tree, &index->entry );
+    free( index );
+}
+
 static struct gdi_font_family *find_family_from_name( const WCHAR *name )
 {
     struct wine_rb_entry *entry;
@@ -942,6 +995,7 @@ static BOOL add_family_replacement( const WCHAR *new_name, const WCHAR *replace
 
     if (!(new_family = create_family( new_name, NULL ))) return FALSE;
     new_family->replacement = family;
+    list_add_tail( &replacement_families, &new_family->replacement_entry );
     family->refcount++;
     TRACE( "mapping %s to %s\n", debugstr_w(replace), debugstr_w(new_name) );
 
@@ -1216,6 +1270,7 @@ static void release_face( struct gdi_font_face *face )
     {
         if (face->flags & ADDFONT_ADD_TO_CACHE) remove_face_from_cache( face );
         list_remove( &face->entry );
+        remove_face_from_name_index( face );
         release_family( face->family );
     }
     if (face_is_in_full_name_tree( face )) wine_rb_remove( &face_full_name_tree, &face->full_name_entry );
@@ -1310,6 +1365,7 @@ static BOOL insert_face_in_family_list( struct gdi_font_face *face, struct gdi_f
                 TRACE("Replacing original %s with %s\n",
                       debugstr_w(cursor->file), debugstr_w(face->file));
                 list_add_before( &cursor->entry, &face->entry );
+                add_face_to_name_index( face );
                 face->family = family;
                 family->refcount++;
                 face->refcount++;
@@ -1328,6 +1384,7 @@ static BOOL insert_face_in_family_list( struct gdi_font_face *face, struct gdi_f
     TRACE( "Adding face %s in family %s from %s\n", debugstr_w(face->full_name),
            debugstr_w(family->family_name), debugstr_w(face->file) );
     list_add_before( &cursor->entry, &face->entry );
+    add_face_to_name_index( face );
     if (face->scalable) wine_rb_put( &face_full_name_tree, face->full_name, &face->full_name_entry );
     face->family = family;
     family->refcount++;
@@ -1585,6 +1642,235 @@ static void remove_face_from_cache( struct gdi_font_face *face )
     NtClose( hkey_family );
 }
 
+/* face database
+ *
+ * A flat copy of the faces found in the font directories, stored in a named
+ * section so that the other processes of the session can create their font
+ * list from it instead of opening and parsing every font file. The section
+ * name contains a stamp of the font directories, so a database is never used
+ * once fonts were added or removed; it goes away with the last process that
+ * has it open.
+ */
+
+#define FONT_DB_MAGIC    0x42444657  /* "WFDB" */
+#define FONT_DB_VERSION  1
+
+struct font_db_header
+{
+    DWORD     magic;    /* set last, once the data is complete */
+    DWORD     version;
+    DWORD     size;     /* total size of the data */
+    DWORD     count;    /* number of faces */
+    ULONGLONG stamp;    /* font directories stamp */
+};
+
+struct font_db_face
+{
+    DWORD                   size;       /* size of the entry, including the names */
+    DWORD                   index;
+    DWORD                   flags;
+    DWORD                   ntmflags;
+    DWORD                   version;
+    DWORD                   scalable;
+    struct bitmap_font_size bitmap_size;
+    FONTSIGNATURE           fs;
+    WCHAR                   names[1];   /* family, second name, style, full name and file */
+};
+
+static HANDLE font_db_section;
+
+static void get_font_db_name( ULONGLONG stamp, WCHAR *nameW, UNICODE_STRING *name )
+{
+    char buffer[64];
+
+    sprintf( buffer, "\\BaseNamedObjects\\__WINE_FONT_DB_%08x%08x__", (UINT)(stamp >> 32), (UINT)stamp );
+    name->Buffer = nameW;
+    name->Length = name->MaximumLength = asciiz_to_unicode( nameW, buffer ) - sizeof(WCHAR);
+}
+
+static BOOL is_font_db_face( const struct gdi_font_face *face )
+{
+    /* vertical faces are created again by add_gdi_face, resources are in the registry cache */
+    return face->file && !face->data_ptr && !(face->flags & (ADDFONT_VERTICAL_FONT | ADDFONT_ADD_RESOURCE));
+}
+
+static const WCHAR *get_font_db_name_string( const WCHAR **ptr, const WCHAR *end )
+{
+    const WCHAR *str = *ptr;
+
+    while (*ptr < end && **ptr) (*ptr)++;
+    if (*ptr == end) return NULL;
+    (*ptr)++;
+    return str;
+}
+
+/***********************************************************************
+ *           load_font_database
+ *
+ * Create the font list from an existing database, if any.
+ */
+static BOOL load_font_database( ULONGLONG stamp )
+{
+    OBJECT_ATTRIBUTES attr;
+    UNICODE_STRING name;
+    WCHAR nameW[64];
+    const struct font_db_header *header;
+    const struct font_db_face *entry;
+    const WCHAR *ptr, *end, *family, *second, *style, *full_name, *file;
+    const char *data;
+    void *view = NULL;
+    SIZE_T view_size = 0;
+    HANDLE section;
+    DWORD pos, i;
+
+    get_font_db_name( stamp, nameW, &name );
+    InitializeObjectAttributes( &attr, &name, 0, 0, NULL );
+    if (NtOpenSection( &section, SECTION_MAP_READ | SECTION_QUERY, &attr )) return FALSE;
+    if (NtMapViewOfSection( section, GetCurrentProcess(), &view, 0, 0, NULL, &view_size,
+                            ViewShare, 0, PAGE_READONLY ))
+    {
+        NtClose( section );
+        return FALSE;
+    }
+
+    header = view;
+    data = view;
+    if (view_size < sizeof(*header) ||
+        __atomic_load_n( &header->magic, __ATOMIC_SEQ_CST ) != FONT_DB_MAGIC ||
+        header->version != FONT_DB_VERSION || header->stamp != stamp ||
+        header->size > view_size)
+    {
+        TRACE( "ignoring incomplete or mismatched database\n" );
+        NtUnmapViewOfSection( GetCurrentProcess(), view );
+        NtClose( section );
+        return FALSE;
+    }
+
+    for (i = 0, pos = sizeof(*header); i < header->count; i++, pos += entry->size)
+    {
+        if (header->size - pos < offsetof( struct font_db_face, names )) break;
+        entry = (const struct font_db_face *)(data + pos);
+        if (entry->size < offsetof( struct font_db_face, names ) || entry->size > header->size - pos ||
+            entry->size % sizeof(DWORD))
+            break;
+
+        ptr = entry->names;
+        end = (const WCHAR *)(data + pos + entry->size);
+        if (!(family = get_font_db_name_string( &ptr, end )) ||
+            !(second = get_font_db_name_string( &ptr, end )) ||
+            !(style = get_font_db_name_string( &ptr, end )) ||
+            !(full_name = get_font_db_name_string( &ptr, end )) ||
+            !(file = get_font_db_name_string( &ptr, end )))
+            break;
+
+        add_gdi_face( family, second, style, full_name, file, NULL, 0, entry->index, entry->fs,
+                      entry->ntmflags, entry->version, entry->flags,
+                      entry->scalable ? NULL : &entry->bitmap_size );
+    }
+
+    if (i < header->count) ERR( "corrupted font database entry %u\n", i );
+    TRACE( "loaded %u/%u faces from database\n", i, header->count );
+    NtUnmapViewOfSection( GetCurrentProcess(), view );
+    /* keep the section alive for the processes started later */
+    font_db_section = section;
+    return TRUE;
+}
+
+static DWORD get_font_db_face_size( const struct gdi_font_face *face )
+{
+    DWORD len = lstrlenW( face->family->family_name ) + lstrlenW( face->family->second_name ) +
+                lstrlenW( face->style_name ) + lstrlenW( face->full_name ) + lstrlenW( face->file ) + 5;
+
+    return (offsetof( struct font_db_face, names[len] ) + sizeof(DWORD) - 1) & ~(sizeof(DWORD) - 1);
+}
+
+static WCHAR *put_font_db_string( WCHAR *ptr, const WCHAR *str )
+{
+    DWORD len = lstrlenW( str ) + 1;
+
+    memcpy( ptr, str, len * sizeof(WCHAR) );
+    return ptr + len;
+}
+
+/***********************************************************************
+ *           create_font_database
+ *
+ * Store the faces loaded from the font directories for the other processes.
+ */
+static void create_font_database( ULONGLONG stamp )
+{
+    OBJECT_ATTRIBUTES attr;
+    UNICODE_STRING name;
+    LARGE_INTEGER section_size;
+    WCHAR nameW[64], *ptr;
+    struct font_db_header *header;
+    struct font_db_face *entry;
+    struct gdi_font_family *family;
+    struct gdi_font_face *face;
+    void *view = NULL;
+    SIZE_T view_size = 0;
+    HANDLE section;
+    DWORD size = sizeof(*header), count = 0;
+    NTSTATUS status;
+
+    WINE_RB_FOR_EACH_ENTRY( family, &family_name_tree, struct gdi_font_family, name_entry )
+        LIST_FOR_EACH_ENTRY( face, &family->faces, struct gdi_font_face, entry )
+            if (is_font_db_face( face )) size += get_font_db_face_size( face );
+
+    get_font_db_name( stamp, nameW, &name );
+    InitializeObjectAttributes( &attr, &name, OBJ_OPENIF, 0, NULL );
+    section_size.QuadPart = size;
+    status = NtCreateSection( &section, SECTION_MAP_READ | SECTION_MAP_WRITE | SECTION_QUERY, &attr,
+                              &section_size, PAGE_READWRITE, SEC_COMMIT, 0 );
+    if (status)
+    {
+        /* another process is already creating it */
+        if (status == STATUS_OBJECT_NAME_EXISTS) NtClose( section );
+        return;
+    }
+    if (NtMapViewOfSection( section, GetCurrentProcess(), &view, 0, 0, NULL, &view_size,
+                            ViewShare, 0, PAGE_READWRITE ))
+    {
+        NtClose( section );
+        return;
+    }
+
+    header = view;
+    entry = (struct font_db_face *)(header + 1);
+    WINE_RB_FOR_EACH_ENTRY( family, &family_name_tree, struct gdi_font_family, name_entry )
+    {
+        LIST_FOR_EACH_ENTRY( face, &family->faces, struct gdi_font_face, entry )
+        {
+            if (!is_font_db_face( face )) continue;
+            entry->size = get_font_db_face_size( face );
+            entry->index = face->face_index;
+            entry->flags = face->flags;
+            entry->ntmflags = face->ntmFlags;
+            entry->version = face->version;
+            entry->scalable = face->scalable;
+            entry->bitmap_size = face->size;
+            entry->fs = face->fs;
+            ptr = put_font_db_string( entry->names, face->family->family_name );
+            ptr = put_font_db_string( ptr, face->family->second_name );
+            ptr = put_font_db_string( ptr, face->style_name );
+            ptr = put_font_db_string( ptr, face->full_name );
+            put_font_db_string( ptr, face->file );
+            entry = (struct font_db_face *)((char *)entry + entry->size);
+            count++;
+        }
+    }
+
+    header->version = FONT_DB_VERSION;
+    header->size = size;
+    header->count = count;
+    header->stamp = stamp;
+    __atomic_store_n( &header->magic, FONT_DB_MAGIC, __ATOMIC_SEQ_CST );
+
+    TRACE( "stored %u faces, %u bytes\n", count, size );
+    NtUnmapViewOfSection( GetCurrentProcess(), view );
+    font_db_section = section;
+}
+
 /* font links */
 
 struct gdi_font_link
@@ -2660,7 +2946,9 @@ static void create_child_font_list( struct gdi_font *font )
 
 /* font cache */
 
-static struct list gdi_font_list = LIST_INIT( gdi_font_list );
+/* in-use and unused fonts, hashed by LOGFONT and matrix, most-recently used first in each bucket */
+#define GDI_FONT_CACHE_BITS 7
+static struct list gdi_font_cache[1 << GDI_FONT_CACHE_BITS];
 static struct list unused_gdi_font_list = LIST_INIT( unused_gdi_font_list );
 static unsigned int unused_font_count;
 #define UNUSED_CACHE_SIZE 10
@@ -2700,13 +2988,22 @@ static DWORD hash_font( const LOGFONTW *lf, const FMAT2 *matrix, BOOL can_use_bi
     return hash;
 }
 
+static struct list *get_gdi_font_bucket( DWORD hash )
+{
+    /* the hash is a plain xor of the LOGFONT fields, mix it before using the top bits */
+    struct list *bucket = &gdi_font_cache[(hash * 0x9e3779b1) >> (32 - GDI_FONT_CACHE_BITS)];
+
+    if (!bucket->next) list_init( bucket );
+    return bucket;
+}
+
 static void cache_gdi_font( struct gdi_font *font )
 {
     static DWORD cache_num = 1;
 
     font->cache_num = cache_num++;
     font->hash = hash_font( &font->lf, &font->matrix, font->can_use_bitmap );
-    list_add_head( &gdi_font_list, &font->entry );
+    list_add_head( get_gdi_font_bucket( font->hash ), &font->entry );
     TRACE( "font %p\n", font );
 }
 
@@ -2714,13 +3011,13 @@ static struct gdi_font *find_cached_gdi_font( const LOGFONTW *lf, const FMAT2 *m
 {
     struct gdi_font *font;
     DWORD hash = hash_font( lf, matrix, can_use_bitmap );
+    struct list *bucket = get_gdi_font_bucket( hash );
 
-    /* try the in-use list */
-    LIST_FOR_EACH_ENTRY( font, &gdi_font_list, struct gdi_font, entry )
+    LIST_FOR_EACH_ENTRY( font, bucket, struct gdi_font, entry )
     {
         if (fontcmp( font, hash, lf, matrix, can_use_bitmap )) continue;
         list_remove( &font->entry );
-        list_add_head( &gdi_font_list, &font->entry );
+        list_add_head( bucket, &font->entry );
         if (!font->refcount++)
         {
             list_remove( &font->unused_entry );
@@ -3306,15 +3603,77 @@ static BOOL enum_face_charsets( const struct gdi_font_family *family, struct gdi
     return TRUE;
 }
 
+static int family_ptr_compare( const void *a, const void *b )
+{
+    const struct gdi_font_family *family1 = *(struct gdi_font_family * const *)a;
+    const struct gdi_font_family *family2 = *(struct gdi_font_family * const *)b;
+    return family_namecmp( family1->family_name, family2->family_name );
+}
+
+/***********************************************************************
+ *           find_enum_families
+ *
+ * Find the families matching a face name, in family_name_tree order.
+ * Same as checking family_matches() on all the families, but using
+ * the name indexes. The returned families are referenced.
+ */
+static BOOL add_enum_family( struct gdi_font_family ***families, unsigned int *count, unsigned int *size,
+                             struct gdi_font_family *family )
+{
+    if (*count == *size)
+    {
+        unsigned int new_size = max( 16, *size * 2 );
+        struct gdi_font_family **new_families;
+
+        if (!(new_families = realloc( *families, new_size * sizeof(*new_families) ))) return FALSE;
+        *families = new_families;
+        *size = new_size;
+    }
+    (*families)[(*count)++] = family;
+    return TRUE;
+}
+
+static unsigned int find_enum_families( const WCHAR *face_name, struct gdi_font_family ***ret )
+{
+    struct gdi_font_family **families = NULL, *family;
+    struct gdi_font_face *face;
+    struct wine_rb_entry *entry;
+    unsigned int i, j, count = 0, size = 0;
+
+    if ((family = find_family_from_name( face_name )))
+        add_enum_family( &families, &count, &size, family );
+    if ((entry = wine_rb_get( &face_name_index_tree, face_name )))
+    {
+        struct face_name_index *index = WINE_RB_ENTRY_VALUE( entry, struct face_name_index, entry );
+        LIST_FOR_EACH_ENTRY( face, &index->faces, struct gdi_font_face, name_index_entry )
+            add_enum_family( &families, &count, &size, face->family );
+    }
+    /* replacement families expose the faces of another family */
+    LIST_FOR_EACH_ENTRY( family, &replacement_families, struct gdi_font_family, replacement_entry )
+        if (family_matches( family, face_name )) add_enum_family( &families, &count, &size, family );
+
+    if (count > 1)
+    {
+        qsort( families, count, sizeof(*families), family_ptr_compare );
+        for (i = j = 1; i < count; i++) if (families[i] != families[j - 1]) families[j++] = families[i];
+        count = j;
+    }
+    for (i = 0; i < count; i++) families[i]->refcount++;
+    *ret = families;
+    return count;
+}
+
 /*************************************************************
  * font_EnumFonts
  */
 static BOOL CDECL font_EnumFonts( PHYSDEV dev, LOGFONTW *lf, FONTENUMPROCW proc, LPARAM lparam )
 {
-    struct gdi_font_family *family;
+    struct gdi_font_family *family, **families;
     struct gdi_font_face *face;
     struct enum_charset enum_charsets[32];
     DWORD count, charset;
+    unsigned int i, family_count;
+    BOOL ret = TRUE;
 
     charset = lf ? lf->lfCharSet : DEFAULT_CHARSET;
 
@@ -3335,16 +3694,29 @@ static BOOL CDECL font_EnumFonts( PHYSDEV dev, LOGFONTW *lf, FONTENUMPROCW proc,
         }
         else face_name = lf->lfFaceName;
 
-        WINE_RB_FOR_EACH_ENTRY( family, &family_name_tree, struct gdi_font_family, name_entry )
+        family_count = find_enum_families( face_name, &families );
+        for (i = 0; i < family_count; i++)
         {
-            if (!family_matches(family, face_name)) continue;
+            family = families[i];
             LIST_FOR_EACH_ENTRY( face, get_family_face_list(family), struct gdi_font_face, entry )
             {
                 if (!face_matches( family->family_name, face, face_name )) continue;
                 if (!enum_face_charsets( family, face, enum_charsets, count, proc, lparam, orig_name ))
-                    return FALSE;
-	    }
-	}
+                {
+                    pthread_mutex_lock( &font_lock );
+                    ret = FALSE;
+                    break;
+                }
+            }
+            if (!ret) break;
+        }
+        for (i = 0; i < family_count; i++) release_family( families[i] );
+        free( families );
+        if (!ret)
+        {
+            pthread_mutex_unlock( &font_lock );
+            return FALSE;
+        }
     }
     else
     {
@@ -6304,7 +6676,7 @@ static void load_directory_fonts( WCHAR *path, UINT flags )
     NtClose( handle );
 }
 
-static void load_file_system_fonts(void)
+static void enum_font_directories( void (*func)( WCHAR *path, UINT flags, void *arg ), void *arg )
 {
     char value_buffer[FIELD_OFFSET(KEY_VALUE_PARTIAL_INFORMATION, Data[1024 * sizeof(WCHAR)])];
     KEY_VALUE_PARTIAL_INFORMATION *info = (void *)value_buffer;
@@ -6312,11 +6684,11 @@ static void load_file_system_fonts(void)
 
     /* Windows directory */
     get_fonts_win_dir_path( NULL, path );
-    load_directory_fonts( path, 0 );
+    func( path, 0, arg );
 
     /* Wine data directory */
     get_fonts_data_dir_path( NULL, path );
-    load_directory_fonts( path, ADDFONT_EXTERNAL_FONT );
+    func( path, ADDFONT_EXTERNAL_FONT, arg );
 
     /* custom paths */
     /* @@ Wine registry key: HKCU\Software\Wine\Fonts */
@@ -6333,11 +6705,51 @@ static void load_file_system_fonts(void)
                 memmove( path + ARRAYSIZE(nt_prefixW), path, (lstrlenW( path ) + 1) * sizeof(WCHAR) );
                 memcpy( path, nt_prefixW, sizeof(nt_prefixW) );
             }
-            load_directory_fonts( path, ADDFONT_EXTERNAL_FONT );
+            func( path, ADDFONT_EXTERNAL_FONT, arg );
         }
     }
 }
 
+static void load_directory_fonts_callback( WCHAR *path, UINT flags, void *arg )
+{
+    load_directory_fonts( path, flags );
+}
+
+static void load_file_system_fonts(void)
+{
+    enum_font_directories( load_directory_fonts_callback, NULL );
+}
+
+static void font_directory_stamp_callback( WCHAR *path, UINT flags, void *arg )
+{
+    ULONGLONG *stamp = arg;
+    OBJECT_ATTRIBUTES attr;
+    UNICODE_STRING nt_name;
+    FILE_BASIC_INFORMATION info;
+    size_t len;
+
+    len = lstrlenW( path );
+    while (len && path[len - 1] == '\\') len--;
+
+    nt_name.Buffer = path;
+    nt_name.MaximumLength = nt_name.Length = len * sizeof(WCHAR);
+    InitializeObjectAttributes( &attr, &nt_name, OBJ_CASE_INSENSITIVE, 0, NULL );
+
+    /* the modification time of a directory changes when files are added or removed */
+    if (NtQueryAttributesFile( &attr, &info )) info.LastWriteTime.QuadPart = 0;
+    *stamp = (*stamp * 0x100000001b3ull) ^ info.LastWriteTime.QuadPart;
+}
+
+static ULONGLONG get_font_directories_stamp(void)
+{
+    ULONGLONG stamp = 0xcbf29ce484222325ull;
+
+    enum_font_directories( font_directory_stamp_callback, &stamp );
+    /* fonts found through fontconfig end up in the database too */
+    font_funcs->update_font_stamp( &stamp );
+    return stamp;
+}
+
 struct external_key
 {
     struct list entry;
@@ -6514,6 +6926,7 @@ UINT font_init(void)
     UNICODE_STRING name;
     HANDLE mutex;
     DWORD disposition;
+    ULONGLONG stamp;
     UINT dpi = 0;
 
     static WCHAR wine_font_mutexW[] =
@@ -6532,9 +6945,14 @@ UINT font_init(void)
     if (!(font_funcs = init_freetype_lib()))
         return dpi;
 
-    load_system_bitmap_fonts();
-    load_file_system_fonts();
-    font_funcs->load_fonts();
+    stamp = get_font_directories_stamp();
+    if (!load_font_database( stamp ))
+    {
+        load_system_bitmap_fonts();
+        load_file_system_fonts();
+        font_funcs->load_fonts();
+        create_font_database( stamp );
+    }
 
     attr.Attributes = OBJ_OPENIF;
     attr.ObjectName = &name;
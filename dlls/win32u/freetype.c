@@ -1709,6 +1709,31 @@ done:
     if (done_set) pFcStrSetDestroy( done_set );
 }
 
+static void add_dir_to_font_stamp( const char *dir, ULONGLONG *stamp )
+{
+    struct stat st;
+    const char *ptr;
+
+    for (ptr = dir; *ptr; ptr++) *stamp = (*stamp * 0x100000001b3ull) ^ (BYTE)*ptr;
+    /* the modification time of a directory changes when files are added or removed */
+    if (stat( dir, &st )) st.st_mtime = 0;
+    *stamp = (*stamp * 0x100000001b3ull) ^ (ULONGLONG)st.st_mtime;
+}
+
+static void fontconfig_update_font_stamp( ULONGLONG *stamp )
+{
+    FcStrList *dir_list;
+    const FcChar8 *dir;
+    FcConfig *config;
+
+    if (!fontconfig_enabled) return;
+    if (!(config = pFcConfigGetCurrent())) return;
+    /* this also lists the subdirectories fontconfig found below the configured ones */
+    if (!(dir_list = pFcConfigGetFontDirs( config ))) return;
+    while ((dir = pFcStrListNext( dir_list ))) add_dir_to_font_stamp( (const char *)dir, stamp );
+    pFcStrListDone( dir_list );
+}
+
 #elif defined(HAVE_CARBON_CARBON_H)
 
 static void load_mac_font_callback(const void *value, void *context)
@@ -1938,6 +1963,19 @@ static void freetype_load_fonts(void)
 #endif
 }
 
+/*************************************************************
+ * freetype_update_font_stamp
+ *
+ * Mix the state of the font directories loaded by freetype_load_fonts into
+ * the stamp of the font database.
+ */
+static void freetype_update_font_stamp( ULONGLONG *stamp )
+{
+#ifdef SONAME_LIBFONTCONFIG
+    fontconfig_update_font_stamp( stamp );
+#endif
+}
+
 /* Some fonts have large usWinDescent values, as a result of storing signed short
    in unsigned field. That's probably caused by sTypoDescent vs usWinDescent confusion in
    some font generation tools. */
@@ -4268,6 +4306,7 @@ static DWORD freetype_get_kerning_pairs( struct gdi_font *font, KERNINGPAIR **pa
 static const struct font_backend_funcs font_funcs =
 {
     freetype_load_fonts,
+    freetype_update_font_stamp,
     fontconfig_enum_family_fallbacks,
     freetype_add_font,
     freetype_add_mem_font,
@@ -1200,6 +1200,7 @@ NTSTATUS gdi_init(void)
     NtQuerySystemInformation( SystemBasicInformation, &system_info, sizeof(system_info), NULL );
     init_gdi_shared();
     if (!gdi_shared) return STATUS_NO_MEMORY;
+    init_dib_simd();
 
     dpi = font_init();
     init_stock_objects( dpi );
@@ -206,6 +206,7 @@ extern UINT get_dib_dc_color_table( HDC hdc, UINT startpos, UINT entries,
 extern UINT set_dib_dc_color_table( HDC hdc, UINT startpos, UINT entries,
                                     const RGBQUAD *colors ) DECLSPEC_HIDDEN;
 extern void dibdrv_set_window_surface( DC *dc, struct window_surface *surface ) DECLSPEC_HIDDEN;
+extern void init_dib_simd(void) DECLSPEC_HIDDEN;
 
 /* driver.c */
 extern const struct gdi_dc_funcs null_driver DECLSPEC_HIDDEN;
@@ -302,6 +303,7 @@ struct gdi_font
 struct font_backend_funcs
 {
     void  (*load_fonts)(void);
+    void  (*update_font_stamp)( ULONGLONG *stamp );
     BOOL  (*enum_family_fallbacks)( DWORD pitch_and_family, int index, WCHAR buffer[LF_FACESIZE] );
     INT   (*add_font)( const WCHAR *file, DWORD flags );
     INT   (*add_mem_font)( void *ptr, SIZE_T size, DWORD flags );
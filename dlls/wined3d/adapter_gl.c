@@ -90,6 +90,7 @@ static const struct wined3d_extension_map gl_extension_map[] =
     {"GL_ARB_framebuffer_object",           ARB_FRAMEBUFFER_OBJECT        },
     {"GL_ARB_framebuffer_sRGB",             ARB_FRAMEBUFFER_SRGB          },
     {"GL_ARB_geometry_shader4",             ARB_GEOMETRY_SHADER4          },
+    {"GL_ARB_get_program_binary",           ARB_GET_PROGRAM_BINARY        },
     {"GL_ARB_gpu_shader5",                  ARB_GPU_SHADER5               },
     {"GL_ARB_half_float_pixel",             ARB_HALF_FLOAT_PIXEL          },
     {"GL_ARB_half_float_vertex",            ARB_HALF_FLOAT_VERTEX         },
@@ -2201,6 +2202,10 @@ static void load_gl_funcs(struct wined3d_gl_info *gl_info)
     USE_GL_FUNC(glFramebufferTextureFaceARB)
     USE_GL_FUNC(glFramebufferTextureLayerARB)
     USE_GL_FUNC(glProgramParameteriARB)
+    /* GL_ARB_get_program_binary */
+    USE_GL_FUNC(glGetProgramBinary)
+    USE_GL_FUNC(glProgramBinary)
+    USE_GL_FUNC(glProgramParameteri)
     /* GL_ARB_instanced_arrays */
     USE_GL_FUNC(glVertexAttribDivisorARB)
     /* GL_ARB_internalformat_query */
@@ -2919,6 +2924,7 @@ static void wined3d_adapter_init_limits(struct wined3d_gl_info *gl_info)
     gl_info->limits.graphics_samplers = gl_info->limits.combined_samplers;
     gl_info->limits.vertex_attribs = 16;
     gl_info->limits.texture_buffer_offset_alignment = 1;
+    gl_info->limits.uniform_buffer_offset_alignment = 1;
     gl_info->limits.glsl_vs_float_constants = 0;
     gl_info->limits.glsl_ps_float_constants = 0;
     gl_info->limits.arb_vs_float_constants = 0;
@@ -3190,6 +3196,12 @@ static void wined3d_adapter_init_limits(struct wined3d_gl_info *gl_info)
         gl_info->gl_ops.gl.p_glGetIntegerv(GL_MAX_UNIFORM_BUFFER_BINDINGS, &gl_max);
         TRACE("Max uniform buffer bindings: %d.\n", gl_max);
     }
+    if (gl_info->supported[ARB_UNIFORM_BUFFER_OBJECT])
+    {
+        gl_info->gl_ops.gl.p_glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &gl_max);
+        gl_info->limits.uniform_buffer_offset_alignment = gl_max;
+        TRACE("Minimum required uniform buffer offset alignment %d.\n", gl_max);
+    }
     if (gl_info->supported[ARB_TEXTURE_BUFFER_RANGE])
     {
         gl_info->gl_ops.gl.p_glGetIntegerv(GL_TEXTURE_BUFFER_OFFSET_ALIGNMENT, &gl_max);
@@ -3369,6 +3381,7 @@ static BOOL wined3d_adapter_init_gl_caps(struct wined3d_adapter *adapter,
         {ARB_TRANSFORM_FEEDBACK3,          MAKEDWORD_VERSION(4, 0)},
 
         {ARB_ES2_COMPATIBILITY,            MAKEDWORD_VERSION(4, 1)},
+        {ARB_GET_PROGRAM_BINARY,           MAKEDWORD_VERSION(4, 1)},
         {ARB_VIEWPORT_ARRAY,               MAKEDWORD_VERSION(4, 1)},
 
         {ARB_BASE_INSTANCE,                MAKEDWORD_VERSION(4, 2)},
@@ -4624,10 +4637,124 @@ static void adapter_gl_flush_bo_address(struct wined3d_context *context,
     wined3d_context_gl_flush_bo_address(wined3d_context_gl(context), data, size);
 }
 
+static void adapter_gl_create_bo_ring_block_cs(void *object)
+{
+    struct wined3d_device *device = object;
+    struct wined3d_context_gl *context_gl;
+    struct wined3d_bo_address addr;
+    struct wined3d_context *context;
+    struct wined3d_bo_gl *bo_gl;
+
+    TRACE("device %p.\n", device);
+
+    if (!(bo_gl = heap_alloc(sizeof(*bo_gl))))
+    {
+        wined3d_bo_ring_add_block(&device->bo_ring, NULL, 0);
+        return;
+    }
+
+    context = context_acquire(device, NULL, 0);
+    context_gl = wined3d_context_gl(context);
+    if (!wined3d_context_gl_create_bo(context_gl, WINED3D_BO_RING_BLOCK_SIZE, GL_ARRAY_BUFFER,
+            GL_STREAM_DRAW, true, GL_MAP_WRITE_BIT | GL_CLIENT_STORAGE_BIT, bo_gl))
+    {
+        ERR("Failed to create ring block.\n");
+        heap_free(bo_gl);
+        bo_gl = NULL;
+    }
+    else
+    {
+        addr.buffer_object = &bo_gl->b;
+        addr.addr = NULL;
+        if (!wined3d_context_gl_map_bo_address(context_gl, &addr, WINED3D_BO_RING_BLOCK_SIZE,
+                WINED3D_MAP_WRITE | WINED3D_MAP_NOOVERWRITE) || !bo_gl->b.map_ptr)
+        {
+            ERR("Failed to persistently map ring block.\n");
+            wined3d_context_gl_destroy_bo(context_gl, bo_gl);
+            heap_free(bo_gl);
+            bo_gl = NULL;
+        }
+    }
+    context_release(context);
+
+    wined3d_bo_ring_add_block(&device->bo_ring, bo_gl ? &bo_gl->b : NULL, WINED3D_BO_RING_BLOCK_SIZE);
+}
+
+static bool adapter_gl_suballoc_ring_bo(struct wined3d_device *device,
+        size_t size, struct wined3d_bo_address *addr)
+{
+    const struct wined3d_gl_info *gl_info = &device->adapter->gl_info;
+    struct wined3d_bo_ring *ring = &device->bo_ring;
+    struct wined3d_bo_ring_block *block;
+    struct wined3d_bo_gl *bo_gl;
+    size_t offset;
+
+    /* Ring blocks can only be created on the CS thread. If there's no room
+     * left, queue the creation of a new block and let this map go through
+     * the CS; subsequent maps will use the new block. */
+    if (!wined3d_bo_ring_suballoc(ring, size, gl_info->limits.uniform_buffer_offset_alignment, &block, &offset))
+    {
+        if (wined3d_bo_ring_reserve_block(ring))
+            wined3d_cs_init_object(device->cs, adapter_gl_create_bo_ring_block_cs, device);
+        return false;
+    }
+
+    if (!(bo_gl = heap_alloc(sizeof(*bo_gl))))
+    {
+        wined3d_bo_ring_release(ring, block, 0);
+        return false;
+    }
+
+    *bo_gl = *wined3d_bo_gl(block->bo);
+    list_init(&bo_gl->b.users);
+    bo_gl->b.buffer_offset = offset;
+    bo_gl->b.memory_offset = offset;
+    bo_gl->b.ring_block = block;
+    bo_gl->size = size;
+    bo_gl->command_fence_id = 0;
+
+    TRACE("Suballocated bo %p at offset %#lx from buffer %u.\n", bo_gl, (unsigned long)offset, bo_gl->id);
+
+    addr->buffer_object = &bo_gl->b;
+    addr->addr = NULL;
+    return true;
+}
+
 static bool adapter_gl_alloc_bo(struct wined3d_device *device, struct wined3d_resource *resource,
         unsigned int sub_resource_idx, struct wined3d_bo_address *addr)
 {
-    return false;
+    const struct wined3d_d3d_info *d3d_info = &device->adapter->d3d_info;
+    const struct wined3d_gl_info *gl_info = &device->adapter->gl_info;
+
+    wined3d_not_from_cs(device->cs);
+
+    if (!gl_info->supported[ARB_BUFFER_STORAGE] || !wined3d_resource_is_streaming_buffer(resource))
+        return false;
+
+    /* Buffers that may need vertex conversion can't simply be renamed. */
+    if (!d3d_info->xyzrhw || !(d3d_info->vertex_bgra || d3d_info->ffp_generic_attributes))
+        return false;
+
+    return adapter_gl_suballoc_ring_bo(device, resource->size, addr);
+}
+
+static bool adapter_gl_alloc_upload_bo(struct wined3d_device *device, struct wined3d_resource *resource,
+        unsigned int sub_resource_idx, size_t size, struct wined3d_bo_address *addr)
+{
+    const struct wined3d_gl_info *gl_info = &device->adapter->gl_info;
+    const struct wined3d_format *format = resource->format;
+
+    wined3d_not_from_cs(device->cs);
+
+    if (!gl_info->supported[ARB_BUFFER_STORAGE] || !gl_info->supported[ARB_PIXEL_BUFFER_OBJECT])
+        return false;
+
+    /* Converted uploads read the source back on the CPU, which the write-only
+     * ring mapping doesn't allow. */
+    if (format->upload || (resource->format_flags & WINED3DFMT_FLAG_DECOMPRESS))
+        return false;
+
+    return adapter_gl_suballoc_ring_bo(device, size, addr);
 }
 
 static void adapter_gl_destroy_bo(struct wined3d_context *context, struct wined3d_bo *bo)
@@ -5089,6 +5216,7 @@ static const struct wined3d_adapter_ops wined3d_adapter_gl_ops =
     .adapter_copy_bo_address = adapter_gl_copy_bo_address,
     .adapter_flush_bo_address = adapter_gl_flush_bo_address,
     .adapter_alloc_bo = adapter_gl_alloc_bo,
+    .adapter_alloc_upload_bo = adapter_gl_alloc_upload_bo,
     .adapter_destroy_bo = adapter_gl_destroy_bo,
     .adapter_create_swapchain = adapter_gl_create_swapchain,
     .adapter_destroy_swapchain = adapter_gl_destroy_swapchain,
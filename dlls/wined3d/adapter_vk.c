@@ -753,6 +753,7 @@ static void adapter_vk_uninit_3d_cs(void *object)
         wined3d_device_vk_uav_clear_state_cleanup(device_vk);
     device->blitter->ops->blitter_destroy(device->blitter, NULL);
     device->shader_backend->shader_free_private(device, &context_vk->c);
+    wined3d_bo_ring_destroy_blocks(&device->bo_ring, &context_vk->c);
     wined3d_device_vk_destroy_null_views(device_vk, context_vk);
     wined3d_device_vk_destroy_null_resources(device_vk, context_vk);
 }
@@ -974,6 +975,7 @@ static void *adapter_vk_map_bo_address(struct wined3d_context *context,
             bool host_synced = bo->host_synced;
             list_move_head(&tmp.b.users, &bo->b.users);
             wined3d_context_vk_destroy_bo(context_vk, bo);
+            wined3d_bo_ring_add_stats(&device_vk->d.bo_ring, 1, 0);
             *bo = tmp;
             bo->host_synced = host_synced;
             list_init(&bo->b.users);
@@ -1216,6 +1218,66 @@ static void adapter_vk_flush_bo_address(struct wined3d_context *context,
     flush_bo_range(context_vk, wined3d_bo_vk(bo), (uintptr_t)data->addr, size);
 }
 
+static struct wined3d_bo_vk *wined3d_device_vk_suballoc_ring_bo(struct wined3d_device_vk *device_vk, size_t size)
+{
+    const VkPhysicalDeviceLimits *limits = &wined3d_adapter_vk(device_vk->d.adapter)->device_limits;
+    struct wined3d_context_vk *context_vk = &device_vk->context_vk;
+    struct wined3d_bo_ring *ring = &device_vk->d.bo_ring;
+    struct wined3d_bo_ring_block *block;
+    struct wined3d_bo_vk *bo_vk;
+    size_t offset, alignment;
+
+    alignment = max(WINED3D_SLAB_BO_MIN_OBJECT_ALIGN, limits->minUniformBufferOffsetAlignment);
+    while (!wined3d_bo_ring_suballoc(ring, size, alignment, &block, &offset))
+    {
+        if (!wined3d_bo_ring_reserve_block(ring))
+            return NULL;
+
+        if (!(bo_vk = heap_alloc(sizeof(*bo_vk))))
+        {
+            wined3d_bo_ring_add_block(ring, NULL, 0);
+            return NULL;
+        }
+
+        if (!wined3d_context_vk_create_bo(context_vk, WINED3D_BO_RING_BLOCK_SIZE,
+                vk_buffer_usage_from_bind_flags(WINED3D_BIND_VERTEX_BUFFER
+                | WINED3D_BIND_INDEX_BUFFER | WINED3D_BIND_CONSTANT_BUFFER),
+                VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT, bo_vk))
+        {
+            ERR("Failed to create ring block.\n");
+            heap_free(bo_vk);
+            wined3d_bo_ring_add_block(ring, NULL, 0);
+            return NULL;
+        }
+
+        if (!wined3d_bo_vk_map(bo_vk, context_vk))
+            ERR("Failed to map ring block.\n");
+
+        wined3d_bo_ring_add_block(ring, &bo_vk->b, WINED3D_BO_RING_BLOCK_SIZE);
+    }
+
+    if (!(bo_vk = heap_alloc(sizeof(*bo_vk))))
+    {
+        wined3d_bo_ring_release(ring, block, 0);
+        return NULL;
+    }
+
+    *bo_vk = *wined3d_bo_vk(block->bo);
+    list_init(&bo_vk->b.users);
+    bo_vk->b.buffer_offset = offset;
+    bo_vk->b.memory_offset = block->bo->memory_offset + offset;
+    bo_vk->b.ring_block = block;
+    bo_vk->memory = NULL;
+    bo_vk->size = size;
+    bo_vk->command_buffer_id = 0;
+    bo_vk->host_synced = false;
+
+    TRACE("Suballocated bo %p at offset 0x%s from buffer 0x%s.\n", bo_vk,
+            wine_dbgstr_longlong(offset), wine_dbgstr_longlong(bo_vk->vk_buffer));
+
+    return bo_vk;
+}
+
 static bool adapter_vk_alloc_bo(struct wined3d_device *device, struct wined3d_resource *resource,
         unsigned int sub_resource_idx, struct wined3d_bo_address *addr)
 {
@@ -1229,6 +1291,14 @@ static bool adapter_vk_alloc_bo(struct wined3d_device *device, struct wined3d_re
     {
         struct wined3d_bo_vk *bo_vk;
 
+        if (wined3d_resource_is_streaming_buffer(resource)
+                && (bo_vk = wined3d_device_vk_suballoc_ring_bo(device_vk, resource->size)))
+        {
+            addr->buffer_object = &bo_vk->b;
+            addr->addr = NULL;
+            return true;
+        }
+
         if (!(bo_vk = heap_alloc(sizeof(*bo_vk))))
             return false;
 
@@ -1240,6 +1310,7 @@ static bool adapter_vk_alloc_bo(struct wined3d_device *device, struct wined3d_re
             heap_free(bo_vk);
             return false;
         }
+        wined3d_bo_ring_add_stats(&device->bo_ring, 1, 0);
 
         if (!bo_vk->b.map_ptr)
         {
@@ -1258,6 +1329,22 @@ static bool adapter_vk_alloc_bo(struct wined3d_device *device, struct wined3d_re
     return false;
 }
 
+static bool adapter_vk_alloc_upload_bo(struct wined3d_device *device, struct wined3d_resource *resource,
+        unsigned int sub_resource_idx, size_t size, struct wined3d_bo_address *addr)
+{
+    struct wined3d_bo_vk *bo_vk;
+
+    wined3d_not_from_cs(device->cs);
+    assert(device->context_count);
+
+    if (!(bo_vk = wined3d_device_vk_suballoc_ring_bo(wined3d_device_vk(device), size)))
+        return false;
+
+    addr->buffer_object = &bo_vk->b;
+    addr->addr = NULL;
+    return true;
+}
+
 static void adapter_vk_destroy_bo(struct wined3d_context *context, struct wined3d_bo *bo)
 {
     wined3d_context_vk_destroy_bo(wined3d_context_vk(context), wined3d_bo_vk(bo));
@@ -1916,6 +2003,7 @@ static const struct wined3d_adapter_ops wined3d_adapter_vk_ops =
     .adapter_copy_bo_address = adapter_vk_copy_bo_address,
     .adapter_flush_bo_address = adapter_vk_flush_bo_address,
     .adapter_alloc_bo = adapter_vk_alloc_bo,
+    .adapter_alloc_upload_bo = adapter_vk_alloc_upload_bo,
     .adapter_destroy_bo = adapter_vk_destroy_bo,
     .adapter_create_swapchain = adapter_vk_create_swapchain,
     .adapter_destroy_swapchain = adapter_vk_destroy_swapchain,
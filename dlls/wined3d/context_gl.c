@@ -2627,6 +2627,8 @@ static void wined3d_context_gl_poll_fences(struct wined3d_context_gl *context_gl
             *f = context_gl->submitted.fences[context_gl->submitted.fence_count - 1];
         --context_gl->submitted.fence_count;
     }
+
+    wined3d_bo_ring_set_completed_id(&device_gl->d.bo_ring, device_gl->completed_fence_id);
 }
 
 void wined3d_context_gl_wait_command_fence(struct wined3d_context_gl *context_gl, uint64_t id)
@@ -2668,6 +2670,8 @@ void wined3d_context_gl_submit_command_fence(struct wined3d_context_gl *context_
     if (FAILED(hr = wined3d_fence_create(&device_gl->d, &f->fence)))
         ERR("Failed to create fence, hr %#x.\n", hr);
     wined3d_fence_issue(f->fence, &device_gl->d);
+    if (device_gl->d.cs->profiler)
+        wined3d_profiler_submit(device_gl->d.cs->profiler);
 
     /* We don't expect this to ever happen, but handle it anyway. */
     if (!++device_gl->current_fence_id)
@@ -2697,6 +2701,7 @@ static void *wined3d_bo_gl_map(struct wined3d_bo_gl *bo, struct wined3d_context_
         {
             list_move_head(&tmp.b.users, &bo->b.users);
             wined3d_context_gl_destroy_bo(context_gl, bo);
+            wined3d_bo_ring_add_stats(&device_gl->d.bo_ring, 1, 0);
             *bo = tmp;
             list_init(&bo->b.users);
             list_move_head(&bo->b.users, &tmp.b.users);
@@ -2927,6 +2932,15 @@ void wined3d_context_gl_destroy_bo(struct wined3d_context_gl *context_gl, struct
 
     TRACE("context_gl %p, bo %p.\n", context_gl, bo);
 
+    if (bo->b.ring_block)
+    {
+        TRACE("Releasing suballocation %#lx from GL buffer %u.\n", (unsigned long)bo->b.buffer_offset, bo->id);
+        wined3d_bo_ring_release(&context_gl->c.device->bo_ring, bo->b.ring_block, bo->command_fence_id);
+        bo->b.ring_block = NULL;
+        bo->id = 0;
+        return;
+    }
+
     TRACE("Destroying GL buffer %u.\n", bo->id);
     GL_EXTCALL(glDeleteBuffers(1, &bo->id));
     checkGLcall("buffer object destruction");
@@ -2982,6 +2996,7 @@ bool wined3d_context_gl_create_bo(struct wined3d_context_gl *context_gl, GLsizei
     bo->b.memory_offset = 0;
     bo->b.buffer_offset = 0;
     bo->b.map_ptr = NULL;
+    bo->b.ring_block = NULL;
 
     return true;
 }
@@ -543,6 +543,7 @@ BOOL wined3d_context_vk_create_bo(struct wined3d_context_vk *context_vk, VkDevic
     bo->command_buffer_id = 0;
     bo->slab = NULL;
     bo->host_synced = false;
+    bo->b.ring_block = NULL;
 
     TRACE("Created buffer 0x%s, memory 0x%s for bo %p.\n",
             wine_dbgstr_longlong(bo->vk_buffer), wine_dbgstr_longlong(bo->vk_memory), bo);
@@ -953,6 +954,12 @@ void wined3d_context_vk_destroy_bo(struct wined3d_context_vk *context_vk, const
 
     TRACE("context_vk %p, bo %p.\n", context_vk, bo);
 
+    if (bo->b.ring_block)
+    {
+        wined3d_bo_ring_release(&device_vk->d.bo_ring, bo->b.ring_block, bo->command_buffer_id);
+        return;
+    }
+
     if (bo->command_buffer_id == context_vk->current_command_buffer.id)
         context_vk->retired_bo_size += bo->size;
 
@@ -1006,6 +1013,8 @@ void wined3d_context_vk_poll_command_buffers(struct wined3d_context_vk *context_
             context_vk->completed_command_buffer_id = buffer->id;
         *buffer = context_vk->submitted.buffers[--context_vk->submitted.buffer_count];
     }
+
+    wined3d_bo_ring_set_completed_id(&device_vk->d.bo_ring, context_vk->completed_command_buffer_id);
 }
 
 static void wined3d_context_vk_cleanup_resources(struct wined3d_context_vk *context_vk)
@@ -1678,6 +1687,9 @@ void wined3d_context_vk_submit_command_buffer(struct wined3d_context_vk *context
     TRACE("Submitting command buffer %p with id 0x%s.\n",
             buffer->vk_command_buffer, wine_dbgstr_longlong(buffer->id));
 
+    if (device_vk->d.cs->profiler)
+        wined3d_profiler_submit(device_vk->d.cs->profiler);
+
     wined3d_context_vk_end_current_render_pass(context_vk);
 
     LIST_FOR_EACH_ENTRY(query_vk, &context_vk->active_queries, struct wined3d_query_vk, entry)
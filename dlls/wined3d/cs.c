@@ -20,10 +20,12 @@
 #include "wined3d_private.h"
 
 WINE_DEFAULT_DEBUG_CHANNEL(d3d);
+WINE_DECLARE_DEBUG_CHANNEL(d3d_perf);
 WINE_DECLARE_DEBUG_CHANNEL(d3d_sync);
 WINE_DECLARE_DEBUG_CHANNEL(fps);
 
 #define WINED3D_INITIAL_CS_SIZE 4096
+#define WINED3D_CS_CHUNK_SIZE 0x4000
 
 struct wined3d_deferred_upload
 {
@@ -40,14 +42,26 @@ struct wined3d_deferred_query_issue
     unsigned int flags;
 };
 
+/* Deferred contexts record into a list of chunks. Recording a command list
+ * transfers the chunks to it, and the CS thread executes them in place.
+ * Chunks of the default size are recycled through a lock-free list on the
+ * CS, since they are allocated by recording threads and released by the CS
+ * thread. */
+struct wined3d_cs_chunk
+{
+    SLIST_ENTRY entry;
+    struct wined3d_cs_chunk *next;
+    SIZE_T size, capacity;
+    BYTE data[1];
+};
+
 struct wined3d_command_list
 {
     LONG refcount;
 
     struct wined3d_device *device;
 
-    SIZE_T data_size;
-    void *data;
+    struct wined3d_cs_chunk *chunks;
 
     SIZE_T resource_count;
     struct wined3d_resource **resources;
@@ -81,61 +95,6 @@ static void invalidate_client_address(struct wined3d_resource *resource)
     memset(&client->addr, 0, sizeof(client->addr));
 }
 
-enum wined3d_cs_op
-{
-    WINED3D_CS_OP_NOP,
-    WINED3D_CS_OP_PRESENT,
-    WINED3D_CS_OP_CLEAR,
-    WINED3D_CS_OP_DISPATCH,
-    WINED3D_CS_OP_DRAW,
-    WINED3D_CS_OP_FLUSH,
-    WINED3D_CS_OP_SET_PREDICATION,
-    WINED3D_CS_OP_SET_VIEWPORTS,
-    WINED3D_CS_OP_SET_SCISSOR_RECTS,
-    WINED3D_CS_OP_SET_RENDERTARGET_VIEWS,
-    WINED3D_CS_OP_SET_DEPTH_STENCIL_VIEW,
-    WINED3D_CS_OP_SET_VERTEX_DECLARATION,
-    WINED3D_CS_OP_SET_STREAM_SOURCES,
-    WINED3D_CS_OP_SET_STREAM_OUTPUTS,
-    WINED3D_CS_OP_SET_INDEX_BUFFER,
-    WINED3D_CS_OP_SET_CONSTANT_BUFFERS,
-    WINED3D_CS_OP_SET_TEXTURE,
-    WINED3D_CS_OP_SET_SHADER_RESOURCE_VIEWS,
-    WINED3D_CS_OP_SET_UNORDERED_ACCESS_VIEWS,
-    WINED3D_CS_OP_SET_SAMPLERS,
-    WINED3D_CS_OP_SET_SHADER,
-    WINED3D_CS_OP_SET_BLEND_STATE,
-    WINED3D_CS_OP_SET_DEPTH_STENCIL_STATE,
-    WINED3D_CS_OP_SET_RASTERIZER_STATE,
-    WINED3D_CS_OP_SET_RENDER_STATE,
-    WINED3D_CS_OP_SET_TEXTURE_STATE,
-    WINED3D_CS_OP_SET_SAMPLER_STATE,
-    WINED3D_CS_OP_SET_DEPTH_BOUNDS,
-    WINED3D_CS_OP_SET_TRANSFORM,
-    WINED3D_CS_OP_SET_CLIP_PLANE,
-    WINED3D_CS_OP_SET_COLOR_KEY,
-    WINED3D_CS_OP_SET_MATERIAL,
-    WINED3D_CS_OP_SET_LIGHT,
-    WINED3D_CS_OP_SET_LIGHT_ENABLE,
-    WINED3D_CS_OP_SET_FEATURE_LEVEL,
-    WINED3D_CS_OP_PUSH_CONSTANTS,
-    WINED3D_CS_OP_RESET_STATE,
-    WINED3D_CS_OP_CALLBACK,
-    WINED3D_CS_OP_QUERY_ISSUE,
-    WINED3D_CS_OP_PRELOAD_RESOURCE,
-    WINED3D_CS_OP_UNLOAD_RESOURCE,
-    WINED3D_CS_OP_MAP,
-    WINED3D_CS_OP_UNMAP,
-    WINED3D_CS_OP_BLT_SUB_RESOURCE,
-    WINED3D_CS_OP_UPDATE_SUB_RESOURCE,
-    WINED3D_CS_OP_ADD_DIRTY_TEXTURE_REGION,
-    WINED3D_CS_OP_CLEAR_UNORDERED_ACCESS_VIEW,
-    WINED3D_CS_OP_COPY_UAV_COUNTER,
-    WINED3D_CS_OP_GENERATE_MIPMAPS,
-    WINED3D_CS_OP_EXECUTE_COMMAND_LIST,
-    WINED3D_CS_OP_STOP,
-};
-
 struct wined3d_cs_packet
 {
     size_t size;
@@ -647,6 +606,42 @@ static struct wined3d_cs_packet *wined3d_next_cs_packet(const uint8_t *data, SIZ
     return packet;
 }
 
+static struct wined3d_cs_chunk *wined3d_cs_get_chunk(struct wined3d_cs *cs, SIZE_T size)
+{
+    struct wined3d_cs_chunk *chunk = NULL;
+    SIZE_T capacity;
+
+    if (size <= WINED3D_CS_CHUNK_SIZE)
+        chunk = (struct wined3d_cs_chunk *)InterlockedPopEntrySList(&cs->chunk_pool);
+
+    if (!chunk)
+    {
+        capacity = max(size, WINED3D_CS_CHUNK_SIZE);
+        if (!(chunk = heap_alloc(offsetof(struct wined3d_cs_chunk, data[capacity]))))
+            return NULL;
+        chunk->capacity = capacity;
+    }
+
+    chunk->next = NULL;
+    chunk->size = 0;
+
+    return chunk;
+}
+
+static void wined3d_cs_release_chunks(struct wined3d_cs *cs, struct wined3d_cs_chunk *chunk)
+{
+    struct wined3d_cs_chunk *next;
+
+    for (; chunk; chunk = next)
+    {
+        next = chunk->next;
+        if (chunk->capacity == WINED3D_CS_CHUNK_SIZE)
+            InterlockedPushEntrySList(&cs->chunk_pool, &chunk->entry);
+        else
+            heap_free(chunk);
+    }
+}
+
 static void wined3d_cs_exec_nop(struct wined3d_cs *cs, const void *data)
 {
 }
@@ -700,6 +695,8 @@ static void wined3d_cs_exec_present(struct wined3d_cs *cs, const void *data)
     }
 
     swapchain->swapchain_ops->swapchain_present(swapchain, &op->src_rect, &op->dst_rect, op->swap_interval, op->flags);
+    if (cs->profiler)
+        wined3d_profiler_present(cs->profiler);
 
     /* Discard buffers if the swap effect allows it. */
     back_buffer = swapchain->back_buffers[desc->backbuffer_count - 1];
@@ -729,6 +726,31 @@ static void wined3d_cs_exec_present(struct wined3d_cs *cs, const void *data)
         }
     }
 
+    if (swapchain->device->shader_stall_count)
+    {
+        struct wined3d_device *device = swapchain->device;
+
+        if (TRACE_ON(d3d_perf))
+        {
+            LARGE_INTEGER freq;
+
+            QueryPerformanceFrequency(&freq);
+            TRACE_(d3d_perf)("%p: Frame stalled %.3f ms on %u shader compilation(s).\n", swapchain,
+                    1000.0 * device->shader_stall_time / freq.QuadPart, device->shader_stall_count);
+        }
+        device->shader_stall_time = 0;
+        device->shader_stall_count = 0;
+    }
+
+    {
+        struct wined3d_bo_stats stats;
+
+        wined3d_bo_ring_get_stats(&swapchain->device->bo_ring, &stats);
+        if (stats.alloc_count || stats.suballoc_count || stats.mapped_bytes)
+            TRACE_(d3d_perf)("%p: Frame mapped 0x%s bytes, %u bo allocation(s), %u ring suballocation(s).\n",
+                    swapchain, wine_dbgstr_longlong(stats.mapped_bytes), stats.alloc_count, stats.suballoc_count);
+    }
+
     wined3d_resource_release(&swapchain->front_buffer->resource);
     for (i = 0; i < desc->backbuffer_count; ++i)
     {
@@ -738,6 +760,32 @@ static void wined3d_cs_exec_present(struct wined3d_cs *cs, const void *data)
     InterlockedDecrement(&cs->pending_presents);
 }
 
+static void wined3d_cs_report_op_counts(struct wined3d_cs *cs)
+{
+    unsigned int i, emitted = 0, filtered = 0;
+
+    if (TRACE_ON(d3d_perf))
+    {
+        for (i = 0; i <= WINED3D_CS_OP_STOP; ++i)
+        {
+            emitted += cs->emitted_op_count[i];
+            filtered += cs->filtered_op_count[i];
+        }
+
+        TRACE_(d3d_perf)("%p: Frame emitted %u packet(s), filtered %u redundant packet(s).\n",
+                cs, emitted, filtered);
+        for (i = 0; i <= WINED3D_CS_OP_STOP; ++i)
+        {
+            if (cs->emitted_op_count[i] || cs->filtered_op_count[i])
+                TRACE_(d3d_perf)("    %s: %u emitted, %u filtered.\n", debug_cs_op(i),
+                        cs->emitted_op_count[i], cs->filtered_op_count[i]);
+        }
+    }
+
+    memset(cs->emitted_op_count, 0, sizeof(cs->emitted_op_count));
+    memset(cs->filtered_op_count, 0, sizeof(cs->filtered_op_count));
+}
+
 void wined3d_cs_emit_present(struct wined3d_cs *cs, struct wined3d_swapchain *swapchain,
         const RECT *src_rect, const RECT *dst_rect, HWND dst_window_override,
         unsigned int swap_interval, DWORD flags)
@@ -746,6 +794,8 @@ void wined3d_cs_emit_present(struct wined3d_cs *cs, struct wined3d_swapchain *sw
     unsigned int i;
     LONG pending;
 
+    wined3d_cs_report_op_counts(cs);
+
     op = wined3d_device_context_require_space(&cs->c, sizeof(*op), WINED3D_CS_QUEUE_DEFAULT);
     op->opcode = WINED3D_CS_OP_PRESENT;
     op->dst_window_override = dst_window_override;
@@ -2787,6 +2837,8 @@ static void wined3d_cs_exec_update_sub_resource(struct wined3d_cs *cs, const voi
         wined3d_texture_load_location(texture, op->sub_resource_idx, context, WINED3D_LOCATION_TEXTURE_RGB);
 
     wined3d_box_set(&src_box, 0, 0, box->right - box->left, box->bottom - box->top, 0, box->back - box->front);
+    if ((op->bo.flags & UPLOAD_BO_FREE_ON_UPLOAD) && !op->bo.addr.buffer_object->coherent)
+        wined3d_context_flush_bo_address(context, &op->bo.addr, op->slice_pitch * src_box.back);
     texture->texture_ops->texture_upload_data(context, &op->bo.addr, texture->resource.format, &src_box,
             op->row_pitch, op->slice_pitch, texture, op->sub_resource_idx,
             WINED3D_LOCATION_TEXTURE_RGB, box->left, box->top, box->front);
@@ -2794,12 +2846,74 @@ static void wined3d_cs_exec_update_sub_resource(struct wined3d_cs *cs, const voi
     wined3d_texture_validate_location(texture, op->sub_resource_idx, WINED3D_LOCATION_TEXTURE_RGB);
     wined3d_texture_invalidate_location(texture, op->sub_resource_idx, ~WINED3D_LOCATION_TEXTURE_RGB);
 
+    /* The staging bo is recycled once the GPU is done reading from it. */
+    if (op->bo.flags & UPLOAD_BO_FREE_ON_UPLOAD)
+    {
+        wined3d_context_destroy_bo(context, op->bo.addr.buffer_object);
+        heap_free(op->bo.addr.buffer_object);
+    }
+
 done:
     context_release(context);
 
     wined3d_resource_release(resource);
 }
 
+/* Copies texture update data into a staging bo suballocated from the
+ * device's bo ring, so that the application's pointer can be released
+ * without waiting for the CS to consume it. */
+static bool wined3d_cs_upload_staging(struct wined3d_device_context *context, struct wined3d_resource *resource,
+        unsigned int sub_resource_idx, const struct wined3d_box *box, const void *data,
+        unsigned int row_pitch, unsigned int slice_pitch)
+{
+    const struct wined3d_format *format = resource->format;
+    struct wined3d_device *device = context->device;
+    unsigned int staging_row_pitch, staging_slice_pitch;
+    unsigned int width, height, depth;
+    struct wined3d_bo_address addr;
+    struct wined3d_bo *staging_bo;
+    struct upload_bo bo;
+    uint8_t *map_ptr;
+    size_t size;
+
+    /* Only the immediate context is fenced against the ring. Suballocations
+     * are aligned for texel blocks of up to 16 bytes. */
+    if (context != &device->cs->c || !wined3d_map_persistent()
+            || format->block_byte_count & (format->block_byte_count - 1))
+        return false;
+
+    width = box->right - box->left;
+    height = box->bottom - box->top;
+    depth = box->back - box->front;
+    wined3d_format_calculate_pitch(format, 1, width, height, &staging_row_pitch, &staging_slice_pitch);
+    size = (size_t)staging_slice_pitch * depth;
+
+    if (!device->adapter->adapter_ops->adapter_alloc_upload_bo(device, resource, sub_resource_idx, size, &addr))
+        return false;
+
+    staging_bo = addr.buffer_object;
+    if (!(map_ptr = staging_bo->map_ptr))
+    {
+        ERR("Staging bo %p is not mapped.\n", staging_bo);
+        wined3d_bo_ring_release(&device->bo_ring, staging_bo->ring_block, 0);
+        heap_free(staging_bo);
+        return false;
+    }
+    map_ptr += staging_bo->memory_offset;
+
+    wined3d_format_copy_data(format, data, row_pitch, slice_pitch, map_ptr,
+            staging_row_pitch, staging_slice_pitch, width, height, depth);
+    wined3d_bo_ring_add_stats(&device->bo_ring, 0, size);
+
+    bo.addr = *wined3d_const_bo_address(&addr);
+    bo.flags = UPLOAD_BO_FREE_ON_UPLOAD;
+
+    TRACE("Uploading through staging bo %p.\n", staging_bo);
+    wined3d_device_context_upload_bo(context, resource, sub_resource_idx, box,
+            &bo, staging_row_pitch, staging_slice_pitch);
+    return true;
+}
+
 void wined3d_device_context_emit_update_sub_resource(struct wined3d_device_context *context,
         struct wined3d_resource *resource, unsigned int sub_resource_idx, const struct wined3d_box *box,
         const void *data, unsigned int row_pitch, unsigned int slice_pitch)
@@ -2824,6 +2938,10 @@ void wined3d_device_context_emit_update_sub_resource(struct wined3d_device_conte
         return;
     }
 
+    if (resource->type != WINED3D_RTYPE_BUFFER
+            && wined3d_cs_upload_staging(context, resource, sub_resource_idx, box, data, row_pitch, slice_pitch))
+        return;
+
     wined3d_resource_wait_idle(resource);
 
     op = wined3d_device_context_require_space(context, sizeof(*op), WINED3D_CS_QUEUE_MAP);
@@ -3056,21 +3174,31 @@ static void (* const wined3d_cs_op_handlers[])(struct wined3d_cs *cs, const void
 static void wined3d_cs_exec_execute_command_list(struct wined3d_cs *cs, const void *data)
 {
     const struct wined3d_cs_execute_command_list *op = data;
-    SIZE_T start = 0, end = op->list->data_size;
-    const BYTE *cs_data = op->list->data;
+    const struct wined3d_cs_chunk *chunk;
+    SIZE_T start;
 
     TRACE("Executing command list %p.\n", op->list);
 
-    while (start < end)
+    for (chunk = op->list->chunks; chunk; chunk = chunk->next)
     {
-        const struct wined3d_cs_packet *packet = wined3d_next_cs_packet(cs_data, &start);
-        enum wined3d_cs_op opcode = *(const enum wined3d_cs_op *)packet->data;
+        start = 0;
+        while (start < chunk->size)
+        {
+            const struct wined3d_cs_packet *packet = wined3d_next_cs_packet(chunk->data, &start);
+            enum wined3d_cs_op opcode = *(const enum wined3d_cs_op *)packet->data;
 
-        if (opcode >= WINED3D_CS_OP_STOP)
-            ERR("Invalid opcode %#x.\n", opcode);
-        else
-            wined3d_cs_op_handlers[opcode](cs, packet->data);
-        TRACE("%s executed.\n", debug_cs_op(opcode));
+            if (opcode >= WINED3D_CS_OP_STOP)
+            {
+                ERR("Invalid opcode %#x.\n", opcode);
+            }
+            else
+            {
+                if (cs->profiler)
+                    wined3d_profiler_op(cs->profiler, opcode);
+                wined3d_cs_op_handlers[opcode](cs, packet->data);
+            }
+            TRACE("%s executed.\n", debug_cs_op(opcode));
+        }
     }
 }
 
@@ -3133,10 +3261,20 @@ static void wined3d_cs_st_submit(struct wined3d_device_context *context, enum wi
     cs->start = cs->end;
 
     opcode = *(const enum wined3d_cs_op *)&data[start];
+    if (!cs->thread && opcode <= WINED3D_CS_OP_STOP)
+        ++cs->emitted_op_count[opcode];
     if (opcode >= WINED3D_CS_OP_STOP)
+    {
         ERR("Invalid opcode %#x.\n", opcode);
+    }
     else
+    {
+        if (cs->profiler)
+            wined3d_profiler_op(cs->profiler, opcode);
         wined3d_cs_op_handlers[opcode](cs, &data[start]);
+        if (cs->profiler)
+            wined3d_profiler_end_batch(cs->profiler);
+    }
 
     if (cs->data == data)
         cs->start = cs->end = start;
@@ -3194,6 +3332,7 @@ static bool wined3d_cs_map_upload_bo(struct wined3d_device_context *context, str
             client->mapped_upload.flags |= UPLOAD_BO_UPLOAD_ON_UNMAP | UPLOAD_BO_RENAME_ON_UNMAP;
 
         client->mapped_box = *box;
+        wined3d_bo_ring_add_stats(&device->bo_ring, 0, box->right - box->left);
 
         TRACE("Returning bo %s, flags %#x.\n", debug_const_bo_address(&client->mapped_upload.addr),
                 client->mapped_upload.flags);
@@ -3249,10 +3388,14 @@ static BOOL wined3d_cs_queue_is_empty(const struct wined3d_cs *cs, const struct
 static void wined3d_cs_queue_submit(struct wined3d_cs_queue *queue, struct wined3d_cs *cs)
 {
     struct wined3d_cs_packet *packet;
+    enum wined3d_cs_op opcode;
     size_t packet_size;
 
     packet = (struct wined3d_cs_packet *)&queue->data[queue->head];
-    TRACE("Queuing op %s at %p.\n", debug_cs_op(*(const enum wined3d_cs_op *)packet->data), packet);
+    opcode = *(const enum wined3d_cs_op *)packet->data;
+    TRACE("Queuing op %s at %p.\n", debug_cs_op(opcode), packet);
+    if (opcode <= WINED3D_CS_OP_STOP)
+        ++cs->emitted_op_count[opcode];
     packet_size = FIELD_OFFSET(struct wined3d_cs_packet, data[packet->size]);
     InterlockedExchange(&queue->head, (queue->head + packet_size) & (WINED3D_CS_QUEUE_SIZE - 1));
 
@@ -3452,6 +3595,8 @@ static DWORD WINAPI wined3d_cs_run(void *ctx)
             queue = &cs->queue[WINED3D_CS_QUEUE_DEFAULT];
             if (wined3d_cs_queue_is_empty(cs, queue))
             {
+                if (cs->profiler)
+                    wined3d_profiler_end_batch(cs->profiler);
                 if (++spin_count >= WINED3D_CS_SPIN_COUNT && list_empty(&cs->query_poll_list))
                     wined3d_cs_wait_event(cs);
                 continue;
@@ -3474,6 +3619,8 @@ static DWORD WINAPI wined3d_cs_run(void *ctx)
             }
 
             wined3d_cs_command_lock(cs);
+            if (cs->profiler)
+                wined3d_profiler_op(cs->profiler, opcode);
             wined3d_cs_op_handlers[opcode](cs, packet->data);
             wined3d_cs_command_unlock(cs);
             TRACE("%s at %p executed.\n", debug_cs_op(opcode), packet);
@@ -3512,6 +3659,8 @@ struct wined3d_cs *wined3d_cs_create(struct wined3d_device *device,
         ERR_(d3d_sync)("Forcing serialization of all command streams.\n");
 
     state_init(&cs->state, d3d_info, WINED3D_STATE_NO_REF | WINED3D_STATE_INIT_DEFAULT, cs->c.state->feature_level);
+    InitializeSListHead(&cs->chunk_pool);
+    cs->profiler = wined3d_profiler_create(device);
 
     cs->data_size = WINED3D_INITIAL_CS_SIZE;
     if (!(cs->data = heap_alloc(cs->data_size)))
@@ -3551,6 +3700,8 @@ struct wined3d_cs *wined3d_cs_create(struct wined3d_device *device,
     return cs;
 
 fail:
+    if (cs->profiler)
+        wined3d_profiler_destroy(cs->profiler);
     wined3d_state_destroy(cs->c.state);
     state_cleanup(&cs->state);
     heap_free(cs);
@@ -3559,6 +3710,8 @@ fail:
 
 void wined3d_cs_destroy(struct wined3d_cs *cs)
 {
+    SLIST_ENTRY *entry;
+
     if (cs->thread)
     {
         wined3d_cs_emit_stop(cs);
@@ -3567,6 +3720,11 @@ void wined3d_cs_destroy(struct wined3d_cs *cs)
             ERR("Closing event failed.\n");
     }
 
+    while ((entry = InterlockedPopEntrySList(&cs->chunk_pool)))
+        heap_free(CONTAINING_RECORD(entry, struct wined3d_cs_chunk, entry));
+
+    if (cs->profiler)
+        wined3d_profiler_destroy(cs->profiler);
     wined3d_state_destroy(cs->c.state);
     state_cleanup(&cs->state);
     heap_free(cs->data);
@@ -3606,6 +3764,22 @@ static void wined3d_cs_packet_decref_objects(const struct wined3d_cs_packet *pac
     }
 }
 
+static void wined3d_cs_chunks_decref_objects(const struct wined3d_cs_chunk *chunk)
+{
+    const struct wined3d_cs_packet *packet;
+    SIZE_T offset;
+
+    for (; chunk; chunk = chunk->next)
+    {
+        offset = 0;
+        while (offset < chunk->size)
+        {
+            packet = wined3d_next_cs_packet(chunk->data, &offset);
+            wined3d_cs_packet_decref_objects(packet);
+        }
+    }
+}
+
 static void wined3d_cs_packet_incref_objects(struct wined3d_cs_packet *packet)
 {
     enum wined3d_cs_op opcode = *(const enum wined3d_cs_op *)packet->data;
@@ -3643,8 +3817,7 @@ struct wined3d_deferred_context
 {
     struct wined3d_device_context c;
 
-    SIZE_T data_size, data_capacity;
-    void *data;
+    struct wined3d_cs_chunk *chunks, *last_chunk;
 
     SIZE_T resource_count, resources_capacity;
     struct wined3d_resource **resources;
@@ -3680,6 +3853,7 @@ static void *wined3d_deferred_context_require_space(struct wined3d_device_contex
         size_t size, enum wined3d_cs_queue_id queue_id)
 {
     struct wined3d_deferred_context *deferred = wined3d_deferred_context_from_context(context);
+    struct wined3d_cs_chunk *chunk = deferred->last_chunk;
     struct wined3d_cs_packet *packet;
     size_t header_size, packet_size;
 
@@ -3690,11 +3864,19 @@ static void *wined3d_deferred_context_require_space(struct wined3d_device_contex
     packet_size = offsetof(struct wined3d_cs_packet, data[size]);
     packet_size = (packet_size + header_size - 1) & ~(header_size - 1);
 
-    if (!wined3d_array_reserve(&deferred->data, &deferred->data_capacity, deferred->data_size + packet_size, 1))
-        return NULL;
+    if (!chunk || chunk->capacity - chunk->size < packet_size)
+    {
+        if (!(chunk = wined3d_cs_get_chunk(context->device->cs, packet_size)))
+            return NULL;
+        if (deferred->last_chunk)
+            deferred->last_chunk->next = chunk;
+        else
+            deferred->chunks = chunk;
+        deferred->last_chunk = chunk;
+    }
 
-    packet = (struct wined3d_cs_packet *)((BYTE *)deferred->data + deferred->data_size);
-    TRACE("size was %zu, adding %zu\n", (size_t)deferred->data_size, packet_size);
+    packet = (struct wined3d_cs_packet *)&chunk->data[chunk->size];
+    TRACE("size was %zu, adding %zu\n", (size_t)chunk->size, packet_size);
     packet->size = packet_size - header_size;
     return &packet->data;
 }
@@ -3705,7 +3887,7 @@ static void wined3d_deferred_context_submit(struct wined3d_device_context *conte
     struct wined3d_cs_packet *packet;
 
     assert(queue_id == WINED3D_CS_QUEUE_DEFAULT);
-    packet = wined3d_next_cs_packet(deferred->data, &deferred->data_size);
+    packet = wined3d_next_cs_packet(deferred->last_chunk->data, &deferred->last_chunk->size);
     wined3d_cs_packet_incref_objects(packet);
 }
 
@@ -3954,8 +4136,7 @@ HRESULT CDECL wined3d_deferred_context_create(struct wined3d_device *device, str
 void CDECL wined3d_deferred_context_destroy(struct wined3d_device_context *context)
 {
     struct wined3d_deferred_context *deferred = wined3d_deferred_context_from_context(context);
-    const struct wined3d_cs_packet *packet;
-    SIZE_T i, offset = 0;
+    SIZE_T i;
 
     TRACE("context %p.\n", context);
 
@@ -3990,14 +4171,10 @@ void CDECL wined3d_deferred_context_destroy(struct wined3d_device_context *conte
         wined3d_depth_stencil_state_decref(deferred->depth_stencil_states[i]);
     heap_free(deferred->depth_stencil_states);
 
-    while (offset < deferred->data_size)
-    {
-        packet = wined3d_next_cs_packet(deferred->data, &offset);
-        wined3d_cs_packet_decref_objects(packet);
-    }
+    wined3d_cs_chunks_decref_objects(deferred->chunks);
+    wined3d_cs_release_chunks(deferred->c.device->cs, deferred->chunks);
 
     wined3d_state_destroy(deferred->c.state);
-    heap_free(deferred->data);
     heap_free(deferred);
 }
 
@@ -4017,8 +4194,7 @@ HRESULT CDECL wined3d_deferred_context_record_command_list(struct wined3d_device
             + deferred->query_count * sizeof(*object->queries)
             + deferred->blend_state_count * sizeof(*object->blend_states)
             + deferred->rasterizer_state_count * sizeof(*object->rasterizer_states)
-            + deferred->depth_stencil_state_count * sizeof(*object->depth_stencil_states)
-            + deferred->data_size);
+            + deferred->depth_stencil_state_count * sizeof(*object->depth_stencil_states));
 
     if (!memory)
     {
@@ -4077,11 +4253,10 @@ HRESULT CDECL wined3d_deferred_context_record_command_list(struct wined3d_device
             deferred->depth_stencil_state_count * sizeof(*object->depth_stencil_states));
     /* Transfer our references to the depth stencil states to the command list. */
 
-    object->data = memory;
-    object->data_size = deferred->data_size;
-    memcpy(object->data, deferred->data, deferred->data_size);
+    /* Transfer the recorded chunks to the command list. */
+    object->chunks = deferred->chunks;
+    deferred->chunks = deferred->last_chunk = NULL;
 
-    deferred->data_size = 0;
     deferred->resource_count = 0;
     deferred->upload_count = 0;
     deferred->command_list_count = 0;
@@ -4113,6 +4288,7 @@ static void wined3d_command_list_destroy_object(void *object)
     for (i = 0; i < list->upload_count; ++i)
         heap_free(list->uploads[i].sysmem);
 
+    wined3d_cs_release_chunks(list->device->cs, list->chunks);
     heap_free(list);
 }
 
@@ -4129,8 +4305,7 @@ ULONG CDECL wined3d_command_list_decref(struct wined3d_command_list *list)
 {
     ULONG refcount = InterlockedDecrement(&list->refcount);
     struct wined3d_device *device = list->device;
-    const struct wined3d_cs_packet *packet;
-    SIZE_T i, offset;
+    SIZE_T i;
 
     TRACE("%p decreasing refcount to %u.\n", list, refcount);
 
@@ -4151,12 +4326,7 @@ ULONG CDECL wined3d_command_list_decref(struct wined3d_command_list *list)
         for (i = 0; i < list->depth_stencil_state_count; ++i)
             wined3d_depth_stencil_state_decref(list->depth_stencil_states[i]);
 
-        offset = 0;
-        while (offset < list->data_size)
-        {
-            packet = wined3d_next_cs_packet(list->data, &offset);
-            wined3d_cs_packet_decref_objects(packet);
-        }
+        wined3d_cs_chunks_decref_objects(list->chunks);
 
         wined3d_mutex_lock();
         wined3d_cs_destroy_object(device->cs, wined3d_command_list_destroy_object, list);
@@ -171,6 +171,180 @@ ULONG CDECL wined3d_device_incref(struct wined3d_device *device)
     return refcount;
 }
 
+void wined3d_bo_ring_init(struct wined3d_bo_ring *ring)
+{
+    InitializeCriticalSection(&ring->cs);
+    if (ring->cs.DebugInfo != (RTL_CRITICAL_SECTION_DEBUG *)-1)
+        ring->cs.DebugInfo->Spare[0] = (DWORD_PTR)(__FILE__ ": wined3d_bo_ring.cs");
+    ring->current = NULL;
+    list_init(&ring->blocks);
+    ring->block_count = 0;
+    ring->block_pending = false;
+    ring->completed_id = 0;
+    memset(&ring->stats, 0, sizeof(ring->stats));
+}
+
+void wined3d_bo_ring_cleanup(struct wined3d_bo_ring *ring)
+{
+    if (ring->block_count)
+        ERR("Ring %p still has %u block(s).\n", ring, ring->block_count);
+
+    if (ring->cs.DebugInfo != (RTL_CRITICAL_SECTION_DEBUG *)-1)
+        ring->cs.DebugInfo->Spare[0] = 0;
+    DeleteCriticalSection(&ring->cs);
+}
+
+/* Returns false if the allocation doesn't fit in the current block and no
+ * retired block can be recycled yet. "completed_id" is the most recent fence
+ * (GL) or command buffer (Vulkan) ID known to have completed. */
+bool wined3d_bo_ring_suballoc(struct wined3d_bo_ring *ring, size_t size, size_t alignment,
+        struct wined3d_bo_ring_block **block, size_t *offset)
+{
+    struct wined3d_bo_ring_block *b, *recycled = NULL;
+    uint64_t completed_id;
+    size_t start = 0;
+
+    /* Large allocations would only fragment the blocks. */
+    if (size > WINED3D_BO_RING_BLOCK_SIZE / 4)
+        return false;
+
+    EnterCriticalSection(&ring->cs);
+
+    if ((b = ring->current))
+    {
+        start = (b->offset + (alignment - 1)) & ~(alignment - 1);
+        if (start + size > b->size)
+        {
+            list_add_tail(&ring->blocks, &b->entry);
+            ring->current = b = NULL;
+        }
+    }
+
+    if (!b)
+    {
+        completed_id = InterlockedCompareExchange64(&ring->completed_id, 0, 0);
+        LIST_FOR_EACH_ENTRY(b, &ring->blocks, struct wined3d_bo_ring_block, entry)
+        {
+            if (!b->suballocation_count && b->fence_id <= completed_id && size <= b->size)
+            {
+                recycled = b;
+                break;
+            }
+        }
+
+        if (!(b = recycled))
+        {
+            LeaveCriticalSection(&ring->cs);
+            return false;
+        }
+
+        TRACE("Recycling block %p.\n", b);
+        list_remove(&b->entry);
+        b->offset = 0;
+        b->fence_id = 0;
+        ring->current = b;
+        start = 0;
+    }
+
+    b->offset = start + size;
+    ++b->suballocation_count;
+    ++ring->stats.suballoc_count;
+
+    LeaveCriticalSection(&ring->cs);
+
+    *block = b;
+    *offset = start;
+    return true;
+}
+
+/* Claims the right to create a new block. The caller must follow up with
+ * wined3d_bo_ring_add_block(), passing a NULL bo if creation failed. */
+bool wined3d_bo_ring_reserve_block(struct wined3d_bo_ring *ring)
+{
+    bool ret = false;
+
+    EnterCriticalSection(&ring->cs);
+    if (!ring->block_pending && ring->block_count < WINED3D_BO_RING_MAX_BLOCKS)
+        ret = ring->block_pending = true;
+    LeaveCriticalSection(&ring->cs);
+
+    return ret;
+}
+
+void wined3d_bo_ring_add_block(struct wined3d_bo_ring *ring, struct wined3d_bo *bo, size_t size)
+{
+    struct wined3d_bo_ring_block *block = NULL;
+
+    if (bo && !(block = heap_alloc_zero(sizeof(*block))))
+        ERR("Failed to allocate block.\n");
+
+    EnterCriticalSection(&ring->cs);
+    ring->block_pending = false;
+    if (block)
+    {
+        block->bo = bo;
+        block->size = size;
+        if (ring->current)
+            list_add_tail(&ring->blocks, &ring->current->entry);
+        ring->current = block;
+        ++ring->block_count;
+        ++ring->stats.alloc_count;
+        TRACE("Added block %p, bo %p, size %#lx; %u block(s).\n", block, bo, (unsigned long)size, ring->block_count);
+    }
+    LeaveCriticalSection(&ring->cs);
+}
+
+void wined3d_bo_ring_release(struct wined3d_bo_ring *ring, struct wined3d_bo_ring_block *block, uint64_t fence_id)
+{
+    EnterCriticalSection(&ring->cs);
+    --block->suballocation_count;
+    if (fence_id > block->fence_id)
+        block->fence_id = fence_id;
+    LeaveCriticalSection(&ring->cs);
+}
+
+/* Context activation is done by the caller. */
+void wined3d_bo_ring_destroy_blocks(struct wined3d_bo_ring *ring, struct wined3d_context *context)
+{
+    struct wined3d_bo_ring_block *block, *next;
+
+    EnterCriticalSection(&ring->cs);
+
+    if (ring->current)
+        list_add_tail(&ring->blocks, &ring->current->entry);
+    ring->current = NULL;
+
+    LIST_FOR_EACH_ENTRY_SAFE(block, next, &ring->blocks, struct wined3d_bo_ring_block, entry)
+    {
+        if (block->suballocation_count)
+            ERR("Block %p still has %u suballocation(s).\n", block, block->suballocation_count);
+        list_remove(&block->entry);
+        wined3d_context_destroy_bo(context, block->bo);
+        heap_free(block->bo);
+        heap_free(block);
+    }
+    ring->block_count = 0;
+    ring->block_pending = false;
+
+    LeaveCriticalSection(&ring->cs);
+}
+
+void wined3d_bo_ring_add_stats(struct wined3d_bo_ring *ring, unsigned int alloc_count, uint64_t mapped_bytes)
+{
+    EnterCriticalSection(&ring->cs);
+    ring->stats.alloc_count += alloc_count;
+    ring->stats.mapped_bytes += mapped_bytes;
+    LeaveCriticalSection(&ring->cs);
+}
+
+void wined3d_bo_ring_get_stats(struct wined3d_bo_ring *ring, struct wined3d_bo_stats *stats)
+{
+    EnterCriticalSection(&ring->cs);
+    *stats = ring->stats;
+    memset(&ring->stats, 0, sizeof(ring->stats));
+    LeaveCriticalSection(&ring->cs);
+}
+
 static void device_free_so_desc(struct wine_rb_entry *entry, void *context)
 {
     struct wined3d_so_desc_entry *s = WINE_RB_ENTRY_VALUE(entry, struct wined3d_so_desc_entry, entry);
@@ -214,6 +388,7 @@ void wined3d_device_cleanup(struct wined3d_device *device)
         wined3d_device_uninit_3d(device);
 
     wined3d_cs_destroy(device->cs);
+    wined3d_bo_ring_cleanup(&device->bo_ring);
 
     for (i = 0; i < ARRAY_SIZE(device->multistate_funcs); ++i)
     {
@@ -978,6 +1153,7 @@ void wined3d_device_gl_delete_opengl_contexts_cs(void *object)
     device->blitter->ops->blitter_destroy(device->blitter, context);
     device->shader_backend->shader_free_private(device, context);
     wined3d_device_gl_destroy_dummy_textures(device_gl, context_gl);
+    wined3d_bo_ring_destroy_blocks(&device->bo_ring, context);
     context_release(context);
 
     while (device->context_count)
@@ -1193,6 +1369,8 @@ void wined3d_device_uninit_3d(struct wined3d_device *device)
         wined3d_cs_emit_unload_resource(device->cs, resource);
     }
 
+    if (device->cs->profiler)
+        wined3d_cs_destroy_object(device->cs, wined3d_profiler_release_queries, device->cs->profiler);
     device->adapter->adapter_ops->adapter_uninit_3d(device);
     device->d3d_initialized = FALSE;
 
@@ -1326,6 +1504,7 @@ static void wined3d_device_set_transform(struct wined3d_device *device,
     if (!memcmp(&device->cs->c.state->transforms[state], matrix, sizeof(*matrix)))
     {
         TRACE("The application is setting the same matrix over again.\n");
+        wined3d_device_context_filter_op(&device->cs->c, WINED3D_CS_OP_SET_TRANSFORM);
         return;
     }
 
@@ -1466,6 +1645,13 @@ static void wined3d_device_set_light_enable(struct wined3d_device *device, UINT
         }
     }
 
+    if (light_info->enabled == enable && (!enable || light_info->glIndex != -1))
+    {
+        TRACE("Light %u is already in the requested state, nothing to do.\n", light_idx);
+        wined3d_device_context_filter_op(&device->cs->c, WINED3D_CS_OP_SET_LIGHT_ENABLE);
+        return;
+    }
+
     wined3d_light_state_enable_light(light_state, &device->adapter->d3d_info, light_info, enable);
     wined3d_device_context_emit_set_light_enable(&device->cs->c, light_idx, enable);
 }
@@ -1486,6 +1672,7 @@ static HRESULT wined3d_device_set_clip_plane(struct wined3d_device *device,
     if (!memcmp(&clip_planes[plane_idx], plane, sizeof(*plane)))
     {
         TRACE("Application is setting old values over, nothing to do.\n");
+        wined3d_device_context_filter_op(&device->cs->c, WINED3D_CS_OP_SET_CLIP_PLANE);
         return WINED3D_OK;
     }
 
@@ -1522,6 +1709,13 @@ static void wined3d_device_set_material(struct wined3d_device *device, const str
 {
     TRACE("device %p, material %p.\n", device, material);
 
+    if (!memcmp(&device->cs->c.state->material, material, sizeof(*material)))
+    {
+        TRACE("Application is setting the old material over, nothing to do.\n");
+        wined3d_device_context_filter_op(&device->cs->c, WINED3D_CS_OP_SET_MATERIAL);
+        return;
+    }
+
     device->cs->c.state->material = *material;
     wined3d_device_context_emit_set_material(&device->cs->c, material);
 }
@@ -1621,7 +1815,10 @@ static void wined3d_device_set_render_state(struct wined3d_device *device,
     }
 
     if (value == device->cs->c.state->render_states[state])
+    {
         TRACE("Application is setting the old value over, nothing to do.\n");
+        wined3d_device_context_filter_op(&device->cs->c, WINED3D_CS_OP_SET_RENDER_STATE);
+    }
     else
     {
         device->cs->c.state->render_states[state] = value;
@@ -1644,6 +1841,7 @@ static void wined3d_device_set_sampler_state(struct wined3d_device *device,
     if (value == device->cs->c.state->sampler_states[sampler_idx][state])
     {
         TRACE("Application is setting the old value over, nothing to do.\n");
+        wined3d_device_context_filter_op(&device->cs->c, WINED3D_CS_OP_SET_SAMPLER_STATE);
         return;
     }
 
@@ -1816,7 +2014,10 @@ void CDECL wined3d_device_context_set_shader(struct wined3d_device_context *cont
     wined3d_device_context_lock(context);
     prev = state->shader[type];
     if (shader == prev)
+    {
+        wined3d_device_context_filter_op(context, WINED3D_CS_OP_SET_SHADER);
         goto out;
+    }
 
     if (shader)
         wined3d_shader_incref(shader);
@@ -1853,7 +2054,10 @@ void CDECL wined3d_device_context_set_constant_buffers(struct wined3d_device_con
 
     wined3d_device_context_lock(context);
     if (!memcmp(buffers, &state->cb[type][start_idx], count * sizeof(*buffers)))
+    {
+        wined3d_device_context_filter_op(context, WINED3D_CS_OP_SET_CONSTANT_BUFFERS);
         goto out;
+    }
 
     wined3d_device_context_emit_set_constant_buffers(context, type, start_idx, count, buffers);
     for (i = 0; i < count; ++i)
@@ -1884,7 +2088,10 @@ void CDECL wined3d_device_context_set_blend_state(struct wined3d_device_context
     prev = state->blend_state;
     if (prev == blend_state && !memcmp(blend_factor, &state->blend_factor, sizeof(*blend_factor))
             && sample_mask == state->sample_mask)
+    {
+        wined3d_device_context_filter_op(context, WINED3D_CS_OP_SET_BLEND_STATE);
         goto out;
+    }
 
     if (blend_state)
         wined3d_blend_state_incref(blend_state);
@@ -1909,7 +2116,10 @@ void CDECL wined3d_device_context_set_depth_stencil_state(struct wined3d_device_
     wined3d_device_context_lock(context);
     prev = state->depth_stencil_state;
     if (prev == depth_stencil_state && state->stencil_ref == stencil_ref)
+    {
+        wined3d_device_context_filter_op(context, WINED3D_CS_OP_SET_DEPTH_STENCIL_STATE);
         goto out;
+    }
 
     if (depth_stencil_state)
         wined3d_depth_stencil_state_incref(depth_stencil_state);
@@ -1933,7 +2143,10 @@ void CDECL wined3d_device_context_set_rasterizer_state(struct wined3d_device_con
     wined3d_device_context_lock(context);
     prev = state->rasterizer_state;
     if (prev == rasterizer_state)
+    {
+        wined3d_device_context_filter_op(context, WINED3D_CS_OP_SET_RASTERIZER_STATE);
         goto out;
+    }
 
     if (rasterizer_state)
         wined3d_rasterizer_state_incref(rasterizer_state);
@@ -1968,6 +2181,14 @@ void CDECL wined3d_device_context_set_viewports(struct wined3d_device_context *c
     }
 
     wined3d_device_context_lock(context);
+    if (state->viewport_count == viewport_count
+            && !memcmp(state->viewports, viewports, viewport_count * sizeof(*viewports)))
+    {
+        TRACE("App is setting the old viewports over, nothing to do.\n");
+        wined3d_device_context_filter_op(context, WINED3D_CS_OP_SET_VIEWPORTS);
+        goto out;
+    }
+
     if (viewport_count)
         memcpy(state->viewports, viewports, viewport_count * sizeof(*viewports));
     else
@@ -1975,6 +2196,7 @@ void CDECL wined3d_device_context_set_viewports(struct wined3d_device_context *c
     state->viewport_count = viewport_count;
 
     wined3d_device_context_emit_set_viewports(context, viewport_count, viewports);
+out:
     wined3d_device_context_unlock(context);
 }
 
@@ -1996,6 +2218,7 @@ void CDECL wined3d_device_context_set_scissor_rects(struct wined3d_device_contex
             && !memcmp(state->scissor_rects, rects, rect_count * sizeof(*rects)))
     {
         TRACE("App is setting the old scissor rectangles over, nothing to do.\n");
+        wined3d_device_context_filter_op(context, WINED3D_CS_OP_SET_SCISSOR_RECTS);
         goto out;
     }
 
@@ -2029,7 +2252,10 @@ void CDECL wined3d_device_context_set_shader_resource_views(struct wined3d_devic
 
     wined3d_device_context_lock(context);
     if (!memcmp(views, &state->shader_resource_view[type][start_idx], count * sizeof(*views)))
+    {
+        wined3d_device_context_filter_op(context, WINED3D_CS_OP_SET_SHADER_RESOURCE_VIEWS);
         goto out;
+    }
 
     memcpy(real_views, views, count * sizeof(*views));
 
@@ -2084,7 +2310,10 @@ void CDECL wined3d_device_context_set_samplers(struct wined3d_device_context *co
 
     wined3d_device_context_lock(context);
     if (!memcmp(samplers, &state->sampler[type][start_idx], count * sizeof(*samplers)))
+    {
+        wined3d_device_context_filter_op(context, WINED3D_CS_OP_SET_SAMPLERS);
         goto out;
+    }
 
     wined3d_device_context_emit_set_samplers(context, type, start_idx, count, samplers);
     for (i = 0; i < count; ++i)
@@ -2120,7 +2349,10 @@ void CDECL wined3d_device_context_set_unordered_access_views(struct wined3d_devi
 
     wined3d_device_context_lock(context);
     if (!memcmp(uavs, &state->unordered_access_view[pipeline][start_idx], count * sizeof(*uavs)) && !initial_counts)
+    {
+        wined3d_device_context_filter_op(context, WINED3D_CS_OP_SET_UNORDERED_ACCESS_VIEWS);
         goto out;
+    }
 
     wined3d_device_context_emit_set_unordered_access_views(context, pipeline, start_idx, count, uavs, initial_counts);
     for (i = 0; i < count; ++i)
@@ -2249,7 +2481,10 @@ HRESULT CDECL wined3d_device_context_set_rendertarget_views(struct wined3d_devic
     }
 
     if (!memcmp(views, &state->fb.render_targets[start_idx], count * sizeof(*views)))
+    {
+        wined3d_device_context_filter_op(context, WINED3D_CS_OP_SET_RENDERTARGET_VIEWS);
         goto out;
+    }
 
     wined3d_device_context_emit_set_rendertarget_views(context, start_idx, count, views);
     for (i = 0; i < count; ++i)
@@ -2298,6 +2533,7 @@ HRESULT CDECL wined3d_device_context_set_depth_stencil_view(struct wined3d_devic
     if (prev == view)
     {
         TRACE("Trying to do a NOP SetRenderTarget operation.\n");
+        wined3d_device_context_filter_op(context, WINED3D_CS_OP_SET_DEPTH_STENCIL_VIEW);
         goto out;
     }
 
@@ -2322,6 +2558,12 @@ void CDECL wined3d_device_context_set_predication(struct wined3d_device_context
 
     wined3d_device_context_lock(context);
     prev = state->predicate;
+    if (predicate == prev && value == state->predicate_value)
+    {
+        wined3d_device_context_filter_op(context, WINED3D_CS_OP_SET_PREDICATION);
+        goto out;
+    }
+
     if (predicate)
     {
         FIXME("Predicated rendering not implemented.\n");
@@ -2332,6 +2574,7 @@ void CDECL wined3d_device_context_set_predication(struct wined3d_device_context
     wined3d_device_context_emit_set_predication(context, predicate, value);
     if (prev)
         wined3d_query_decref(prev);
+out:
     wined3d_device_context_unlock(context);
 }
 
@@ -2362,7 +2605,10 @@ HRESULT CDECL wined3d_device_context_set_stream_sources(struct wined3d_device_co
 
     wined3d_device_context_lock(context);
     if (!memcmp(streams, &state->streams[start_idx], count * sizeof(*streams)))
+    {
+        wined3d_device_context_filter_op(context, WINED3D_CS_OP_SET_STREAM_SOURCES);
         goto out;
+    }
 
     wined3d_device_context_emit_set_stream_sources(context, start_idx, count, streams);
     for (i = 0; i < count; ++i)
@@ -2399,7 +2645,10 @@ void CDECL wined3d_device_context_set_index_buffer(struct wined3d_device_context
     prev_offset = state->index_offset;
 
     if (prev_buffer == buffer && prev_format == format_id && prev_offset == offset)
+    {
+        wined3d_device_context_filter_op(context, WINED3D_CS_OP_SET_INDEX_BUFFER);
         goto out;
+    }
 
     if (buffer)
         wined3d_buffer_incref(buffer);
@@ -2424,7 +2673,10 @@ void CDECL wined3d_device_context_set_vertex_declaration(struct wined3d_device_c
     wined3d_device_context_lock(context);
     prev = state->vertex_declaration;
     if (declaration == prev)
+    {
+        wined3d_device_context_filter_op(context, WINED3D_CS_OP_SET_VERTEX_DECLARATION);
         goto out;
+    }
 
     if (declaration)
         wined3d_vertex_declaration_incref(declaration);
@@ -2445,6 +2697,22 @@ void CDECL wined3d_device_context_set_stream_outputs(struct wined3d_device_conte
     TRACE("context %p, outputs %p.\n", context, outputs);
 
     wined3d_device_context_lock(context);
+    /* Rebinding a buffer at an explicit offset restarts stream output at
+     * that offset, so only appending rebinds are redundant. */
+    if (!memcmp(outputs, state->stream_output, sizeof(state->stream_output)))
+    {
+        for (i = 0; i < WINED3D_MAX_STREAM_OUTPUT_BUFFERS; ++i)
+        {
+            if (outputs[i].buffer && outputs[i].offset != ~0u)
+                break;
+        }
+        if (i == WINED3D_MAX_STREAM_OUTPUT_BUFFERS)
+        {
+            wined3d_device_context_filter_op(context, WINED3D_CS_OP_SET_STREAM_OUTPUTS);
+            goto out;
+        }
+    }
+
     wined3d_device_context_emit_set_stream_outputs(context, outputs);
     for (i = 0; i < WINED3D_MAX_STREAM_OUTPUT_BUFFERS; ++i)
     {
@@ -2457,6 +2725,7 @@ void CDECL wined3d_device_context_set_stream_outputs(struct wined3d_device_conte
         if (prev_buffer)
             wined3d_buffer_decref(prev_buffer);
     }
+out:
     wined3d_device_context_unlock(context);
 }
 
@@ -2528,14 +2797,42 @@ struct wined3d_sampler * CDECL wined3d_device_context_get_sampler(const struct w
     return context->state->sampler[shader_type][idx];
 }
 
+/* Trims the constants matching the current state off both ends of the
+ * range. Returns false if the whole range is redundant. */
+static bool wined3d_device_trim_constants(const void *current, const void *constants,
+        size_t size, unsigned int *first, unsigned int *count)
+{
+    const uint8_t *dst = current, *src = constants;
+    unsigned int start = 0, end = *count;
+
+    while (start < end && !memcmp(&dst[start * size], &src[start * size], size))
+        ++start;
+    while (end > start && !memcmp(&dst[(end - 1) * size], &src[(end - 1) * size], size))
+        --end;
+
+    *first = start;
+    *count = end - start;
+    return start != end;
+}
+
 static void wined3d_device_set_vs_consts_b(struct wined3d_device *device,
         unsigned int start_idx, unsigned int count, const BOOL *constants)
 {
-    unsigned int i;
+    unsigned int i, first;
 
     TRACE("device %p, start_idx %u, count %u, constants %p.\n",
             device, start_idx, count, constants);
 
+    if (!wined3d_device_trim_constants(&device->cs->c.state->vs_consts_b[start_idx],
+            constants, sizeof(*constants), &first, &count))
+    {
+        TRACE("Application is setting the old values over, nothing to do.\n");
+        wined3d_device_context_filter_op(&device->cs->c, WINED3D_CS_OP_PUSH_CONSTANTS);
+        return;
+    }
+    start_idx += first;
+    constants += first;
+
     memcpy(&device->cs->c.state->vs_consts_b[start_idx], constants, count * sizeof(*constants));
     if (TRACE_ON(d3d))
     {
@@ -2549,11 +2846,21 @@ static void wined3d_device_set_vs_consts_b(struct wined3d_device *device,
 static void wined3d_device_set_vs_consts_i(struct wined3d_device *device,
         unsigned int start_idx, unsigned int count, const struct wined3d_ivec4 *constants)
 {
-    unsigned int i;
+    unsigned int i, first;
 
     TRACE("device %p, start_idx %u, count %u, constants %p.\n",
             device, start_idx, count, constants);
 
+    if (!wined3d_device_trim_constants(&device->cs->c.state->vs_consts_i[start_idx],
+            constants, sizeof(*constants), &first, &count))
+    {
+        TRACE("Application is setting the old values over, nothing to do.\n");
+        wined3d_device_context_filter_op(&device->cs->c, WINED3D_CS_OP_PUSH_CONSTANTS);
+        return;
+    }
+    start_idx += first;
+    constants += first;
+
     memcpy(&device->cs->c.state->vs_consts_i[start_idx], constants, count * sizeof(*constants));
     if (TRACE_ON(d3d))
     {
@@ -2567,11 +2874,21 @@ static void wined3d_device_set_vs_consts_i(struct wined3d_device *device,
 static void wined3d_device_set_vs_consts_f(struct wined3d_device *device,
         unsigned int start_idx, unsigned int count, const struct wined3d_vec4 *constants)
 {
-    unsigned int i;
+    unsigned int i, first;
 
     TRACE("device %p, start_idx %u, count %u, constants %p.\n",
             device, start_idx, count, constants);
 
+    if (!wined3d_device_trim_constants(&device->cs->c.state->vs_consts_f[start_idx],
+            constants, sizeof(*constants), &first, &count))
+    {
+        TRACE("Application is setting the old values over, nothing to do.\n");
+        wined3d_device_context_filter_op(&device->cs->c, WINED3D_CS_OP_PUSH_CONSTANTS);
+        return;
+    }
+    start_idx += first;
+    constants += first;
+
     memcpy(&device->cs->c.state->vs_consts_f[start_idx], constants, count * sizeof(*constants));
     if (TRACE_ON(d3d))
     {
@@ -2585,11 +2902,21 @@ static void wined3d_device_set_vs_consts_f(struct wined3d_device *device,
 static void wined3d_device_set_ps_consts_b(struct wined3d_device *device,
         unsigned int start_idx, unsigned int count, const BOOL *constants)
 {
-    unsigned int i;
+    unsigned int i, first;
 
     TRACE("device %p, start_idx %u, count %u, constants %p.\n",
             device, start_idx, count, constants);
 
+    if (!wined3d_device_trim_constants(&device->cs->c.state->ps_consts_b[start_idx],
+            constants, sizeof(*constants), &first, &count))
+    {
+        TRACE("Application is setting the old values over, nothing to do.\n");
+        wined3d_device_context_filter_op(&device->cs->c, WINED3D_CS_OP_PUSH_CONSTANTS);
+        return;
+    }
+    start_idx += first;
+    constants += first;
+
     memcpy(&device->cs->c.state->ps_consts_b[start_idx], constants, count * sizeof(*constants));
     if (TRACE_ON(d3d))
     {
@@ -2603,11 +2930,21 @@ static void wined3d_device_set_ps_consts_b(struct wined3d_device *device,
 static void wined3d_device_set_ps_consts_i(struct wined3d_device *device,
         unsigned int start_idx, unsigned int count, const struct wined3d_ivec4 *constants)
 {
-    unsigned int i;
+    unsigned int i, first;
 
     TRACE("device %p, start_idx %u, count %u, constants %p.\n",
             device, start_idx, count, constants);
 
+    if (!wined3d_device_trim_constants(&device->cs->c.state->ps_consts_i[start_idx],
+            constants, sizeof(*constants), &first, &count))
+    {
+        TRACE("Application is setting the old values over, nothing to do.\n");
+        wined3d_device_context_filter_op(&device->cs->c, WINED3D_CS_OP_PUSH_CONSTANTS);
+        return;
+    }
+    start_idx += first;
+    constants += first;
+
     memcpy(&device->cs->c.state->ps_consts_i[start_idx], constants, count * sizeof(*constants));
     if (TRACE_ON(d3d))
     {
@@ -2621,11 +2958,21 @@ static void wined3d_device_set_ps_consts_i(struct wined3d_device *device,
 static void wined3d_device_set_ps_consts_f(struct wined3d_device *device,
         unsigned int start_idx, unsigned int count, const struct wined3d_vec4 *constants)
 {
-    unsigned int i;
+    unsigned int i, first;
 
     TRACE("device %p, start_idx %u, count %u, constants %p.\n",
             device, start_idx, count, constants);
 
+    if (!wined3d_device_trim_constants(&device->cs->c.state->ps_consts_f[start_idx],
+            constants, sizeof(*constants), &first, &count))
+    {
+        TRACE("Application is setting the old values over, nothing to do.\n");
+        wined3d_device_context_filter_op(&device->cs->c, WINED3D_CS_OP_PUSH_CONSTANTS);
+        return;
+    }
+    start_idx += first;
+    constants += first;
+
     memcpy(&device->cs->c.state->ps_consts_f[start_idx], constants, count * sizeof(*constants));
     if (TRACE_ON(d3d))
     {
@@ -3626,6 +3973,7 @@ static void wined3d_device_set_texture_stage_state(struct wined3d_device *device
     if (value == device->cs->c.state->texture_states[stage][state])
     {
         TRACE("Application is setting the old value over, nothing to do.\n");
+        wined3d_device_context_filter_op(&device->cs->c, WINED3D_CS_OP_SET_TEXTURE_STATE);
         return;
     }
 
@@ -3655,6 +4003,7 @@ static void wined3d_device_set_texture(struct wined3d_device *device,
     if (texture == prev)
     {
         TRACE("App is setting the same texture again, nothing to do.\n");
+        wined3d_device_context_filter_op(&device->cs->c, WINED3D_CS_OP_SET_TEXTURE);
         return;
     }
 
@@ -5936,6 +6285,8 @@ HRESULT wined3d_device_init(struct wined3d_device *device, struct wined3d *wined
         goto err;
     }
 
+    wined3d_bo_ring_init(&device->bo_ring);
+
     return WINED3D_OK;
 
 err:
@@ -2811,6 +2811,12 @@ static bool adapter_no3d_alloc_bo(struct wined3d_device *device, struct wined3d_
     return false;
 }
 
+static bool adapter_no3d_alloc_upload_bo(struct wined3d_device *device, struct wined3d_resource *resource,
+        unsigned int sub_resource_idx, size_t size, struct wined3d_bo_address *addr)
+{
+    return false;
+}
+
 static void adapter_no3d_destroy_bo(struct wined3d_context *context, struct wined3d_bo *bo)
 {
 }
@@ -3086,6 +3092,7 @@ static const struct wined3d_adapter_ops wined3d_adapter_no3d_ops =
     .adapter_copy_bo_address = adapter_no3d_copy_bo_address,
     .adapter_flush_bo_address = adapter_no3d_flush_bo_address,
     .adapter_alloc_bo = adapter_no3d_alloc_bo,
+    .adapter_alloc_upload_bo = adapter_no3d_alloc_upload_bo,
     .adapter_destroy_bo = adapter_no3d_destroy_bo,
     .adapter_create_swapchain = adapter_no3d_create_swapchain,
     .adapter_destroy_swapchain = adapter_no3d_destroy_swapchain,
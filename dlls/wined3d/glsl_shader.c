@@ -38,6 +38,8 @@
 
 WINE_DEFAULT_DEBUG_CHANNEL(d3d_shader);
 WINE_DECLARE_DEBUG_CHANNEL(d3d);
+WINE_DECLARE_DEBUG_CHANNEL(d3d_perf);
+WINE_DECLARE_DEBUG_CHANNEL(shader_cache);
 WINE_DECLARE_DEBUG_CHANNEL(winediag);
 
 #define WINED3D_GLSL_SAMPLE_PROJECTED   0x01
@@ -124,6 +126,56 @@ struct constant_heap
 };
 
 /* GLSL shader private data */
+#define WINED3D_GLSL_CACHE_MAGIC        0x43534c47u /* "GLSC" */
+#define WINED3D_GLSL_CACHE_VERSION      1
+
+/* Link state which isn't part of the GLSL source, folded into the cache key. */
+#define WINED3D_GLSL_LINK_DUAL_SOURCE   0x00010000u
+
+struct glsl_program_cache_header
+{
+    uint32_t magic;
+    uint32_t version;
+    uint64_t driver_hash;
+    uint64_t key;
+    uint32_t format;
+    uint32_t size;
+};
+
+enum glsl_program_cache_state
+{
+    GLSL_PROGRAM_CACHE_UNINITIALISED,
+    GLSL_PROGRAM_CACHE_ENABLED,
+    GLSL_PROGRAM_CACHE_DISABLED,
+};
+
+struct glsl_program_cache
+{
+    enum glsl_program_cache_state state;
+    char path[MAX_PATH];
+    uint64_t driver_hash;
+
+    unsigned int hits;
+    unsigned int misses;
+    unsigned int stores;
+    unsigned int failures;
+    uint64_t bytes_loaded;
+    uint64_t bytes_stored;
+};
+
+/* A d3d9 float constant file packed into a uniform buffer. The CPU copy
+ * mirrors the buffer contents, including the local constants of the last
+ * shader that used it, so that only the dirty range needs to be uploaded. */
+struct glsl_consts_ubo
+{
+    GLuint id;
+    unsigned int size;
+    struct wined3d_vec4 *data;
+    unsigned int dirty_start, dirty_end;
+    const struct wined3d_shader *lconst_shader;
+    BOOL clamped;
+};
+
 struct shader_glsl_priv
 {
     struct wined3d_string_buffer shader_buffer;
@@ -135,9 +187,9 @@ struct shader_glsl_priv
     UINT next_constant_version;
 
     BOOL consts_ubo;
-    GLuint ubo_vs_c;
+    struct glsl_consts_ubo vs_c_ubo;
+    struct glsl_consts_ubo ps_c_ubo;
     BOOL prev_device_swvp;
-    struct wined3d_vec4 vs_c_buffer[WINED3D_MAX_VS_CONSTS_F_SWVP];
     unsigned int max_vs_consts_f;
 
     const struct wined3d_vertex_pipe_ops *vertex_pipe;
@@ -149,6 +201,9 @@ struct shader_glsl_priv
 
     GLuint ubo_modelview;
     struct wined3d_matrix *modelview_buffer;
+
+    struct glsl_program_cache program_cache;
+    unsigned int link_count;
 };
 
 struct glsl_vs_program
@@ -241,6 +296,7 @@ struct glsl_ps_program
     GLint ycorrection_location;
     GLint np2_fixup_location;
     GLint color_key_location;
+    GLint ps_c_block_index;
     const struct ps_np2fixup_info *np2_fixup_info;
 };
 
@@ -650,6 +706,287 @@ void shader_glsl_validate_link(const struct wined3d_gl_info *gl_info, GLuint pro
     print_glsl_info_log(gl_info, program, TRUE);
 }
 
+static uint64_t glsl_program_cache_hash(uint64_t hash, const void *data, size_t size)
+{
+    const unsigned char *ptr = data;
+
+    /* 64-bit FNV-1a. */
+    while (size--)
+        hash = (hash ^ *ptr++) * 0x100000001b3ull;
+    return hash;
+}
+
+static int glsl_program_cache_hash_compare(const void *a, const void *b)
+{
+    const uint64_t *x = a, *y = b;
+
+    return (*x > *y) - (*x < *y);
+}
+
+static void glsl_program_cache_dump_stats(const struct glsl_program_cache *cache)
+{
+    TRACE_(shader_cache)("%u hits, %u misses, %u stores, %u failures, %s bytes loaded, %s bytes stored.\n",
+            cache->hits, cache->misses, cache->stores, cache->failures,
+            wine_dbgstr_longlong(cache->bytes_loaded), wine_dbgstr_longlong(cache->bytes_stored));
+}
+
+/* Context activation is done by the caller. */
+static BOOL glsl_program_cache_init(struct glsl_program_cache *cache, const struct wined3d_gl_info *gl_info)
+{
+    static const GLenum strings[] = {GL_VENDOR, GL_RENDERER, GL_VERSION, GL_SHADING_LANGUAGE_VERSION_ARB};
+    const char *str;
+    unsigned int i;
+    GLint count;
+    char *p;
+
+    cache->state = GLSL_PROGRAM_CACHE_DISABLED;
+
+    if (!wined3d_settings.shader_cache || !gl_info->supported[ARB_GET_PROGRAM_BINARY])
+        return FALSE;
+
+    gl_info->gl_ops.gl.p_glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &count);
+    if (!count)
+    {
+        TRACE_(shader_cache)("No program binary formats supported.\n");
+        return FALSE;
+    }
+
+    if (wined3d_settings.shader_cache_path)
+    {
+        lstrcpynA(cache->path, wined3d_settings.shader_cache_path, sizeof(cache->path));
+    }
+    else
+    {
+        i = GetEnvironmentVariableA("LOCALAPPDATA", cache->path, sizeof(cache->path));
+        if (!i || i + sizeof("\\wined3d\\glsl") > sizeof(cache->path))
+            return FALSE;
+        strcat(cache->path, "\\wined3d\\glsl");
+    }
+
+    /* Create the directory and any missing parents. */
+    for (p = cache->path + 3; (p = strchr(p, '\\')); ++p)
+    {
+        *p = 0;
+        CreateDirectoryA(cache->path, NULL);
+        *p = '\\';
+    }
+    if (!CreateDirectoryA(cache->path, NULL) && GetLastError() != ERROR_ALREADY_EXISTS)
+    {
+        WARN("Failed to create shader cache directory %s, error %u.\n", debugstr_a(cache->path), GetLastError());
+        return FALSE;
+    }
+
+    /* Binaries are only valid for the driver which produced them. */
+    cache->driver_hash = 0xcbf29ce484222325ull;
+    for (i = 0; i < ARRAY_SIZE(strings); ++i)
+    {
+        if ((str = (const char *)gl_info->gl_ops.gl.p_glGetString(strings[i])))
+            cache->driver_hash = glsl_program_cache_hash(cache->driver_hash, str, strlen(str) + 1);
+    }
+
+    TRACE_(shader_cache)("Using shader cache %s, driver hash %s.\n",
+            debugstr_a(cache->path), wine_dbgstr_longlong(cache->driver_hash));
+    cache->state = GLSL_PROGRAM_CACHE_ENABLED;
+    return TRUE;
+}
+
+/* Context activation is done by the caller. */
+static BOOL glsl_program_cache_get_key(const struct wined3d_gl_info *gl_info,
+        GLuint program_id, unsigned int link_flags, uint64_t *key)
+{
+    GLint i, shader_count, length, source_size = 0;
+    uint64_t *hashes = NULL;
+    GLuint *shaders;
+    char *source;
+    BOOL ret = FALSE;
+
+    GL_EXTCALL(glGetProgramiv(program_id, GL_ATTACHED_SHADERS, &shader_count));
+    if (!(shaders = heap_calloc(shader_count, sizeof(*shaders)))
+            || !(hashes = heap_calloc(shader_count, sizeof(*hashes))))
+    {
+        heap_free(shaders);
+        return FALSE;
+    }
+    GL_EXTCALL(glGetAttachedShaders(program_id, shader_count, NULL, shaders));
+
+    for (i = 0; i < shader_count; ++i)
+    {
+        GL_EXTCALL(glGetShaderiv(shaders[i], GL_SHADER_SOURCE_LENGTH, &length));
+        source_size = max(source_size, length);
+    }
+    if (!(source = heap_alloc(source_size + 1)))
+        goto done;
+
+    for (i = 0; i < shader_count; ++i)
+    {
+        GL_EXTCALL(glGetShaderSource(shaders[i], source_size + 1, &length, source));
+        hashes[i] = glsl_program_cache_hash(0xcbf29ce484222325ull, source, length);
+    }
+    heap_free(source);
+    checkGLcall("get shader sources");
+
+    /* The attachment order isn't significant. */
+    qsort(hashes, shader_count, sizeof(*hashes), glsl_program_cache_hash_compare);
+    *key = glsl_program_cache_hash(0xcbf29ce484222325ull, hashes, shader_count * sizeof(*hashes));
+    *key = glsl_program_cache_hash(*key, &link_flags, sizeof(link_flags));
+    ret = TRUE;
+
+done:
+    heap_free(hashes);
+    heap_free(shaders);
+    return ret;
+}
+
+static void glsl_program_cache_get_file_name(const struct glsl_program_cache *cache,
+        uint64_t key, char *name, size_t size)
+{
+    snprintf(name, size, "%s\\%08x%08x.bin", cache->path, (unsigned int)(key >> 32), (unsigned int)key);
+}
+
+/* Context activation is done by the caller. */
+static BOOL glsl_program_cache_load(struct glsl_program_cache *cache,
+        const struct wined3d_gl_info *gl_info, GLuint program_id, uint64_t key)
+{
+    struct glsl_program_cache_header header;
+    char name[MAX_PATH + 24];
+    void *binary = NULL;
+    BOOL ret = FALSE;
+    GLint status;
+    HANDLE file;
+    DWORD size;
+
+    glsl_program_cache_get_file_name(cache, key, name, sizeof(name));
+    file = CreateFileA(name, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, NULL, OPEN_EXISTING, 0, NULL);
+    if (file == INVALID_HANDLE_VALUE)
+        return FALSE;
+
+    if (!ReadFile(file, &header, sizeof(header), &size, NULL) || size != sizeof(header)
+            || header.magic != WINED3D_GLSL_CACHE_MAGIC || header.version != WINED3D_GLSL_CACHE_VERSION
+            || header.driver_hash != cache->driver_hash || header.key != key)
+    {
+        TRACE_(shader_cache)("Ignoring stale cache entry %s.\n", debugstr_a(name));
+        goto done;
+    }
+
+    if (!(binary = heap_alloc(header.size))
+            || !ReadFile(file, binary, header.size, &size, NULL) || size != header.size)
+        goto done;
+
+    GL_EXTCALL(glProgramBinary(program_id, header.format, binary, header.size));
+    GL_EXTCALL(glGetProgramiv(program_id, GL_LINK_STATUS, &status));
+    checkGLcall("glProgramBinary");
+    if (!status)
+    {
+        /* The driver may reject binaries for any reason, e.g. after an update
+         * which didn't change the version string. Link from source instead. */
+        TRACE_(shader_cache)("Driver rejected cache entry %s.\n", debugstr_a(name));
+        ++cache->failures;
+        goto done;
+    }
+
+    cache->bytes_loaded += header.size;
+    ret = TRUE;
+
+done:
+    heap_free(binary);
+    CloseHandle(file);
+    return ret;
+}
+
+/* Context activation is done by the caller. */
+static void glsl_program_cache_store(struct glsl_program_cache *cache,
+        const struct wined3d_gl_info *gl_info, GLuint program_id, uint64_t key)
+{
+    struct glsl_program_cache_header header;
+    char name[MAX_PATH + 24], tmp_name[MAX_PATH + 40];
+    GLint status, length;
+    void *binary;
+    HANDLE file;
+    DWORD size;
+    BOOL ret;
+
+    GL_EXTCALL(glGetProgramiv(program_id, GL_LINK_STATUS, &status));
+    if (!status)
+        return;
+    GL_EXTCALL(glGetProgramiv(program_id, GL_PROGRAM_BINARY_LENGTH, &length));
+    if (length <= 0 || !(binary = heap_alloc(length)))
+        return;
+
+    GL_EXTCALL(glGetProgramBinary(program_id, length, &length, &header.format, binary));
+    checkGLcall("glGetProgramBinary");
+
+    header.magic = WINED3D_GLSL_CACHE_MAGIC;
+    header.version = WINED3D_GLSL_CACHE_VERSION;
+    header.driver_hash = cache->driver_hash;
+    header.key = key;
+    header.size = length;
+
+    /* Write to a private file first, so that other processes never see a
+     * partially written entry. */
+    glsl_program_cache_get_file_name(cache, key, name, sizeof(name));
+    snprintf(tmp_name, sizeof(tmp_name), "%s.%x.tmp", name, GetCurrentProcessId());
+    file = CreateFileA(tmp_name, GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, 0, NULL);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        heap_free(binary);
+        return;
+    }
+    ret = WriteFile(file, &header, sizeof(header), &size, NULL) && size == sizeof(header)
+            && WriteFile(file, binary, length, &size, NULL) && size == length;
+    CloseHandle(file);
+    heap_free(binary);
+
+    if (ret && MoveFileExA(tmp_name, name, MOVEFILE_REPLACE_EXISTING))
+    {
+        ++cache->stores;
+        cache->bytes_stored += length;
+    }
+    else
+    {
+        WARN("Failed to write shader cache entry %s.\n", debugstr_a(name));
+        DeleteFileA(tmp_name);
+    }
+}
+
+/* Context activation is done by the caller. */
+static void shader_glsl_link_program(struct shader_glsl_priv *priv,
+        const struct wined3d_gl_info *gl_info, GLuint program_id, unsigned int link_flags, BOOL cacheable)
+{
+    struct glsl_program_cache *cache = &priv->program_cache;
+    uint64_t key;
+
+    ++priv->link_count;
+    if (cache->state == GLSL_PROGRAM_CACHE_UNINITIALISED)
+        glsl_program_cache_init(cache, gl_info);
+
+    if (!cacheable || cache->state != GLSL_PROGRAM_CACHE_ENABLED
+            || !glsl_program_cache_get_key(gl_info, program_id, link_flags, &key))
+    {
+        TRACE("Linking GLSL shader program %u.\n", program_id);
+        GL_EXTCALL(glLinkProgram(program_id));
+        shader_glsl_validate_link(gl_info, program_id);
+        return;
+    }
+
+    if (glsl_program_cache_load(cache, gl_info, program_id, key))
+    {
+        TRACE("Loaded GLSL shader program %u from the shader cache.\n", program_id);
+        ++cache->hits;
+    }
+    else
+    {
+        TRACE("Linking GLSL shader program %u.\n", program_id);
+        ++cache->misses;
+        GL_EXTCALL(glProgramParameteri(program_id, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE));
+        GL_EXTCALL(glLinkProgram(program_id));
+        shader_glsl_validate_link(gl_info, program_id);
+        glsl_program_cache_store(cache, gl_info, program_id, key);
+    }
+
+    if (TRACE_ON(shader_cache) && !((cache->hits + cache->misses) % 64))
+        glsl_program_cache_dump_stats(cache);
+}
+
 static BOOL shader_glsl_use_layout_qualifier(const struct wined3d_gl_info *gl_info)
 {
     /* Layout qualifiers were introduced in GLSL 1.40. The Nvidia Legacy GPU
@@ -1193,13 +1530,168 @@ static void walk_constant_heap_clamped(const struct wined3d_gl_info *gl_info,
     checkGLcall("walk_constant_heap_clamped()");
 }
 
-static void bind_and_orphan_consts_ubo(const struct wined3d_gl_info *gl_info, struct shader_glsl_priv *priv)
+static void glsl_consts_ubo_invalidate(struct glsl_consts_ubo *ubo, unsigned int start, unsigned int count)
 {
-    GL_EXTCALL(glBindBuffer(GL_UNIFORM_BUFFER, priv->ubo_vs_c));
-    checkGLcall("glBindBuffer");
-    GL_EXTCALL(glBufferData(GL_UNIFORM_BUFFER, priv->max_vs_consts_f * sizeof(struct wined3d_vec4),
-            NULL, GL_STREAM_DRAW));
-    checkGLcall("glBufferData");
+    if (start >= ubo->size)
+        return;
+    count = min(count, ubo->size - start);
+
+    ubo->dirty_start = min(ubo->dirty_start, start);
+    ubo->dirty_end = max(ubo->dirty_end, start + count);
+}
+
+static void glsl_consts_ubo_invalidate_lconsts(struct glsl_consts_ubo *ubo, const struct wined3d_shader *shader)
+{
+    const struct wined3d_shader_lconst *lconst;
+
+    LIST_FOR_EACH_ENTRY(lconst, &shader->constantsF, struct wined3d_shader_lconst, entry)
+    {
+        glsl_consts_ubo_invalidate(ubo, lconst->idx, 1);
+    }
+}
+
+/* The local constants of a destroyed shader may still be in the buffer. */
+static void glsl_consts_ubo_release_shader(struct glsl_consts_ubo *ubo, const struct wined3d_shader *shader)
+{
+    if (ubo->lconst_shader != shader)
+        return;
+
+    glsl_consts_ubo_invalidate_lconsts(ubo, shader);
+    ubo->lconst_shader = NULL;
+}
+
+static BOOL glsl_consts_ubo_init(struct glsl_consts_ubo *ubo, unsigned int size)
+{
+    ubo->id = 0;
+    ubo->size = size;
+    ubo->dirty_start = size;
+    ubo->dirty_end = 0;
+    ubo->lconst_shader = NULL;
+    ubo->clamped = FALSE;
+
+    return !!(ubo->data = heap_calloc(size, sizeof(*ubo->data)));
+}
+
+/* Context activation is done by the caller. */
+static void glsl_consts_ubo_cleanup(struct glsl_consts_ubo *ubo, const struct wined3d_gl_info *gl_info)
+{
+    if (ubo->id)
+    {
+        GL_EXTCALL(glDeleteBuffers(1, &ubo->id));
+        checkGLcall("glDeleteBuffers");
+    }
+    heap_free(ubo->data);
+}
+
+/* Context activation is done by the caller. */
+static void glsl_consts_ubo_bind(struct glsl_consts_ubo *ubo, const struct wined3d_gl_info *gl_info,
+        unsigned int binding)
+{
+    if (!ubo->id)
+    {
+        GL_EXTCALL(glGenBuffers(1, &ubo->id));
+        GL_EXTCALL(glBindBuffer(GL_UNIFORM_BUFFER, ubo->id));
+        checkGLcall("glBindBuffer (UBO)");
+        GL_EXTCALL(glBufferData(GL_UNIFORM_BUFFER, ubo->size * sizeof(*ubo->data), NULL, GL_DYNAMIC_DRAW));
+        checkGLcall("glBufferData");
+        glsl_consts_ubo_invalidate(ubo, 0, ubo->size);
+    }
+    GL_EXTCALL(glBindBufferBase(GL_UNIFORM_BUFFER, binding, ubo->id));
+    checkGLcall("glBindBufferBase");
+}
+
+/* Context activation is done by the caller. Constants past "constant_count"
+ * read as zero. */
+static void glsl_consts_ubo_load(struct glsl_consts_ubo *ubo, const struct wined3d_gl_info *gl_info,
+        const struct wined3d_shader *shader, const struct wined3d_vec4 *constants, unsigned int constant_count)
+{
+    const struct wined3d_shader *lconst_shader = shader->load_local_constsF ? shader : NULL;
+    const struct wined3d_shader_lconst *lconst;
+    struct wined3d_vec4 *dst;
+    unsigned int i;
+    BOOL clamped;
+
+    if (!ubo->id)
+    {
+        ERR("UBO is not initialized.\n");
+        return;
+    }
+
+    /* 1.X pshaders have the constants clamped to [-1;1] implicitly. */
+    clamped = shader->reg_maps.shader_version.major == 1
+            && shader->reg_maps.shader_version.type == WINED3D_SHADER_TYPE_PIXEL;
+    if (ubo->clamped != clamped)
+    {
+        glsl_consts_ubo_invalidate(ubo, 0, ubo->size);
+        ubo->clamped = clamped;
+    }
+
+    if (ubo->lconst_shader != lconst_shader)
+    {
+        if (ubo->lconst_shader)
+            glsl_consts_ubo_invalidate_lconsts(ubo, ubo->lconst_shader);
+        if (lconst_shader)
+            glsl_consts_ubo_invalidate_lconsts(ubo, lconst_shader);
+        ubo->lconst_shader = lconst_shader;
+    }
+
+    if (ubo->dirty_start >= ubo->dirty_end)
+        return;
+
+    for (i = ubo->dirty_start; i < ubo->dirty_end; ++i)
+    {
+        dst = &ubo->data[i];
+        if (i >= constant_count)
+        {
+            memset(dst, 0, sizeof(*dst));
+        }
+        else if (clamped)
+        {
+            dst->x = constants[i].x < -1.0f ? -1.0f : constants[i].x > 1.0f ? 1.0f : constants[i].x;
+            dst->y = constants[i].y < -1.0f ? -1.0f : constants[i].y > 1.0f ? 1.0f : constants[i].y;
+            dst->z = constants[i].z < -1.0f ? -1.0f : constants[i].z > 1.0f ? 1.0f : constants[i].z;
+            dst->w = constants[i].w < -1.0f ? -1.0f : constants[i].w > 1.0f ? 1.0f : constants[i].w;
+        }
+        else
+        {
+            *dst = constants[i];
+        }
+    }
+
+    /* Immediate constants are clamped to [-1;1] at shader creation time if needed */
+    if (lconst_shader)
+    {
+        LIST_FOR_EACH_ENTRY(lconst, &lconst_shader->constantsF, struct wined3d_shader_lconst, entry)
+        {
+            if (lconst->idx >= ubo->dirty_start && lconst->idx < ubo->dirty_end)
+                ubo->data[lconst->idx] = *(const struct wined3d_vec4 *)lconst->value;
+        }
+    }
+
+    TRACE("Uploading constants %u-%u to UBO %u.\n", ubo->dirty_start, ubo->dirty_end - 1, ubo->id);
+    GL_EXTCALL(glBindBuffer(GL_UNIFORM_BUFFER, ubo->id));
+    GL_EXTCALL(glBufferSubData(GL_UNIFORM_BUFFER, ubo->dirty_start * sizeof(*ubo->data),
+            (ubo->dirty_end - ubo->dirty_start) * sizeof(*ubo->data), &ubo->data[ubo->dirty_start]));
+    checkGLcall("glBufferSubData");
+
+    ubo->dirty_start = ubo->size;
+    ubo->dirty_end = 0;
+}
+
+/* The buffers are shared by all the contexts of the device, but the local
+ * constants and clamping in them follow the shaders of the context that
+ * uploaded last. The other contexts have to reload before their next draw,
+ * even if their own shaders didn't change. */
+static void glsl_consts_ubo_invalidate_contexts(const struct wined3d_device *device,
+        const struct wined3d_context *context, DWORD mask)
+{
+    unsigned int i;
+
+    for (i = 0; i < device->context_count; ++i)
+    {
+        if (device->contexts[i] != context)
+            device->contexts[i]->constant_update_mask |= mask;
+    }
 }
 
 /* Context activation is done by the caller. */
@@ -1210,47 +1702,24 @@ static void shader_glsl_load_constants_f(const struct wined3d_shader *shader, co
     const struct wined3d_shader_lconst *lconst;
     BOOL is_vertex_shader = shader->reg_maps.shader_version.type == WINED3D_SHADER_TYPE_VERTEX;
 
-    if (is_vertex_shader && priv->consts_ubo)
+    if (priv->consts_ubo)
     {
-        BOOL zero_sw_constants = !device_swvp && priv->prev_device_swvp;
-        const struct wined3d_vec4 *data;
-        unsigned int const_count;
-        unsigned max_const_used;
-
-        if (priv->ubo_vs_c == -1)
+        if (!is_vertex_shader)
         {
-            ERR("UBO is not initialized.\n");
+            glsl_consts_ubo_load(&priv->ps_c_ubo, gl_info, shader, constants, WINED3D_MAX_PS_CONSTS_F);
             return;
         }
 
-        bind_and_orphan_consts_ubo(gl_info, priv);
-        const_count = device_swvp ? priv->max_vs_consts_f : WINED3D_MAX_VS_CONSTS_F;
-        max_const_used = shader->reg_maps.usesrelconstF ? const_count : shader->reg_maps.constant_float_count;
-        if (shader->load_local_constsF || (zero_sw_constants && shader->reg_maps.usesrelconstF))
+        /* Leaving software vertex processing makes the extra constants read
+         * as zero again. */
+        if (device_swvp != priv->prev_device_swvp)
         {
-            data = priv->vs_c_buffer;
-            memcpy(priv->vs_c_buffer, constants, max_const_used * sizeof(*constants));
-            if (zero_sw_constants)
-            {
-                memset(&priv->vs_c_buffer[const_count], 0, (priv->max_vs_consts_f - WINED3D_MAX_VS_CONSTS_F)
-                        * sizeof(*constants));
-                priv->prev_device_swvp = FALSE;
-            }
-            if (shader->load_local_constsF)
-            {
-                LIST_FOR_EACH_ENTRY(lconst, &shader->constantsF, struct wined3d_shader_lconst, entry)
-                {
-                    priv->vs_c_buffer[lconst->idx] = *(const struct wined3d_vec4 *)lconst->value;
-                }
-            }
-        }
-        else
-        {
-            data = constants;
+            glsl_consts_ubo_invalidate(&priv->vs_c_ubo, WINED3D_MAX_VS_CONSTS_F,
+                    priv->max_vs_consts_f - WINED3D_MAX_VS_CONSTS_F);
+            priv->prev_device_swvp = device_swvp;
         }
-        GL_EXTCALL(glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(*constants)
-                * (zero_sw_constants ? priv->max_vs_consts_f : max_const_used), data));
-        checkGLcall("glBufferSubData");
+        glsl_consts_ubo_load(&priv->vs_c_ubo, gl_info, shader, constants,
+                device_swvp ? priv->max_vs_consts_f : WINED3D_MAX_VS_CONSTS_F);
         return;
     }
 
@@ -1612,17 +2081,12 @@ static void shader_glsl_load_constants(void *shader_priv, struct wined3d_context
                 &base, &count);
         if (priv->consts_ubo)
         {
-            if (priv->ubo_vs_c == -1)
-            {
-                GL_EXTCALL(glGenBuffers(1, &priv->ubo_vs_c));
-                GL_EXTCALL(glBindBuffer(GL_UNIFORM_BUFFER, priv->ubo_vs_c));
-                checkGLcall("glBindBuffer (UBO)");
-                GL_EXTCALL(glBufferData(GL_UNIFORM_BUFFER, priv->max_vs_consts_f * sizeof(struct wined3d_vec4),
-                        NULL, GL_STREAM_DRAW));
-                checkGLcall("glBufferData");
-            }
-            GL_EXTCALL(glBindBufferBase(GL_UNIFORM_BUFFER, base, priv->ubo_vs_c));
-            checkGLcall("glBindBufferBase");
+            unsigned int ps_base, ps_count;
+
+            glsl_consts_ubo_bind(&priv->vs_c_ubo, gl_info, base);
+            wined3d_gl_limits_get_uniform_block_range(&gl_info->limits, WINED3D_SHADER_TYPE_PIXEL,
+                    &ps_base, &ps_count);
+            glsl_consts_ubo_bind(&priv->ps_c_ubo, gl_info, ps_base);
         }
         if (gl_info->supported[ARB_UNIFORM_BUFFER_OBJECT]
                 && (context->device->adapter->d3d_info.wined3d_creation_flags & WINED3D_LEGACY_SHADER_CONSTANTS))
@@ -1642,6 +2106,10 @@ static void shader_glsl_load_constants(void *shader_priv, struct wined3d_context
         ctx_data->ubo_bound = TRUE;
     }
 
+    if (priv->consts_ubo && (update_mask & (WINED3D_SHADER_CONST_VS_F | WINED3D_SHADER_CONST_PS_F)))
+        glsl_consts_ubo_invalidate_contexts(context->device, context,
+                update_mask & (WINED3D_SHADER_CONST_VS_F | WINED3D_SHADER_CONST_PS_F));
+
     if (update_mask & WINED3D_SHADER_CONST_VS_F)
         shader_glsl_load_constants_f(vshader, gl_info, state->vs_consts_f,
                 prog->vs.uniform_f_locations, &priv->vconst_heap, priv->stack,
@@ -1955,7 +2423,10 @@ static void shader_glsl_update_float_vertex_constants(struct wined3d_device *dev
         WARN("Called without legacy shader constant mode.\n");
 
     if (priv->consts_ubo)
+    {
+        glsl_consts_ubo_invalidate(&priv->vs_c_ubo, start, count);
         return;
+    }
 
     for (i = start; i < count + start; ++i)
     {
@@ -1972,6 +2443,12 @@ static void shader_glsl_update_float_pixel_constants(struct wined3d_device *devi
     if (!(device->adapter->d3d_info.wined3d_creation_flags & WINED3D_LEGACY_SHADER_CONSTANTS))
         WARN("Called without legacy shader constant mode.\n");
 
+    if (priv->consts_ubo)
+    {
+        glsl_consts_ubo_invalidate(&priv->ps_c_ubo, start, count);
+        return;
+    }
+
     for (i = start; i < count + start; ++i)
     {
         update_heap_entry(heap, i, priv->next_constant_version);
@@ -2342,6 +2819,14 @@ static void shader_generate_glsl_declarations(const struct wined3d_context_gl *c
                 "    vec4 %s_c[%u];\n"
                 "};\n", prefix, min(shader->limits->constant_float, priv->max_vs_consts_f));
     }
+    else if (shader->limits->constant_float > 0 && priv->consts_ubo
+            && version->type == WINED3D_SHADER_TYPE_PIXEL)
+    {
+        shader_addline(buffer,"layout(std140) uniform ps_c_ubo\n"
+                "{ \n"
+                "    vec4 %s_c[%u];\n"
+                "};\n", prefix, min(shader->limits->constant_float, WINED3D_MAX_PS_CONSTS_F));
+    }
     else if (shader->limits->constant_float > 0)
     {
         unsigned max_constantsF;
@@ -10373,12 +10858,36 @@ static void shader_glsl_init_ps_uniform_locations(const struct wined3d_gl_info *
     unsigned int i;
     struct wined3d_string_buffer *name = string_buffer_get(&priv->string_buffers);
 
-    for (i = 0; i < ps_c_count; ++i)
+    ps->ps_c_block_index = -1;
+    if (priv->consts_ubo)
+    {
+        unsigned int base, count;
+
+        if (ps_c_count)
+        {
+            ps->ps_c_block_index = GL_EXTCALL(glGetUniformBlockIndex(program_id, "ps_c_ubo"));
+            checkGLcall("glGetUniformBlockIndex");
+        }
+        /* FFP fragment shaders don't use the constant file. */
+        if (ps->ps_c_block_index != -1)
+        {
+            wined3d_gl_limits_get_uniform_block_range(&gl_info->limits, WINED3D_SHADER_TYPE_PIXEL,
+                    &base, &count);
+            assert(count >= 1);
+            GL_EXTCALL(glUniformBlockBinding(program_id, ps->ps_c_block_index, base));
+            checkGLcall("glUniformBlockBinding");
+        }
+        memset(ps->uniform_f_locations, 0xff, sizeof(ps->uniform_f_locations));
+    }
+    else
     {
-        string_buffer_sprintf(name, "ps_c[%u]", i);
-        ps->uniform_f_locations[i] = GL_EXTCALL(glGetUniformLocation(program_id, name->buffer));
+        for (i = 0; i < ps_c_count; ++i)
+        {
+            string_buffer_sprintf(name, "ps_c[%u]", i);
+            ps->uniform_f_locations[i] = GL_EXTCALL(glGetUniformLocation(program_id, name->buffer));
+        }
+        memset(&ps->uniform_f_locations[ps_c_count], 0xff, (WINED3D_MAX_PS_CONSTS_F - ps_c_count) * sizeof(GLuint));
     }
-    memset(&ps->uniform_f_locations[ps_c_count], 0xff, (WINED3D_MAX_PS_CONSTS_F - ps_c_count) * sizeof(GLuint));
 
     for (i = 0; i < WINED3D_MAX_CONSTS_I; ++i)
     {
@@ -10484,9 +10993,7 @@ static HRESULT shader_glsl_compile_compute_shader(struct shader_glsl_priv *priv,
 
     list_add_head(&shader->linked_programs, &entry->cs.shader_entry);
 
-    TRACE("Linking GLSL shader program %u.\n", program_id);
-    GL_EXTCALL(glLinkProgram(program_id));
-    shader_glsl_validate_link(gl_info, program_id);
+    shader_glsl_link_program(priv, gl_info, program_id, 0, TRUE);
 
     GL_EXTCALL(glUseProgram(program_id));
     checkGLcall("glUseProgram");
@@ -10567,6 +11074,7 @@ static void set_glsl_shader_program(const struct wined3d_context_gl *context_gl,
     GLuint gs_id = 0;
     GLuint ps_id = 0;
     struct list *ps_list, *vs_list;
+    unsigned int link_flags;
     WORD attribs_map;
     struct wined3d_string_buffer *tmp_name;
 
@@ -10736,6 +11244,9 @@ static void set_glsl_shader_program(const struct wined3d_context_gl *context_gl,
     {
         attribs_map = (1u << WINED3D_FFP_ATTRIBS_COUNT) - 1;
     }
+    link_flags = attribs_map;
+    if (state->blend_state && state->blend_state->dual_source)
+        link_flags |= WINED3D_GLSL_LINK_DUAL_SOURCE;
 
     if (!shader_glsl_use_explicit_attrib_location(gl_info))
     {
@@ -10820,10 +11331,9 @@ static void set_glsl_shader_program(const struct wined3d_context_gl *context_gl,
         list_add_head(ps_list, &entry->ps.shader_entry);
     }
 
-    /* Link the program */
-    TRACE("Linking GLSL shader program %u.\n", program_id);
-    GL_EXTCALL(glLinkProgram(program_id));
-    shader_glsl_validate_link(gl_info, program_id);
+    /* Link the program. Transform feedback varyings aren't part of the
+     * cache key, so programs using stream output are always linked. */
+    shader_glsl_link_program(priv, gl_info, program_id, link_flags, !(gshader && gshader->u.gs.so_desc));
 
     shader_glsl_init_vs_uniform_locations(gl_info, priv, program_id, &entry->vs,
             vshader ? vshader->limits->constant_float : 0);
@@ -11004,12 +11514,24 @@ static void shader_glsl_select(void *shader_priv, struct wined3d_context *contex
     struct glsl_shader_prog_link *glsl_program;
     GLenum current_vertex_color_clamp;
     GLuint program_id, prev_id;
+    unsigned int link_count;
+    LARGE_INTEGER start;
+    BOOL track_stalls;
 
     priv->vertex_pipe->vp_enable(context, !use_vs(state));
     priv->fragment_pipe->fp_enable(context, !use_ps(state));
 
     prev_id = ctx_data->glsl_program ? ctx_data->glsl_program->id : 0;
+    link_count = priv->link_count;
+    /* Shader stalls are only reported through the d3d_perf channel and the
+     * frame profiler, don't query the counter on every draw otherwise. */
+    if ((track_stalls = TRACE_ON(d3d_perf) || context->device->cs->profiler))
+        QueryPerformanceCounter(&start);
     set_glsl_shader_program(context_gl, state, priv, ctx_data);
+    /* Shaders are translated and compiled on demand, so a new link means the
+     * draw waited for shader compilation. */
+    if (track_stalls && priv->link_count != link_count)
+        wined3d_device_add_shader_stall(context->device, &start);
     glsl_program = ctx_data->glsl_program;
 
     if (glsl_program)
@@ -11145,6 +11667,12 @@ static void shader_glsl_destroy(struct wined3d_shader *shader)
     const struct list *linked_programs;
     struct wined3d_context *context;
 
+    if (priv->consts_ubo)
+    {
+        glsl_consts_ubo_release_shader(&priv->vs_c_ubo, shader);
+        glsl_consts_ubo_release_shader(&priv->ps_c_ubo, shader);
+    }
+
     if (!shader_data || !shader_data->num_gl_shaders)
     {
         heap_free(shader_data);
@@ -11384,9 +11912,7 @@ static HRESULT shader_glsl_alloc(struct wined3d_device *device, const struct win
     if (!(device->create_parms.flags & (WINED3DCREATE_SOFTWARE_VERTEXPROCESSING | WINED3DCREATE_MIXED_VERTEXPROCESSING)))
         priv->max_vs_consts_f = min(priv->max_vs_consts_f, WINED3D_MAX_VS_CONSTS_F);
 
-    stack_size = priv->consts_ubo
-            ? wined3d_log2i(WINED3D_MAX_PS_CONSTS_F) + 1
-            : wined3d_log2i(max(priv->max_vs_consts_f, WINED3D_MAX_PS_CONSTS_F)) + 1;
+    stack_size = wined3d_log2i(max(priv->max_vs_consts_f, WINED3D_MAX_PS_CONSTS_F)) + 1;
     TRACE("consts_ubo %#x, max_vs_consts_f %u.\n", priv->consts_ubo, priv->max_vs_consts_f);
 
     string_buffer_list_init(&priv->string_buffers);
@@ -11424,12 +11950,19 @@ static HRESULT shader_glsl_alloc(struct wined3d_device *device, const struct win
         goto fail;
     }
 
-    if (!constant_heap_init(&priv->pconst_heap, WINED3D_MAX_PS_CONSTS_F))
+    if (!priv->consts_ubo && !constant_heap_init(&priv->pconst_heap, WINED3D_MAX_PS_CONSTS_F))
     {
         ERR("Failed to initialize pixel shader constant heap\n");
         goto fail;
     }
 
+    if (priv->consts_ubo && (!glsl_consts_ubo_init(&priv->vs_c_ubo, priv->max_vs_consts_f)
+            || !glsl_consts_ubo_init(&priv->ps_c_ubo, WINED3D_MAX_PS_CONSTS_F)))
+    {
+        ERR("Failed to initialize shader constant buffers.\n");
+        goto fail;
+    }
+
     wine_rb_init(&priv->program_lookup, glsl_program_key_compare);
 
     priv->next_constant_version = 1;
@@ -11453,11 +11986,11 @@ static HRESULT shader_glsl_alloc(struct wined3d_device *device, const struct win
     device->fragment_priv = fragment_priv;
     device->shader_priv = priv;
 
-    priv->ubo_vs_c = -1;
-
     return WINED3D_OK;
 
 fail:
+    heap_free(priv->ps_c_ubo.data);
+    heap_free(priv->vs_c_ubo.data);
     constant_heap_free(&priv->pconst_heap);
     constant_heap_free(&priv->vconst_heap);
     heap_free(priv->stack);
@@ -11473,6 +12006,8 @@ static void shader_glsl_free(struct wined3d_device *device, struct wined3d_conte
 {
     struct shader_glsl_priv *priv = device->shader_priv;
 
+    if (priv->program_cache.state == GLSL_PROGRAM_CACHE_ENABLED && TRACE_ON(shader_cache))
+        glsl_program_cache_dump_stats(&priv->program_cache);
     wine_rb_destroy(&priv->program_lookup, NULL, NULL);
     constant_heap_free(&priv->pconst_heap);
     constant_heap_free(&priv->vconst_heap);
@@ -11490,12 +12025,11 @@ static void shader_glsl_free(struct wined3d_device *device, struct wined3d_conte
     }
     HeapFree(GetProcessHeap(), 0, priv->modelview_buffer);
 
-    if (priv->ubo_vs_c != -1)
+    if (priv->consts_ubo)
     {
         const struct wined3d_gl_info *gl_info = &device->adapter->gl_info;
-        GL_EXTCALL(glDeleteBuffers(1, &priv->ubo_vs_c));
-        checkGLcall("glDeleteBuffers");
-        priv->ubo_vs_c = -1;
+        glsl_consts_ubo_cleanup(&priv->vs_c_ubo, gl_info);
+        glsl_consts_ubo_cleanup(&priv->ps_c_ubo, gl_info);
     }
     heap_free(device->shader_priv);
     device->shader_priv = NULL;
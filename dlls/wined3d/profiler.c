@@ -0,0 +1,616 @@
+/*
+ * Frame profiling for wined3d
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
+ */
+
+#include "config.h"
+
+#include <stdio.h>
+
+#include "wined3d_private.h"
+
+WINE_DEFAULT_DEBUG_CHANNEL(d3d);
+
+/* The profiler records one event stream per command stream, and writes it in
+ * the Chrome trace event format, which both chrome://tracing and Perfetto
+ * can load. Events are written as they complete, using the "JSON array"
+ * flavour of the format, which tolerates a missing closing bracket. That
+ * keeps the file usable if the application never destroys its device.
+ *
+ * All entry points except wined3d_profiler_create() and
+ * wined3d_profiler_destroy() are called from the thread executing the
+ * command stream. */
+
+#define WINED3D_PROFILER_BUFFER_SIZE    0x10000
+#define WINED3D_PROFILER_MAX_MARKS      64
+#define WINED3D_PROFILER_GPU_FRAMES     4
+/* The "thread" id used for GPU events. */
+#define WINED3D_PROFILER_GPU_TID        0
+
+struct wined3d_profiler_mark
+{
+    struct wined3d_query *query;
+    /* The name of the span starting at this mark, or NULL for the last mark
+     * of a frame. */
+    const char *name;
+    LONGLONG cpu_time;
+};
+
+struct wined3d_profiler_gpu_frame
+{
+    unsigned int frame_id;
+    unsigned int mark_count;
+    struct wined3d_profiler_mark marks[WINED3D_PROFILER_MAX_MARKS];
+};
+
+struct wined3d_profiler
+{
+    struct wined3d_device *device;
+
+    HANDLE file;
+    char buffer[WINED3D_PROFILER_BUFFER_SIZE];
+    size_t buffer_pos;
+    unsigned int event_count;
+
+    LONGLONG frequency, base_time;
+    DWORD pid, tid;
+
+    unsigned int frame_id;
+    LONGLONG frame_start, present_start;
+    unsigned int op_count[WINED3D_CS_OP_STOP];
+    unsigned int submit_count, batch_count;
+
+    /* A batch is a run of operations executed without the command stream
+     * running out of work. Batches separated by less than
+     * "batch_merge_ticks" are merged, mostly for the benefit of the
+     * single-threaded command stream, where every operation is submitted on
+     * its own. */
+    BOOL in_batch;
+    LONGLONG batch_start, batch_end, batch_merge_ticks;
+    unsigned int batch_op_count;
+
+    /* GPU timestamps. Marks are issued at the start of each render pass,
+     * i.e. on the first draw, clear or dispatch after the render targets
+     * change, and around the swapchain present. Frames whose results aren't
+     * available yet are kept in a small ring. */
+    BOOL gpu_disabled, pass_pending, frame_marked;
+    uint64_t gpu_frequency;
+    double gpu_last_end;
+    struct wined3d_query **free_queries;
+    SIZE_T free_queries_size, free_query_count;
+    struct wined3d_profiler_gpu_frame gpu_frame;
+    struct wined3d_profiler_gpu_frame pending_frames[WINED3D_PROFILER_GPU_FRAMES];
+    unsigned int pending_head, pending_count;
+    unsigned int dropped_frame_count;
+};
+
+static void wined3d_profiler_flush(struct wined3d_profiler *profiler)
+{
+    DWORD written;
+
+    if (profiler->buffer_pos && !WriteFile(profiler->file, profiler->buffer, profiler->buffer_pos, &written, NULL))
+        ERR("Failed to write frame trace, error %u.\n", GetLastError());
+    profiler->buffer_pos = 0;
+}
+
+static void WINAPIV wined3d_profiler_write_event(struct wined3d_profiler *profiler, const char *format, ...)
+{
+    size_t size;
+    va_list args;
+    int len;
+
+    for (;;)
+    {
+        size = sizeof(profiler->buffer) - profiler->buffer_pos;
+        va_start(args, format);
+        len = vsnprintf(profiler->buffer + profiler->buffer_pos, size, format, args);
+        va_end(args);
+
+        if (len < 0)
+            return;
+        if (len + 2 < size)
+            break;
+        if (!profiler->buffer_pos)
+        {
+            ERR("Event too large.\n");
+            return;
+        }
+        wined3d_profiler_flush(profiler);
+    }
+
+    /* Separate events, rather than terminate them, so the array stays valid
+     * JSON once it's closed. */
+    if (profiler->event_count++)
+    {
+        memmove(profiler->buffer + profiler->buffer_pos + 2, profiler->buffer + profiler->buffer_pos, len);
+        memcpy(profiler->buffer + profiler->buffer_pos, ",\n", 2);
+        len += 2;
+    }
+    profiler->buffer_pos += len;
+
+    if (profiler->buffer_pos > sizeof(profiler->buffer) / 2)
+        wined3d_profiler_flush(profiler);
+}
+
+/* Convert performance counter ticks to the microseconds used by the trace. */
+static double wined3d_profiler_us(const struct wined3d_profiler *profiler, LONGLONG time)
+{
+    return (time - profiler->base_time) * 1000000.0 / profiler->frequency;
+}
+
+static LONGLONG wined3d_profiler_now(void)
+{
+    LARGE_INTEGER now;
+
+    QueryPerformanceCounter(&now);
+    return now.QuadPart;
+}
+
+static void wined3d_profiler_write_thread_name(struct wined3d_profiler *profiler, DWORD tid, const char *name)
+{
+    wined3d_profiler_write_event(profiler,
+            "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%u,\"tid\":%u,\"args\":{\"name\":\"%s\"}}",
+            profiler->pid, tid, name);
+}
+
+static void wined3d_profiler_write_span(struct wined3d_profiler *profiler, const char *name,
+        const char *category, DWORD tid, double start, double end, const char *args)
+{
+    wined3d_profiler_write_event(profiler,
+            "{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"pid\":%u,\"tid\":%u,"
+            "\"ts\":%.3f,\"dur\":%.3f,\"args\":{%s}}",
+            name, category, profiler->pid, tid, start, end - start, args);
+}
+
+static void wined3d_profiler_flush_batch(struct wined3d_profiler *profiler)
+{
+    char args[32];
+
+    if (!profiler->batch_op_count)
+        return;
+
+    sprintf(args, "\"ops\":%u", profiler->batch_op_count);
+    wined3d_profiler_write_span(profiler, "CS batch", "cs", profiler->tid,
+            wined3d_profiler_us(profiler, profiler->batch_start),
+            wined3d_profiler_us(profiler, profiler->batch_end), args);
+    ++profiler->batch_count;
+    profiler->batch_op_count = 0;
+}
+
+static struct wined3d_query *wined3d_profiler_get_query(struct wined3d_profiler *profiler)
+{
+    struct wined3d_device *device = profiler->device;
+    struct wined3d_query *query;
+
+    if (profiler->free_query_count)
+        return profiler->free_queries[--profiler->free_query_count];
+
+    if (!profiler->gpu_frequency)
+    {
+        if (FAILED(wined3d_query_create(device, WINED3D_QUERY_TYPE_TIMESTAMP_DISJOINT,
+                NULL, &wined3d_null_parent_ops, &query)))
+            goto disable;
+        profiler->gpu_frequency = ((const struct wined3d_query_data_timestamp_disjoint *)query->data)->frequency;
+        query->query_ops->query_destroy(query);
+        if (!profiler->gpu_frequency)
+            goto disable;
+    }
+
+    if (FAILED(wined3d_query_create(device, WINED3D_QUERY_TYPE_TIMESTAMP,
+            NULL, &wined3d_null_parent_ops, &query)))
+        goto disable;
+
+    return query;
+
+disable:
+    WARN("GPU timestamps are not available, only recording CPU times.\n");
+    profiler->gpu_disabled = TRUE;
+    return NULL;
+}
+
+static void wined3d_profiler_put_query(struct wined3d_profiler *profiler, struct wined3d_query *query)
+{
+    if (!wined3d_array_reserve((void **)&profiler->free_queries, &profiler->free_queries_size,
+            profiler->free_query_count + 1, sizeof(*profiler->free_queries)))
+    {
+        query->query_ops->query_destroy(query);
+        return;
+    }
+    profiler->free_queries[profiler->free_query_count++] = query;
+}
+
+static void wined3d_profiler_release_frame(struct wined3d_profiler *profiler,
+        struct wined3d_profiler_gpu_frame *frame)
+{
+    unsigned int i;
+
+    for (i = 0; i < frame->mark_count; ++i)
+        wined3d_profiler_put_query(profiler, frame->marks[i].query);
+    frame->mark_count = 0;
+}
+
+static void wined3d_profiler_gpu_mark(struct wined3d_profiler *profiler, const char *name, LONGLONG cpu_time)
+{
+    struct wined3d_profiler_gpu_frame *frame = &profiler->gpu_frame;
+    struct wined3d_profiler_mark *mark;
+    struct wined3d_query *query;
+
+    if (profiler->gpu_disabled || !profiler->device->context_count)
+        return;
+
+    /* Keep room for the present marks; further passes are attributed to
+     * the last pass that got a mark. */
+    if (name && !strcmp(name, "Pass") && frame->mark_count >= WINED3D_PROFILER_MAX_MARKS - 2)
+        return;
+    if (frame->mark_count == WINED3D_PROFILER_MAX_MARKS)
+        return;
+
+    if (!(query = wined3d_profiler_get_query(profiler)))
+        return;
+    if (!query->query_ops->query_issue(query, WINED3DISSUE_END))
+    {
+        wined3d_profiler_put_query(profiler, query);
+        return;
+    }
+
+    mark = &frame->marks[frame->mark_count++];
+    mark->query = query;
+    mark->name = name;
+    mark->cpu_time = cpu_time;
+}
+
+/* Returns FALSE if the frame's results aren't available yet. */
+static BOOL wined3d_profiler_resolve_frame(struct wined3d_profiler *profiler,
+        struct wined3d_profiler_gpu_frame *frame)
+{
+    uint64_t timestamps[WINED3D_PROFILER_MAX_MARKS];
+    struct wined3d_query *query;
+    unsigned int i, pass = 0;
+    double start, anchor;
+    char args[48];
+
+    for (i = 0; i < frame->mark_count; ++i)
+    {
+        query = frame->marks[i].query;
+        if (!query->query_ops->query_poll(query, 0))
+            return FALSE;
+        timestamps[i] = *(const uint64_t *)query->data;
+        if (i && timestamps[i] < timestamps[i - 1])
+        {
+            WARN("Discarding GPU times of frame %u with non-monotonic timestamps.\n", frame->frame_id);
+            return TRUE;
+        }
+    }
+
+    if (frame->mark_count < 2)
+        return TRUE;
+
+    /* GPU and CPU clocks aren't correlated; GPU spans are placed relative
+     * to the CPU time the first mark of the frame was issued, without
+     * overlapping the previous GPU frame. Durations are exact. */
+    anchor = max(wined3d_profiler_us(profiler, frame->marks[0].cpu_time), profiler->gpu_last_end);
+#define GPU_US(t) (anchor + (double)((t) - timestamps[0]) * 1000000.0 / profiler->gpu_frequency)
+    sprintf(args, "\"frame\":%u", frame->frame_id);
+    wined3d_profiler_write_span(profiler, "GPU frame", "gpu", WINED3D_PROFILER_GPU_TID,
+            anchor, GPU_US(timestamps[frame->mark_count - 1]), args);
+    for (i = 0; i + 1 < frame->mark_count; ++i)
+    {
+        start = GPU_US(timestamps[i]);
+        if (!strcmp(frame->marks[i].name, "Pass"))
+            sprintf(args, "\"frame\":%u,\"pass\":%u", frame->frame_id, pass++);
+        else
+            sprintf(args, "\"frame\":%u", frame->frame_id);
+        wined3d_profiler_write_span(profiler, frame->marks[i].name, "gpu", WINED3D_PROFILER_GPU_TID,
+                start, GPU_US(timestamps[i + 1]), args);
+    }
+    profiler->gpu_last_end = GPU_US(timestamps[frame->mark_count - 1]);
+#undef GPU_US
+
+    return TRUE;
+}
+
+static void wined3d_profiler_resolve_frames(struct wined3d_profiler *profiler)
+{
+    struct wined3d_profiler_gpu_frame *frame;
+
+    while (profiler->pending_count)
+    {
+        frame = &profiler->pending_frames[profiler->pending_head];
+        if (!wined3d_profiler_resolve_frame(profiler, frame))
+            break;
+        wined3d_profiler_release_frame(profiler, frame);
+        profiler->pending_head = (profiler->pending_head + 1) % WINED3D_PROFILER_GPU_FRAMES;
+        --profiler->pending_count;
+    }
+}
+
+static void wined3d_profiler_end_gpu_frame(struct wined3d_profiler *profiler)
+{
+    struct wined3d_profiler_gpu_frame *frame;
+
+    if (!profiler->gpu_frame.mark_count)
+        return;
+
+    /* Don't stall the command stream waiting for the GPU; if it falls too
+     * far behind, the oldest frame is dropped instead. Reissuing its
+     * queries is safe. */
+    if (profiler->pending_count == WINED3D_PROFILER_GPU_FRAMES)
+    {
+        frame = &profiler->pending_frames[profiler->pending_head];
+        wined3d_profiler_release_frame(profiler, frame);
+        profiler->pending_head = (profiler->pending_head + 1) % WINED3D_PROFILER_GPU_FRAMES;
+        --profiler->pending_count;
+        ++profiler->dropped_frame_count;
+    }
+
+    frame = &profiler->pending_frames[(profiler->pending_head + profiler->pending_count)
+            % WINED3D_PROFILER_GPU_FRAMES];
+    frame->frame_id = profiler->gpu_frame.frame_id;
+    frame->mark_count = profiler->gpu_frame.mark_count;
+    memcpy(frame->marks, profiler->gpu_frame.marks, frame->mark_count * sizeof(*frame->marks));
+    ++profiler->pending_count;
+    profiler->gpu_frame.mark_count = 0;
+
+    wined3d_profiler_resolve_frames(profiler);
+}
+
+void wined3d_profiler_op(struct wined3d_profiler *profiler, enum wined3d_cs_op opcode)
+{
+    LONGLONG now = 0;
+    DWORD tid;
+
+    if (!profiler->in_batch)
+    {
+        now = wined3d_profiler_now();
+        if (!profiler->batch_op_count || now - profiler->batch_end > profiler->batch_merge_ticks)
+        {
+            wined3d_profiler_flush_batch(profiler);
+            profiler->batch_start = now;
+        }
+        profiler->in_batch = TRUE;
+
+        if ((tid = GetCurrentThreadId()) != profiler->tid)
+        {
+            wined3d_profiler_write_thread_name(profiler, tid, "wined3d CS");
+            profiler->tid = tid;
+        }
+    }
+
+    ++profiler->batch_op_count;
+    ++profiler->op_count[opcode];
+
+    switch (opcode)
+    {
+        case WINED3D_CS_OP_SET_RENDERTARGET_VIEWS:
+        case WINED3D_CS_OP_SET_DEPTH_STENCIL_VIEW:
+            profiler->pass_pending = TRUE;
+            break;
+
+        case WINED3D_CS_OP_CLEAR:
+        case WINED3D_CS_OP_DRAW:
+        case WINED3D_CS_OP_DISPATCH:
+        case WINED3D_CS_OP_CLEAR_UNORDERED_ACCESS_VIEW:
+            if (profiler->pass_pending)
+            {
+                wined3d_profiler_gpu_mark(profiler, "Pass", now ? now : wined3d_profiler_now());
+                profiler->pass_pending = FALSE;
+            }
+            break;
+
+        case WINED3D_CS_OP_PRESENT:
+            profiler->present_start = now ? now : wined3d_profiler_now();
+            wined3d_profiler_gpu_mark(profiler, "Present", profiler->present_start);
+            break;
+
+        default:
+            break;
+    }
+}
+
+void wined3d_profiler_end_batch(struct wined3d_profiler *profiler)
+{
+    if (!profiler->in_batch)
+        return;
+
+    profiler->batch_end = wined3d_profiler_now();
+    profiler->in_batch = FALSE;
+}
+
+void wined3d_profiler_submit(struct wined3d_profiler *profiler)
+{
+    wined3d_profiler_write_event(profiler,
+            "{\"name\":\"Submit\",\"cat\":\"gpu\",\"ph\":\"i\",\"s\":\"t\",\"pid\":%u,\"tid\":%u,\"ts\":%.3f}",
+            profiler->pid, GetCurrentThreadId(), wined3d_profiler_us(profiler, wined3d_profiler_now()));
+    ++profiler->submit_count;
+}
+
+static void wined3d_profiler_write_frame(struct wined3d_profiler *profiler, LONGLONG now, BOOL partial)
+{
+    const unsigned int *count = profiler->op_count;
+    struct wined3d_device *device = profiler->device;
+    unsigned int i, op_count, state_changes, uploads;
+    double frame_start, now_us;
+    char args[512];
+
+    now_us = wined3d_profiler_us(profiler, now);
+    frame_start = wined3d_profiler_us(profiler, profiler->frame_start);
+
+    for (i = 0, op_count = 0; i < WINED3D_CS_OP_STOP; ++i)
+        op_count += count[i];
+    for (i = WINED3D_CS_OP_SET_PREDICATION, state_changes = 0; i <= WINED3D_CS_OP_PUSH_CONSTANTS; ++i)
+        state_changes += count[i];
+    uploads = count[WINED3D_CS_OP_UPDATE_SUB_RESOURCE] + count[WINED3D_CS_OP_UNMAP];
+
+    sprintf(args, "\"frame\":%u,\"ops\":%u,\"draws\":%u,\"dispatches\":%u,\"clears\":%u,"
+            "\"state_changes\":%u,\"uploads\":%u,\"shader_stalls\":%u,\"shader_stall_ms\":%.3f,"
+            "\"submits\":%u,\"batches\":%u,\"dropped_gpu_frames\":%u%s",
+            profiler->frame_id, op_count, count[WINED3D_CS_OP_DRAW],
+            count[WINED3D_CS_OP_DISPATCH], count[WINED3D_CS_OP_CLEAR], state_changes, uploads,
+            device->shader_stall_count, device->shader_stall_time * 1000.0 / profiler->frequency,
+            profiler->submit_count, profiler->batch_count, profiler->dropped_frame_count,
+            partial ? ",\"partial\":true" : "");
+    wined3d_profiler_write_span(profiler, "Frame", "frame", profiler->tid, frame_start, now_us, args);
+
+    sprintf(args, "\"draws\":%u,\"state_changes\":%u,\"uploads\":%u,\"shader_stalls\":%u",
+            count[WINED3D_CS_OP_DRAW], state_changes, uploads, device->shader_stall_count);
+    wined3d_profiler_write_event(profiler,
+            "{\"name\":\"wined3d\",\"ph\":\"C\",\"pid\":%u,\"ts\":%.3f,\"args\":{%s}}",
+            profiler->pid, now_us, args);
+}
+
+/* Called by the swapchain after recording the present, before submitting
+ * it. The closing mark needs to go out with the present; issued from
+ * wined3d_profiler_present() it would only be submitted with the next frame. */
+void wined3d_profiler_present_mark(struct wined3d_profiler *profiler)
+{
+    if (profiler->frame_marked)
+        return;
+    wined3d_profiler_gpu_mark(profiler, NULL, 0);
+    profiler->frame_marked = TRUE;
+}
+
+/* Called after the swapchain presented, from wined3d_cs_exec_present(). */
+void wined3d_profiler_present(struct wined3d_profiler *profiler)
+{
+    LONGLONG now;
+
+    /* Swapchains that don't issue the mark themselves. */
+    if (!profiler->frame_marked)
+        wined3d_profiler_gpu_mark(profiler, NULL, 0);
+    profiler->frame_marked = FALSE;
+    wined3d_profiler_end_gpu_frame(profiler);
+
+    now = wined3d_profiler_now();
+
+    /* Close the current batch at the frame boundary. */
+    profiler->batch_end = now;
+    wined3d_profiler_flush_batch(profiler);
+    profiler->batch_start = now;
+
+    wined3d_profiler_write_span(profiler, "Present", "frame", profiler->tid,
+            wined3d_profiler_us(profiler, profiler->present_start), wined3d_profiler_us(profiler, now), "");
+    wined3d_profiler_write_frame(profiler, now, FALSE);
+
+    memset(profiler->op_count, 0, sizeof(profiler->op_count));
+    profiler->submit_count = 0;
+    profiler->batch_count = 0;
+    profiler->frame_start = now;
+    profiler->gpu_frame.frame_id = ++profiler->frame_id;
+    profiler->pass_pending = TRUE;
+}
+
+/* Called through wined3d_cs_destroy_object() before the device's contexts
+ * are destroyed. */
+void wined3d_profiler_release_queries(void *object)
+{
+    struct wined3d_profiler *profiler = object;
+
+    wined3d_profiler_resolve_frames(profiler);
+    while (profiler->pending_count)
+    {
+        wined3d_profiler_release_frame(profiler, &profiler->pending_frames[profiler->pending_head]);
+        profiler->pending_head = (profiler->pending_head + 1) % WINED3D_PROFILER_GPU_FRAMES;
+        --profiler->pending_count;
+        ++profiler->dropped_frame_count;
+    }
+    wined3d_profiler_release_frame(profiler, &profiler->gpu_frame);
+
+    while (profiler->free_query_count)
+    {
+        struct wined3d_query *query = profiler->free_queries[--profiler->free_query_count];
+
+        query->query_ops->query_destroy(query);
+    }
+    wined3d_profiler_flush(profiler);
+}
+
+struct wined3d_profiler *wined3d_profiler_create(struct wined3d_device *device)
+{
+    static LONG trace_count;
+    struct wined3d_profiler *profiler;
+    LARGE_INTEGER frequency;
+    char path[MAX_PATH];
+
+    if (!wined3d_settings.frame_trace_path)
+        return NULL;
+
+    if (!(profiler = heap_alloc_zero(sizeof(*profiler))))
+        return NULL;
+
+    profiler->pid = GetCurrentProcessId();
+    snprintf(path, sizeof(path), "%s-%u-%u.json", wined3d_settings.frame_trace_path,
+            profiler->pid, InterlockedIncrement(&trace_count));
+    if ((profiler->file = CreateFileA(path, GENERIC_WRITE, FILE_SHARE_READ, NULL,
+            CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL)) == INVALID_HANDLE_VALUE)
+    {
+        ERR("Failed to create frame trace %s, error %u.\n", debugstr_a(path), GetLastError());
+        heap_free(profiler);
+        return NULL;
+    }
+
+    profiler->device = device;
+    QueryPerformanceFrequency(&frequency);
+    profiler->frequency = frequency.QuadPart;
+    profiler->base_time = profiler->frame_start = wined3d_profiler_now();
+    profiler->batch_merge_ticks = profiler->frequency / 10000;
+    profiler->pass_pending = TRUE;
+
+    memcpy(profiler->buffer, "[\n", 2);
+    profiler->buffer_pos = 2;
+    wined3d_profiler_write_event(profiler,
+            "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%u,\"args\":{\"name\":\"wined3d device %p\"}}",
+            profiler->pid, device);
+    wined3d_profiler_write_thread_name(profiler, WINED3D_PROFILER_GPU_TID, "GPU");
+
+    TRACE("Writing frame trace for device %p to %s.\n", device, debugstr_a(path));
+
+    return profiler;
+}
+
+void wined3d_profiler_destroy(struct wined3d_profiler *profiler)
+{
+    unsigned int i;
+    LONGLONG now;
+
+    if (profiler->free_query_count || profiler->pending_count || profiler->gpu_frame.mark_count)
+        ERR("Profiler %p still has GPU queries.\n", profiler);
+
+    /* Write out whatever was recorded since the last present, so that
+     * applications which never present, or work done after the last
+     * present, still show up in the trace. */
+    now = wined3d_profiler_now();
+    if (profiler->in_batch)
+        profiler->batch_end = now;
+    wined3d_profiler_flush_batch(profiler);
+    for (i = 0; i < WINED3D_CS_OP_STOP; ++i)
+    {
+        if (profiler->op_count[i])
+        {
+            wined3d_profiler_write_frame(profiler, now, TRUE);
+            break;
+        }
+    }
+
+    if (profiler->buffer_pos + 3 > sizeof(profiler->buffer))
+        wined3d_profiler_flush(profiler);
+    memcpy(profiler->buffer + profiler->buffer_pos, "\n]\n", 3);
+    profiler->buffer_pos += 3;
+    wined3d_profiler_flush(profiler);
+
+    CloseHandle(profiler->file);
+    heap_free(profiler->free_queries);
+    heap_free(profiler);
+}
@@ -64,6 +64,14 @@ struct shader_spirv_priv
     bool ffp_proj_control;
 
     struct shader_spirv_resource_bindings bindings;
+
+    /* Background compilation of the variants we expect the first draw to
+     * use. Shaders are paired with the most recently created shader of the
+     * other stage to predict the binding layout. */
+    TP_POOL *compile_pool;
+    TP_CALLBACK_ENVIRON_V3 compile_env;
+    struct wined3d_shader *last_vs;
+    size_t last_ps_binding_count;
 };
 
 struct shader_spirv_compile_arguments
@@ -78,6 +86,18 @@ struct shader_spirv_compile_arguments
     } u;
 };
 
+struct shader_spirv_compile_job
+{
+    struct wined3d_device_vk *device_vk;
+    struct wined3d_shader_desc shader_desc;
+    enum wined3d_shader_type shader_type;
+    struct shader_spirv_compile_arguments args;
+    struct shader_spirv_resource_bindings bindings;
+
+    HANDLE event;
+    VkShaderModule vk_module;
+};
+
 struct shader_spirv_graphics_program_variant_vk
 {
     struct shader_spirv_compile_arguments compile_args;
@@ -85,6 +105,7 @@ struct shader_spirv_graphics_program_variant_vk
     size_t binding_base;
 
     VkShaderModule vk_module;
+    struct shader_spirv_compile_job *job;
 };
 
 struct shader_spirv_graphics_program_vk
@@ -303,7 +324,7 @@ static void shader_spirv_init_shader_interface_vk(struct wined3d_shader_spirv_sh
     iface->vkd3d_interface.uav_counter_count = b->uav_counter_count;
 }
 
-static VkShaderModule shader_spirv_compile_shader(struct wined3d_context_vk *context_vk,
+static VkShaderModule shader_spirv_compile_shader(struct wined3d_device_vk *device_vk,
         const struct wined3d_shader_desc *shader_desc, enum wined3d_shader_type shader_type,
         const struct shader_spirv_compile_arguments *args, const struct shader_spirv_resource_bindings *bindings,
         const struct wined3d_stream_output_desc *so_desc)
@@ -311,9 +332,8 @@ static VkShaderModule shader_spirv_compile_shader(struct wined3d_context_vk *con
     struct wined3d_shader_spirv_compile_args compile_args;
     struct wined3d_shader_spirv_shader_interface iface;
     VkShaderModuleCreateInfo shader_create_info;
+    const struct wined3d_vk_info *vk_info = &device_vk->vk_info;
     struct vkd3d_shader_compile_info info;
-    const struct wined3d_vk_info *vk_info;
-    struct wined3d_device_vk *device_vk;
     struct vkd3d_shader_code spirv;
     VkShaderModule module;
     char *messages;
@@ -356,9 +376,6 @@ static VkShaderModule shader_spirv_compile_shader(struct wined3d_context_vk *con
         return VK_NULL_HANDLE;
     }
 
-    device_vk = wined3d_device_vk(context_vk->c.device);
-    vk_info = &device_vk->vk_info;
-
     shader_create_info.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
     shader_create_info.pNext = NULL;
     shader_create_info.flags = 0;
@@ -376,10 +393,50 @@ static VkShaderModule shader_spirv_compile_shader(struct wined3d_context_vk *con
     return module;
 }
 
+static void shader_spirv_resource_bindings_cleanup(struct shader_spirv_resource_bindings *bindings)
+{
+    heap_free(bindings->vk_bindings);
+    heap_free(bindings->bindings);
+}
+
+static void shader_spirv_compile_job_destroy(struct shader_spirv_compile_job *job)
+{
+    if (job->event)
+        CloseHandle(job->event);
+    shader_spirv_resource_bindings_cleanup(&job->bindings);
+    heap_free(job);
+}
+
+/* Wait for the background compilation of "variant_vk" to finish and take
+ * ownership of the resulting module. If "device" is non-NULL, the time spent
+ * waiting is accounted as a shader compilation stall. */
+static bool shader_spirv_graphics_program_variant_finish_job(struct wined3d_device *device,
+        struct shader_spirv_graphics_program_variant_vk *variant_vk)
+{
+    struct shader_spirv_compile_job *job = variant_vk->job;
+    LARGE_INTEGER start;
+
+    if (WaitForSingleObject(job->event, 0) == WAIT_TIMEOUT)
+    {
+        TRACE("Waiting for background compilation of variant %p.\n", variant_vk);
+        QueryPerformanceCounter(&start);
+        WaitForSingleObject(job->event, INFINITE);
+        if (device)
+            wined3d_device_add_shader_stall(device, &start);
+    }
+
+    variant_vk->vk_module = job->vk_module;
+    variant_vk->job = NULL;
+    shader_spirv_compile_job_destroy(job);
+
+    return variant_vk->vk_module != VK_NULL_HANDLE;
+}
+
 static struct shader_spirv_graphics_program_variant_vk *shader_spirv_find_graphics_program_variant_vk(
         struct shader_spirv_priv *priv, struct wined3d_context_vk *context_vk, struct wined3d_shader *shader,
         const struct wined3d_state *state, const struct shader_spirv_resource_bindings *bindings)
 {
+    struct wined3d_device_vk *device_vk = wined3d_device_vk(context_vk->c.device);
     enum wined3d_shader_type shader_type = shader->reg_maps.shader_version.type;
     struct shader_spirv_graphics_program_variant_vk *variant_vk;
     size_t binding_base = bindings->binding_base[shader_type];
@@ -388,6 +445,7 @@ static struct shader_spirv_graphics_program_variant_vk *shader_spirv_find_graphi
     struct shader_spirv_compile_arguments args;
     struct wined3d_shader_desc shader_desc;
     size_t variant_count, i;
+    LARGE_INTEGER start;
 
     shader_spirv_compile_arguments_init(&args, &context_vk->c, shader, state, context_vk->sample_count);
     if (bindings->so_stage == shader_type)
@@ -402,7 +460,16 @@ static struct shader_spirv_graphics_program_variant_vk *shader_spirv_find_graphi
         variant_vk = &program_vk->variants[i];
         if (variant_vk->so_desc == so_desc && variant_vk->binding_base == binding_base
                 && !memcmp(&variant_vk->compile_args, &args, sizeof(args)))
+        {
+            if (variant_vk->job && !shader_spirv_graphics_program_variant_finish_job(&device_vk->d, variant_vk))
+            {
+                /* The background compilation failed, retry it synchronously below. */
+                program_vk->variants[i] = program_vk->variants[--program_vk->variant_count];
+                variant_count = program_vk->variant_count;
+                break;
+            }
             return variant_vk;
+        }
     }
 
     if (!wined3d_array_reserve((void **)&program_vk->variants, &program_vk->variants_size,
@@ -411,14 +478,18 @@ static struct shader_spirv_graphics_program_variant_vk *shader_spirv_find_graphi
 
     variant_vk = &program_vk->variants[variant_count];
     variant_vk->compile_args = args;
+    variant_vk->so_desc = so_desc;
     variant_vk->binding_base = binding_base;
+    variant_vk->job = NULL;
 
     shader_desc.byte_code = shader->byte_code;
     shader_desc.byte_code_size = shader->byte_code_size;
 
-    if (!(variant_vk->vk_module = shader_spirv_compile_shader(context_vk, &shader_desc, shader_type, &args,
+    QueryPerformanceCounter(&start);
+    if (!(variant_vk->vk_module = shader_spirv_compile_shader(device_vk, &shader_desc, shader_type, &args,
             bindings, so_desc)))
         return NULL;
+    wined3d_device_add_shader_stall(&device_vk->d, &start);
     ++program_vk->variant_count;
 
     return variant_vk;
@@ -445,7 +516,7 @@ static struct shader_spirv_compute_program_vk *shader_spirv_find_compute_program
     shader_desc.byte_code = shader->byte_code;
     shader_desc.byte_code_size = shader->byte_code_size;
 
-    if (!(program->vk_module = shader_spirv_compile_shader(context_vk, &shader_desc, WINED3D_SHADER_TYPE_COMPUTE,
+    if (!(program->vk_module = shader_spirv_compile_shader(device_vk, &shader_desc, WINED3D_SHADER_TYPE_COMPUTE,
             NULL, bindings, NULL)))
         return NULL;
 
@@ -484,12 +555,6 @@ static struct shader_spirv_compute_program_vk *shader_spirv_find_compute_program
     return program;
 }
 
-static void shader_spirv_resource_bindings_cleanup(struct shader_spirv_resource_bindings *bindings)
-{
-    heap_free(bindings->vk_bindings);
-    heap_free(bindings->bindings);
-}
-
 static bool shader_spirv_resource_bindings_add_vk_binding(struct shader_spirv_resource_bindings *bindings,
         VkDescriptorType vk_type, VkShaderStageFlagBits vk_stage, size_t *binding_idx)
 {
@@ -666,20 +731,72 @@ static enum wined3d_data_type wined3d_data_type_from_vkd3d(enum vkd3d_shader_res
     }
 }
 
-static bool shader_spirv_resource_bindings_init(struct shader_spirv_resource_bindings *bindings,
-        struct wined3d_shader_resource_bindings *wined3d_bindings,
-        const struct wined3d_state *state, uint32_t shader_mask)
+/* "wined3d_bindings" may be NULL when only the vkd3d bindings are needed. */
+static bool shader_spirv_resource_bindings_add_shader(struct shader_spirv_resource_bindings *bindings,
+        struct wined3d_shader_resource_bindings *wined3d_bindings, enum wined3d_shader_type shader_type,
+        const struct vkd3d_shader_scan_descriptor_info *descriptor_info)
 {
-    struct vkd3d_shader_scan_descriptor_info *descriptor_info;
     enum wined3d_shader_descriptor_type wined3d_type;
     enum vkd3d_shader_visibility shader_visibility;
-    enum wined3d_shader_type shader_type;
     VkDescriptorType vk_descriptor_type;
     VkShaderStageFlagBits vk_stage;
-    struct wined3d_shader *shader;
     size_t binding_idx;
     unsigned int i;
 
+    vk_stage = vk_shader_stage_from_wined3d(shader_type);
+    shader_visibility = vkd3d_shader_visibility_from_wined3d(shader_type);
+
+    for (i = 0; i < descriptor_info->descriptor_count; ++i)
+    {
+        struct vkd3d_shader_descriptor_info *d = &descriptor_info->descriptors[i];
+        uint32_t flags;
+
+        if (d->register_space)
+        {
+            WARN("Unsupported register space %u.\n", d->register_space);
+            return false;
+        }
+
+        if (d->resource_type == VKD3D_SHADER_RESOURCE_BUFFER)
+            flags = VKD3D_SHADER_BINDING_FLAG_BUFFER;
+        else
+            flags = VKD3D_SHADER_BINDING_FLAG_IMAGE;
+
+        vk_descriptor_type = vk_descriptor_type_from_vkd3d(d->type, d->resource_type);
+        if (!shader_spirv_resource_bindings_add_binding(bindings, d->type, vk_descriptor_type,
+                d->register_index, shader_visibility, vk_stage, flags, &binding_idx))
+            return false;
+
+        wined3d_type = wined3d_descriptor_type_from_vkd3d(d->type);
+        if (wined3d_bindings && !wined3d_shader_resource_bindings_add_binding(wined3d_bindings, shader_type,
+                wined3d_type, d->register_index, wined3d_shader_resource_type_from_vkd3d(d->resource_type),
+                wined3d_data_type_from_vkd3d(d->resource_data_type), binding_idx))
+            return false;
+
+        if (d->type == VKD3D_SHADER_DESCRIPTOR_TYPE_UAV
+                && (d->flags & VKD3D_SHADER_DESCRIPTOR_INFO_FLAG_UAV_COUNTER))
+        {
+            if (!shader_spirv_resource_bindings_add_uav_counter_binding(bindings,
+                    d->register_index, shader_visibility, vk_stage, &binding_idx))
+                return false;
+            if (wined3d_bindings && !wined3d_shader_resource_bindings_add_binding(wined3d_bindings,
+                    shader_type, WINED3D_SHADER_DESCRIPTOR_TYPE_UAV_COUNTER, d->register_index,
+                    WINED3D_SHADER_RESOURCE_BUFFER, WINED3D_DATA_UINT, binding_idx))
+                return false;
+        }
+    }
+
+    return true;
+}
+
+static bool shader_spirv_resource_bindings_init(struct shader_spirv_resource_bindings *bindings,
+        struct wined3d_shader_resource_bindings *wined3d_bindings,
+        const struct wined3d_state *state, uint32_t shader_mask)
+{
+    struct vkd3d_shader_scan_descriptor_info *descriptor_info;
+    enum wined3d_shader_type shader_type;
+    struct wined3d_shader *shader;
+
     bindings->binding_count = 0;
     bindings->uav_counter_count = 0;
     bindings->vk_binding_count = 0;
@@ -704,48 +821,8 @@ static bool shader_spirv_resource_bindings_init(struct shader_spirv_resource_bin
                 bindings->so_stage = WINED3D_SHADER_TYPE_VERTEX;
         }
 
-        vk_stage = vk_shader_stage_from_wined3d(shader_type);
-        shader_visibility = vkd3d_shader_visibility_from_wined3d(shader_type);
-
-        for (i = 0; i < descriptor_info->descriptor_count; ++i)
-        {
-            struct vkd3d_shader_descriptor_info *d = &descriptor_info->descriptors[i];
-            uint32_t flags;
-
-            if (d->register_space)
-            {
-                WARN("Unsupported register space %u.\n", d->register_space);
-                return false;
-            }
-
-            if (d->resource_type == VKD3D_SHADER_RESOURCE_BUFFER)
-                flags = VKD3D_SHADER_BINDING_FLAG_BUFFER;
-            else
-                flags = VKD3D_SHADER_BINDING_FLAG_IMAGE;
-
-            vk_descriptor_type = vk_descriptor_type_from_vkd3d(d->type, d->resource_type);
-            if (!shader_spirv_resource_bindings_add_binding(bindings, d->type, vk_descriptor_type,
-                    d->register_index, shader_visibility, vk_stage, flags, &binding_idx))
-                return false;
-
-            wined3d_type = wined3d_descriptor_type_from_vkd3d(d->type);
-            if (!wined3d_shader_resource_bindings_add_binding(wined3d_bindings, shader_type,
-                    wined3d_type, d->register_index, wined3d_shader_resource_type_from_vkd3d(d->resource_type),
-                    wined3d_data_type_from_vkd3d(d->resource_data_type), binding_idx))
-                return false;
-
-            if (d->type == VKD3D_SHADER_DESCRIPTOR_TYPE_UAV
-                    && (d->flags & VKD3D_SHADER_DESCRIPTOR_INFO_FLAG_UAV_COUNTER))
-            {
-                if (!shader_spirv_resource_bindings_add_uav_counter_binding(bindings,
-                        d->register_index, shader_visibility, vk_stage, &binding_idx))
-                    return false;
-                if (!wined3d_shader_resource_bindings_add_binding(wined3d_bindings,
-                        shader_type, WINED3D_SHADER_DESCRIPTOR_TYPE_UAV_COUNTER, d->register_index,
-                        WINED3D_SHADER_RESOURCE_BUFFER, WINED3D_DATA_UINT, binding_idx))
-                    return false;
-            }
-        }
+        if (!shader_spirv_resource_bindings_add_shader(bindings, wined3d_bindings, shader_type, descriptor_info))
+            return false;
     }
 
     return true;
@@ -803,9 +880,116 @@ static void shader_spirv_precompile_compute(struct wined3d_shader *shader)
     shader_spirv_scan_shader(shader, &program_vk->descriptor_info);
 }
 
+static size_t shader_spirv_get_vk_binding_count(const struct vkd3d_shader_scan_descriptor_info *descriptor_info)
+{
+    size_t count = descriptor_info->descriptor_count;
+    unsigned int i;
+
+    for (i = 0; i < descriptor_info->descriptor_count; ++i)
+    {
+        const struct vkd3d_shader_descriptor_info *d = &descriptor_info->descriptors[i];
+
+        if (d->type == VKD3D_SHADER_DESCRIPTOR_TYPE_UAV && (d->flags & VKD3D_SHADER_DESCRIPTOR_INFO_FLAG_UAV_COUNTER))
+            ++count;
+    }
+
+    return count;
+}
+
+static void CALLBACK shader_spirv_compile_job_cb(TP_CALLBACK_INSTANCE *instance, void *ctx)
+{
+    struct shader_spirv_compile_job *job = ctx;
+
+    TRACE("Compiling job %p.\n", job);
+
+    job->vk_module = shader_spirv_compile_shader(job->device_vk, &job->shader_desc,
+            job->shader_type, &job->args, &job->bindings, NULL);
+    SetEvent(job->event);
+}
+
+/* Queue a background compilation of the variant of "shader" that a draw
+ * without stream output is most likely to need, assuming the stage's
+ * descriptors start at "binding_base". The job owns a copy of everything it
+ * needs except the shader byte code, which outlives it because
+ * shader_spirv_destroy() waits for pending jobs. */
+static void shader_spirv_queue_graphics_program_variant(struct shader_spirv_priv *priv,
+        struct wined3d_shader *shader, size_t binding_base)
+{
+    enum wined3d_shader_type shader_type = shader->reg_maps.shader_version.type;
+    struct shader_spirv_graphics_program_variant_vk *variant_vk;
+    struct shader_spirv_graphics_program_vk *program_vk;
+    struct shader_spirv_compile_arguments args;
+    struct shader_spirv_compile_job *job;
+    size_t i;
+
+    if (!priv->compile_pool || !(program_vk = shader->backend_data) || !shader->function)
+        return;
+
+    memset(&args, 0, sizeof(args));
+    if (shader_type == WINED3D_SHADER_TYPE_PIXEL)
+        args.u.fs.sample_count = 1;
+
+    for (i = 0; i < program_vk->variant_count; ++i)
+    {
+        variant_vk = &program_vk->variants[i];
+        if (!variant_vk->so_desc && variant_vk->binding_base == binding_base
+                && !memcmp(&variant_vk->compile_args, &args, sizeof(args)))
+            return;
+    }
+
+    if (!wined3d_array_reserve((void **)&program_vk->variants, &program_vk->variants_size,
+            program_vk->variant_count + 1, sizeof(*program_vk->variants)))
+        return;
+
+    if (!(job = heap_alloc_zero(sizeof(*job))))
+        return;
+    job->device_vk = wined3d_device_vk(shader->device);
+    job->shader_desc.byte_code = shader->byte_code;
+    job->shader_desc.byte_code_size = shader->byte_code_size;
+    job->shader_type = shader_type;
+    job->args = args;
+
+    /* Only the bindings of this stage matter to the compiler; the preceding
+     * stages merely offset the binding indices. */
+    if (binding_base)
+    {
+        if (!wined3d_array_reserve((void **)&job->bindings.vk_bindings, &job->bindings.vk_bindings_size,
+                binding_base, sizeof(*job->bindings.vk_bindings)))
+            goto fail;
+        memset(job->bindings.vk_bindings, 0, binding_base * sizeof(*job->bindings.vk_bindings));
+        job->bindings.vk_binding_count = binding_base;
+    }
+    job->bindings.binding_base[shader_type] = binding_base;
+    if (!shader_spirv_resource_bindings_add_shader(&job->bindings, NULL, shader_type, &program_vk->descriptor_info))
+        goto fail;
+
+    if (!(job->event = CreateEventW(NULL, TRUE, FALSE, NULL)))
+        goto fail;
+
+    if (!TrySubmitThreadpoolCallback(shader_spirv_compile_job_cb, job, (TP_CALLBACK_ENVIRON *)&priv->compile_env))
+    {
+        WARN("Failed to submit compile job, error %u.\n", GetLastError());
+        goto fail;
+    }
+
+    TRACE("Queued job %p for shader %p, binding base %lu.\n", job, shader, (unsigned long)binding_base);
+
+    variant_vk = &program_vk->variants[program_vk->variant_count++];
+    variant_vk->compile_args = args;
+    variant_vk->so_desc = NULL;
+    variant_vk->binding_base = binding_base;
+    variant_vk->vk_module = VK_NULL_HANDLE;
+    variant_vk->job = job;
+    return;
+
+fail:
+    shader_spirv_compile_job_destroy(job);
+}
+
 static void shader_spirv_precompile(void *shader_priv, struct wined3d_shader *shader)
 {
     struct shader_spirv_graphics_program_vk *program_vk;
+    struct shader_spirv_priv *priv = shader_priv;
 
     TRACE("shader_priv %p, shader %p.\n", shader_priv, shader);
 
@@ -823,6 +1007,32 @@ static void shader_spirv_precompile(void *shader_priv, struct wined3d_shader *sh
     }
 
     shader_spirv_scan_shader(shader, &program_vk->descriptor_info);
+
+    if (shader->reg_maps.shader_version.major < 4)
+        return;
+
+    /* The pixel shader's bindings always come first, so its likely variant
+     * is known up front. The vertex shader's bindings follow those of the
+     * pixel shader it is drawn with; assume that is the pixel shader created
+     * around the same time, and recompile the last vertex shader against a
+     * newly created pixel shader as well. */
+    switch (shader->reg_maps.shader_version.type)
+    {
+        case WINED3D_SHADER_TYPE_PIXEL:
+            priv->last_ps_binding_count = shader_spirv_get_vk_binding_count(&program_vk->descriptor_info);
+            shader_spirv_queue_graphics_program_variant(priv, shader, 0);
+            if (priv->last_vs)
+                shader_spirv_queue_graphics_program_variant(priv, priv->last_vs, priv->last_ps_binding_count);
+            break;
+
+        case WINED3D_SHADER_TYPE_VERTEX:
+            priv->last_vs = shader;
+            shader_spirv_queue_graphics_program_variant(priv, shader, priv->last_ps_binding_count);
+            break;
+
+        default:
+            break;
+    }
 }
 
 static void shader_spirv_select(void *shader_priv, struct wined3d_context *context,
@@ -1008,10 +1218,14 @@ static void shader_spirv_destroy(struct wined3d_shader *shader)
 {
     struct wined3d_device_vk *device_vk = wined3d_device_vk(shader->device);
     struct shader_spirv_graphics_program_variant_vk *variant_vk;
+    struct shader_spirv_priv *priv = device_vk->d.shader_priv;
     struct wined3d_vk_info *vk_info = &device_vk->vk_info;
     struct shader_spirv_graphics_program_vk *program_vk;
     size_t i;
 
+    if (priv->last_vs == shader)
+        priv->last_vs = NULL;
+
     if (!shader->backend_data)
         return;
 
@@ -1025,6 +1239,8 @@ static void shader_spirv_destroy(struct wined3d_shader *shader)
     for (i = 0; i < program_vk->variant_count; ++i)
     {
         variant_vk = &program_vk->variants[i];
+        if (variant_vk->job && !shader_spirv_graphics_program_variant_finish_job(NULL, variant_vk))
+            continue;
         shader_spirv_invalidate_contexts_graphics_program_variant(&device_vk->d, variant_vk);
         VK_CALL(vkDestroyShaderModule(device_vk->vk_device, variant_vk->vk_module, NULL));
     }
@@ -1066,6 +1282,26 @@ static HRESULT shader_spirv_alloc(struct wined3d_device *device,
     priv->ffp_proj_control = fragment_caps.wined3d_caps & WINED3D_FRAGMENT_CAP_PROJ_CONTROL;
     memset(&priv->bindings, 0, sizeof(priv->bindings));
 
+    memset(&priv->compile_env, 0, sizeof(priv->compile_env));
+    if ((priv->compile_pool = CreateThreadpool(NULL)))
+    {
+        SYSTEM_INFO system_info;
+
+        /* Leave a processor for the application and CS threads. */
+        GetSystemInfo(&system_info);
+        SetThreadpoolThreadMaximum(priv->compile_pool, max(system_info.dwNumberOfProcessors, 2) - 1);
+        priv->compile_env.Version = 3;
+        priv->compile_env.Pool = priv->compile_pool;
+        priv->compile_env.CallbackPriority = TP_CALLBACK_PRIORITY_NORMAL;
+        priv->compile_env.Size = sizeof(priv->compile_env);
+    }
+    else
+    {
+        WARN("Failed to create shader compilation thread pool, error %u.\n", GetLastError());
+    }
+    priv->last_vs = NULL;
+    priv->last_ps_binding_count = 0;
+
     device->vertex_priv = vertex_priv;
     device->fragment_priv = fragment_priv;
     device->shader_priv = priv;
@@ -1077,6 +1313,8 @@ static void shader_spirv_free(struct wined3d_device *device, struct wined3d_cont
 {
     struct shader_spirv_priv *priv = device->shader_priv;
 
+    if (priv->compile_pool)
+        CloseThreadpool(priv->compile_pool);
     shader_spirv_resource_bindings_cleanup(&priv->bindings);
     priv->fragment_pipe->free_private(device, context);
     priv->vertex_pipe->vp_free(device, context);
@@ -1130,7 +1368,8 @@ static uint64_t shader_spirv_compile(struct wined3d_context *context, const stru
         enum wined3d_shader_type shader_type)
 {
     struct shader_spirv_resource_bindings bindings = {0};
-    return (uint64_t)shader_spirv_compile_shader(wined3d_context_vk(context), shader_desc, shader_type, NULL, &bindings, NULL);
+    return (uint64_t)shader_spirv_compile_shader(wined3d_device_vk(context->device),
+            shader_desc, shader_type, NULL, &bindings, NULL);
 }
 
 static const struct wined3d_shader_backend_ops spirv_shader_backend_vk =
@@ -630,6 +630,10 @@ static void swapchain_gl_present(struct wined3d_swapchain *swapchain,
         if (swapchain_gl->context_count > 1)
             gl_info->gl_ops.gl.p_glFinish();
 
+        /* Close the profiled frame before the swap flushes the command stream. */
+        if (swapchain->device->cs->profiler)
+            wined3d_profiler_present_mark(swapchain->device->cs->profiler);
+
         /* call wglSwapBuffers through the gl table to avoid confusing the Steam overlay */
         gl_info->gl_ops.wgl.p_wglSwapBuffers(context_gl->dc);
     }
@@ -1152,6 +1156,10 @@ static VkResult wined3d_swapchain_vk_blit(struct wined3d_swapchain_vk *swapchain
             back_buffer_vk->image.vk_image, &vk_range);
     back_buffer_vk->bind_mask = 0;
 
+    /* Close the profiled frame in the command buffer that presents it. */
+    if (device_vk->d.cs->profiler)
+        wined3d_profiler_present_mark(device_vk->d.cs->profiler);
+
     swapchain_vk->vk_semaphores[present_idx].command_buffer_id = context_vk->current_command_buffer.id;
     wined3d_context_vk_submit_command_buffer(context_vk,
             1, &swapchain_vk->vk_semaphores[present_idx].available, &wait_stage,
@@ -4809,7 +4809,9 @@ static void wined3d_texture_vk_upload_data(struct wined3d_context *context,
         vk_barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
         vk_barrier.buffer = src_bo->vk_buffer;
         vk_barrier.offset = src_bo->b.buffer_offset + (size_t)src_bo_addr->addr;
-        vk_barrier.size = sub_resource->size;
+        /* The source may be suballocated from a larger staging buffer, and
+         * needn't cover the whole sub-resource. */
+        vk_barrier.size = VK_WHOLE_SIZE;
 
         src_offset += (size_t)src_bo_addr->addr;
 
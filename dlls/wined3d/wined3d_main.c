@@ -124,6 +124,7 @@ struct wined3d_settings wined3d_settings =
     .max_sm_cs = UINT_MAX,
     .renderer = WINED3D_RENDERER_AUTO,
     .shader_backend = WINED3D_SHADER_BACKEND_AUTO,
+    .shader_cache = TRUE,
 };
 
 struct wined3d * CDECL wined3d_create(DWORD flags)
@@ -400,6 +401,26 @@ static BOOL wined3d_dll_init(HINSTANCE hInstDLL)
             TRACE("Forcing all constant buffers to be write-mappable.\n");
             wined3d_settings.cb_access_map_w = TRUE;
         }
+        if (!get_config_key_dword(hkey, appkey, "ShaderCache", &wined3d_settings.shader_cache))
+            ERR_(winediag)("Setting shader cache to %#x.\n", wined3d_settings.shader_cache);
+        if (!get_config_key(hkey, appkey, "ShaderCachePath", buffer, size))
+        {
+            size_t len = strlen(buffer) + 1;
+
+            if (!(wined3d_settings.shader_cache_path = heap_alloc(len)))
+                ERR("Failed to allocate shader cache path memory.\n");
+            else
+                memcpy(wined3d_settings.shader_cache_path, buffer, len);
+        }
+        if (!get_config_key(hkey, appkey, "FrameTracePath", buffer, size))
+        {
+            size_t len = strlen(buffer) + 1;
+
+            if (!(wined3d_settings.frame_trace_path = heap_alloc(len)))
+                ERR("Failed to allocate frame trace path memory.\n");
+            else
+                memcpy(wined3d_settings.frame_trace_path, buffer, len);
+        }
     }
 
     if (appkey) RegCloseKey( appkey );
@@ -442,6 +463,8 @@ static BOOL wined3d_dll_destroy(HINSTANCE hInstDLL)
     heap_free(swapchain_state_table.hooks);
 
     heap_free(wined3d_settings.logo);
+    heap_free(wined3d_settings.shader_cache_path);
+    heap_free(wined3d_settings.frame_trace_path);
     UnregisterClassA(WINED3D_OPENGL_WINDOW_CLASS_NAME, hInstDLL);
 
     DeleteCriticalSection(&wined3d_command_cs);
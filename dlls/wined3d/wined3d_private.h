@@ -501,6 +501,9 @@ struct wined3d_settings
     enum wined3d_renderer renderer;
     enum wined3d_shader_backend shader_backend;
     BOOL cb_access_map_w;
+    unsigned int shader_cache;
+    char *shader_cache_path;
+    char *frame_trace_path;
 };
 
 extern struct wined3d_settings wined3d_settings DECLSPEC_HIDDEN;
@@ -1605,8 +1608,71 @@ struct wined3d_bo
     size_t buffer_offset;
     size_t memory_offset;
     bool coherent;
+    /* The streaming block this bo was suballocated from, if any. */
+    struct wined3d_bo_ring_block *ring_block;
 };
 
+#define WINED3D_BO_RING_BLOCK_SIZE      0x400000
+#define WINED3D_BO_RING_MAX_BLOCKS      16
+
+/* DISCARD maps of dynamic buffers are suballocated linearly from large,
+ * persistently mapped blocks. A block is recycled as a whole once all of its
+ * suballocations have been released and the GPU is done with them. */
+struct wined3d_bo_ring_block
+{
+    struct list entry;
+    struct wined3d_bo *bo;
+    size_t size;
+    size_t offset;
+    unsigned int suballocation_count;
+    uint64_t fence_id;
+};
+
+struct wined3d_bo_stats
+{
+    unsigned int alloc_count;
+    unsigned int suballoc_count;
+    uint64_t mapped_bytes;
+};
+
+struct wined3d_bo_ring
+{
+    CRITICAL_SECTION cs;
+    struct wined3d_bo_ring_block *current;
+    struct list blocks;
+    unsigned int block_count;
+    bool block_pending;
+    /* Newest GL fence or Vulkan command buffer id known to be complete. Set
+     * by the CS thread, read by the allocator on the application thread. */
+    LONG64 completed_id;
+
+    struct wined3d_bo_stats stats;
+};
+
+void wined3d_bo_ring_init(struct wined3d_bo_ring *ring) DECLSPEC_HIDDEN;
+void wined3d_bo_ring_cleanup(struct wined3d_bo_ring *ring) DECLSPEC_HIDDEN;
+bool wined3d_bo_ring_suballoc(struct wined3d_bo_ring *ring, size_t size, size_t alignment,
+        struct wined3d_bo_ring_block **block, size_t *offset) DECLSPEC_HIDDEN;
+bool wined3d_bo_ring_reserve_block(struct wined3d_bo_ring *ring) DECLSPEC_HIDDEN;
+void wined3d_bo_ring_add_block(struct wined3d_bo_ring *ring, struct wined3d_bo *bo, size_t size) DECLSPEC_HIDDEN;
+void wined3d_bo_ring_release(struct wined3d_bo_ring *ring,
+        struct wined3d_bo_ring_block *block, uint64_t fence_id) DECLSPEC_HIDDEN;
+void wined3d_bo_ring_destroy_blocks(struct wined3d_bo_ring *ring, struct wined3d_context *context) DECLSPEC_HIDDEN;
+void wined3d_bo_ring_add_stats(struct wined3d_bo_ring *ring,
+        unsigned int alloc_count, uint64_t mapped_bytes) DECLSPEC_HIDDEN;
+void wined3d_bo_ring_get_stats(struct wined3d_bo_ring *ring, struct wined3d_bo_stats *stats) DECLSPEC_HIDDEN;
+
+static inline void wined3d_bo_ring_set_completed_id(struct wined3d_bo_ring *ring, uint64_t id)
+{
+    LONG64 old;
+
+    /* There's no InterlockedExchange64() in our headers. */
+    do
+    {
+        old = ring->completed_id;
+    } while (InterlockedCompareExchange64(&ring->completed_id, id, old) != old);
+}
+
 struct wined3d_bo_gl
 {
     struct wined3d_bo b;
@@ -3255,6 +3321,7 @@ struct wined3d_gl_limits
     UINT vertex_attribs;
 
     unsigned int texture_buffer_offset_alignment;
+    unsigned int uniform_buffer_offset_alignment;
 
     unsigned int framebuffer_width;
     unsigned int framebuffer_height;
@@ -3365,6 +3432,7 @@ bool wined3d_driver_info_init(struct wined3d_driver_info *driver_info,
 
 #define UPLOAD_BO_UPLOAD_ON_UNMAP   0x1
 #define UPLOAD_BO_RENAME_ON_UNMAP   0x2
+#define UPLOAD_BO_FREE_ON_UPLOAD    0x4
 
 struct upload_bo
 {
@@ -3399,6 +3467,8 @@ struct wined3d_adapter_ops
             const struct wined3d_const_bo_address *data, size_t size);
     bool (*adapter_alloc_bo)(struct wined3d_device *device, struct wined3d_resource *resource,
             unsigned int sub_resource_idx, struct wined3d_bo_address *addr);
+    bool (*adapter_alloc_upload_bo)(struct wined3d_device *device, struct wined3d_resource *resource,
+            unsigned int sub_resource_idx, size_t size, struct wined3d_bo_address *addr);
     void (*adapter_destroy_bo)(struct wined3d_context *context, struct wined3d_bo *bo);
     HRESULT (*adapter_create_swapchain)(struct wined3d_device *device,
             struct wined3d_swapchain_desc *desc,
@@ -3930,11 +4000,28 @@ struct wined3d_device
     /* Command stream */
     struct wined3d_cs *cs;
 
+    /* Time the CS thread spent waiting for shader compilation in the current
+     * frame, in performance counter ticks. */
+    LONGLONG shader_stall_time;
+    unsigned int shader_stall_count;
+
+    /* Suballocator for DISCARD maps of dynamic buffers. */
+    struct wined3d_bo_ring bo_ring;
+
     /* Context management */
     struct wined3d_context **contexts;
     UINT context_count;
 };
 
+static inline void wined3d_device_add_shader_stall(struct wined3d_device *device, const LARGE_INTEGER *start)
+{
+    LARGE_INTEGER end;
+
+    QueryPerformanceCounter(&end);
+    device->shader_stall_time += end.QuadPart - start->QuadPart;
+    ++device->shader_stall_count;
+}
+
 void wined3d_device_cleanup(struct wined3d_device *device) DECLSPEC_HIDDEN;
 BOOL device_context_add(struct wined3d_device *device, struct wined3d_context *context) DECLSPEC_HIDDEN;
 void device_context_remove(struct wined3d_device *device, struct wined3d_context *context) DECLSPEC_HIDDEN;
@@ -4313,6 +4400,21 @@ static inline void wined3d_resource_get_sub_resource_map_pitch(struct wined3d_re
     resource->resource_ops->resource_sub_resource_get_map_pitch(resource, sub_resource_idx, row_pitch, slice_pitch);
 }
 
+/* Whether DISCARD maps of the resource can be suballocated from the device's
+ * bo ring. Managed and software vertex processing buffers need to retain
+ * their contents across DISCARD maps. */
+static inline bool wined3d_resource_is_streaming_buffer(const struct wined3d_resource *resource)
+{
+    return resource->type == WINED3D_RTYPE_BUFFER && (resource->usage & WINED3DUSAGE_DYNAMIC)
+            && (resource->access & WINED3D_RESOURCE_ACCESS_GPU)
+            && (resource->access & (WINED3D_RESOURCE_ACCESS_MAP_R | WINED3D_RESOURCE_ACCESS_MAP_W))
+            == WINED3D_RESOURCE_ACCESS_MAP_W
+            && !wined3d_resource_access_is_managed(resource->access)
+            && !(resource->device->create_parms.flags & WINED3DCREATE_SOFTWARE_VERTEXPROCESSING)
+            && !(resource->bind_flags & ~(WINED3D_BIND_VERTEX_BUFFER
+            | WINED3D_BIND_INDEX_BUFFER | WINED3D_BIND_CONSTANT_BUFFER));
+}
+
 void resource_cleanup(struct wined3d_resource *resource) DECLSPEC_HIDDEN;
 HRESULT resource_init(struct wined3d_resource *resource, struct wined3d_device *device,
         enum wined3d_resource_type type, const struct wined3d_format *format,
@@ -4919,6 +5021,61 @@ struct wined3d_device_context
     struct wined3d_state *state;
 };
 
+enum wined3d_cs_op
+{
+    WINED3D_CS_OP_NOP,
+    WINED3D_CS_OP_PRESENT,
+    WINED3D_CS_OP_CLEAR,
+    WINED3D_CS_OP_DISPATCH,
+    WINED3D_CS_OP_DRAW,
+    WINED3D_CS_OP_FLUSH,
+    WINED3D_CS_OP_SET_PREDICATION,
+    WINED3D_CS_OP_SET_VIEWPORTS,
+    WINED3D_CS_OP_SET_SCISSOR_RECTS,
+    WINED3D_CS_OP_SET_RENDERTARGET_VIEWS,
+    WINED3D_CS_OP_SET_DEPTH_STENCIL_VIEW,
+    WINED3D_CS_OP_SET_VERTEX_DECLARATION,
+    WINED3D_CS_OP_SET_STREAM_SOURCES,
+    WINED3D_CS_OP_SET_STREAM_OUTPUTS,
+    WINED3D_CS_OP_SET_INDEX_BUFFER,
+    WINED3D_CS_OP_SET_CONSTANT_BUFFERS,
+    WINED3D_CS_OP_SET_TEXTURE,
+    WINED3D_CS_OP_SET_SHADER_RESOURCE_VIEWS,
+    WINED3D_CS_OP_SET_UNORDERED_ACCESS_VIEWS,
+    WINED3D_CS_OP_SET_SAMPLERS,
+    WINED3D_CS_OP_SET_SHADER,
+    WINED3D_CS_OP_SET_BLEND_STATE,
+    WINED3D_CS_OP_SET_DEPTH_STENCIL_STATE,
+    WINED3D_CS_OP_SET_RASTERIZER_STATE,
+    WINED3D_CS_OP_SET_RENDER_STATE,
+    WINED3D_CS_OP_SET_TEXTURE_STATE,
+    WINED3D_CS_OP_SET_SAMPLER_STATE,
+    WINED3D_CS_OP_SET_DEPTH_BOUNDS,
+    WINED3D_CS_OP_SET_TRANSFORM,
+    WINED3D_CS_OP_SET_CLIP_PLANE,
+    WINED3D_CS_OP_SET_COLOR_KEY,
+    WINED3D_CS_OP_SET_MATERIAL,
+    WINED3D_CS_OP_SET_LIGHT,
+    WINED3D_CS_OP_SET_LIGHT_ENABLE,
+    WINED3D_CS_OP_SET_FEATURE_LEVEL,
+    WINED3D_CS_OP_PUSH_CONSTANTS,
+    WINED3D_CS_OP_RESET_STATE,
+    WINED3D_CS_OP_CALLBACK,
+    WINED3D_CS_OP_QUERY_ISSUE,
+    WINED3D_CS_OP_PRELOAD_RESOURCE,
+    WINED3D_CS_OP_UNLOAD_RESOURCE,
+    WINED3D_CS_OP_MAP,
+    WINED3D_CS_OP_UNMAP,
+    WINED3D_CS_OP_BLT_SUB_RESOURCE,
+    WINED3D_CS_OP_UPDATE_SUB_RESOURCE,
+    WINED3D_CS_OP_ADD_DIRTY_TEXTURE_REGION,
+    WINED3D_CS_OP_CLEAR_UNORDERED_ACCESS_VIEW,
+    WINED3D_CS_OP_COPY_UAV_COUNTER,
+    WINED3D_CS_OP_GENERATE_MIPMAPS,
+    WINED3D_CS_OP_EXECUTE_COMMAND_LIST,
+    WINED3D_CS_OP_STOP,
+};
+
 struct wined3d_cs
 {
     struct wined3d_device_context c;
@@ -4938,6 +5095,16 @@ struct wined3d_cs
     HANDLE event;
     BOOL waiting_for_event;
     LONG pending_presents;
+
+    SLIST_HEADER chunk_pool;
+
+    /* Packets emitted and filtered as redundant on the client side of the
+     * immediate context since the last present. */
+    unsigned int emitted_op_count[WINED3D_CS_OP_STOP + 1];
+    unsigned int filtered_op_count[WINED3D_CS_OP_STOP + 1];
+
+    /* Frame trace, if enabled through the "FrameTracePath" setting. */
+    struct wined3d_profiler *profiler;
 };
 
 static inline void wined3d_device_context_lock(struct wined3d_device_context *context)
@@ -4952,6 +5119,23 @@ static inline void wined3d_device_context_unlock(struct wined3d_device_context *
         wined3d_mutex_unlock();
 }
 
+static inline void wined3d_device_context_filter_op(struct wined3d_device_context *context, enum wined3d_cs_op op)
+{
+    struct wined3d_cs *cs = context->device->cs;
+
+    if (context == &cs->c)
+        ++cs->filtered_op_count[op];
+}
+
+struct wined3d_profiler *wined3d_profiler_create(struct wined3d_device *device) DECLSPEC_HIDDEN;
+void wined3d_profiler_destroy(struct wined3d_profiler *profiler) DECLSPEC_HIDDEN;
+void wined3d_profiler_end_batch(struct wined3d_profiler *profiler) DECLSPEC_HIDDEN;
+void wined3d_profiler_op(struct wined3d_profiler *profiler, enum wined3d_cs_op opcode) DECLSPEC_HIDDEN;
+void wined3d_profiler_present(struct wined3d_profiler *profiler) DECLSPEC_HIDDEN;
+void wined3d_profiler_present_mark(struct wined3d_profiler *profiler) DECLSPEC_HIDDEN;
+void wined3d_profiler_release_queries(void *object) DECLSPEC_HIDDEN;
+void wined3d_profiler_submit(struct wined3d_profiler *profiler) DECLSPEC_HIDDEN;
+
 struct wined3d_cs *wined3d_cs_create(struct wined3d_device *device,
         const enum wined3d_feature_level *levels, unsigned int level_count) DECLSPEC_HIDDEN;
 void wined3d_cs_destroy(struct wined3d_cs *cs) DECLSPEC_HIDDEN;
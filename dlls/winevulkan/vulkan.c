@@ -71,6 +71,69 @@ static uint32_t wine_vk_count_struct_(void *s, VkStructureType t)
 
 static const struct vulkan_funcs *vk_funcs;
 
+static inline uint64_t wine_vk_hash_handle(uint64_t native_handle)
+{
+    /* handles are often pointers or small indices, spread them over all the bits */
+    return native_handle * 0x9e3779b97f4a7c15ull;
+}
+
+static struct wine_vk_mapping_shard *wine_vk_get_mapping_shard(struct VkInstance_T *instance, uint64_t hash)
+{
+    return &instance->wrappers[hash >> (64 - WINE_VK_MAPPING_SHARD_BITS)];
+}
+
+static struct list *wine_vk_get_mapping_bucket(const struct wine_vk_mapping_shard *shard, uint64_t hash)
+{
+    return &shard->buckets[(hash >> 32) & (shard->bucket_count - 1)];
+}
+
+/* Grow the hash table of a shard, called with the shard lock held for writing. */
+static void wine_vk_grow_mapping_shard(struct wine_vk_mapping_shard *shard)
+{
+    struct wine_vk_mapping_shard new_shard = *shard;
+    struct wine_vk_mapping *mapping, *next;
+    unsigned int i;
+
+    new_shard.bucket_count = shard->bucket_count ? shard->bucket_count * 2 : 64;
+    if (!(new_shard.buckets = malloc(new_shard.bucket_count * sizeof(*new_shard.buckets))))
+        return;
+    for (i = 0; i < new_shard.bucket_count; i++)
+        list_init(&new_shard.buckets[i]);
+
+    for (i = 0; i < shard->bucket_count; i++)
+    {
+        LIST_FOR_EACH_ENTRY_SAFE(mapping, next, &shard->buckets[i], struct wine_vk_mapping, link)
+        {
+            list_remove(&mapping->link);
+            list_add_tail(wine_vk_get_mapping_bucket(&new_shard, wine_vk_hash_handle(mapping->native_handle)),
+                    &mapping->link);
+        }
+    }
+
+    free(shard->buckets);
+    shard->buckets = new_shard.buckets;
+    shard->bucket_count = new_shard.bucket_count;
+}
+
+static void wine_vk_init_mappings(struct VkInstance_T *instance)
+{
+    unsigned int i;
+
+    for (i = 0; i < ARRAY_SIZE(instance->wrappers); i++)
+        pthread_rwlock_init(&instance->wrappers[i].lock, NULL);
+}
+
+static void wine_vk_free_mappings(struct VkInstance_T *instance)
+{
+    unsigned int i;
+
+    for (i = 0; i < ARRAY_SIZE(instance->wrappers); i++)
+    {
+        pthread_rwlock_destroy(&instance->wrappers[i].lock);
+        free(instance->wrappers[i].buckets);
+    }
+}
+
 #define WINE_VK_ADD_DISPATCHABLE_MAPPING(instance, object, native_handle) \
     wine_vk_add_handle_mapping((instance), (uint64_t) (uintptr_t) (object), (uint64_t) (uintptr_t) (native_handle), &(object)->mapping)
 #define WINE_VK_ADD_NON_DISPATCHABLE_MAPPING(instance, object, native_handle) \
@@ -78,13 +141,29 @@ static const struct vulkan_funcs *vk_funcs;
 static void  wine_vk_add_handle_mapping(struct VkInstance_T *instance, uint64_t wrapped_handle,
         uint64_t native_handle, struct wine_vk_mapping *mapping)
 {
+    struct wine_vk_mapping_shard *shard;
+    uint64_t hash;
+
     if (instance->enable_wrapper_list)
     {
         mapping->native_handle = native_handle;
         mapping->wine_wrapped_handle = wrapped_handle;
-        pthread_rwlock_wrlock(&instance->wrapper_lock);
-        list_add_tail(&instance->wrappers, &mapping->link);
-        pthread_rwlock_unlock(&instance->wrapper_lock);
+        hash = wine_vk_hash_handle(native_handle);
+        shard = wine_vk_get_mapping_shard(instance, hash);
+        pthread_rwlock_wrlock(&shard->lock);
+        if (shard->count >= shard->bucket_count)
+            wine_vk_grow_mapping_shard(shard);
+        if (shard->bucket_count)
+        {
+            list_add_tail(wine_vk_get_mapping_bucket(shard, hash), &mapping->link);
+            shard->count++;
+        }
+        else
+        {
+            ERR("Failed to allocate mapping table.\n");
+            list_init(&mapping->link);
+        }
+        pthread_rwlock_unlock(&shard->lock);
     }
 }
 
@@ -92,29 +171,39 @@ static void  wine_vk_add_handle_mapping(struct VkInstance_T *instance, uint64_t
     wine_vk_remove_handle_mapping((instance), &(object)->mapping)
 static void wine_vk_remove_handle_mapping(struct VkInstance_T *instance, struct wine_vk_mapping *mapping)
 {
+    struct wine_vk_mapping_shard *shard;
+
     if (instance->enable_wrapper_list)
     {
-        pthread_rwlock_wrlock(&instance->wrapper_lock);
+        shard = wine_vk_get_mapping_shard(instance, wine_vk_hash_handle(mapping->native_handle));
+        pthread_rwlock_wrlock(&shard->lock);
+        if (!list_empty(&mapping->link))
+            shard->count--;
         list_remove(&mapping->link);
-        pthread_rwlock_unlock(&instance->wrapper_lock);
+        pthread_rwlock_unlock(&shard->lock);
     }
 }
 
 static uint64_t wine_vk_get_wrapper(struct VkInstance_T *instance, uint64_t native_handle)
 {
+    uint64_t hash = wine_vk_hash_handle(native_handle);
+    struct wine_vk_mapping_shard *shard = wine_vk_get_mapping_shard(instance, hash);
     struct wine_vk_mapping *mapping;
     uint64_t result = 0;
 
-    pthread_rwlock_rdlock(&instance->wrapper_lock);
-    LIST_FOR_EACH_ENTRY(mapping, &instance->wrappers, struct wine_vk_mapping, link)
+    pthread_rwlock_rdlock(&shard->lock);
+    if (shard->bucket_count)
     {
-        if (mapping->native_handle == native_handle)
+        LIST_FOR_EACH_ENTRY(mapping, wine_vk_get_mapping_bucket(shard, hash), struct wine_vk_mapping, link)
         {
-            result = mapping->wine_wrapped_handle;
-            break;
+            if (mapping->native_handle == native_handle)
+            {
+                result = mapping->wine_wrapped_handle;
+                break;
+            }
         }
     }
-    pthread_rwlock_unlock(&instance->wrapper_lock);
+    pthread_rwlock_unlock(&shard->lock);
     return result;
 }
 
@@ -766,7 +855,7 @@ static void wine_vk_instance_free(struct VkInstance_T *instance)
         WINE_VK_REMOVE_HANDLE_MAPPING(instance, instance);
     }
 
-    pthread_rwlock_destroy(&instance->wrapper_lock);
+    wine_vk_free_mappings(instance);
     free(instance->utils_messengers);
 
     free(instance);
@@ -1000,8 +1089,7 @@ VkResult WINAPI __wine_create_vk_instance_with_callback(const VkInstanceCreateIn
         return VK_ERROR_OUT_OF_HOST_MEMORY;
     }
     object->base.loader_magic = VULKAN_ICD_MAGIC_VALUE;
-    list_init(&object->wrappers);
-    pthread_rwlock_init(&object->wrapper_lock, NULL);
+    wine_vk_init_mappings(object);
 
     res = wine_vk_instance_convert_create_info(create_info, &create_info_host, object);
     if (res != VK_SUCCESS)
@@ -43,6 +43,20 @@ struct wine_vk_mapping
     uint64_t wine_wrapped_handle;
 };
 
+/* The mappings are stored in a hash table keyed by native handle, split in
+ * shards with their own lock so that object creation on several threads
+ * doesn't serialize on a single lock.
+ */
+#define WINE_VK_MAPPING_SHARD_BITS 4
+
+struct wine_vk_mapping_shard
+{
+    pthread_rwlock_t lock;
+    struct list *buckets;
+    unsigned int bucket_count; /* power of 2, or 0 if not allocated yet */
+    unsigned int count;
+};
+
 struct VkCommandBuffer_T
 {
     struct wine_vk_base base;
@@ -143,8 +157,7 @@ struct VkInstance_T
     uint32_t phys_dev_count;
 
     VkBool32 enable_wrapper_list;
-    struct list wrappers;
-    pthread_rwlock_t wrapper_lock;
+    struct wine_vk_mapping_shard wrappers[1 << WINE_VK_MAPPING_SHARD_BITS];
 
     struct wine_debug_utils_messenger *utils_messengers;
     uint32_t utils_messenger_count;
@@ -309,4 +322,49 @@ static inline void init_unicode_string( UNICODE_STRING *str, const WCHAR *data )
     str->Buffer = (WCHAR *)data;
 }
 
+/* Temporary storage for the win32 to host struct conversions of a single thunk call.
+ * Small conversions are carved out of the on-stack buffer, larger ones fall back to
+ * the heap and are released by free_conversion_context(). */
+struct conversion_context
+{
+    UINT64 buffer[256];
+    uint32_t used;
+    struct list alloc_entries;
+};
+
+static inline void init_conversion_context(struct conversion_context *pool)
+{
+    pool->used = 0;
+    list_init(&pool->alloc_entries);
+}
+
+static inline void free_conversion_context(struct conversion_context *pool)
+{
+    struct list *entry, *next;
+
+    LIST_FOR_EACH_SAFE(entry, next, &pool->alloc_entries)
+        free(entry);
+}
+
+/* A NULL context is used by struct chain conversions, which are freed explicitly. */
+static inline void *conversion_context_alloc(struct conversion_context *pool, size_t size)
+{
+    struct list *entry;
+
+    if (!pool) return malloc(size);
+
+    size = (size + sizeof(UINT64) - 1) & ~(sizeof(UINT64) - 1);
+    if (size <= sizeof(pool->buffer) - pool->used)
+    {
+        void *ret = (char *)pool->buffer + pool->used;
+        pool->used += size;
+        return ret;
+    }
+
+    /* keep the allocation 8-byte aligned on 32-bit */
+    if (!(entry = malloc(sizeof(UINT64) + size))) return NULL;
+    list_add_tail(&pool->alloc_entries, entry);
+    return (char *)entry + sizeof(UINT64);
+}
+
 #endif /* __WINE_VULKAN_PRIVATE_H */
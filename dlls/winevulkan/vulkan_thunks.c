@@ -47,14 +47,14 @@ static inline void convert_VkDescriptorSetAllocateInfo_win_to_host(const VkDescr
 #endif /* USE_STRUCT_CONVERSION */
 
 #if defined(USE_STRUCT_CONVERSION)
-static inline VkCommandBufferInheritanceInfo_host *convert_VkCommandBufferInheritanceInfo_array_win_to_host(const VkCommandBufferInheritanceInfo *in, uint32_t count)
+static inline VkCommandBufferInheritanceInfo_host *convert_VkCommandBufferInheritanceInfo_array_win_to_host(struct conversion_context *ctx, const VkCommandBufferInheritanceInfo *in, uint32_t count)
 {
     VkCommandBufferInheritanceInfo_host *out;
     unsigned int i;
 
     if (!in) return NULL;
 
-    out = malloc(count * sizeof(*out));
+    out = conversion_context_alloc(ctx, count * sizeof(*out));
     for (i = 0; i < count; i++)
     {
         out[i].sType = in[i].sType;
@@ -72,39 +72,23 @@ static inline VkCommandBufferInheritanceInfo_host *convert_VkCommandBufferInheri
 #endif /* USE_STRUCT_CONVERSION */
 
 #if defined(USE_STRUCT_CONVERSION)
-static inline void free_VkCommandBufferInheritanceInfo_array(VkCommandBufferInheritanceInfo_host *in, uint32_t count)
-{
-    if (!in) return;
-
-    free(in);
-}
-#endif /* USE_STRUCT_CONVERSION */
-
-#if defined(USE_STRUCT_CONVERSION)
-static inline void convert_VkCommandBufferBeginInfo_win_to_host(const VkCommandBufferBeginInfo *in, VkCommandBufferBeginInfo_host *out)
+static inline void convert_VkCommandBufferBeginInfo_win_to_host(struct conversion_context *ctx, const VkCommandBufferBeginInfo *in, VkCommandBufferBeginInfo_host *out)
 {
     if (!in) return;
 
     out->sType = in->sType;
     out->pNext = in->pNext;
     out->flags = in->flags;
-    out->pInheritanceInfo = convert_VkCommandBufferInheritanceInfo_array_win_to_host(in->pInheritanceInfo, 1);
+    out->pInheritanceInfo = convert_VkCommandBufferInheritanceInfo_array_win_to_host(ctx, in->pInheritanceInfo, 1);
 }
 #endif /* USE_STRUCT_CONVERSION */
 
 #if defined(USE_STRUCT_CONVERSION)
-static inline void free_VkCommandBufferBeginInfo(VkCommandBufferBeginInfo_host *in)
-{
-    free_VkCommandBufferInheritanceInfo_array((VkCommandBufferInheritanceInfo_host *)in->pInheritanceInfo, 1);
-}
-#endif /* USE_STRUCT_CONVERSION */
-
-#if defined(USE_STRUCT_CONVERSION)
-static inline VkBindAccelerationStructureMemoryInfoNV_host *convert_VkBindAccelerationStructureMemoryInfoNV_array_win_to_host(const VkBindAccelerationStructureMemoryInfoNV *in, uint32_t count)
+static inline VkBindAccelerationStructureMemoryInfoNV_host *convert_VkBindAccelerationStructureMemoryInfoNV_array_win_to_host(struct conversion_context *ctx, const VkBindAccelerationStructureMemoryInfoNV *in, uint32_t count)
 {
     VkBindAccelerationStructureMemoryInfoNV_host *out;
 #else
-static inline VkBindAccelerationStructureMemoryInfoNV *convert_VkBindAccelerationStructureMemoryInfoNV_array_win_to_host(const VkBindAccelerationStructureMemoryInfoNV *in, uint32_t count)
+static inline VkBindAccelerationStructureMemoryInfoNV *convert_VkBindAccelerationStructureMemoryInfoNV_array_win_to_host(struct conversion_context *ctx, const VkBindAccelerationStructureMemoryInfoNV *in, uint32_t count)
 {
     VkBindAccelerationStructureMemoryInfoNV *out;
 #endif /* USE_STRUCT_CONVERSION */
@@ -112,7 +96,7 @@ static inline VkBindAccelerationStructureMemoryInfoNV *convert_VkBindAcceleratio
 
     if (!in) return NULL;
 
-    out = malloc(count * sizeof(*out));
+    out = conversion_context_alloc(ctx, count * sizeof(*out));
     for (i = 0; i < count; i++)
     {
         out[i].sType = in[i].sType;
@@ -128,22 +112,11 @@ static inline VkBindAccelerationStructureMemoryInfoNV *convert_VkBindAcceleratio
 }
 
 #if defined(USE_STRUCT_CONVERSION)
-static inline void free_VkBindAccelerationStructureMemoryInfoNV_array(VkBindAccelerationStructureMemoryInfoNV_host *in, uint32_t count)
-#else
-static inline void free_VkBindAccelerationStructureMemoryInfoNV_array(VkBindAccelerationStructureMemoryInfoNV *in, uint32_t count)
-#endif /* USE_STRUCT_CONVERSION */
-{
-    if (!in) return;
-
-    free(in);
-}
-
-#if defined(USE_STRUCT_CONVERSION)
-static inline VkBindBufferMemoryInfo_host *convert_VkBindBufferMemoryInfo_array_win_to_host(const VkBindBufferMemoryInfo *in, uint32_t count)
+static inline VkBindBufferMemoryInfo_host *convert_VkBindBufferMemoryInfo_array_win_to_host(struct conversion_context *ctx, const VkBindBufferMemoryInfo *in, uint32_t count)
 {
     VkBindBufferMemoryInfo_host *out;
 #else
-static inline VkBindBufferMemoryInfo *convert_VkBindBufferMemoryInfo_array_win_to_host(const VkBindBufferMemoryInfo *in, uint32_t count)
+static inline VkBindBufferMemoryInfo *convert_VkBindBufferMemoryInfo_array_win_to_host(struct conversion_context *ctx, const VkBindBufferMemoryInfo *in, uint32_t count)
 {
     VkBindBufferMemoryInfo *out;
 #endif /* USE_STRUCT_CONVERSION */
@@ -151,7 +124,7 @@ static inline VkBindBufferMemoryInfo *convert_VkBindBufferMemoryInfo_array_win_t
 
     if (!in) return NULL;
 
-    out = malloc(count * sizeof(*out));
+    out = conversion_context_alloc(ctx, count * sizeof(*out));
     for (i = 0; i < count; i++)
     {
         out[i].sType = in[i].sType;
@@ -165,22 +138,11 @@ static inline VkBindBufferMemoryInfo *convert_VkBindBufferMemoryInfo_array_win_t
 }
 
 #if defined(USE_STRUCT_CONVERSION)
-static inline void free_VkBindBufferMemoryInfo_array(VkBindBufferMemoryInfo_host *in, uint32_t count)
-#else
-static inline void free_VkBindBufferMemoryInfo_array(VkBindBufferMemoryInfo *in, uint32_t count)
-#endif /* USE_STRUCT_CONVERSION */
-{
-    if (!in) return;
-
-    free(in);
-}
-
-#if defined(USE_STRUCT_CONVERSION)
-static inline VkBindImageMemoryInfo_host *convert_VkBindImageMemoryInfo_array_win_to_host(const VkBindImageMemoryInfo *in, uint32_t count)
+static inline VkBindImageMemoryInfo_host *convert_VkBindImageMemoryInfo_array_win_to_host(struct conversion_context *ctx, const VkBindImageMemoryInfo *in, uint32_t count)
 {
     VkBindImageMemoryInfo_host *out;
 #else
-static inline VkBindImageMemoryInfo *convert_VkBindImageMemoryInfo_array_win_to_host(const VkBindImageMemoryInfo *in, uint32_t count)
+static inline VkBindImageMemoryInfo *convert_VkBindImageMemoryInfo_array_win_to_host(struct conversion_context *ctx, const VkBindImageMemoryInfo *in, uint32_t count)
 {
     VkBindImageMemoryInfo *out;
 #endif /* USE_STRUCT_CONVERSION */
@@ -188,7 +150,7 @@ static inline VkBindImageMemoryInfo *convert_VkBindImageMemoryInfo_array_win_to_
 
     if (!in) return NULL;
 
-    out = malloc(count * sizeof(*out));
+    out = conversion_context_alloc(ctx, count * sizeof(*out));
     for (i = 0; i < count; i++)
     {
         out[i].sType = in[i].sType;
@@ -202,25 +164,14 @@ static inline VkBindImageMemoryInfo *convert_VkBindImageMemoryInfo_array_win_to_
 }
 
 #if defined(USE_STRUCT_CONVERSION)
-static inline void free_VkBindImageMemoryInfo_array(VkBindImageMemoryInfo_host *in, uint32_t count)
-#else
-static inline void free_VkBindImageMemoryInfo_array(VkBindImageMemoryInfo *in, uint32_t count)
-#endif /* USE_STRUCT_CONVERSION */
-{
-    if (!in) return;
-
-    free(in);
-}
-
-#if defined(USE_STRUCT_CONVERSION)
-static inline VkAccelerationStructureBuildGeometryInfoKHR_host *convert_VkAccelerationStructureBuildGeometryInfoKHR_array_win_to_host(const VkAccelerationStructureBuildGeometryInfoKHR *in, uint32_t count)
+static inline VkAccelerationStructureBuildGeometryInfoKHR_host *convert_VkAccelerationStructureBuildGeometryInfoKHR_array_win_to_host(struct conversion_context *ctx, const VkAccelerationStructureBuildGeometryInfoKHR *in, uint32_t count)
 {
     VkAccelerationStructureBuildGeometryInfoKHR_host *out;
     unsigned int i;
 
     if (!in) return NULL;
 
-    out = malloc(count * sizeof(*out));
+    out = conversion_context_alloc(ctx, count * sizeof(*out));
     for (i = 0; i < count; i++)
     {
         out[i].sType = in[i].sType;
@@ -240,15 +191,6 @@ static inline VkAccelerationStructureBuildGeometryInfoKHR_host *convert_VkAccele
 }
 #endif /* USE_STRUCT_CONVERSION */
 
-#if defined(USE_STRUCT_CONVERSION)
-static inline void free_VkAccelerationStructureBuildGeometryInfoKHR_array(VkAccelerationStructureBuildGeometryInfoKHR_host *in, uint32_t count)
-{
-    if (!in) return;
-
-    free(in);
-}
-#endif /* USE_STRUCT_CONVERSION */
-
 #if defined(USE_STRUCT_CONVERSION)
 static inline void convert_VkConditionalRenderingBeginInfoEXT_win_to_host(const VkConditionalRenderingBeginInfoEXT *in, VkConditionalRenderingBeginInfoEXT_host *out)
 {
@@ -278,14 +220,14 @@ static inline void convert_VkRenderPassBeginInfo_win_to_host(const VkRenderPassB
 #endif /* USE_STRUCT_CONVERSION */
 
 #if defined(USE_STRUCT_CONVERSION)
-static inline VkRenderingAttachmentInfoKHR_host *convert_VkRenderingAttachmentInfoKHR_array_win_to_host(const VkRenderingAttachmentInfoKHR *in, uint32_t count)
+static inline VkRenderingAttachmentInfoKHR_host *convert_VkRenderingAttachmentInfoKHR_array_win_to_host(struct conversion_context *ctx, const VkRenderingAttachmentInfoKHR *in, uint32_t count)
 {
     VkRenderingAttachmentInfoKHR_host *out;
     unsigned int i;
 
     if (!in) return NULL;
 
-    out = malloc(count * sizeof(*out));
+    out = conversion_context_alloc(ctx, count * sizeof(*out));
     for (i = 0; i < count; i++)
     {
         out[i].sType = in[i].sType;
@@ -305,16 +247,7 @@ static inline VkRenderingAttachmentInfoKHR_host *convert_VkRenderingAttachmentIn
 #endif /* USE_STRUCT_CONVERSION */
 
 #if defined(USE_STRUCT_CONVERSION)
-static inline void free_VkRenderingAttachmentInfoKHR_array(VkRenderingAttachmentInfoKHR_host *in, uint32_t count)
-{
-    if (!in) return;
-
-    free(in);
-}
-#endif /* USE_STRUCT_CONVERSION */
-
-#if defined(USE_STRUCT_CONVERSION)
-static inline void convert_VkRenderingInfoKHR_win_to_host(const VkRenderingInfoKHR *in, VkRenderingInfoKHR_host *out)
+static inline void convert_VkRenderingInfoKHR_win_to_host(struct conversion_context *ctx, const VkRenderingInfoKHR *in, VkRenderingInfoKHR_host *out)
 {
     if (!in) return;
 
@@ -325,18 +258,9 @@ static inline void convert_VkRenderingInfoKHR_win_to_host(const VkRenderingInfoK
     out->layerCount = in->layerCount;
     out->viewMask = in->viewMask;
     out->colorAttachmentCount = in->colorAttachmentCount;
-    out->pColorAttachments = convert_VkRenderingAttachmentInfoKHR_array_win_to_host(in->pColorAttachments, in->colorAttachmentCount);
-    out->pDepthAttachment = convert_VkRenderingAttachmentInfoKHR_array_win_to_host(in->pDepthAttachment, 1);
-    out->pStencilAttachment = convert_VkRenderingAttachmentInfoKHR_array_win_to_host(in->pStencilAttachment, 1);
-}
-#endif /* USE_STRUCT_CONVERSION */
-
-#if defined(USE_STRUCT_CONVERSION)
-static inline void free_VkRenderingInfoKHR(VkRenderingInfoKHR_host *in)
-{
-    free_VkRenderingAttachmentInfoKHR_array((VkRenderingAttachmentInfoKHR_host *)in->pColorAttachments, in->colorAttachmentCount);
-    free_VkRenderingAttachmentInfoKHR_array((VkRenderingAttachmentInfoKHR_host *)in->pDepthAttachment, 1);
-    free_VkRenderingAttachmentInfoKHR_array((VkRenderingAttachmentInfoKHR_host *)in->pStencilAttachment, 1);
+    out->pColorAttachments = convert_VkRenderingAttachmentInfoKHR_array_win_to_host(ctx, in->pColorAttachments, in->colorAttachmentCount);
+    out->pDepthAttachment = convert_VkRenderingAttachmentInfoKHR_array_win_to_host(ctx, in->pDepthAttachment, 1);
+    out->pStencilAttachment = convert_VkRenderingAttachmentInfoKHR_array_win_to_host(ctx, in->pStencilAttachment, 1);
 }
 #endif /* USE_STRUCT_CONVERSION */
 
@@ -403,14 +327,14 @@ static inline void convert_VkGeometryDataNV_win_to_host(const VkGeometryDataNV *
 #endif /* USE_STRUCT_CONVERSION */
 
 #if defined(USE_STRUCT_CONVERSION)
-static inline VkGeometryNV_host *convert_VkGeometryNV_array_win_to_host(const VkGeometryNV *in, uint32_t count)
+static inline VkGeometryNV_host *convert_VkGeometryNV_array_win_to_host(struct conversion_context *ctx, const VkGeometryNV *in, uint32_t count)
 {
     VkGeometryNV_host *out;
     unsigned int i;
 
     if (!in) return NULL;
 
-    out = malloc(count * sizeof(*out));
+    out = conversion_context_alloc(ctx, count * sizeof(*out));
     for (i = 0; i < count; i++)
     {
         out[i].sType = in[i].sType;
@@ -425,16 +349,7 @@ static inline VkGeometryNV_host *convert_VkGeometryNV_array_win_to_host(const Vk
 #endif /* USE_STRUCT_CONVERSION */
 
 #if defined(USE_STRUCT_CONVERSION)
-static inline void free_VkGeometryNV_array(VkGeometryNV_host *in, uint32_t count)
-{
-    if (!in) return;
-
-    free(in);
-}
-#endif /* USE_STRUCT_CONVERSION */
-
-#if defined(USE_STRUCT_CONVERSION)
-static inline void convert_VkAccelerationStructureInfoNV_win_to_host(const VkAccelerationStructureInfoNV *in, VkAccelerationStructureInfoNV_host *out)
+static inline void convert_VkAccelerationStructureInfoNV_win_to_host(struct conversion_context *ctx, const VkAccelerationStructureInfoNV *in, VkAccelerationStructureInfoNV_host *out)
 {
     if (!in) return;
 
@@ -444,14 +359,7 @@ static inline void convert_VkAccelerationStructureInfoNV_win_to_host(const VkAcc
     out->flags = in->flags;
     out->instanceCount = in->instanceCount;
     out->geometryCount = in->geometryCount;
-    out->pGeometries = convert_VkGeometryNV_array_win_to_host(in->pGeometries, in->geometryCount);
-}
-#endif /* USE_STRUCT_CONVERSION */
-
-#if defined(USE_STRUCT_CONVERSION)
-static inline void free_VkAccelerationStructureInfoNV(VkAccelerationStructureInfoNV_host *in)
-{
-    free_VkGeometryNV_array((VkGeometryNV_host *)in->pGeometries, in->geometryCount);
+    out->pGeometries = convert_VkGeometryNV_array_win_to_host(ctx, in->pGeometries, in->geometryCount);
 }
 #endif /* USE_STRUCT_CONVERSION */
 
@@ -482,14 +390,14 @@ static inline void convert_VkCopyAccelerationStructureToMemoryInfoKHR_win_to_hos
 #endif /* USE_STRUCT_CONVERSION */
 
 #if defined(USE_STRUCT_CONVERSION)
-static inline VkBufferCopy_host *convert_VkBufferCopy_array_win_to_host(const VkBufferCopy *in, uint32_t count)
+static inline VkBufferCopy_host *convert_VkBufferCopy_array_win_to_host(struct conversion_context *ctx, const VkBufferCopy *in, uint32_t count)
 {
     VkBufferCopy_host *out;
     unsigned int i;
 
     if (!in) return NULL;
 
-    out = malloc(count * sizeof(*out));
+    out = conversion_context_alloc(ctx, count * sizeof(*out));
     for (i = 0; i < count; i++)
     {
         out[i].srcOffset = in[i].srcOffset;
@@ -502,23 +410,14 @@ static inline VkBufferCopy_host *convert_VkBufferCopy_array_win_to_host(const Vk
 #endif /* USE_STRUCT_CONVERSION */
 
 #if defined(USE_STRUCT_CONVERSION)
-static inline void free_VkBufferCopy_array(VkBufferCopy_host *in, uint32_t count)
-{
-    if (!in) return;
-
-    free(in);
-}
-#endif /* USE_STRUCT_CONVERSION */
-
-#if defined(USE_STRUCT_CONVERSION)
-static inline VkBufferCopy2KHR_host *convert_VkBufferCopy2KHR_array_win_to_host(const VkBufferCopy2KHR *in, uint32_t count)
+static inline VkBufferCopy2KHR_host *convert_VkBufferCopy2KHR_array_win_to_host(struct conversion_context *ctx, const VkBufferCopy2KHR *in, uint32_t count)
 {
     VkBufferCopy2KHR_host *out;
     unsigned int i;
 
     if (!in) return NULL;
 
-    out = malloc(count * sizeof(*out));
+    out = conversion_context_alloc(ctx, count * sizeof(*out));
     for (i = 0; i < count; i++)
     {
         out[i].sType = in[i].sType;
@@ -533,16 +432,7 @@ static inline VkBufferCopy2KHR_host *convert_VkBufferCopy2KHR_array_win_to_host(
 #endif /* USE_STRUCT_CONVERSION */
 
 #if defined(USE_STRUCT_CONVERSION)
-static inline void free_VkBufferCopy2KHR_array(VkBufferCopy2KHR_host *in, uint32_t count)
-{
-    if (!in) return;
-
-    free(in);
-}
-#endif /* USE_STRUCT_CONVERSION */
-
-#if defined(USE_STRUCT_CONVERSION)
-static inline void convert_VkCopyBufferInfo2KHR_win_to_host(const VkCopyBufferInfo2KHR *in, VkCopyBufferInfo2KHR_host *out)
+static inline void convert_VkCopyBufferInfo2KHR_win_to_host(struct conversion_context *ctx, const VkCopyBufferInfo2KHR *in, VkCopyBufferInfo2KHR_host *out)
 {
     if (!in) return;
 
@@ -551,26 +441,19 @@ static inline void convert_VkCopyBufferInfo2KHR_win_to_host(const VkCopyBufferIn
     out->srcBuffer = in->srcBuffer;
     out->dstBuffer = in->dstBuffer;
     out->regionCount = in->regionCount;
-    out->pRegions = convert_VkBufferCopy2KHR_array_win_to_host(in->pRegions, in->regionCount);
+    out->pRegions = convert_VkBufferCopy2KHR_array_win_to_host(ctx, in->pRegions, in->regionCount);
 }
 #endif /* USE_STRUCT_CONVERSION */
 
 #if defined(USE_STRUCT_CONVERSION)
-static inline void free_VkCopyBufferInfo2KHR(VkCopyBufferInfo2KHR_host *in)
-{
-    free_VkBufferCopy2KHR_array((VkBufferCopy2KHR_host *)in->pRegions, in->regionCount);
-}
-#endif /* USE_STRUCT_CONVERSION */
-
-#if defined(USE_STRUCT_CONVERSION)
-static inline VkBufferImageCopy_host *convert_VkBufferImageCopy_array_win_to_host(const VkBufferImageCopy *in, uint32_t count)
+static inline VkBufferImageCopy_host *convert_VkBufferImageCopy_array_win_to_host(struct conversion_context *ctx, const VkBufferImageCopy *in, uint32_t count)
 {
     VkBufferImageCopy_host *out;
     unsigned int i;
 
     if (!in) return NULL;
 
-    out = malloc(count * sizeof(*out));
+    out = conversion_context_alloc(ctx, count * sizeof(*out));
     for (i = 0; i < count; i++)
     {
         out[i].bufferOffset = in[i].bufferOffset;
@@ -586,23 +469,14 @@ static inline VkBufferImageCopy_host *convert_VkBufferImageCopy_array_win_to_hos
 #endif /* USE_STRUCT_CONVERSION */
 
 #if defined(USE_STRUCT_CONVERSION)
-static inline void free_VkBufferImageCopy_array(VkBufferImageCopy_host *in, uint32_t count)
-{
-    if (!in) return;
-
-    free(in);
-}
-#endif /* USE_STRUCT_CONVERSION */
-
-#if defined(USE_STRUCT_CONVERSION)
-static inline VkBufferImageCopy2KHR_host *convert_VkBufferImageCopy2KHR_array_win_to_host(const VkBufferImageCopy2KHR *in, uint32_t count)
+static inline VkBufferImageCopy2KHR_host *convert_VkBufferImageCopy2KHR_array_win_to_host(struct conversion_context *ctx, const VkBufferImageCopy2KHR *in, uint32_t count)
 {
     VkBufferImageCopy2KHR_host *out;
     unsigned int i;
 
     if (!in) return NULL;
 
-    out = malloc(count * sizeof(*out));
+    out = conversion_context_alloc(ctx, count * sizeof(*out));
     for (i = 0; i < count; i++)
     {
         out[i].sType = in[i].sType;
@@ -620,16 +494,7 @@ static inline VkBufferImageCopy2KHR_host *convert_VkBufferImageCopy2KHR_array_wi
 #endif /* USE_STRUCT_CONVERSION */
 
 #if defined(USE_STRUCT_CONVERSION)
-static inline void free_VkBufferImageCopy2KHR_array(VkBufferImageCopy2KHR_host *in, uint32_t count)
-{
-    if (!in) return;
-
-    free(in);
-}
-#endif /* USE_STRUCT_CONVERSION */
-
-#if defined(USE_STRUCT_CONVERSION)
-static inline void convert_VkCopyBufferToImageInfo2KHR_win_to_host(const VkCopyBufferToImageInfo2KHR *in, VkCopyBufferToImageInfo2KHR_host *out)
+static inline void convert_VkCopyBufferToImageInfo2KHR_win_to_host(struct conversion_context *ctx, const VkCopyBufferToImageInfo2KHR *in, VkCopyBufferToImageInfo2KHR_host *out)
 {
     if (!in) return;
 
@@ -639,14 +504,7 @@ static inline void convert_VkCopyBufferToImageInfo2KHR_win_to_host(const VkCopyB
     out->dstImage = in->dstImage;
     out->dstImageLayout = in->dstImageLayout;
     out->regionCount = in->regionCount;
-    out->pRegions = convert_VkBufferImageCopy2KHR_array_win_to_host(in->pRegions, in->regionCount);
-}
-#endif /* USE_STRUCT_CONVERSION */
-
-#if defined(USE_STRUCT_CONVERSION)
-static inline void free_VkCopyBufferToImageInfo2KHR(VkCopyBufferToImageInfo2KHR_host *in)
-{
-    free_VkBufferImageCopy2KHR_array((VkBufferImageCopy2KHR_host *)in->pRegions, in->regionCount);
+    out->pRegions = convert_VkBufferImageCopy2KHR_array_win_to_host(ctx, in->pRegions, in->regionCount);
 }
 #endif /* USE_STRUCT_CONVERSION */
 
@@ -667,7 +525,7 @@ static inline void convert_VkCopyImageInfo2KHR_win_to_host(const VkCopyImageInfo
 #endif /* USE_STRUCT_CONVERSION */
 
 #if defined(USE_STRUCT_CONVERSION)
-static inline void convert_VkCopyImageToBufferInfo2KHR_win_to_host(const VkCopyImageToBufferInfo2KHR *in, VkCopyImageToBufferInfo2KHR_host *out)
+static inline void convert_VkCopyImageToBufferInfo2KHR_win_to_host(struct conversion_context *ctx, const VkCopyImageToBufferInfo2KHR *in, VkCopyImageToBufferInfo2KHR_host *out)
 {
     if (!in) return;
 
@@ -677,14 +535,7 @@ static inline void convert_VkCopyImageToBufferInfo2KHR_win_to_host(const VkCopyI
     out->srcImageLayout = in->srcImageLayout;
     out->dstBuffer = in->dstBuffer;
     out->regionCount = in->regionCount;
-    out->pRegions = convert_VkBufferImageCopy2KHR_array_win_to_host(in->pRegions, in->regionCount);
-}
-#endif /* USE_STRUCT_CONVERSION */
-
-#if defined(USE_STRUCT_CONVERSION)
-static inline void free_VkCopyImageToBufferInfo2KHR(VkCopyImageToBufferInfo2KHR_host *in)
-{
-    free_VkBufferImageCopy2KHR_array((VkBufferImageCopy2KHR_host *)in->pRegions, in->regionCount);
+    out->pRegions = convert_VkBufferImageCopy2KHR_array_win_to_host(ctx, in->pRegions, in->regionCount);
 }
 #endif /* USE_STRUCT_CONVERSION */
 
@@ -723,14 +574,14 @@ static inline void convert_VkCuLaunchInfoNVX_win_to_host(const VkCuLaunchInfoNVX
 }
 #endif /* USE_STRUCT_CONVERSION */
 
-static inline VkCommandBuffer *convert_VkCommandBuffer_array_win_to_host(const VkCommandBuffer *in, uint32_t count)
+static inline VkCommandBuffer *convert_VkCommandBuffer_array_win_to_host(struct conversion_context *ctx, const VkCommandBuffer *in, uint32_t count)
 {
     VkCommandBuffer *out;
     unsigned int i;
 
     if (!in) return NULL;
 
-    out = malloc(count * sizeof(*out));
+    out = conversion_context_alloc(ctx, count * sizeof(*out));
     for (i = 0; i < count; i++)
     {
         out[i] = in[i]->command_buffer;
@@ -739,22 +590,15 @@ static inline VkCommandBuffer *convert_VkCommandBuffer_array_win_to_host(const V
     return out;
 }
 
-static inline void free_VkCommandBuffer_array(VkCommandBuffer *in, uint32_t count)
-{
-    if (!in) return;
-
-    free(in);
-}
-
 #if defined(USE_STRUCT_CONVERSION)
-static inline VkIndirectCommandsStreamNV_host *convert_VkIndirectCommandsStreamNV_array_win_to_host(const VkIndirectCommandsStreamNV *in, uint32_t count)
+static inline VkIndirectCommandsStreamNV_host *convert_VkIndirectCommandsStreamNV_array_win_to_host(struct conversion_context *ctx, const VkIndirectCommandsStreamNV *in, uint32_t count)
 {
     VkIndirectCommandsStreamNV_host *out;
     unsigned int i;
 
     if (!in) return NULL;
 
-    out = malloc(count * sizeof(*out));
+    out = conversion_context_alloc(ctx, count * sizeof(*out));
     for (i = 0; i < count; i++)
     {
         out[i].buffer = in[i].buffer;
@@ -766,16 +610,7 @@ static inline VkIndirectCommandsStreamNV_host *convert_VkIndirectCommandsStreamN
 #endif /* USE_STRUCT_CONVERSION */
 
 #if defined(USE_STRUCT_CONVERSION)
-static inline void free_VkIndirectCommandsStreamNV_array(VkIndirectCommandsStreamNV_host *in, uint32_t count)
-{
-    if (!in) return;
-
-    free(in);
-}
-#endif /* USE_STRUCT_CONVERSION */
-
-#if defined(USE_STRUCT_CONVERSION)
-static inline void convert_VkGeneratedCommandsInfoNV_win_to_host(const VkGeneratedCommandsInfoNV *in, VkGeneratedCommandsInfoNV_host *out)
+static inline void convert_VkGeneratedCommandsInfoNV_win_to_host(struct conversion_context *ctx, const VkGeneratedCommandsInfoNV *in, VkGeneratedCommandsInfoNV_host *out)
 {
     if (!in) return;
 
@@ -785,7 +620,7 @@ static inline void convert_VkGeneratedCommandsInfoNV_win_to_host(const VkGenerat
     out->pipeline = in->pipeline;
     out->indirectCommandsLayout = in->indirectCommandsLayout;
     out->streamCount = in->streamCount;
-    out->pStreams = convert_VkIndirectCommandsStreamNV_array_win_to_host(in->pStreams, in->streamCount);
+    out->pStreams = convert_VkIndirectCommandsStreamNV_array_win_to_host(ctx, in->pStreams, in->streamCount);
     out->sequencesCount = in->sequencesCount;
     out->preprocessBuffer = in->preprocessBuffer;
     out->preprocessOffset = in->preprocessOffset;
@@ -798,21 +633,14 @@ static inline void convert_VkGeneratedCommandsInfoNV_win_to_host(const VkGenerat
 #endif /* USE_STRUCT_CONVERSION */
 
 #if defined(USE_STRUCT_CONVERSION)
-static inline void free_VkGeneratedCommandsInfoNV(VkGeneratedCommandsInfoNV_host *in)
-{
-    free_VkIndirectCommandsStreamNV_array((VkIndirectCommandsStreamNV_host *)in->pStreams, in->streamCount);
-}
-#endif /* USE_STRUCT_CONVERSION */
-
-#if defined(USE_STRUCT_CONVERSION)
-static inline VkBufferMemoryBarrier_host *convert_VkBufferMemoryBarrier_array_win_to_host(const VkBufferMemoryBarrier *in, uint32_t count)
+static inline VkBufferMemoryBarrier_host *convert_VkBufferMemoryBarrier_array_win_to_host(struct conversion_context *ctx, const VkBufferMemoryBarrier *in, uint32_t count)
 {
     VkBufferMemoryBarrier_host *out;
     unsigned int i;
 
     if (!in) return NULL;
 
-    out = malloc(count * sizeof(*out));
+    out = conversion_context_alloc(ctx, count * sizeof(*out));
     for (i = 0; i < count; i++)
     {
         out[i].sType = in[i].sType;
@@ -831,23 +659,14 @@ static inline VkBufferMemoryBarrier_host *convert_VkBufferMemoryBarrier_array_wi
 #endif /* USE_STRUCT_CONVERSION */
 
 #if defined(USE_STRUCT_CONVERSION)
-static inline void free_VkBufferMemoryBarrier_array(VkBufferMemoryBarrier_host *in, uint32_t count)
-{
-    if (!in) return;
-
-    free(in);
-}
-#endif /* USE_STRUCT_CONVERSION */
-
-#if defined(USE_STRUCT_CONVERSION)
-static inline VkImageMemoryBarrier_host *convert_VkImageMemoryBarrier_array_win_to_host(const VkImageMemoryBarrier *in, uint32_t count)
+static inline VkImageMemoryBarrier_host *convert_VkImageMemoryBarrier_array_win_to_host(struct conversion_context *ctx, const VkImageMemoryBarrier *in, uint32_t count)
 {
     VkImageMemoryBarrier_host *out;
     unsigned int i;
 
     if (!in) return NULL;
 
-    out = malloc(count * sizeof(*out));
+    out = conversion_context_alloc(ctx, count * sizeof(*out));
     for (i = 0; i < count; i++)
     {
         out[i].sType = in[i].sType;
@@ -867,23 +686,14 @@ static inline VkImageMemoryBarrier_host *convert_VkImageMemoryBarrier_array_win_
 #endif /* USE_STRUCT_CONVERSION */
 
 #if defined(USE_STRUCT_CONVERSION)
-static inline void free_VkImageMemoryBarrier_array(VkImageMemoryBarrier_host *in, uint32_t count)
-{
-    if (!in) return;
-
-    free(in);
-}
-#endif /* USE_STRUCT_CONVERSION */
-
-#if defined(USE_STRUCT_CONVERSION)
-static inline VkBufferMemoryBarrier2KHR_host *convert_VkBufferMemoryBarrier2KHR_array_win_to_host(const VkBufferMemoryBarrier2KHR *in, uint32_t count)
+static inline VkBufferMemoryBarrier2KHR_host *convert_VkBufferMemoryBarrier2KHR_array_win_to_host(struct conversion_context *ctx, const VkBufferMemoryBarrier2KHR *in, uint32_t count)
 {
     VkBufferMemoryBarrier2KHR_host *out;
     unsigned int i;
 
     if (!in) return NULL;
 
-    out = malloc(count * sizeof(*out));
+    out = conversion_context_alloc(ctx, count * sizeof(*out));
     for (i = 0; i < count; i++)
     {
         out[i].sType = in[i].sType;
@@ -904,23 +714,14 @@ static inline VkBufferMemoryBarrier2KHR_host *convert_VkBufferMemoryBarrier2KHR_
 #endif /* USE_STRUCT_CONVERSION */
 
 #if defined(USE_STRUCT_CONVERSION)
-static inline void free_VkBufferMemoryBarrier2KHR_array(VkBufferMemoryBarrier2KHR_host *in, uint32_t count)
-{
-    if (!in) return;
-
-    free(in);
-}
-#endif /* USE_STRUCT_CONVERSION */
-
-#if defined(USE_STRUCT_CONVERSION)
-static inline VkImageMemoryBarrier2KHR_host *convert_VkImageMemoryBarrier2KHR_array_win_to_host(const VkImageMemoryBarrier2KHR *in, uint32_t count)
+static inline VkImageMemoryBarrier2KHR_host *convert_VkImageMemoryBarrier2KHR_array_win_to_host(struct conversion_context *ctx, const VkImageMemoryBarrier2KHR *in, uint32_t count)
 {
     VkImageMemoryBarrier2KHR_host *out;
     unsigned int i;
 
     if (!in) return NULL;
 
-    out = malloc(count * sizeof(*out));
+    out = conversion_context_alloc(ctx, count * sizeof(*out));
     for (i = 0; i < count; i++)
     {
         out[i].sType = in[i].sType;
@@ -942,16 +743,7 @@ static inline VkImageMemoryBarrier2KHR_host *convert_VkImageMemoryBarrier2KHR_ar
 #endif /* USE_STRUCT_CONVERSION */
 
 #if defined(USE_STRUCT_CONVERSION)
-static inline void free_VkImageMemoryBarrier2KHR_array(VkImageMemoryBarrier2KHR_host *in, uint32_t count)
-{
-    if (!in) return;
-
-    free(in);
-}
-#endif /* USE_STRUCT_CONVERSION */
-
-#if defined(USE_STRUCT_CONVERSION)
-static inline void convert_VkDependencyInfoKHR_win_to_host(const VkDependencyInfoKHR *in, VkDependencyInfoKHR_host *out)
+static inline void convert_VkDependencyInfoKHR_win_to_host(struct conversion_context *ctx, const VkDependencyInfoKHR *in, VkDependencyInfoKHR_host *out)
 {
     if (!in) return;
 
@@ -961,29 +753,21 @@ static inline void convert_VkDependencyInfoKHR_win_to_host(const VkDependencyInf
     out->memoryBarrierCount = in->memoryBarrierCount;
     out->pMemoryBarriers = in->pMemoryBarriers;
     out->bufferMemoryBarrierCount = in->bufferMemoryBarrierCount;
-    out->pBufferMemoryBarriers = convert_VkBufferMemoryBarrier2KHR_array_win_to_host(in->pBufferMemoryBarriers, in->bufferMemoryBarrierCount);
+    out->pBufferMemoryBarriers = convert_VkBufferMemoryBarrier2KHR_array_win_to_host(ctx, in->pBufferMemoryBarriers, in->bufferMemoryBarrierCount);
     out->imageMemoryBarrierCount = in->imageMemoryBarrierCount;
-    out->pImageMemoryBarriers = convert_VkImageMemoryBarrier2KHR_array_win_to_host(in->pImageMemoryBarriers, in->imageMemoryBarrierCount);
-}
-#endif /* USE_STRUCT_CONVERSION */
-
-#if defined(USE_STRUCT_CONVERSION)
-static inline void free_VkDependencyInfoKHR(VkDependencyInfoKHR_host *in)
-{
-    free_VkBufferMemoryBarrier2KHR_array((VkBufferMemoryBarrier2KHR_host *)in->pBufferMemoryBarriers, in->bufferMemoryBarrierCount);
-    free_VkImageMemoryBarrier2KHR_array((VkImageMemoryBarrier2KHR_host *)in->pImageMemoryBarriers, in->imageMemoryBarrierCount);
+    out->pImageMemoryBarriers = convert_VkImageMemoryBarrier2KHR_array_win_to_host(ctx, in->pImageMemoryBarriers, in->imageMemoryBarrierCount);
 }
 #endif /* USE_STRUCT_CONVERSION */
 
 #if defined(USE_STRUCT_CONVERSION)
-static inline VkDescriptorImageInfo_host *convert_VkDescriptorImageInfo_array_win_to_host(const VkDescriptorImageInfo *in, uint32_t count)
+static inline VkDescriptorImageInfo_host *convert_VkDescriptorImageInfo_array_win_to_host(struct conversion_context *ctx, const VkDescriptorImageInfo *in, uint32_t count)
 {
     VkDescriptorImageInfo_host *out;
     unsigned int i;
 
     if (!in) return NULL;
 
-    out = malloc(count * sizeof(*out));
+    out = conversion_context_alloc(ctx, count * sizeof(*out));
     for (i = 0; i < count; i++)
     {
         out[i].sampler = in[i].sampler;
@@ -996,23 +780,14 @@ static inline VkDescriptorImageInfo_host *convert_VkDescriptorImageInfo_array_wi
 #endif /* USE_STRUCT_CONVERSION */
 
 #if defined(USE_STRUCT_CONVERSION)
-static inline void free_VkDescriptorImageInfo_array(VkDescriptorImageInfo_host *in, uint32_t count)
-{
-    if (!in) return;
-
-    free(in);
-}
-#endif /* USE_STRUCT_CONVERSION */
-
-#if defined(USE_STRUCT_CONVERSION)
-static inline VkDescriptorBufferInfo_host *convert_VkDescriptorBufferInfo_array_win_to_host(const VkDescriptorBufferInfo *in, uint32_t count)
+static inline VkDescriptorBufferInfo_host *convert_VkDescriptorBufferInfo_array_win_to_host(struct conversion_context *ctx, const VkDescriptorBufferInfo *in, uint32_t count)
 {
     VkDescriptorBufferInfo_host *out;
     unsigned int i;
 
     if (!in) return NULL;
 
-    out = malloc(count * sizeof(*out));
+    out = conversion_context_alloc(ctx, count * sizeof(*out));
     for (i = 0; i < count; i++)
     {
         out[i].buffer = in[i].buffer;
@@ -1025,23 +800,14 @@ static inline VkDescriptorBufferInfo_host *convert_VkDescriptorBufferInfo_array_
 #endif /* USE_STRUCT_CONVERSION */
 
 #if defined(USE_STRUCT_CONVERSION)
-static inline void free_VkDescriptorBufferInfo_array(VkDescriptorBufferInfo_host *in, uint32_t count)
-{
-    if (!in) return;
-
-    free(in);
-}
-#endif /* USE_STRUCT_CONVERSION */
-
-#if defined(USE_STRUCT_CONVERSION)
-static inline VkWriteDescriptorSet_host *convert_VkWriteDescriptorSet_array_win_to_host(const VkWriteDescriptorSet *in, uint32_t count)
+static inline VkWriteDescriptorSet_host *convert_VkWriteDescriptorSet_array_win_to_host(struct conversion_context *ctx, const VkWriteDescriptorSet *in, uint32_t count)
 {
     VkWriteDescriptorSet_host *out;
     unsigned int i;
 
     if (!in) return NULL;
 
-    out = malloc(count * sizeof(*out));
+    out = conversion_context_alloc(ctx, count * sizeof(*out));
     for (i = 0; i < count; i++)
     {
         out[i].sType = in[i].sType;
@@ -1051,8 +817,8 @@ static inline VkWriteDescriptorSet_host *convert_VkWriteDescriptorSet_array_win_
         out[i].dstArrayElement = in[i].dstArrayElement;
         out[i].descriptorCount = in[i].descriptorCount;
         out[i].descriptorType = in[i].descriptorType;
-        out[i].pImageInfo = convert_VkDescriptorImageInfo_array_win_to_host(in[i].pImageInfo, in[i].descriptorCount);
-        out[i].pBufferInfo = convert_VkDescriptorBufferInfo_array_win_to_host(in[i].pBufferInfo, in[i].descriptorCount);
+        out[i].pImageInfo = convert_VkDescriptorImageInfo_array_win_to_host(ctx, in[i].pImageInfo, in[i].descriptorCount);
+        out[i].pBufferInfo = convert_VkDescriptorBufferInfo_array_win_to_host(ctx, in[i].pBufferInfo, in[i].descriptorCount);
         out[i].pTexelBufferView = in[i].pTexelBufferView;
     }
 
@@ -1060,22 +826,6 @@ static inline VkWriteDescriptorSet_host *convert_VkWriteDescriptorSet_array_win_
 }
 #endif /* USE_STRUCT_CONVERSION */
 
-#if defined(USE_STRUCT_CONVERSION)
-static inline void free_VkWriteDescriptorSet_array(VkWriteDescriptorSet_host *in, uint32_t count)
-{
-    unsigned int i;
-
-    if (!in) return;
-
-    for (i = 0; i < count; i++)
-    {
-        free_VkDescriptorImageInfo_array((VkDescriptorImageInfo_host *)in[i].pImageInfo, in[i].descriptorCount);
-        free_VkDescriptorBufferInfo_array((VkDescriptorBufferInfo_host *)in[i].pBufferInfo, in[i].descriptorCount);
-    }
-    free(in);
-}
-#endif /* USE_STRUCT_CONVERSION */
-
 #if defined(USE_STRUCT_CONVERSION)
 static inline void convert_VkResolveImageInfo2KHR_win_to_host(const VkResolveImageInfo2KHR *in, VkResolveImageInfo2KHR_host *out)
 {
@@ -1128,14 +878,14 @@ static inline void convert_VkStridedDeviceAddressRegionKHR_win_to_host(const VkS
 #endif /* USE_STRUCT_CONVERSION */
 
 #if defined(USE_STRUCT_CONVERSION)
-static inline VkDependencyInfoKHR_host *convert_VkDependencyInfoKHR_array_win_to_host(const VkDependencyInfoKHR *in, uint32_t count)
+static inline VkDependencyInfoKHR_host *convert_VkDependencyInfoKHR_array_win_to_host(struct conversion_context *ctx, const VkDependencyInfoKHR *in, uint32_t count)
 {
     VkDependencyInfoKHR_host *out;
     unsigned int i;
 
     if (!in) return NULL;
 
-    out = malloc(count * sizeof(*out));
+    out = conversion_context_alloc(ctx, count * sizeof(*out));
     for (i = 0; i < count; i++)
     {
         out[i].sType = in[i].sType;
@@ -1144,31 +894,15 @@ static inline VkDependencyInfoKHR_host *convert_VkDependencyInfoKHR_array_win_to
         out[i].memoryBarrierCount = in[i].memoryBarrierCount;
         out[i].pMemoryBarriers = in[i].pMemoryBarriers;
         out[i].bufferMemoryBarrierCount = in[i].bufferMemoryBarrierCount;
-        out[i].pBufferMemoryBarriers = convert_VkBufferMemoryBarrier2KHR_array_win_to_host(in[i].pBufferMemoryBarriers, in[i].bufferMemoryBarrierCount);
+        out[i].pBufferMemoryBarriers = convert_VkBufferMemoryBarrier2KHR_array_win_to_host(ctx, in[i].pBufferMemoryBarriers, in[i].bufferMemoryBarrierCount);
         out[i].imageMemoryBarrierCount = in[i].imageMemoryBarrierCount;
-        out[i].pImageMemoryBarriers = convert_VkImageMemoryBarrier2KHR_array_win_to_host(in[i].pImageMemoryBarriers, in[i].imageMemoryBarrierCount);
+        out[i].pImageMemoryBarriers = convert_VkImageMemoryBarrier2KHR_array_win_to_host(ctx, in[i].pImageMemoryBarriers, in[i].imageMemoryBarrierCount);
     }
 
     return out;
 }
 #endif /* USE_STRUCT_CONVERSION */
 
-#if defined(USE_STRUCT_CONVERSION)
-static inline void free_VkDependencyInfoKHR_array(VkDependencyInfoKHR_host *in, uint32_t count)
-{
-    unsigned int i;
-
-    if (!in) return;
-
-    for (i = 0; i < count; i++)
-    {
-        free_VkBufferMemoryBarrier2KHR_array((VkBufferMemoryBarrier2KHR_host *)in[i].pBufferMemoryBarriers, in[i].bufferMemoryBarrierCount);
-        free_VkImageMemoryBarrier2KHR_array((VkImageMemoryBarrier2KHR_host *)in[i].pImageMemoryBarriers, in[i].imageMemoryBarrierCount);
-    }
-    free(in);
-}
-#endif /* USE_STRUCT_CONVERSION */
-
 #if defined(USE_STRUCT_CONVERSION)
 static inline void convert_VkAccelerationStructureCreateInfoKHR_win_to_host(const VkAccelerationStructureCreateInfoKHR *in, VkAccelerationStructureCreateInfoKHR_host *out)
 {
@@ -1186,14 +920,14 @@ static inline void convert_VkAccelerationStructureCreateInfoKHR_win_to_host(cons
 #endif /* USE_STRUCT_CONVERSION */
 
 #if defined(USE_STRUCT_CONVERSION)
-static inline void convert_VkAccelerationStructureCreateInfoNV_win_to_host(const VkAccelerationStructureCreateInfoNV *in, VkAccelerationStructureCreateInfoNV_host *out)
+static inline void convert_VkAccelerationStructureCreateInfoNV_win_to_host(struct conversion_context *ctx, const VkAccelerationStructureCreateInfoNV *in, VkAccelerationStructureCreateInfoNV_host *out)
 {
     if (!in) return;
 
     out->sType = in->sType;
     out->pNext = in->pNext;
     out->compactedSize = in->compactedSize;
-    convert_VkAccelerationStructureInfoNV_win_to_host(&in->info, &out->info);
+    convert_VkAccelerationStructureInfoNV_win_to_host(ctx, &in->info, &out->info);
 }
 #endif /* USE_STRUCT_CONVERSION */
 
@@ -1228,14 +962,14 @@ static inline void convert_VkPipelineShaderStageCreateInfo_win_to_host(const VkP
 #endif /* USE_STRUCT_CONVERSION */
 
 #if defined(USE_STRUCT_CONVERSION)
-static inline VkComputePipelineCreateInfo_host *convert_VkComputePipelineCreateInfo_array_win_to_host(const VkComputePipelineCreateInfo *in, uint32_t count)
+static inline VkComputePipelineCreateInfo_host *convert_VkComputePipelineCreateInfo_array_win_to_host(struct conversion_context *ctx, const VkComputePipelineCreateInfo *in, uint32_t count)
 {
     VkComputePipelineCreateInfo_host *out;
     unsigned int i;
 
     if (!in) return NULL;
 
-    out = malloc(count * sizeof(*out));
+    out = conversion_context_alloc(ctx, count * sizeof(*out));
     for (i = 0; i < count; i++)
     {
         out[i].sType = in[i].sType;
@@ -1251,15 +985,6 @@ static inline VkComputePipelineCreateInfo_host *convert_VkComputePipelineCreateI
 }
 #endif /* USE_STRUCT_CONVERSION */
 
-#if defined(USE_STRUCT_CONVERSION)
-static inline void free_VkComputePipelineCreateInfo_array(VkComputePipelineCreateInfo_host *in, uint32_t count)
-{
-    if (!in) return;
-
-    free(in);
-}
-#endif /* USE_STRUCT_CONVERSION */
-
 #if defined(USE_STRUCT_CONVERSION)
 static inline void convert_VkCuFunctionCreateInfoNVX_win_to_host(const VkCuFunctionCreateInfoNVX *in, VkCuFunctionCreateInfoNVX_host *out)
 {
@@ -1308,14 +1033,14 @@ static inline void convert_VkFramebufferCreateInfo_win_to_host(const VkFramebuff
 #endif /* USE_STRUCT_CONVERSION */
 
 #if defined(USE_STRUCT_CONVERSION)
-static inline VkPipelineShaderStageCreateInfo_host *convert_VkPipelineShaderStageCreateInfo_array_win_to_host(const VkPipelineShaderStageCreateInfo *in, uint32_t count)
+static inline VkPipelineShaderStageCreateInfo_host *convert_VkPipelineShaderStageCreateInfo_array_win_to_host(struct conversion_context *ctx, const VkPipelineShaderStageCreateInfo *in, uint32_t count)
 {
     VkPipelineShaderStageCreateInfo_host *out;
     unsigned int i;
 
     if (!in) return NULL;
 
-    out = malloc(count * sizeof(*out));
+    out = conversion_context_alloc(ctx, count * sizeof(*out));
     for (i = 0; i < count; i++)
     {
         out[i].sType = in[i].sType;
@@ -1332,30 +1057,21 @@ static inline VkPipelineShaderStageCreateInfo_host *convert_VkPipelineShaderStag
 #endif /* USE_STRUCT_CONVERSION */
 
 #if defined(USE_STRUCT_CONVERSION)
-static inline void free_VkPipelineShaderStageCreateInfo_array(VkPipelineShaderStageCreateInfo_host *in, uint32_t count)
-{
-    if (!in) return;
-
-    free(in);
-}
-#endif /* USE_STRUCT_CONVERSION */
-
-#if defined(USE_STRUCT_CONVERSION)
-static inline VkGraphicsPipelineCreateInfo_host *convert_VkGraphicsPipelineCreateInfo_array_win_to_host(const VkGraphicsPipelineCreateInfo *in, uint32_t count)
+static inline VkGraphicsPipelineCreateInfo_host *convert_VkGraphicsPipelineCreateInfo_array_win_to_host(struct conversion_context *ctx, const VkGraphicsPipelineCreateInfo *in, uint32_t count)
 {
     VkGraphicsPipelineCreateInfo_host *out;
     unsigned int i;
 
     if (!in) return NULL;
 
-    out = malloc(count * sizeof(*out));
+    out = conversion_context_alloc(ctx, count * sizeof(*out));
     for (i = 0; i < count; i++)
     {
         out[i].sType = in[i].sType;
         out[i].pNext = in[i].pNext;
         out[i].flags = in[i].flags;
         out[i].stageCount = in[i].stageCount;
-        out[i].pStages = convert_VkPipelineShaderStageCreateInfo_array_win_to_host(in[i].pStages, in[i].stageCount);
+        out[i].pStages = convert_VkPipelineShaderStageCreateInfo_array_win_to_host(ctx, in[i].pStages, in[i].stageCount);
         out[i].pVertexInputState = in[i].pVertexInputState;
         out[i].pInputAssemblyState = in[i].pInputAssemblyState;
         out[i].pTessellationState = in[i].pTessellationState;
@@ -1376,21 +1092,6 @@ static inline VkGraphicsPipelineCreateInfo_host *convert_VkGraphicsPipelineCreat
 }
 #endif /* USE_STRUCT_CONVERSION */
 
-#if defined(USE_STRUCT_CONVERSION)
-static inline void free_VkGraphicsPipelineCreateInfo_array(VkGraphicsPipelineCreateInfo_host *in, uint32_t count)
-{
-    unsigned int i;
-
-    if (!in) return;
-
-    for (i = 0; i < count; i++)
-    {
-        free_VkPipelineShaderStageCreateInfo_array((VkPipelineShaderStageCreateInfo_host *)in[i].pStages, in[i].stageCount);
-    }
-    free(in);
-}
-#endif /* USE_STRUCT_CONVERSION */
-
 #if defined(USE_STRUCT_CONVERSION)
 static inline void convert_VkImageViewCreateInfo_win_to_host(const VkImageViewCreateInfo *in, VkImageViewCreateInfo_host *out)
 {
@@ -1408,14 +1109,14 @@ static inline void convert_VkImageViewCreateInfo_win_to_host(const VkImageViewCr
 #endif /* USE_STRUCT_CONVERSION */
 
 #if defined(USE_STRUCT_CONVERSION)
-static inline VkIndirectCommandsLayoutTokenNV_host *convert_VkIndirectCommandsLayoutTokenNV_array_win_to_host(const VkIndirectCommandsLayoutTokenNV *in, uint32_t count)
+static inline VkIndirectCommandsLayoutTokenNV_host *convert_VkIndirectCommandsLayoutTokenNV_array_win_to_host(struct conversion_context *ctx, const VkIndirectCommandsLayoutTokenNV *in, uint32_t count)
 {
     VkIndirectCommandsLayoutTokenNV_host *out;
     unsigned int i;
 
     if (!in) return NULL;
 
-    out = malloc(count * sizeof(*out));
+    out = conversion_context_alloc(ctx, count * sizeof(*out));
     for (i = 0; i < count; i++)
     {
         out[i].sType = in[i].sType;
@@ -1440,16 +1141,7 @@ static inline VkIndirectCommandsLayoutTokenNV_host *convert_VkIndirectCommandsLa
 #endif /* USE_STRUCT_CONVERSION */
 
 #if defined(USE_STRUCT_CONVERSION)
-static inline void free_VkIndirectCommandsLayoutTokenNV_array(VkIndirectCommandsLayoutTokenNV_host *in, uint32_t count)
-{
-    if (!in) return;
-
-    free(in);
-}
-#endif /* USE_STRUCT_CONVERSION */
-
-#if defined(USE_STRUCT_CONVERSION)
-static inline void convert_VkIndirectCommandsLayoutCreateInfoNV_win_to_host(const VkIndirectCommandsLayoutCreateInfoNV *in, VkIndirectCommandsLayoutCreateInfoNV_host *out)
+static inline void convert_VkIndirectCommandsLayoutCreateInfoNV_win_to_host(struct conversion_context *ctx, const VkIndirectCommandsLayoutCreateInfoNV *in, VkIndirectCommandsLayoutCreateInfoNV_host *out)
 {
     if (!in) return;
 
@@ -1458,35 +1150,28 @@ static inline void convert_VkIndirectCommandsLayoutCreateInfoNV_win_to_host(cons
     out->flags = in->flags;
     out->pipelineBindPoint = in->pipelineBindPoint;
     out->tokenCount = in->tokenCount;
-    out->pTokens = convert_VkIndirectCommandsLayoutTokenNV_array_win_to_host(in->pTokens, in->tokenCount);
+    out->pTokens = convert_VkIndirectCommandsLayoutTokenNV_array_win_to_host(ctx, in->pTokens, in->tokenCount);
     out->streamCount = in->streamCount;
     out->pStreamStrides = in->pStreamStrides;
 }
 #endif /* USE_STRUCT_CONVERSION */
 
 #if defined(USE_STRUCT_CONVERSION)
-static inline void free_VkIndirectCommandsLayoutCreateInfoNV(VkIndirectCommandsLayoutCreateInfoNV_host *in)
-{
-    free_VkIndirectCommandsLayoutTokenNV_array((VkIndirectCommandsLayoutTokenNV_host *)in->pTokens, in->tokenCount);
-}
-#endif /* USE_STRUCT_CONVERSION */
-
-#if defined(USE_STRUCT_CONVERSION)
-static inline VkRayTracingPipelineCreateInfoKHR_host *convert_VkRayTracingPipelineCreateInfoKHR_array_win_to_host(const VkRayTracingPipelineCreateInfoKHR *in, uint32_t count)
+static inline VkRayTracingPipelineCreateInfoKHR_host *convert_VkRayTracingPipelineCreateInfoKHR_array_win_to_host(struct conversion_context *ctx, const VkRayTracingPipelineCreateInfoKHR *in, uint32_t count)
 {
     VkRayTracingPipelineCreateInfoKHR_host *out;
     unsigned int i;
 
     if (!in) return NULL;
 
-    out = malloc(count * sizeof(*out));
+    out = conversion_context_alloc(ctx, count * sizeof(*out));
     for (i = 0; i < count; i++)
     {
         out[i].sType = in[i].sType;
         out[i].pNext = in[i].pNext;
         out[i].flags = in[i].flags;
         out[i].stageCount = in[i].stageCount;
-        out[i].pStages = convert_VkPipelineShaderStageCreateInfo_array_win_to_host(in[i].pStages, in[i].stageCount);
+        out[i].pStages = convert_VkPipelineShaderStageCreateInfo_array_win_to_host(ctx, in[i].pStages, in[i].stageCount);
         out[i].groupCount = in[i].groupCount;
         out[i].pGroups = in[i].pGroups;
         out[i].maxPipelineRayRecursionDepth = in[i].maxPipelineRayRecursionDepth;
@@ -1503,36 +1188,21 @@ static inline VkRayTracingPipelineCreateInfoKHR_host *convert_VkRayTracingPipeli
 #endif /* USE_STRUCT_CONVERSION */
 
 #if defined(USE_STRUCT_CONVERSION)
-static inline void free_VkRayTracingPipelineCreateInfoKHR_array(VkRayTracingPipelineCreateInfoKHR_host *in, uint32_t count)
-{
-    unsigned int i;
-
-    if (!in) return;
-
-    for (i = 0; i < count; i++)
-    {
-        free_VkPipelineShaderStageCreateInfo_array((VkPipelineShaderStageCreateInfo_host *)in[i].pStages, in[i].stageCount);
-    }
-    free(in);
-}
-#endif /* USE_STRUCT_CONVERSION */
-
-#if defined(USE_STRUCT_CONVERSION)
-static inline VkRayTracingPipelineCreateInfoNV_host *convert_VkRayTracingPipelineCreateInfoNV_array_win_to_host(const VkRayTracingPipelineCreateInfoNV *in, uint32_t count)
+static inline VkRayTracingPipelineCreateInfoNV_host *convert_VkRayTracingPipelineCreateInfoNV_array_win_to_host(struct conversion_context *ctx, const VkRayTracingPipelineCreateInfoNV *in, uint32_t count)
 {
     VkRayTracingPipelineCreateInfoNV_host *out;
     unsigned int i;
 
     if (!in) return NULL;
 
-    out = malloc(count * sizeof(*out));
+    out = conversion_context_alloc(ctx, count * sizeof(*out));
     for (i = 0; i < count; i++)
     {
         out[i].sType = in[i].sType;
         out[i].pNext = in[i].pNext;
         out[i].flags = in[i].flags;
         out[i].stageCount = in[i].stageCount;
-        out[i].pStages = convert_VkPipelineShaderStageCreateInfo_array_win_to_host(in[i].pStages, in[i].stageCount);
+        out[i].pStages = convert_VkPipelineShaderStageCreateInfo_array_win_to_host(ctx, in[i].pStages, in[i].stageCount);
         out[i].groupCount = in[i].groupCount;
         out[i].pGroups = in[i].pGroups;
         out[i].maxRecursionDepth = in[i].maxRecursionDepth;
@@ -1545,21 +1215,6 @@ static inline VkRayTracingPipelineCreateInfoNV_host *convert_VkRayTracingPipelin
 }
 #endif /* USE_STRUCT_CONVERSION */
 
-#if defined(USE_STRUCT_CONVERSION)
-static inline void free_VkRayTracingPipelineCreateInfoNV_array(VkRayTracingPipelineCreateInfoNV_host *in, uint32_t count)
-{
-    unsigned int i;
-
-    if (!in) return;
-
-    for (i = 0; i < count; i++)
-    {
-        free_VkPipelineShaderStageCreateInfo_array((VkPipelineShaderStageCreateInfo_host *)in[i].pStages, in[i].stageCount);
-    }
-    free(in);
-}
-#endif /* USE_STRUCT_CONVERSION */
-
 #if defined(USE_STRUCT_CONVERSION)
 static inline void convert_VkDebugMarkerObjectNameInfoEXT_win_to_host(const VkDebugMarkerObjectNameInfoEXT *in, VkDebugMarkerObjectNameInfoEXT_host *out)
 #else
@@ -1593,11 +1248,11 @@ static inline void convert_VkDebugMarkerObjectTagInfoEXT_win_to_host(const VkDeb
 }
 
 #if defined(USE_STRUCT_CONVERSION)
-static inline VkMappedMemoryRange_host *convert_VkMappedMemoryRange_array_win_to_host(const VkMappedMemoryRange *in, uint32_t count)
+static inline VkMappedMemoryRange_host *convert_VkMappedMemoryRange_array_win_to_host(struct conversion_context *ctx, const VkMappedMemoryRange *in, uint32_t count)
 {
     VkMappedMemoryRange_host *out;
 #else
-static inline VkMappedMemoryRange *convert_VkMappedMemoryRange_array_win_to_host(const VkMappedMemoryRange *in, uint32_t count)
+static inline VkMappedMemoryRange *convert_VkMappedMemoryRange_array_win_to_host(struct conversion_context *ctx, const VkMappedMemoryRange *in, uint32_t count)
 {
     VkMappedMemoryRange *out;
 #endif /* USE_STRUCT_CONVERSION */
@@ -1605,7 +1260,7 @@ static inline VkMappedMemoryRange *convert_VkMappedMemoryRange_array_win_to_host
 
     if (!in) return NULL;
 
-    out = malloc(count * sizeof(*out));
+    out = conversion_context_alloc(ctx, count * sizeof(*out));
     for (i = 0; i < count; i++)
     {
         out[i].sType = in[i].sType;
@@ -1618,17 +1273,6 @@ static inline VkMappedMemoryRange *convert_VkMappedMemoryRange_array_win_to_host
     return out;
 }
 
-#if defined(USE_STRUCT_CONVERSION)
-static inline void free_VkMappedMemoryRange_array(VkMappedMemoryRange_host *in, uint32_t count)
-#else
-static inline void free_VkMappedMemoryRange_array(VkMappedMemoryRange *in, uint32_t count)
-#endif /* USE_STRUCT_CONVERSION */
-{
-    if (!in) return;
-
-    free(in);
-}
-
 #if defined(USE_STRUCT_CONVERSION)
 static inline void convert_VkAccelerationStructureBuildGeometryInfoKHR_win_to_host(const VkAccelerationStructureBuildGeometryInfoKHR *in, VkAccelerationStructureBuildGeometryInfoKHR_host *out)
 {
@@ -1760,14 +1404,14 @@ static inline void convert_VkMemoryRequirements2_host_to_win(const VkMemoryRequi
 #endif /* USE_STRUCT_CONVERSION */
 
 #if defined(USE_STRUCT_CONVERSION)
-static inline VkBufferCreateInfo_host *convert_VkBufferCreateInfo_array_win_to_host(const VkBufferCreateInfo *in, uint32_t count)
+static inline VkBufferCreateInfo_host *convert_VkBufferCreateInfo_array_win_to_host(struct conversion_context *ctx, const VkBufferCreateInfo *in, uint32_t count)
 {
     VkBufferCreateInfo_host *out;
     unsigned int i;
 
     if (!in) return NULL;
 
-    out = malloc(count * sizeof(*out));
+    out = conversion_context_alloc(ctx, count * sizeof(*out));
     for (i = 0; i < count; i++)
     {
         out[i].sType = in[i].sType;
@@ -1785,29 +1429,13 @@ static inline VkBufferCreateInfo_host *convert_VkBufferCreateInfo_array_win_to_h
 #endif /* USE_STRUCT_CONVERSION */
 
 #if defined(USE_STRUCT_CONVERSION)
-static inline void free_VkBufferCreateInfo_array(VkBufferCreateInfo_host *in, uint32_t count)
-{
-    if (!in) return;
-
-    free(in);
-}
-#endif /* USE_STRUCT_CONVERSION */
-
-#if defined(USE_STRUCT_CONVERSION)
-static inline void convert_VkDeviceBufferMemoryRequirementsKHR_win_to_host(const VkDeviceBufferMemoryRequirementsKHR *in, VkDeviceBufferMemoryRequirementsKHR_host *out)
+static inline void convert_VkDeviceBufferMemoryRequirementsKHR_win_to_host(struct conversion_context *ctx, const VkDeviceBufferMemoryRequirementsKHR *in, VkDeviceBufferMemoryRequirementsKHR_host *out)
 {
     if (!in) return;
 
     out->sType = in->sType;
     out->pNext = in->pNext;
-    out->pCreateInfo = convert_VkBufferCreateInfo_array_win_to_host(in->pCreateInfo, 1);
-}
-#endif /* USE_STRUCT_CONVERSION */
-
-#if defined(USE_STRUCT_CONVERSION)
-static inline void free_VkDeviceBufferMemoryRequirementsKHR(VkDeviceBufferMemoryRequirementsKHR_host *in)
-{
-    free_VkBufferCreateInfo_array((VkBufferCreateInfo_host *)in->pCreateInfo, 1);
+    out->pCreateInfo = convert_VkBufferCreateInfo_array_win_to_host(ctx, in->pCreateInfo, 1);
 }
 #endif /* USE_STRUCT_CONVERSION */
 
@@ -2193,11 +1821,11 @@ static inline void convert_VkPipelineInfoKHR_win_to_host(const VkPipelineInfoKHR
 #endif /* USE_STRUCT_CONVERSION */
 
 #if defined(USE_STRUCT_CONVERSION)
-static inline VkSparseMemoryBind_host *convert_VkSparseMemoryBind_array_win_to_host(const VkSparseMemoryBind *in, uint32_t count)
+static inline VkSparseMemoryBind_host *convert_VkSparseMemoryBind_array_win_to_host(struct conversion_context *ctx, const VkSparseMemoryBind *in, uint32_t count)
 {
     VkSparseMemoryBind_host *out;
 #else
-static inline VkSparseMemoryBind *convert_VkSparseMemoryBind_array_win_to_host(const VkSparseMemoryBind *in, uint32_t count)
+static inline VkSparseMemoryBind *convert_VkSparseMemoryBind_array_win_to_host(struct conversion_context *ctx, const VkSparseMemoryBind *in, uint32_t count)
 {
     VkSparseMemoryBind *out;
 #endif /* USE_STRUCT_CONVERSION */
@@ -2205,7 +1833,7 @@ static inline VkSparseMemoryBind *convert_VkSparseMemoryBind_array_win_to_host(c
 
     if (!in) return NULL;
 
-    out = malloc(count * sizeof(*out));
+    out = conversion_context_alloc(ctx, count * sizeof(*out));
     for (i = 0; i < count; i++)
     {
         out[i].resourceOffset = in[i].resourceOffset;
@@ -2219,22 +1847,11 @@ static inline VkSparseMemoryBind *convert_VkSparseMemoryBind_array_win_to_host(c
 }
 
 #if defined(USE_STRUCT_CONVERSION)
-static inline void free_VkSparseMemoryBind_array(VkSparseMemoryBind_host *in, uint32_t count)
-#else
-static inline void free_VkSparseMemoryBind_array(VkSparseMemoryBind *in, uint32_t count)
-#endif /* USE_STRUCT_CONVERSION */
-{
-    if (!in) return;
-
-    free(in);
-}
-
-#if defined(USE_STRUCT_CONVERSION)
-static inline VkSparseBufferMemoryBindInfo_host *convert_VkSparseBufferMemoryBindInfo_array_win_to_host(const VkSparseBufferMemoryBindInfo *in, uint32_t count)
+static inline VkSparseBufferMemoryBindInfo_host *convert_VkSparseBufferMemoryBindInfo_array_win_to_host(struct conversion_context *ctx, const VkSparseBufferMemoryBindInfo *in, uint32_t count)
 {
     VkSparseBufferMemoryBindInfo_host *out;
 #else
-static inline VkSparseBufferMemoryBindInfo *convert_VkSparseBufferMemoryBindInfo_array_win_to_host(const VkSparseBufferMemoryBindInfo *in, uint32_t count)
+static inline VkSparseBufferMemoryBindInfo *convert_VkSparseBufferMemoryBindInfo_array_win_to_host(struct conversion_context *ctx, const VkSparseBufferMemoryBindInfo *in, uint32_t count)
 {
     VkSparseBufferMemoryBindInfo *out;
 #endif /* USE_STRUCT_CONVERSION */
@@ -2242,44 +1859,23 @@ static inline VkSparseBufferMemoryBindInfo *convert_VkSparseBufferMemoryBindInfo
 
     if (!in) return NULL;
 
-    out = malloc(count * sizeof(*out));
+    out = conversion_context_alloc(ctx, count * sizeof(*out));
     for (i = 0; i < count; i++)
     {
         out[i].buffer = in[i].buffer;
         out[i].bindCount = in[i].bindCount;
-        out[i].pBinds = convert_VkSparseMemoryBind_array_win_to_host(in[i].pBinds, in[i].bindCount);
+        out[i].pBinds = convert_VkSparseMemoryBind_array_win_to_host(ctx, in[i].pBinds, in[i].bindCount);
     }
 
     return out;
 }
 
 #if defined(USE_STRUCT_CONVERSION)
-static inline void free_VkSparseBufferMemoryBindInfo_array(VkSparseBufferMemoryBindInfo_host *in, uint32_t count)
-#else
-static inline void free_VkSparseBufferMemoryBindInfo_array(VkSparseBufferMemoryBindInfo *in, uint32_t count)
-#endif /* USE_STRUCT_CONVERSION */
-{
-    unsigned int i;
-
-    if (!in) return;
-
-    for (i = 0; i < count; i++)
-    {
-#if defined(USE_STRUCT_CONVERSION)
-        free_VkSparseMemoryBind_array((VkSparseMemoryBind_host *)in[i].pBinds, in[i].bindCount);
-#else
-        free_VkSparseMemoryBind_array((VkSparseMemoryBind *)in[i].pBinds, in[i].bindCount);
-#endif /* USE_STRUCT_CONVERSION */
-    }
-    free(in);
-}
-
-#if defined(USE_STRUCT_CONVERSION)
-static inline VkSparseImageOpaqueMemoryBindInfo_host *convert_VkSparseImageOpaqueMemoryBindInfo_array_win_to_host(const VkSparseImageOpaqueMemoryBindInfo *in, uint32_t count)
+static inline VkSparseImageOpaqueMemoryBindInfo_host *convert_VkSparseImageOpaqueMemoryBindInfo_array_win_to_host(struct conversion_context *ctx, const VkSparseImageOpaqueMemoryBindInfo *in, uint32_t count)
 {
     VkSparseImageOpaqueMemoryBindInfo_host *out;
 #else
-static inline VkSparseImageOpaqueMemoryBindInfo *convert_VkSparseImageOpaqueMemoryBindInfo_array_win_to_host(const VkSparseImageOpaqueMemoryBindInfo *in, uint32_t count)
+static inline VkSparseImageOpaqueMemoryBindInfo *convert_VkSparseImageOpaqueMemoryBindInfo_array_win_to_host(struct conversion_context *ctx, const VkSparseImageOpaqueMemoryBindInfo *in, uint32_t count)
 {
     VkSparseImageOpaqueMemoryBindInfo *out;
 #endif /* USE_STRUCT_CONVERSION */
@@ -2287,44 +1883,23 @@ static inline VkSparseImageOpaqueMemoryBindInfo *convert_VkSparseImageOpaqueMemo
 
     if (!in) return NULL;
 
-    out = malloc(count * sizeof(*out));
+    out = conversion_context_alloc(ctx, count * sizeof(*out));
     for (i = 0; i < count; i++)
     {
         out[i].image = in[i].image;
         out[i].bindCount = in[i].bindCount;
-        out[i].pBinds = convert_VkSparseMemoryBind_array_win_to_host(in[i].pBinds, in[i].bindCount);
+        out[i].pBinds = convert_VkSparseMemoryBind_array_win_to_host(ctx, in[i].pBinds, in[i].bindCount);
     }
 
     return out;
 }
 
 #if defined(USE_STRUCT_CONVERSION)
-static inline void free_VkSparseImageOpaqueMemoryBindInfo_array(VkSparseImageOpaqueMemoryBindInfo_host *in, uint32_t count)
-#else
-static inline void free_VkSparseImageOpaqueMemoryBindInfo_array(VkSparseImageOpaqueMemoryBindInfo *in, uint32_t count)
-#endif /* USE_STRUCT_CONVERSION */
-{
-    unsigned int i;
-
-    if (!in) return;
-
-    for (i = 0; i < count; i++)
-    {
-#if defined(USE_STRUCT_CONVERSION)
-        free_VkSparseMemoryBind_array((VkSparseMemoryBind_host *)in[i].pBinds, in[i].bindCount);
-#else
-        free_VkSparseMemoryBind_array((VkSparseMemoryBind *)in[i].pBinds, in[i].bindCount);
-#endif /* USE_STRUCT_CONVERSION */
-    }
-    free(in);
-}
-
-#if defined(USE_STRUCT_CONVERSION)
-static inline VkSparseImageMemoryBind_host *convert_VkSparseImageMemoryBind_array_win_to_host(const VkSparseImageMemoryBind *in, uint32_t count)
+static inline VkSparseImageMemoryBind_host *convert_VkSparseImageMemoryBind_array_win_to_host(struct conversion_context *ctx, const VkSparseImageMemoryBind *in, uint32_t count)
 {
     VkSparseImageMemoryBind_host *out;
 #else
-static inline VkSparseImageMemoryBind *convert_VkSparseImageMemoryBind_array_win_to_host(const VkSparseImageMemoryBind *in, uint32_t count)
+static inline VkSparseImageMemoryBind *convert_VkSparseImageMemoryBind_array_win_to_host(struct conversion_context *ctx, const VkSparseImageMemoryBind *in, uint32_t count)
 {
     VkSparseImageMemoryBind *out;
 #endif /* USE_STRUCT_CONVERSION */
@@ -2332,7 +1907,7 @@ static inline VkSparseImageMemoryBind *convert_VkSparseImageMemoryBind_array_win
 
     if (!in) return NULL;
 
-    out = malloc(count * sizeof(*out));
+    out = conversion_context_alloc(ctx, count * sizeof(*out));
     for (i = 0; i < count; i++)
     {
         out[i].subresource = in[i].subresource;
@@ -2347,22 +1922,11 @@ static inline VkSparseImageMemoryBind *convert_VkSparseImageMemoryBind_array_win
 }
 
 #if defined(USE_STRUCT_CONVERSION)
-static inline void free_VkSparseImageMemoryBind_array(VkSparseImageMemoryBind_host *in, uint32_t count)
-#else
-static inline void free_VkSparseImageMemoryBind_array(VkSparseImageMemoryBind *in, uint32_t count)
-#endif /* USE_STRUCT_CONVERSION */
-{
-    if (!in) return;
-
-    free(in);
-}
-
-#if defined(USE_STRUCT_CONVERSION)
-static inline VkSparseImageMemoryBindInfo_host *convert_VkSparseImageMemoryBindInfo_array_win_to_host(const VkSparseImageMemoryBindInfo *in, uint32_t count)
+static inline VkSparseImageMemoryBindInfo_host *convert_VkSparseImageMemoryBindInfo_array_win_to_host(struct conversion_context *ctx, const VkSparseImageMemoryBindInfo *in, uint32_t count)
 {
     VkSparseImageMemoryBindInfo_host *out;
 #else
-static inline VkSparseImageMemoryBindInfo *convert_VkSparseImageMemoryBindInfo_array_win_to_host(const VkSparseImageMemoryBindInfo *in, uint32_t count)
+static inline VkSparseImageMemoryBindInfo *convert_VkSparseImageMemoryBindInfo_array_win_to_host(struct conversion_context *ctx, const VkSparseImageMemoryBindInfo *in, uint32_t count)
 {
     VkSparseImageMemoryBindInfo *out;
 #endif /* USE_STRUCT_CONVERSION */
@@ -2370,44 +1934,23 @@ static inline VkSparseImageMemoryBindInfo *convert_VkSparseImageMemoryBindInfo_a
 
     if (!in) return NULL;
 
-    out = malloc(count * sizeof(*out));
+    out = conversion_context_alloc(ctx, count * sizeof(*out));
     for (i = 0; i < count; i++)
     {
         out[i].image = in[i].image;
         out[i].bindCount = in[i].bindCount;
-        out[i].pBinds = convert_VkSparseImageMemoryBind_array_win_to_host(in[i].pBinds, in[i].bindCount);
+        out[i].pBinds = convert_VkSparseImageMemoryBind_array_win_to_host(ctx, in[i].pBinds, in[i].bindCount);
     }
 
     return out;
 }
 
 #if defined(USE_STRUCT_CONVERSION)
-static inline void free_VkSparseImageMemoryBindInfo_array(VkSparseImageMemoryBindInfo_host *in, uint32_t count)
-#else
-static inline void free_VkSparseImageMemoryBindInfo_array(VkSparseImageMemoryBindInfo *in, uint32_t count)
-#endif /* USE_STRUCT_CONVERSION */
-{
-    unsigned int i;
-
-    if (!in) return;
-
-    for (i = 0; i < count; i++)
-    {
-#if defined(USE_STRUCT_CONVERSION)
-        free_VkSparseImageMemoryBind_array((VkSparseImageMemoryBind_host *)in[i].pBinds, in[i].bindCount);
-#else
-        free_VkSparseImageMemoryBind_array((VkSparseImageMemoryBind *)in[i].pBinds, in[i].bindCount);
-#endif /* USE_STRUCT_CONVERSION */
-    }
-    free(in);
-}
-
-#if defined(USE_STRUCT_CONVERSION)
-static inline VkBindSparseInfo_host *convert_VkBindSparseInfo_array_win_to_host(const VkBindSparseInfo *in, uint32_t count)
+static inline VkBindSparseInfo_host *convert_VkBindSparseInfo_array_win_to_host(struct conversion_context *ctx, const VkBindSparseInfo *in, uint32_t count)
 {
     VkBindSparseInfo_host *out;
 #else
-static inline VkBindSparseInfo *convert_VkBindSparseInfo_array_win_to_host(const VkBindSparseInfo *in, uint32_t count)
+static inline VkBindSparseInfo *convert_VkBindSparseInfo_array_win_to_host(struct conversion_context *ctx, const VkBindSparseInfo *in, uint32_t count)
 {
     VkBindSparseInfo *out;
 #endif /* USE_STRUCT_CONVERSION */
@@ -2415,7 +1958,7 @@ static inline VkBindSparseInfo *convert_VkBindSparseInfo_array_win_to_host(const
 
     if (!in) return NULL;
 
-    out = malloc(count * sizeof(*out));
+    out = conversion_context_alloc(ctx, count * sizeof(*out));
     for (i = 0; i < count; i++)
     {
         out[i].sType = in[i].sType;
@@ -2423,11 +1966,11 @@ static inline VkBindSparseInfo *convert_VkBindSparseInfo_array_win_to_host(const
         out[i].waitSemaphoreCount = in[i].waitSemaphoreCount;
         out[i].pWaitSemaphores = in[i].pWaitSemaphores;
         out[i].bufferBindCount = in[i].bufferBindCount;
-        out[i].pBufferBinds = convert_VkSparseBufferMemoryBindInfo_array_win_to_host(in[i].pBufferBinds, in[i].bufferBindCount);
+        out[i].pBufferBinds = convert_VkSparseBufferMemoryBindInfo_array_win_to_host(ctx, in[i].pBufferBinds, in[i].bufferBindCount);
         out[i].imageOpaqueBindCount = in[i].imageOpaqueBindCount;
-        out[i].pImageOpaqueBinds = convert_VkSparseImageOpaqueMemoryBindInfo_array_win_to_host(in[i].pImageOpaqueBinds, in[i].imageOpaqueBindCount);
+        out[i].pImageOpaqueBinds = convert_VkSparseImageOpaqueMemoryBindInfo_array_win_to_host(ctx, in[i].pImageOpaqueBinds, in[i].imageOpaqueBindCount);
         out[i].imageBindCount = in[i].imageBindCount;
-        out[i].pImageBinds = convert_VkSparseImageMemoryBindInfo_array_win_to_host(in[i].pImageBinds, in[i].imageBindCount);
+        out[i].pImageBinds = convert_VkSparseImageMemoryBindInfo_array_win_to_host(ctx, in[i].pImageBinds, in[i].imageBindCount);
         out[i].signalSemaphoreCount = in[i].signalSemaphoreCount;
         out[i].pSignalSemaphores = in[i].pSignalSemaphores;
     }
@@ -2435,45 +1978,14 @@ static inline VkBindSparseInfo *convert_VkBindSparseInfo_array_win_to_host(const
     return out;
 }
 
-#if defined(USE_STRUCT_CONVERSION)
-static inline void free_VkBindSparseInfo_array(VkBindSparseInfo_host *in, uint32_t count)
-#else
-static inline void free_VkBindSparseInfo_array(VkBindSparseInfo *in, uint32_t count)
-#endif /* USE_STRUCT_CONVERSION */
-{
-    unsigned int i;
-
-    if (!in) return;
-
-    for (i = 0; i < count; i++)
-    {
-#if defined(USE_STRUCT_CONVERSION)
-        free_VkSparseBufferMemoryBindInfo_array((VkSparseBufferMemoryBindInfo_host *)in[i].pBufferBinds, in[i].bufferBindCount);
-#else
-        free_VkSparseBufferMemoryBindInfo_array((VkSparseBufferMemoryBindInfo *)in[i].pBufferBinds, in[i].bufferBindCount);
-#endif /* USE_STRUCT_CONVERSION */
-#if defined(USE_STRUCT_CONVERSION)
-        free_VkSparseImageOpaqueMemoryBindInfo_array((VkSparseImageOpaqueMemoryBindInfo_host *)in[i].pImageOpaqueBinds, in[i].imageOpaqueBindCount);
-#else
-        free_VkSparseImageOpaqueMemoryBindInfo_array((VkSparseImageOpaqueMemoryBindInfo *)in[i].pImageOpaqueBinds, in[i].imageOpaqueBindCount);
-#endif /* USE_STRUCT_CONVERSION */
-#if defined(USE_STRUCT_CONVERSION)
-        free_VkSparseImageMemoryBindInfo_array((VkSparseImageMemoryBindInfo_host *)in[i].pImageBinds, in[i].imageBindCount);
-#else
-        free_VkSparseImageMemoryBindInfo_array((VkSparseImageMemoryBindInfo *)in[i].pImageBinds, in[i].imageBindCount);
-#endif /* USE_STRUCT_CONVERSION */
-    }
-    free(in);
-}
-
-static inline VkSubmitInfo *convert_VkSubmitInfo_array_win_to_host(const VkSubmitInfo *in, uint32_t count)
+static inline VkSubmitInfo *convert_VkSubmitInfo_array_win_to_host(struct conversion_context *ctx, const VkSubmitInfo *in, uint32_t count)
 {
     VkSubmitInfo *out;
     unsigned int i;
 
     if (!in) return NULL;
 
-    out = malloc(count * sizeof(*out));
+    out = conversion_context_alloc(ctx, count * sizeof(*out));
     for (i = 0; i < count; i++)
     {
         out[i].sType = in[i].sType;
@@ -2482,7 +1994,7 @@ static inline VkSubmitInfo *convert_VkSubmitInfo_array_win_to_host(const VkSubmi
         out[i].pWaitSemaphores = in[i].pWaitSemaphores;
         out[i].pWaitDstStageMask = in[i].pWaitDstStageMask;
         out[i].commandBufferCount = in[i].commandBufferCount;
-        out[i].pCommandBuffers = convert_VkCommandBuffer_array_win_to_host(in[i].pCommandBuffers, in[i].commandBufferCount);
+        out[i].pCommandBuffers = convert_VkCommandBuffer_array_win_to_host(ctx, in[i].pCommandBuffers, in[i].commandBufferCount);
         out[i].signalSemaphoreCount = in[i].signalSemaphoreCount;
         out[i].pSignalSemaphores = in[i].pSignalSemaphores;
     }
@@ -2490,28 +2002,15 @@ static inline VkSubmitInfo *convert_VkSubmitInfo_array_win_to_host(const VkSubmi
     return out;
 }
 
-static inline void free_VkSubmitInfo_array(VkSubmitInfo *in, uint32_t count)
-{
-    unsigned int i;
-
-    if (!in) return;
-
-    for (i = 0; i < count; i++)
-    {
-        free_VkCommandBuffer_array((VkCommandBuffer *)in[i].pCommandBuffers, in[i].commandBufferCount);
-    }
-    free(in);
-}
-
 #if defined(USE_STRUCT_CONVERSION)
-static inline VkSemaphoreSubmitInfoKHR_host *convert_VkSemaphoreSubmitInfoKHR_array_win_to_host(const VkSemaphoreSubmitInfoKHR *in, uint32_t count)
+static inline VkSemaphoreSubmitInfoKHR_host *convert_VkSemaphoreSubmitInfoKHR_array_win_to_host(struct conversion_context *ctx, const VkSemaphoreSubmitInfoKHR *in, uint32_t count)
 {
     VkSemaphoreSubmitInfoKHR_host *out;
     unsigned int i;
 
     if (!in) return NULL;
 
-    out = malloc(count * sizeof(*out));
+    out = conversion_context_alloc(ctx, count * sizeof(*out));
     for (i = 0; i < count; i++)
     {
         out[i].sType = in[i].sType;
@@ -2526,23 +2025,14 @@ static inline VkSemaphoreSubmitInfoKHR_host *convert_VkSemaphoreSubmitInfoKHR_ar
 }
 #endif /* USE_STRUCT_CONVERSION */
 
-#if defined(USE_STRUCT_CONVERSION)
-static inline void free_VkSemaphoreSubmitInfoKHR_array(VkSemaphoreSubmitInfoKHR_host *in, uint32_t count)
-{
-    if (!in) return;
-
-    free(in);
-}
-#endif /* USE_STRUCT_CONVERSION */
-
-static inline VkCommandBufferSubmitInfoKHR *convert_VkCommandBufferSubmitInfoKHR_array_win_to_host(const VkCommandBufferSubmitInfoKHR *in, uint32_t count)
+static inline VkCommandBufferSubmitInfoKHR *convert_VkCommandBufferSubmitInfoKHR_array_win_to_host(struct conversion_context *ctx, const VkCommandBufferSubmitInfoKHR *in, uint32_t count)
 {
     VkCommandBufferSubmitInfoKHR *out;
     unsigned int i;
 
     if (!in) return NULL;
 
-    out = malloc(count * sizeof(*out));
+    out = conversion_context_alloc(ctx, count * sizeof(*out));
     for (i = 0; i < count; i++)
     {
         out[i].sType = in[i].sType;
@@ -2554,19 +2044,12 @@ static inline VkCommandBufferSubmitInfoKHR *convert_VkCommandBufferSubmitInfoKHR
     return out;
 }
 
-static inline void free_VkCommandBufferSubmitInfoKHR_array(VkCommandBufferSubmitInfoKHR *in, uint32_t count)
-{
-    if (!in) return;
-
-    free(in);
-}
-
 #if defined(USE_STRUCT_CONVERSION)
-static inline VkSubmitInfo2KHR_host *convert_VkSubmitInfo2KHR_array_win_to_host(const VkSubmitInfo2KHR *in, uint32_t count)
+static inline VkSubmitInfo2KHR_host *convert_VkSubmitInfo2KHR_array_win_to_host(struct conversion_context *ctx, const VkSubmitInfo2KHR *in, uint32_t count)
 {
     VkSubmitInfo2KHR_host *out;
 #else
-static inline VkSubmitInfo2KHR *convert_VkSubmitInfo2KHR_array_win_to_host(const VkSubmitInfo2KHR *in, uint32_t count)
+static inline VkSubmitInfo2KHR *convert_VkSubmitInfo2KHR_array_win_to_host(struct conversion_context *ctx, const VkSubmitInfo2KHR *in, uint32_t count)
 {
     VkSubmitInfo2KHR *out;
 #endif /* USE_STRUCT_CONVERSION */
@@ -2574,7 +2057,7 @@ static inline VkSubmitInfo2KHR *convert_VkSubmitInfo2KHR_array_win_to_host(const
 
     if (!in) return NULL;
 
-    out = malloc(count * sizeof(*out));
+    out = conversion_context_alloc(ctx, count * sizeof(*out));
     for (i = 0; i < count; i++)
     {
         out[i].sType = in[i].sType;
@@ -2582,15 +2065,15 @@ static inline VkSubmitInfo2KHR *convert_VkSubmitInfo2KHR_array_win_to_host(const
         out[i].flags = in[i].flags;
         out[i].waitSemaphoreInfoCount = in[i].waitSemaphoreInfoCount;
 #if defined(USE_STRUCT_CONVERSION)
-        out[i].pWaitSemaphoreInfos = convert_VkSemaphoreSubmitInfoKHR_array_win_to_host(in[i].pWaitSemaphoreInfos, in[i].waitSemaphoreInfoCount);
+        out[i].pWaitSemaphoreInfos = convert_VkSemaphoreSubmitInfoKHR_array_win_to_host(ctx, in[i].pWaitSemaphoreInfos, in[i].waitSemaphoreInfoCount);
 #else
         out[i].pWaitSemaphoreInfos = in[i].pWaitSemaphoreInfos;
 #endif /* USE_STRUCT_CONVERSION */
         out[i].commandBufferInfoCount = in[i].commandBufferInfoCount;
-        out[i].pCommandBufferInfos = convert_VkCommandBufferSubmitInfoKHR_array_win_to_host(in[i].pCommandBufferInfos, in[i].commandBufferInfoCount);
+        out[i].pCommandBufferInfos = convert_VkCommandBufferSubmitInfoKHR_array_win_to_host(ctx, in[i].pCommandBufferInfos, in[i].commandBufferInfoCount);
         out[i].signalSemaphoreInfoCount = in[i].signalSemaphoreInfoCount;
 #if defined(USE_STRUCT_CONVERSION)
-        out[i].pSignalSemaphoreInfos = convert_VkSemaphoreSubmitInfoKHR_array_win_to_host(in[i].pSignalSemaphoreInfos, in[i].signalSemaphoreInfoCount);
+        out[i].pSignalSemaphoreInfos = convert_VkSemaphoreSubmitInfoKHR_array_win_to_host(ctx, in[i].pSignalSemaphoreInfos, in[i].signalSemaphoreInfoCount);
 #else
         out[i].pSignalSemaphoreInfos = in[i].pSignalSemaphoreInfos;
 #endif /* USE_STRUCT_CONVERSION */
@@ -2599,29 +2082,6 @@ static inline VkSubmitInfo2KHR *convert_VkSubmitInfo2KHR_array_win_to_host(const
     return out;
 }
 
-#if defined(USE_STRUCT_CONVERSION)
-static inline void free_VkSubmitInfo2KHR_array(VkSubmitInfo2KHR_host *in, uint32_t count)
-#else
-static inline void free_VkSubmitInfo2KHR_array(VkSubmitInfo2KHR *in, uint32_t count)
-#endif /* USE_STRUCT_CONVERSION */
-{
-    unsigned int i;
-
-    if (!in) return;
-
-    for (i = 0; i < count; i++)
-    {
-#if defined(USE_STRUCT_CONVERSION)
-        free_VkSemaphoreSubmitInfoKHR_array((VkSemaphoreSubmitInfoKHR_host *)in[i].pWaitSemaphoreInfos, in[i].waitSemaphoreInfoCount);
-#endif /* USE_STRUCT_CONVERSION */
-        free_VkCommandBufferSubmitInfoKHR_array((VkCommandBufferSubmitInfoKHR *)in[i].pCommandBufferInfos, in[i].commandBufferInfoCount);
-#if defined(USE_STRUCT_CONVERSION)
-        free_VkSemaphoreSubmitInfoKHR_array((VkSemaphoreSubmitInfoKHR_host *)in[i].pSignalSemaphoreInfos, in[i].signalSemaphoreInfoCount);
-#endif /* USE_STRUCT_CONVERSION */
-    }
-    free(in);
-}
-
 #if defined(USE_STRUCT_CONVERSION)
 static inline void convert_VkDebugUtilsObjectNameInfoEXT_win_to_host(const VkDebugUtilsObjectNameInfoEXT *in, VkDebugUtilsObjectNameInfoEXT_host *out)
 #else
@@ -2667,11 +2127,11 @@ static inline void convert_VkSemaphoreSignalInfo_win_to_host(const VkSemaphoreSi
 #endif /* USE_STRUCT_CONVERSION */
 
 #if defined(USE_STRUCT_CONVERSION)
-static inline VkDebugUtilsObjectNameInfoEXT_host *convert_VkDebugUtilsObjectNameInfoEXT_array_win_to_host(const VkDebugUtilsObjectNameInfoEXT *in, uint32_t count)
+static inline VkDebugUtilsObjectNameInfoEXT_host *convert_VkDebugUtilsObjectNameInfoEXT_array_win_to_host(struct conversion_context *ctx, const VkDebugUtilsObjectNameInfoEXT *in, uint32_t count)
 {
     VkDebugUtilsObjectNameInfoEXT_host *out;
 #else
-static inline VkDebugUtilsObjectNameInfoEXT *convert_VkDebugUtilsObjectNameInfoEXT_array_win_to_host(const VkDebugUtilsObjectNameInfoEXT *in, uint32_t count)
+static inline VkDebugUtilsObjectNameInfoEXT *convert_VkDebugUtilsObjectNameInfoEXT_array_win_to_host(struct conversion_context *ctx, const VkDebugUtilsObjectNameInfoEXT *in, uint32_t count)
 {
     VkDebugUtilsObjectNameInfoEXT *out;
 #endif /* USE_STRUCT_CONVERSION */
@@ -2679,7 +2139,7 @@ static inline VkDebugUtilsObjectNameInfoEXT *convert_VkDebugUtilsObjectNameInfoE
 
     if (!in) return NULL;
 
-    out = malloc(count * sizeof(*out));
+    out = conversion_context_alloc(ctx, count * sizeof(*out));
     for (i = 0; i < count; i++)
     {
         out[i].sType = in[i].sType;
@@ -2693,20 +2153,9 @@ static inline VkDebugUtilsObjectNameInfoEXT *convert_VkDebugUtilsObjectNameInfoE
 }
 
 #if defined(USE_STRUCT_CONVERSION)
-static inline void free_VkDebugUtilsObjectNameInfoEXT_array(VkDebugUtilsObjectNameInfoEXT_host *in, uint32_t count)
-#else
-static inline void free_VkDebugUtilsObjectNameInfoEXT_array(VkDebugUtilsObjectNameInfoEXT *in, uint32_t count)
-#endif /* USE_STRUCT_CONVERSION */
-{
-    if (!in) return;
-
-    free(in);
-}
-
-#if defined(USE_STRUCT_CONVERSION)
-static inline void convert_VkDebugUtilsMessengerCallbackDataEXT_win_to_host(const VkDebugUtilsMessengerCallbackDataEXT *in, VkDebugUtilsMessengerCallbackDataEXT_host *out)
+static inline void convert_VkDebugUtilsMessengerCallbackDataEXT_win_to_host(struct conversion_context *ctx, const VkDebugUtilsMessengerCallbackDataEXT *in, VkDebugUtilsMessengerCallbackDataEXT_host *out)
 #else
-static inline void convert_VkDebugUtilsMessengerCallbackDataEXT_win_to_host(const VkDebugUtilsMessengerCallbackDataEXT *in, VkDebugUtilsMessengerCallbackDataEXT *out)
+static inline void convert_VkDebugUtilsMessengerCallbackDataEXT_win_to_host(struct conversion_context *ctx, const VkDebugUtilsMessengerCallbackDataEXT *in, VkDebugUtilsMessengerCallbackDataEXT *out)
 #endif /* USE_STRUCT_CONVERSION */
 {
     if (!in) return;
@@ -2722,31 +2171,18 @@ static inline void convert_VkDebugUtilsMessengerCallbackDataEXT_win_to_host(cons
     out->cmdBufLabelCount = in->cmdBufLabelCount;
     out->pCmdBufLabels = in->pCmdBufLabels;
     out->objectCount = in->objectCount;
-    out->pObjects = convert_VkDebugUtilsObjectNameInfoEXT_array_win_to_host(in->pObjects, in->objectCount);
+    out->pObjects = convert_VkDebugUtilsObjectNameInfoEXT_array_win_to_host(ctx, in->pObjects, in->objectCount);
 }
 
 #if defined(USE_STRUCT_CONVERSION)
-static inline void free_VkDebugUtilsMessengerCallbackDataEXT(VkDebugUtilsMessengerCallbackDataEXT_host *in)
-#else
-static inline void free_VkDebugUtilsMessengerCallbackDataEXT(VkDebugUtilsMessengerCallbackDataEXT *in)
-#endif /* USE_STRUCT_CONVERSION */
-{
-#if defined(USE_STRUCT_CONVERSION)
-    free_VkDebugUtilsObjectNameInfoEXT_array((VkDebugUtilsObjectNameInfoEXT_host *)in->pObjects, in->objectCount);
-#else
-    free_VkDebugUtilsObjectNameInfoEXT_array((VkDebugUtilsObjectNameInfoEXT *)in->pObjects, in->objectCount);
-#endif /* USE_STRUCT_CONVERSION */
-}
-
-#if defined(USE_STRUCT_CONVERSION)
-static inline VkCopyDescriptorSet_host *convert_VkCopyDescriptorSet_array_win_to_host(const VkCopyDescriptorSet *in, uint32_t count)
+static inline VkCopyDescriptorSet_host *convert_VkCopyDescriptorSet_array_win_to_host(struct conversion_context *ctx, const VkCopyDescriptorSet *in, uint32_t count)
 {
     VkCopyDescriptorSet_host *out;
     unsigned int i;
 
     if (!in) return NULL;
 
-    out = malloc(count * sizeof(*out));
+    out = conversion_context_alloc(ctx, count * sizeof(*out));
     for (i = 0; i < count; i++)
     {
         out[i].sType = in[i].sType;
@@ -2764,23 +2200,14 @@ static inline VkCopyDescriptorSet_host *convert_VkCopyDescriptorSet_array_win_to
 }
 #endif /* USE_STRUCT_CONVERSION */
 
-#if defined(USE_STRUCT_CONVERSION)
-static inline void free_VkCopyDescriptorSet_array(VkCopyDescriptorSet_host *in, uint32_t count)
-{
-    if (!in) return;
-
-    free(in);
-}
-#endif /* USE_STRUCT_CONVERSION */
-
-static inline VkPhysicalDevice *convert_VkPhysicalDevice_array_win_to_host(const VkPhysicalDevice *in, uint32_t count)
+static inline VkPhysicalDevice *convert_VkPhysicalDevice_array_win_to_host(struct conversion_context *ctx, const VkPhysicalDevice *in, uint32_t count)
 {
     VkPhysicalDevice *out;
     unsigned int i;
 
     if (!in) return NULL;
 
-    out = malloc(count * sizeof(*out));
+    out = conversion_context_alloc(ctx, count * sizeof(*out));
     for (i = 0; i < count; i++)
     {
         out[i] = in[i]->phys_dev;
@@ -2789,22 +2216,15 @@ static inline VkPhysicalDevice *convert_VkPhysicalDevice_array_win_to_host(const
     return out;
 }
 
-static inline void free_VkPhysicalDevice_array(VkPhysicalDevice *in, uint32_t count)
-{
-    if (!in) return;
-
-    free(in);
-}
-
 #if defined(USE_STRUCT_CONVERSION)
-static inline VkSubresourceLayout *convert_VkSubresourceLayout_array_host_to_win(const VkSubresourceLayout_host *in, uint32_t count)
+static inline VkSubresourceLayout *convert_VkSubresourceLayout_array_host_to_win(struct conversion_context *ctx, const VkSubresourceLayout_host *in, uint32_t count)
 {
     VkSubresourceLayout *out;
     unsigned int i;
 
     if (!in) return NULL;
 
-    out = malloc(count * sizeof(*out));
+    out = conversion_context_alloc(ctx, count * sizeof(*out));
     for (i = 0; i < count; i++)
     {
         out[i].offset = in[i].offset;
@@ -2818,15 +2238,6 @@ static inline VkSubresourceLayout *convert_VkSubresourceLayout_array_host_to_win
 }
 #endif /* USE_STRUCT_CONVERSION */
 
-#if defined(USE_STRUCT_CONVERSION)
-static inline void free_VkSubresourceLayout_array(VkSubresourceLayout_host *in, uint32_t count)
-{
-    if (!in) return;
-
-    free(in);
-}
-#endif /* USE_STRUCT_CONVERSION */
-
 VkResult convert_VkBufferCreateInfo_struct_chain(const void *pNext, VkBufferCreateInfo *out_struct)
 {
     VkBaseOutStructure *out_header = (VkBaseOutStructure *)out_struct;
@@ -3059,7 +2470,7 @@ VkResult convert_VkDeviceCreateInfo_struct_chain(const void *pNext, VkDeviceCrea
             out->sType = in->sType;
             out->pNext = NULL;
             out->physicalDeviceCount = in->physicalDeviceCount;
-            out->pPhysicalDevices = convert_VkPhysicalDevice_array_win_to_host(in->pPhysicalDevices, in->physicalDeviceCount);
+            out->pPhysicalDevices = convert_VkPhysicalDevice_array_win_to_host(NULL, in->pPhysicalDevices, in->physicalDeviceCount);
 
             out_header->pNext = (VkBaseOutStructure *)out;
             out_header = out_header->pNext;
@@ -4866,7 +4277,7 @@ void free_VkDeviceCreateInfo_struct_chain(VkDeviceCreateInfo *s)
             case VK_STRUCTURE_TYPE_DEVICE_GROUP_DEVICE_CREATE_INFO:
             {
                 VkDeviceGroupDeviceCreateInfo *structure = (VkDeviceGroupDeviceCreateInfo *) header;
-                free_VkPhysicalDevice_array((VkPhysicalDevice *)structure->pPhysicalDevices, structure->physicalDeviceCount);
+                free((void *)structure->pPhysicalDevices);
                 break;
             }
             default:
@@ -5471,12 +4882,14 @@ static NTSTATUS wine_vkBeginCommandBuffer(void *args)
 #if defined(USE_STRUCT_CONVERSION)
     VkResult result;
     VkCommandBufferBeginInfo_host pBeginInfo_host;
+    struct conversion_context ctx;
     TRACE("%p, %p\n", params->commandBuffer, params->pBeginInfo);
 
-    convert_VkCommandBufferBeginInfo_win_to_host(params->pBeginInfo, &pBeginInfo_host);
+    init_conversion_context(&ctx);
+    convert_VkCommandBufferBeginInfo_win_to_host(&ctx, params->pBeginInfo, &pBeginInfo_host);
     result = params->commandBuffer->device->funcs.p_vkBeginCommandBuffer(params->commandBuffer->command_buffer, &pBeginInfo_host);
 
-    free_VkCommandBufferBeginInfo(&pBeginInfo_host);
+    free_conversion_context(&ctx);
     return result;
 #else
     TRACE("%p, %p\n", params->commandBuffer, params->pBeginInfo);
@@ -5490,22 +4903,26 @@ static NTSTATUS wine_vkBindAccelerationStructureMemoryNV(void *args)
 #if defined(USE_STRUCT_CONVERSION)
     VkResult result;
     VkBindAccelerationStructureMemoryInfoNV_host *pBindInfos_host;
+    struct conversion_context ctx;
     TRACE("%p, %u, %p\n", params->device, params->bindInfoCount, params->pBindInfos);
 
-    pBindInfos_host = convert_VkBindAccelerationStructureMemoryInfoNV_array_win_to_host(params->pBindInfos, params->bindInfoCount);
+    init_conversion_context(&ctx);
+    pBindInfos_host = convert_VkBindAccelerationStructureMemoryInfoNV_array_win_to_host(&ctx, params->pBindInfos, params->bindInfoCount);
     result = params->device->funcs.p_vkBindAccelerationStructureMemoryNV(params->device->device, params->bindInfoCount, pBindInfos_host);
 
-    free_VkBindAccelerationStructureMemoryInfoNV_array(pBindInfos_host, params->bindInfoCount);
+    free_conversion_context(&ctx);
     return result;
 #else
     VkResult result;
     VkBindAccelerationStructureMemoryInfoNV *pBindInfos_host;
+    struct conversion_context ctx;
     TRACE("%p, %u, %p\n", params->device, params->bindInfoCount, params->pBindInfos);
 
-    pBindInfos_host = convert_VkBindAccelerationStructureMemoryInfoNV_array_win_to_host(params->pBindInfos, params->bindInfoCount);
+    init_conversion_context(&ctx);
+    pBindInfos_host = convert_VkBindAccelerationStructureMemoryInfoNV_array_win_to_host(&ctx, params->pBindInfos, params->bindInfoCount);
     result = params->device->funcs.p_vkBindAccelerationStructureMemoryNV(params->device->device, params->bindInfoCount, pBindInfos_host);
 
-    free_VkBindAccelerationStructureMemoryInfoNV_array(pBindInfos_host, params->bindInfoCount);
+    free_conversion_context(&ctx);
     return result;
 #endif
 }
@@ -5523,22 +4940,26 @@ static NTSTATUS wine_vkBindBufferMemory2(void *args)
 #if defined(USE_STRUCT_CONVERSION)
     VkResult result;
     VkBindBufferMemoryInfo_host *pBindInfos_host;
+    struct conversion_context ctx;
     TRACE("%p, %u, %p\n", params->device, params->bindInfoCount, params->pBindInfos);
 
-    pBindInfos_host = convert_VkBindBufferMemoryInfo_array_win_to_host(params->pBindInfos, params->bindInfoCount);
+    init_conversion_context(&ctx);
+    pBindInfos_host = convert_VkBindBufferMemoryInfo_array_win_to_host(&ctx, params->pBindInfos, params->bindInfoCount);
     result = params->device->funcs.p_vkBindBufferMemory2(params->device->device, params->bindInfoCount, pBindInfos_host);
 
-    free_VkBindBufferMemoryInfo_array(pBindInfos_host, params->bindInfoCount);
+    free_conversion_context(&ctx);
     return result;
 #else
     VkResult result;
     VkBindBufferMemoryInfo *pBindInfos_host;
+    struct conversion_context ctx;
     TRACE("%p, %u, %p\n", params->device, params->bindInfoCount, params->pBindInfos);
 
-    pBindInfos_host = convert_VkBindBufferMemoryInfo_array_win_to_host(params->pBindInfos, params->bindInfoCount);
+    init_conversion_context(&ctx);
+    pBindInfos_host = convert_VkBindBufferMemoryInfo_array_win_to_host(&ctx, params->pBindInfos, params->bindInfoCount);
     result = params->device->funcs.p_vkBindBufferMemory2(params->device->device, params->bindInfoCount, pBindInfos_host);
 
-    free_VkBindBufferMemoryInfo_array(pBindInfos_host, params->bindInfoCount);
+    free_conversion_context(&ctx);
     return result;
 #endif
 }
@@ -5549,22 +4970,26 @@ static NTSTATUS wine_vkBindBufferMemory2KHR(void *args)
 #if defined(USE_STRUCT_CONVERSION)
     VkResult result;
     VkBindBufferMemoryInfo_host *pBindInfos_host;
+    struct conversion_context ctx;
     TRACE("%p, %u, %p\n", params->device, params->bindInfoCount, params->pBindInfos);
 
-    pBindInfos_host = convert_VkBindBufferMemoryInfo_array_win_to_host(params->pBindInfos, params->bindInfoCount);
+    init_conversion_context(&ctx);
+    pBindInfos_host = convert_VkBindBufferMemoryInfo_array_win_to_host(&ctx, params->pBindInfos, params->bindInfoCount);
     result = params->device->funcs.p_vkBindBufferMemory2KHR(params->device->device, params->bindInfoCount, pBindInfos_host);
 
-    free_VkBindBufferMemoryInfo_array(pBindInfos_host, params->bindInfoCount);
+    free_conversion_context(&ctx);
     return result;
 #else
     VkResult result;
     VkBindBufferMemoryInfo *pBindInfos_host;
+    struct conversion_context ctx;
     TRACE("%p, %u, %p\n", params->device, params->bindInfoCount, params->pBindInfos);
 
-    pBindInfos_host = convert_VkBindBufferMemoryInfo_array_win_to_host(params->pBindInfos, params->bindInfoCount);
+    init_conversion_context(&ctx);
+    pBindInfos_host = convert_VkBindBufferMemoryInfo_array_win_to_host(&ctx, params->pBindInfos, params->bindInfoCount);
     result = params->device->funcs.p_vkBindBufferMemory2KHR(params->device->device, params->bindInfoCount, pBindInfos_host);
 
-    free_VkBindBufferMemoryInfo_array(pBindInfos_host, params->bindInfoCount);
+    free_conversion_context(&ctx);
     return result;
 #endif
 }
@@ -5582,22 +5007,26 @@ static NTSTATUS wine_vkBindImageMemory2(void *args)
 #if defined(USE_STRUCT_CONVERSION)
     VkResult result;
     VkBindImageMemoryInfo_host *pBindInfos_host;
+    struct conversion_context ctx;
     TRACE("%p, %u, %p\n", params->device, params->bindInfoCount, params->pBindInfos);
 
-    pBindInfos_host = convert_VkBindImageMemoryInfo_array_win_to_host(params->pBindInfos, params->bindInfoCount);
+    init_conversion_context(&ctx);
+    pBindInfos_host = convert_VkBindImageMemoryInfo_array_win_to_host(&ctx, params->pBindInfos, params->bindInfoCount);
     result = params->device->funcs.p_vkBindImageMemory2(params->device->device, params->bindInfoCount, pBindInfos_host);
 
-    free_VkBindImageMemoryInfo_array(pBindInfos_host, params->bindInfoCount);
+    free_conversion_context(&ctx);
     return result;
 #else
     VkResult result;
     VkBindImageMemoryInfo *pBindInfos_host;
+    struct conversion_context ctx;
     TRACE("%p, %u, %p\n", params->device, params->bindInfoCount, params->pBindInfos);
 
-    pBindInfos_host = convert_VkBindImageMemoryInfo_array_win_to_host(params->pBindInfos, params->bindInfoCount);
+    init_conversion_context(&ctx);
+    pBindInfos_host = convert_VkBindImageMemoryInfo_array_win_to_host(&ctx, params->pBindInfos, params->bindInfoCount);
     result = params->device->funcs.p_vkBindImageMemory2(params->device->device, params->bindInfoCount, pBindInfos_host);
 
-    free_VkBindImageMemoryInfo_array(pBindInfos_host, params->bindInfoCount);
+    free_conversion_context(&ctx);
     return result;
 #endif
 }
@@ -5608,22 +5037,26 @@ static NTSTATUS wine_vkBindImageMemory2KHR(void *args)
 #if defined(USE_STRUCT_CONVERSION)
     VkResult result;
     VkBindImageMemoryInfo_host *pBindInfos_host;
+    struct conversion_context ctx;
     TRACE("%p, %u, %p\n", params->device, params->bindInfoCount, params->pBindInfos);
 
-    pBindInfos_host = convert_VkBindImageMemoryInfo_array_win_to_host(params->pBindInfos, params->bindInfoCount);
+    init_conversion_context(&ctx);
+    pBindInfos_host = convert_VkBindImageMemoryInfo_array_win_to_host(&ctx, params->pBindInfos, params->bindInfoCount);
     result = params->device->funcs.p_vkBindImageMemory2KHR(params->device->device, params->bindInfoCount, pBindInfos_host);
 
-    free_VkBindImageMemoryInfo_array(pBindInfos_host, params->bindInfoCount);
+    free_conversion_context(&ctx);
     return result;
 #else
     VkResult result;
     VkBindImageMemoryInfo *pBindInfos_host;
+    struct conversion_context ctx;
     TRACE("%p, %u, %p\n", params->device, params->bindInfoCount, params->pBindInfos);
 
-    pBindInfos_host = convert_VkBindImageMemoryInfo_array_win_to_host(params->pBindInfos, params->bindInfoCount);
+    init_conversion_context(&ctx);
+    pBindInfos_host = convert_VkBindImageMemoryInfo_array_win_to_host(&ctx, params->pBindInfos, params->bindInfoCount);
     result = params->device->funcs.p_vkBindImageMemory2KHR(params->device->device, params->bindInfoCount, pBindInfos_host);
 
-    free_VkBindImageMemoryInfo_array(pBindInfos_host, params->bindInfoCount);
+    free_conversion_context(&ctx);
     return result;
 #endif
 }
@@ -5634,12 +5067,14 @@ static NTSTATUS wine_vkBuildAccelerationStructuresKHR(void *args)
 #if defined(USE_STRUCT_CONVERSION)
     VkResult result;
     VkAccelerationStructureBuildGeometryInfoKHR_host *pInfos_host;
+    struct conversion_context ctx;
     TRACE("%p, 0x%s, %u, %p, %p\n", params->device, wine_dbgstr_longlong(params->deferredOperation), params->infoCount, params->pInfos, params->ppBuildRangeInfos);
 
-    pInfos_host = convert_VkAccelerationStructureBuildGeometryInfoKHR_array_win_to_host(params->pInfos, params->infoCount);
+    init_conversion_context(&ctx);
+    pInfos_host = convert_VkAccelerationStructureBuildGeometryInfoKHR_array_win_to_host(&ctx, params->pInfos, params->infoCount);
     result = params->device->funcs.p_vkBuildAccelerationStructuresKHR(params->device->device, params->deferredOperation, params->infoCount, pInfos_host, params->ppBuildRangeInfos);
 
-    free_VkAccelerationStructureBuildGeometryInfoKHR_array(pInfos_host, params->infoCount);
+    free_conversion_context(&ctx);
     return result;
 #else
     TRACE("%p, 0x%s, %u, %p, %p\n", params->device, wine_dbgstr_longlong(params->deferredOperation), params->infoCount, params->pInfos, params->ppBuildRangeInfos);
@@ -5748,12 +5183,14 @@ static NTSTATUS wine_vkCmdBeginRenderingKHR(void *args)
     struct vkCmdBeginRenderingKHR_params *params = args;
 #if defined(USE_STRUCT_CONVERSION)
     VkRenderingInfoKHR_host pRenderingInfo_host;
+    struct conversion_context ctx;
     TRACE("%p, %p\n", params->commandBuffer, params->pRenderingInfo);
 
-    convert_VkRenderingInfoKHR_win_to_host(params->pRenderingInfo, &pRenderingInfo_host);
+    init_conversion_context(&ctx);
+    convert_VkRenderingInfoKHR_win_to_host(&ctx, params->pRenderingInfo, &pRenderingInfo_host);
     params->commandBuffer->device->funcs.p_vkCmdBeginRenderingKHR(params->commandBuffer->command_buffer, &pRenderingInfo_host);
 
-    free_VkRenderingInfoKHR(&pRenderingInfo_host);
+    free_conversion_context(&ctx);
     return STATUS_SUCCESS;
 #else
     TRACE("%p, %p\n", params->commandBuffer, params->pRenderingInfo);
@@ -5873,12 +5310,14 @@ static NTSTATUS wine_vkCmdBuildAccelerationStructureNV(void *args)
     struct vkCmdBuildAccelerationStructureNV_params *params = args;
 #if defined(USE_STRUCT_CONVERSION)
     VkAccelerationStructureInfoNV_host pInfo_host;
+    struct conversion_context ctx;
     TRACE("%p, %p, 0x%s, 0x%s, %u, 0x%s, 0x%s, 0x%s, 0x%s\n", params->commandBuffer, params->pInfo, wine_dbgstr_longlong(params->instanceData), wine_dbgstr_longlong(params->instanceOffset), params->update, wine_dbgstr_longlong(params->dst), wine_dbgstr_longlong(params->src), wine_dbgstr_longlong(params->scratch), wine_dbgstr_longlong(params->scratchOffset));
 
-    convert_VkAccelerationStructureInfoNV_win_to_host(params->pInfo, &pInfo_host);
+    init_conversion_context(&ctx);
+    convert_VkAccelerationStructureInfoNV_win_to_host(&ctx, params->pInfo, &pInfo_host);
     params->commandBuffer->device->funcs.p_vkCmdBuildAccelerationStructureNV(params->commandBuffer->command_buffer, &pInfo_host, params->instanceData, params->instanceOffset, params->update, params->dst, params->src, params->scratch, params->scratchOffset);
 
-    free_VkAccelerationStructureInfoNV(&pInfo_host);
+    free_conversion_context(&ctx);
     return STATUS_SUCCESS;
 #else
     TRACE("%p, %p, 0x%s, 0x%s, %u, 0x%s, 0x%s, 0x%s, 0x%s\n", params->commandBuffer, params->pInfo, wine_dbgstr_longlong(params->instanceData), wine_dbgstr_longlong(params->instanceOffset), params->update, wine_dbgstr_longlong(params->dst), wine_dbgstr_longlong(params->src), wine_dbgstr_longlong(params->scratch), wine_dbgstr_longlong(params->scratchOffset));
@@ -5892,12 +5331,14 @@ static NTSTATUS wine_vkCmdBuildAccelerationStructuresIndirectKHR(void *args)
     struct vkCmdBuildAccelerationStructuresIndirectKHR_params *params = args;
 #if defined(USE_STRUCT_CONVERSION)
     VkAccelerationStructureBuildGeometryInfoKHR_host *pInfos_host;
+    struct conversion_context ctx;
     TRACE("%p, %u, %p, %p, %p, %p\n", params->commandBuffer, params->infoCount, params->pInfos, params->pIndirectDeviceAddresses, params->pIndirectStrides, params->ppMaxPrimitiveCounts);
 
-    pInfos_host = convert_VkAccelerationStructureBuildGeometryInfoKHR_array_win_to_host(params->pInfos, params->infoCount);
+    init_conversion_context(&ctx);
+    pInfos_host = convert_VkAccelerationStructureBuildGeometryInfoKHR_array_win_to_host(&ctx, params->pInfos, params->infoCount);
     params->commandBuffer->device->funcs.p_vkCmdBuildAccelerationStructuresIndirectKHR(params->commandBuffer->command_buffer, params->infoCount, pInfos_host, params->pIndirectDeviceAddresses, params->pIndirectStrides, params->ppMaxPrimitiveCounts);
 
-    free_VkAccelerationStructureBuildGeometryInfoKHR_array(pInfos_host, params->infoCount);
+    free_conversion_context(&ctx);
     return STATUS_SUCCESS;
 #else
     TRACE("%p, %u, %p, %p, %p, %p\n", params->commandBuffer, params->infoCount, params->pInfos, params->pIndirectDeviceAddresses, params->pIndirectStrides, params->ppMaxPrimitiveCounts);
@@ -5911,12 +5352,14 @@ static NTSTATUS wine_vkCmdBuildAccelerationStructuresKHR(void *args)
     struct vkCmdBuildAccelerationStructuresKHR_params *params = args;
 #if defined(USE_STRUCT_CONVERSION)
     VkAccelerationStructureBuildGeometryInfoKHR_host *pInfos_host;
+    struct conversion_context ctx;
     TRACE("%p, %u, %p, %p\n", params->commandBuffer, params->infoCount, params->pInfos, params->ppBuildRangeInfos);
 
-    pInfos_host = convert_VkAccelerationStructureBuildGeometryInfoKHR_array_win_to_host(params->pInfos, params->infoCount);
+    init_conversion_context(&ctx);
+    pInfos_host = convert_VkAccelerationStructureBuildGeometryInfoKHR_array_win_to_host(&ctx, params->pInfos, params->infoCount);
     params->commandBuffer->device->funcs.p_vkCmdBuildAccelerationStructuresKHR(params->commandBuffer->command_buffer, params->infoCount, pInfos_host, params->ppBuildRangeInfos);
 
-    free_VkAccelerationStructureBuildGeometryInfoKHR_array(pInfos_host, params->infoCount);
+    free_conversion_context(&ctx);
     return STATUS_SUCCESS;
 #else
     TRACE("%p, %u, %p, %p\n", params->commandBuffer, params->infoCount, params->pInfos, params->ppBuildRangeInfos);
@@ -5998,12 +5441,14 @@ static NTSTATUS wine_vkCmdCopyBuffer(void *args)
     struct vkCmdCopyBuffer_params *params = args;
 #if defined(USE_STRUCT_CONVERSION)
     VkBufferCopy_host *pRegions_host;
+    struct conversion_context ctx;
     TRACE("%p, 0x%s, 0x%s, %u, %p\n", params->commandBuffer, wine_dbgstr_longlong(params->srcBuffer), wine_dbgstr_longlong(params->dstBuffer), params->regionCount, params->pRegions);
 
-    pRegions_host = convert_VkBufferCopy_array_win_to_host(params->pRegions, params->regionCount);
+    init_conversion_context(&ctx);
+    pRegions_host = convert_VkBufferCopy_array_win_to_host(&ctx, params->pRegions, params->regionCount);
     params->commandBuffer->device->funcs.p_vkCmdCopyBuffer(params->commandBuffer->command_buffer, params->srcBuffer, params->dstBuffer, params->regionCount, pRegions_host);
 
-    free_VkBufferCopy_array(pRegions_host, params->regionCount);
+    free_conversion_context(&ctx);
     return STATUS_SUCCESS;
 #else
     TRACE("%p, 0x%s, 0x%s, %u, %p\n", params->commandBuffer, wine_dbgstr_longlong(params->srcBuffer), wine_dbgstr_longlong(params->dstBuffer), params->regionCount, params->pRegions);
@@ -6017,12 +5462,14 @@ static NTSTATUS wine_vkCmdCopyBuffer2KHR(void *args)
     struct vkCmdCopyBuffer2KHR_params *params = args;
 #if defined(USE_STRUCT_CONVERSION)
     VkCopyBufferInfo2KHR_host pCopyBufferInfo_host;
+    struct conversion_context ctx;
     TRACE("%p, %p\n", params->commandBuffer, params->pCopyBufferInfo);
 
-    convert_VkCopyBufferInfo2KHR_win_to_host(params->pCopyBufferInfo, &pCopyBufferInfo_host);
+    init_conversion_context(&ctx);
+    convert_VkCopyBufferInfo2KHR_win_to_host(&ctx, params->pCopyBufferInfo, &pCopyBufferInfo_host);
     params->commandBuffer->device->funcs.p_vkCmdCopyBuffer2KHR(params->commandBuffer->command_buffer, &pCopyBufferInfo_host);
 
-    free_VkCopyBufferInfo2KHR(&pCopyBufferInfo_host);
+    free_conversion_context(&ctx);
     return STATUS_SUCCESS;
 #else
     TRACE("%p, %p\n", params->commandBuffer, params->pCopyBufferInfo);
@@ -6036,12 +5483,14 @@ static NTSTATUS wine_vkCmdCopyBufferToImage(void *args)
     struct vkCmdCopyBufferToImage_params *params = args;
 #if defined(USE_STRUCT_CONVERSION)
     VkBufferImageCopy_host *pRegions_host;
+    struct conversion_context ctx;
     TRACE("%p, 0x%s, 0x%s, %#x, %u, %p\n", params->commandBuffer, wine_dbgstr_longlong(params->srcBuffer), wine_dbgstr_longlong(params->dstImage), params->dstImageLayout, params->regionCount, params->pRegions);
 
-    pRegions_host = convert_VkBufferImageCopy_array_win_to_host(params->pRegions, params->regionCount);
+    init_conversion_context(&ctx);
+    pRegions_host = convert_VkBufferImageCopy_array_win_to_host(&ctx, params->pRegions, params->regionCount);
     params->commandBuffer->device->funcs.p_vkCmdCopyBufferToImage(params->commandBuffer->command_buffer, params->srcBuffer, params->dstImage, params->dstImageLayout, params->regionCount, pRegions_host);
 
-    free_VkBufferImageCopy_array(pRegions_host, params->regionCount);
+    free_conversion_context(&ctx);
     return STATUS_SUCCESS;
 #else
     TRACE("%p, 0x%s, 0x%s, %#x, %u, %p\n", params->commandBuffer, wine_dbgstr_longlong(params->srcBuffer), wine_dbgstr_longlong(params->dstImage), params->dstImageLayout, params->regionCount, params->pRegions);
@@ -6055,12 +5504,14 @@ static NTSTATUS wine_vkCmdCopyBufferToImage2KHR(void *args)
     struct vkCmdCopyBufferToImage2KHR_params *params = args;
 #if defined(USE_STRUCT_CONVERSION)
     VkCopyBufferToImageInfo2KHR_host pCopyBufferToImageInfo_host;
+    struct conversion_context ctx;
     TRACE("%p, %p\n", params->commandBuffer, params->pCopyBufferToImageInfo);
 
-    convert_VkCopyBufferToImageInfo2KHR_win_to_host(params->pCopyBufferToImageInfo, &pCopyBufferToImageInfo_host);
+    init_conversion_context(&ctx);
+    convert_VkCopyBufferToImageInfo2KHR_win_to_host(&ctx, params->pCopyBufferToImageInfo, &pCopyBufferToImageInfo_host);
     params->commandBuffer->device->funcs.p_vkCmdCopyBufferToImage2KHR(params->commandBuffer->command_buffer, &pCopyBufferToImageInfo_host);
 
-    free_VkCopyBufferToImageInfo2KHR(&pCopyBufferToImageInfo_host);
+    free_conversion_context(&ctx);
     return STATUS_SUCCESS;
 #else
     TRACE("%p, %p\n", params->commandBuffer, params->pCopyBufferToImageInfo);
@@ -6100,12 +5551,14 @@ static NTSTATUS wine_vkCmdCopyImageToBuffer(void *args)
     struct vkCmdCopyImageToBuffer_params *params = args;
 #if defined(USE_STRUCT_CONVERSION)
     VkBufferImageCopy_host *pRegions_host;
+    struct conversion_context ctx;
     TRACE("%p, 0x%s, %#x, 0x%s, %u, %p\n", params->commandBuffer, wine_dbgstr_longlong(params->srcImage), params->srcImageLayout, wine_dbgstr_longlong(params->dstBuffer), params->regionCount, params->pRegions);
 
-    pRegions_host = convert_VkBufferImageCopy_array_win_to_host(params->pRegions, params->regionCount);
+    init_conversion_context(&ctx);
+    pRegions_host = convert_VkBufferImageCopy_array_win_to_host(&ctx, params->pRegions, params->regionCount);
     params->commandBuffer->device->funcs.p_vkCmdCopyImageToBuffer(params->commandBuffer->command_buffer, params->srcImage, params->srcImageLayout, params->dstBuffer, params->regionCount, pRegions_host);
 
-    free_VkBufferImageCopy_array(pRegions_host, params->regionCount);
+    free_conversion_context(&ctx);
     return STATUS_SUCCESS;
 #else
     TRACE("%p, 0x%s, %#x, 0x%s, %u, %p\n", params->commandBuffer, wine_dbgstr_longlong(params->srcImage), params->srcImageLayout, wine_dbgstr_longlong(params->dstBuffer), params->regionCount, params->pRegions);
@@ -6119,12 +5572,14 @@ static NTSTATUS wine_vkCmdCopyImageToBuffer2KHR(void *args)
     struct vkCmdCopyImageToBuffer2KHR_params *params = args;
 #if defined(USE_STRUCT_CONVERSION)
     VkCopyImageToBufferInfo2KHR_host pCopyImageToBufferInfo_host;
+    struct conversion_context ctx;
     TRACE("%p, %p\n", params->commandBuffer, params->pCopyImageToBufferInfo);
 
-    convert_VkCopyImageToBufferInfo2KHR_win_to_host(params->pCopyImageToBufferInfo, &pCopyImageToBufferInfo_host);
+    init_conversion_context(&ctx);
+    convert_VkCopyImageToBufferInfo2KHR_win_to_host(&ctx, params->pCopyImageToBufferInfo, &pCopyImageToBufferInfo_host);
     params->commandBuffer->device->funcs.p_vkCmdCopyImageToBuffer2KHR(params->commandBuffer->command_buffer, &pCopyImageToBufferInfo_host);
 
-    free_VkCopyImageToBufferInfo2KHR(&pCopyImageToBufferInfo_host);
+    free_conversion_context(&ctx);
     return STATUS_SUCCESS;
 #else
     TRACE("%p, %p\n", params->commandBuffer, params->pCopyImageToBufferInfo);
@@ -6437,12 +5892,14 @@ static NTSTATUS wine_vkCmdExecuteCommands(void *args)
 {
     struct vkCmdExecuteCommands_params *params = args;
     VkCommandBuffer *pCommandBuffers_host;
+    struct conversion_context ctx;
     TRACE("%p, %u, %p\n", params->commandBuffer, params->commandBufferCount, params->pCommandBuffers);
 
-    pCommandBuffers_host = convert_VkCommandBuffer_array_win_to_host(params->pCommandBuffers, params->commandBufferCount);
+    init_conversion_context(&ctx);
+    pCommandBuffers_host = convert_VkCommandBuffer_array_win_to_host(&ctx, params->pCommandBuffers, params->commandBufferCount);
     params->commandBuffer->device->funcs.p_vkCmdExecuteCommands(params->commandBuffer->command_buffer, params->commandBufferCount, pCommandBuffers_host);
 
-    free_VkCommandBuffer_array(pCommandBuffers_host, params->commandBufferCount);
+    free_conversion_context(&ctx);
     return STATUS_SUCCESS;
 }
 
@@ -6451,12 +5908,14 @@ static NTSTATUS wine_vkCmdExecuteGeneratedCommandsNV(void *args)
     struct vkCmdExecuteGeneratedCommandsNV_params *params = args;
 #if defined(USE_STRUCT_CONVERSION)
     VkGeneratedCommandsInfoNV_host pGeneratedCommandsInfo_host;
+    struct conversion_context ctx;
     TRACE("%p, %u, %p\n", params->commandBuffer, params->isPreprocessed, params->pGeneratedCommandsInfo);
 
-    convert_VkGeneratedCommandsInfoNV_win_to_host(params->pGeneratedCommandsInfo, &pGeneratedCommandsInfo_host);
+    init_conversion_context(&ctx);
+    convert_VkGeneratedCommandsInfoNV_win_to_host(&ctx, params->pGeneratedCommandsInfo, &pGeneratedCommandsInfo_host);
     params->commandBuffer->device->funcs.p_vkCmdExecuteGeneratedCommandsNV(params->commandBuffer->command_buffer, params->isPreprocessed, &pGeneratedCommandsInfo_host);
 
-    free_VkGeneratedCommandsInfoNV(&pGeneratedCommandsInfo_host);
+    free_conversion_context(&ctx);
     return STATUS_SUCCESS;
 #else
     TRACE("%p, %u, %p\n", params->commandBuffer, params->isPreprocessed, params->pGeneratedCommandsInfo);
@@ -6511,14 +5970,15 @@ static NTSTATUS wine_vkCmdPipelineBarrier(void *args)
 #if defined(USE_STRUCT_CONVERSION)
     VkBufferMemoryBarrier_host *pBufferMemoryBarriers_host;
     VkImageMemoryBarrier_host *pImageMemoryBarriers_host;
+    struct conversion_context ctx;
     TRACE("%p, %#x, %#x, %#x, %u, %p, %u, %p, %u, %p\n", params->commandBuffer, params->srcStageMask, params->dstStageMask, params->dependencyFlags, params->memoryBarrierCount, params->pMemoryBarriers, params->bufferMemoryBarrierCount, params->pBufferMemoryBarriers, params->imageMemoryBarrierCount, params->pImageMemoryBarriers);
 
-    pBufferMemoryBarriers_host = convert_VkBufferMemoryBarrier_array_win_to_host(params->pBufferMemoryBarriers, params->bufferMemoryBarrierCount);
-    pImageMemoryBarriers_host = convert_VkImageMemoryBarrier_array_win_to_host(params->pImageMemoryBarriers, params->imageMemoryBarrierCount);
+    init_conversion_context(&ctx);
+    pBufferMemoryBarriers_host = convert_VkBufferMemoryBarrier_array_win_to_host(&ctx, params->pBufferMemoryBarriers, params->bufferMemoryBarrierCount);
+    pImageMemoryBarriers_host = convert_VkImageMemoryBarrier_array_win_to_host(&ctx, params->pImageMemoryBarriers, params->imageMemoryBarrierCount);
     params->commandBuffer->device->funcs.p_vkCmdPipelineBarrier(params->commandBuffer->command_buffer, params->srcStageMask, params->dstStageMask, params->dependencyFlags, params->memoryBarrierCount, params->pMemoryBarriers, params->bufferMemoryBarrierCount, pBufferMemoryBarriers_host, params->imageMemoryBarrierCount, pImageMemoryBarriers_host);
 
-    free_VkBufferMemoryBarrier_array(pBufferMemoryBarriers_host, params->bufferMemoryBarrierCount);
-    free_VkImageMemoryBarrier_array(pImageMemoryBarriers_host, params->imageMemoryBarrierCount);
+    free_conversion_context(&ctx);
     return STATUS_SUCCESS;
 #else
     TRACE("%p, %#x, %#x, %#x, %u, %p, %u, %p, %u, %p\n", params->commandBuffer, params->srcStageMask, params->dstStageMask, params->dependencyFlags, params->memoryBarrierCount, params->pMemoryBarriers, params->bufferMemoryBarrierCount, params->pBufferMemoryBarriers, params->imageMemoryBarrierCount, params->pImageMemoryBarriers);
@@ -6532,12 +5992,14 @@ static NTSTATUS wine_vkCmdPipelineBarrier2KHR(void *args)
     struct vkCmdPipelineBarrier2KHR_params *params = args;
 #if defined(USE_STRUCT_CONVERSION)
     VkDependencyInfoKHR_host pDependencyInfo_host;
+    struct conversion_context ctx;
     TRACE("%p, %p\n", params->commandBuffer, params->pDependencyInfo);
 
-    convert_VkDependencyInfoKHR_win_to_host(params->pDependencyInfo, &pDependencyInfo_host);
+    init_conversion_context(&ctx);
+    convert_VkDependencyInfoKHR_win_to_host(&ctx, params->pDependencyInfo, &pDependencyInfo_host);
     params->commandBuffer->device->funcs.p_vkCmdPipelineBarrier2KHR(params->commandBuffer->command_buffer, &pDependencyInfo_host);
 
-    free_VkDependencyInfoKHR(&pDependencyInfo_host);
+    free_conversion_context(&ctx);
     return STATUS_SUCCESS;
 #else
     TRACE("%p, %p\n", params->commandBuffer, params->pDependencyInfo);
@@ -6551,12 +6013,14 @@ static NTSTATUS wine_vkCmdPreprocessGeneratedCommandsNV(void *args)
     struct vkCmdPreprocessGeneratedCommandsNV_params *params = args;
 #if defined(USE_STRUCT_CONVERSION)
     VkGeneratedCommandsInfoNV_host pGeneratedCommandsInfo_host;
+    struct conversion_context ctx;
     TRACE("%p, %p\n", params->commandBuffer, params->pGeneratedCommandsInfo);
 
-    convert_VkGeneratedCommandsInfoNV_win_to_host(params->pGeneratedCommandsInfo, &pGeneratedCommandsInfo_host);
+    init_conversion_context(&ctx);
+    convert_VkGeneratedCommandsInfoNV_win_to_host(&ctx, params->pGeneratedCommandsInfo, &pGeneratedCommandsInfo_host);
     params->commandBuffer->device->funcs.p_vkCmdPreprocessGeneratedCommandsNV(params->commandBuffer->command_buffer, &pGeneratedCommandsInfo_host);
 
-    free_VkGeneratedCommandsInfoNV(&pGeneratedCommandsInfo_host);
+    free_conversion_context(&ctx);
     return STATUS_SUCCESS;
 #else
     TRACE("%p, %p\n", params->commandBuffer, params->pGeneratedCommandsInfo);
@@ -6578,12 +6042,14 @@ static NTSTATUS wine_vkCmdPushDescriptorSetKHR(void *args)
     struct vkCmdPushDescriptorSetKHR_params *params = args;
 #if defined(USE_STRUCT_CONVERSION)
     VkWriteDescriptorSet_host *pDescriptorWrites_host;
+    struct conversion_context ctx;
     TRACE("%p, %#x, 0x%s, %u, %u, %p\n", params->commandBuffer, params->pipelineBindPoint, wine_dbgstr_longlong(params->layout), params->set, params->descriptorWriteCount, params->pDescriptorWrites);
 
-    pDescriptorWrites_host = convert_VkWriteDescriptorSet_array_win_to_host(params->pDescriptorWrites, params->descriptorWriteCount);
+    init_conversion_context(&ctx);
+    pDescriptorWrites_host = convert_VkWriteDescriptorSet_array_win_to_host(&ctx, params->pDescriptorWrites, params->descriptorWriteCount);
     params->commandBuffer->device->funcs.p_vkCmdPushDescriptorSetKHR(params->commandBuffer->command_buffer, params->pipelineBindPoint, params->layout, params->set, params->descriptorWriteCount, pDescriptorWrites_host);
 
-    free_VkWriteDescriptorSet_array(pDescriptorWrites_host, params->descriptorWriteCount);
+    free_conversion_context(&ctx);
     return STATUS_SUCCESS;
 #else
     TRACE("%p, %#x, 0x%s, %u, %u, %p\n", params->commandBuffer, params->pipelineBindPoint, wine_dbgstr_longlong(params->layout), params->set, params->descriptorWriteCount, params->pDescriptorWrites);
@@ -6783,12 +6249,14 @@ static NTSTATUS wine_vkCmdSetEvent2KHR(void *args)
     struct vkCmdSetEvent2KHR_params *params = args;
 #if defined(USE_STRUCT_CONVERSION)
     VkDependencyInfoKHR_host pDependencyInfo_host;
+    struct conversion_context ctx;
     TRACE("%p, 0x%s, %p\n", params->commandBuffer, wine_dbgstr_longlong(params->event), params->pDependencyInfo);
 
-    convert_VkDependencyInfoKHR_win_to_host(params->pDependencyInfo, &pDependencyInfo_host);
+    init_conversion_context(&ctx);
+    convert_VkDependencyInfoKHR_win_to_host(&ctx, params->pDependencyInfo, &pDependencyInfo_host);
     params->commandBuffer->device->funcs.p_vkCmdSetEvent2KHR(params->commandBuffer->command_buffer, params->event, &pDependencyInfo_host);
 
-    free_VkDependencyInfoKHR(&pDependencyInfo_host);
+    free_conversion_context(&ctx);
     return STATUS_SUCCESS;
 #else
     TRACE("%p, 0x%s, %p\n", params->commandBuffer, wine_dbgstr_longlong(params->event), params->pDependencyInfo);
@@ -7118,14 +6586,15 @@ static NTSTATUS wine_vkCmdWaitEvents(void *args)
 #if defined(USE_STRUCT_CONVERSION)
     VkBufferMemoryBarrier_host *pBufferMemoryBarriers_host;
     VkImageMemoryBarrier_host *pImageMemoryBarriers_host;
+    struct conversion_context ctx;
     TRACE("%p, %u, %p, %#x, %#x, %u, %p, %u, %p, %u, %p\n", params->commandBuffer, params->eventCount, params->pEvents, params->srcStageMask, params->dstStageMask, params->memoryBarrierCount, params->pMemoryBarriers, params->bufferMemoryBarrierCount, params->pBufferMemoryBarriers, params->imageMemoryBarrierCount, params->pImageMemoryBarriers);
 
-    pBufferMemoryBarriers_host = convert_VkBufferMemoryBarrier_array_win_to_host(params->pBufferMemoryBarriers, params->bufferMemoryBarrierCount);
-    pImageMemoryBarriers_host = convert_VkImageMemoryBarrier_array_win_to_host(params->pImageMemoryBarriers, params->imageMemoryBarrierCount);
+    init_conversion_context(&ctx);
+    pBufferMemoryBarriers_host = convert_VkBufferMemoryBarrier_array_win_to_host(&ctx, params->pBufferMemoryBarriers, params->bufferMemoryBarrierCount);
+    pImageMemoryBarriers_host = convert_VkImageMemoryBarrier_array_win_to_host(&ctx, params->pImageMemoryBarriers, params->imageMemoryBarrierCount);
     params->commandBuffer->device->funcs.p_vkCmdWaitEvents(params->commandBuffer->command_buffer, params->eventCount, params->pEvents, params->srcStageMask, params->dstStageMask, params->memoryBarrierCount, params->pMemoryBarriers, params->bufferMemoryBarrierCount, pBufferMemoryBarriers_host, params->imageMemoryBarrierCount, pImageMemoryBarriers_host);
 
-    free_VkBufferMemoryBarrier_array(pBufferMemoryBarriers_host, params->bufferMemoryBarrierCount);
-    free_VkImageMemoryBarrier_array(pImageMemoryBarriers_host, params->imageMemoryBarrierCount);
+    free_conversion_context(&ctx);
     return STATUS_SUCCESS;
 #else
     TRACE("%p, %u, %p, %#x, %#x, %u, %p, %u, %p, %u, %p\n", params->commandBuffer, params->eventCount, params->pEvents, params->srcStageMask, params->dstStageMask, params->memoryBarrierCount, params->pMemoryBarriers, params->bufferMemoryBarrierCount, params->pBufferMemoryBarriers, params->imageMemoryBarrierCount, params->pImageMemoryBarriers);
@@ -7139,12 +6608,14 @@ static NTSTATUS wine_vkCmdWaitEvents2KHR(void *args)
     struct vkCmdWaitEvents2KHR_params *params = args;
 #if defined(USE_STRUCT_CONVERSION)
     VkDependencyInfoKHR_host *pDependencyInfos_host;
+    struct conversion_context ctx;
     TRACE("%p, %u, %p, %p\n", params->commandBuffer, params->eventCount, params->pEvents, params->pDependencyInfos);
 
-    pDependencyInfos_host = convert_VkDependencyInfoKHR_array_win_to_host(params->pDependencyInfos, params->eventCount);
+    init_conversion_context(&ctx);
+    pDependencyInfos_host = convert_VkDependencyInfoKHR_array_win_to_host(&ctx, params->pDependencyInfos, params->eventCount);
     params->commandBuffer->device->funcs.p_vkCmdWaitEvents2KHR(params->commandBuffer->command_buffer, params->eventCount, params->pEvents, pDependencyInfos_host);
 
-    free_VkDependencyInfoKHR_array(pDependencyInfos_host, params->eventCount);
+    free_conversion_context(&ctx);
     return STATUS_SUCCESS;
 #else
     TRACE("%p, %u, %p, %p\n", params->commandBuffer, params->eventCount, params->pEvents, params->pDependencyInfos);
@@ -7286,11 +6757,14 @@ static NTSTATUS wine_vkCreateAccelerationStructureNV(void *args)
 #if defined(USE_STRUCT_CONVERSION)
     VkResult result;
     VkAccelerationStructureCreateInfoNV_host pCreateInfo_host;
+    struct conversion_context ctx;
     TRACE("%p, %p, %p, %p\n", params->device, params->pCreateInfo, params->pAllocator, params->pAccelerationStructure);
 
-    convert_VkAccelerationStructureCreateInfoNV_win_to_host(params->pCreateInfo, &pCreateInfo_host);
+    init_conversion_context(&ctx);
+    convert_VkAccelerationStructureCreateInfoNV_win_to_host(&ctx, params->pCreateInfo, &pCreateInfo_host);
     result = params->device->funcs.p_vkCreateAccelerationStructureNV(params->device->device, &pCreateInfo_host, NULL, params->pAccelerationStructure);
 
+    free_conversion_context(&ctx);
     return result;
 #else
     TRACE("%p, %p, %p, %p\n", params->device, params->pCreateInfo, params->pAllocator, params->pAccelerationStructure);
@@ -7322,12 +6796,14 @@ static NTSTATUS wine_vkCreateComputePipelines(void *args)
 #if defined(USE_STRUCT_CONVERSION)
     VkResult result;
     VkComputePipelineCreateInfo_host *pCreateInfos_host;
+    struct conversion_context ctx;
     TRACE("%p, 0x%s, %u, %p, %p, %p\n", params->device, wine_dbgstr_longlong(params->pipelineCache), params->createInfoCount, params->pCreateInfos, params->pAllocator, params->pPipelines);
 
-    pCreateInfos_host = convert_VkComputePipelineCreateInfo_array_win_to_host(params->pCreateInfos, params->createInfoCount);
+    init_conversion_context(&ctx);
+    pCreateInfos_host = convert_VkComputePipelineCreateInfo_array_win_to_host(&ctx, params->pCreateInfos, params->createInfoCount);
     result = params->device->funcs.p_vkCreateComputePipelines(params->device->device, params->pipelineCache, params->createInfoCount, pCreateInfos_host, NULL, params->pPipelines);
 
-    free_VkComputePipelineCreateInfo_array(pCreateInfos_host, params->createInfoCount);
+    free_conversion_context(&ctx);
     return result;
 #else
     TRACE("%p, 0x%s, %u, %p, %p, %p\n", params->device, wine_dbgstr_longlong(params->pipelineCache), params->createInfoCount, params->pCreateInfos, params->pAllocator, params->pPipelines);
@@ -7455,12 +6931,14 @@ static NTSTATUS wine_vkCreateGraphicsPipelines(void *args)
 #if defined(USE_STRUCT_CONVERSION)
     VkResult result;
     VkGraphicsPipelineCreateInfo_host *pCreateInfos_host;
+    struct conversion_context ctx;
     TRACE("%p, 0x%s, %u, %p, %p, %p\n", params->device, wine_dbgstr_longlong(params->pipelineCache), params->createInfoCount, params->pCreateInfos, params->pAllocator, params->pPipelines);
 
-    pCreateInfos_host = convert_VkGraphicsPipelineCreateInfo_array_win_to_host(params->pCreateInfos, params->createInfoCount);
+    init_conversion_context(&ctx);
+    pCreateInfos_host = convert_VkGraphicsPipelineCreateInfo_array_win_to_host(&ctx, params->pCreateInfos, params->createInfoCount);
     result = params->device->funcs.p_vkCreateGraphicsPipelines(params->device->device, params->pipelineCache, params->createInfoCount, pCreateInfos_host, NULL, params->pPipelines);
 
-    free_VkGraphicsPipelineCreateInfo_array(pCreateInfos_host, params->createInfoCount);
+    free_conversion_context(&ctx);
     return result;
 #else
     TRACE("%p, 0x%s, %u, %p, %p, %p\n", params->device, wine_dbgstr_longlong(params->pipelineCache), params->createInfoCount, params->pCreateInfos, params->pAllocator, params->pPipelines);
@@ -7492,12 +6970,14 @@ static NTSTATUS wine_vkCreateIndirectCommandsLayoutNV(void *args)
 #if defined(USE_STRUCT_CONVERSION)
     VkResult result;
     VkIndirectCommandsLayoutCreateInfoNV_host pCreateInfo_host;
+    struct conversion_context ctx;
     TRACE("%p, %p, %p, %p\n", params->device, params->pCreateInfo, params->pAllocator, params->pIndirectCommandsLayout);
 
-    convert_VkIndirectCommandsLayoutCreateInfoNV_win_to_host(params->pCreateInfo, &pCreateInfo_host);
+    init_conversion_context(&ctx);
+    convert_VkIndirectCommandsLayoutCreateInfoNV_win_to_host(&ctx, params->pCreateInfo, &pCreateInfo_host);
     result = params->device->funcs.p_vkCreateIndirectCommandsLayoutNV(params->device->device, &pCreateInfo_host, NULL, params->pIndirectCommandsLayout);
 
-    free_VkIndirectCommandsLayoutCreateInfoNV(&pCreateInfo_host);
+    free_conversion_context(&ctx);
     return result;
 #else
     TRACE("%p, %p, %p, %p\n", params->device, params->pCreateInfo, params->pAllocator, params->pIndirectCommandsLayout);
@@ -7539,12 +7019,14 @@ static NTSTATUS wine_vkCreateRayTracingPipelinesKHR(void *args)
 #if defined(USE_STRUCT_CONVERSION)
     VkResult result;
     VkRayTracingPipelineCreateInfoKHR_host *pCreateInfos_host;
+    struct conversion_context ctx;
     TRACE("%p, 0x%s, 0x%s, %u, %p, %p, %p\n", params->device, wine_dbgstr_longlong(params->deferredOperation), wine_dbgstr_longlong(params->pipelineCache), params->createInfoCount, params->pCreateInfos, params->pAllocator, params->pPipelines);
 
-    pCreateInfos_host = convert_VkRayTracingPipelineCreateInfoKHR_array_win_to_host(params->pCreateInfos, params->createInfoCount);
+    init_conversion_context(&ctx);
+    pCreateInfos_host = convert_VkRayTracingPipelineCreateInfoKHR_array_win_to_host(&ctx, params->pCreateInfos, params->createInfoCount);
     result = params->device->funcs.p_vkCreateRayTracingPipelinesKHR(params->device->device, params->deferredOperation, params->pipelineCache, params->createInfoCount, pCreateInfos_host, NULL, params->pPipelines);
 
-    free_VkRayTracingPipelineCreateInfoKHR_array(pCreateInfos_host, params->createInfoCount);
+    free_conversion_context(&ctx);
     return result;
 #else
     TRACE("%p, 0x%s, 0x%s, %u, %p, %p, %p\n", params->device, wine_dbgstr_longlong(params->deferredOperation), wine_dbgstr_longlong(params->pipelineCache), params->createInfoCount, params->pCreateInfos, params->pAllocator, params->pPipelines);
@@ -7558,12 +7040,14 @@ static NTSTATUS wine_vkCreateRayTracingPipelinesNV(void *args)
 #if defined(USE_STRUCT_CONVERSION)
     VkResult result;
     VkRayTracingPipelineCreateInfoNV_host *pCreateInfos_host;
+    struct conversion_context ctx;
     TRACE("%p, 0x%s, %u, %p, %p, %p\n", params->device, wine_dbgstr_longlong(params->pipelineCache), params->createInfoCount, params->pCreateInfos, params->pAllocator, params->pPipelines);
 
-    pCreateInfos_host = convert_VkRayTracingPipelineCreateInfoNV_array_win_to_host(params->pCreateInfos, params->createInfoCount);
+    init_conversion_context(&ctx);
+    pCreateInfos_host = convert_VkRayTracingPipelineCreateInfoNV_array_win_to_host(&ctx, params->pCreateInfos, params->createInfoCount);
     result = params->device->funcs.p_vkCreateRayTracingPipelinesNV(params->device->device, params->pipelineCache, params->createInfoCount, pCreateInfos_host, NULL, params->pPipelines);
 
-    free_VkRayTracingPipelineCreateInfoNV_array(pCreateInfos_host, params->createInfoCount);
+    free_conversion_context(&ctx);
     return result;
 #else
     TRACE("%p, 0x%s, %u, %p, %p, %p\n", params->device, wine_dbgstr_longlong(params->pipelineCache), params->createInfoCount, params->pCreateInfos, params->pAllocator, params->pPipelines);
@@ -7956,22 +7440,26 @@ static NTSTATUS wine_vkFlushMappedMemoryRanges(void *args)
 #if defined(USE_STRUCT_CONVERSION)
     VkResult result;
     VkMappedMemoryRange_host *pMemoryRanges_host;
+    struct conversion_context ctx;
     TRACE("%p, %u, %p\n", params->device, params->memoryRangeCount, params->pMemoryRanges);
 
-    pMemoryRanges_host = convert_VkMappedMemoryRange_array_win_to_host(params->pMemoryRanges, params->memoryRangeCount);
+    init_conversion_context(&ctx);
+    pMemoryRanges_host = convert_VkMappedMemoryRange_array_win_to_host(&ctx, params->pMemoryRanges, params->memoryRangeCount);
     result = params->device->funcs.p_vkFlushMappedMemoryRanges(params->device->device, params->memoryRangeCount, pMemoryRanges_host);
 
-    free_VkMappedMemoryRange_array(pMemoryRanges_host, params->memoryRangeCount);
+    free_conversion_context(&ctx);
     return result;
 #else
     VkResult result;
     VkMappedMemoryRange *pMemoryRanges_host;
+    struct conversion_context ctx;
     TRACE("%p, %u, %p\n", params->device, params->memoryRangeCount, params->pMemoryRanges);
 
-    pMemoryRanges_host = convert_VkMappedMemoryRange_array_win_to_host(params->pMemoryRanges, params->memoryRangeCount);
+    init_conversion_context(&ctx);
+    pMemoryRanges_host = convert_VkMappedMemoryRange_array_win_to_host(&ctx, params->pMemoryRanges, params->memoryRangeCount);
     result = params->device->funcs.p_vkFlushMappedMemoryRanges(params->device->device, params->memoryRangeCount, pMemoryRanges_host);
 
-    free_VkMappedMemoryRange_array(pMemoryRanges_host, params->memoryRangeCount);
+    free_conversion_context(&ctx);
     return result;
 #endif
 }
@@ -8243,14 +7731,16 @@ static NTSTATUS wine_vkGetDeviceBufferMemoryRequirementsKHR(void *args)
 #if defined(USE_STRUCT_CONVERSION)
     VkDeviceBufferMemoryRequirementsKHR_host pInfo_host;
     VkMemoryRequirements2_host pMemoryRequirements_host;
+    struct conversion_context ctx;
     TRACE("%p, %p, %p\n", params->device, params->pInfo, params->pMemoryRequirements);
 
-    convert_VkDeviceBufferMemoryRequirementsKHR_win_to_host(params->pInfo, &pInfo_host);
+    init_conversion_context(&ctx);
+    convert_VkDeviceBufferMemoryRequirementsKHR_win_to_host(&ctx, params->pInfo, &pInfo_host);
     convert_VkMemoryRequirements2_win_to_host(params->pMemoryRequirements, &pMemoryRequirements_host);
     params->device->funcs.p_vkGetDeviceBufferMemoryRequirementsKHR(params->device->device, &pInfo_host, &pMemoryRequirements_host);
 
     convert_VkMemoryRequirements2_host_to_win(&pMemoryRequirements_host, params->pMemoryRequirements);
-    free_VkDeviceBufferMemoryRequirementsKHR(&pInfo_host);
+    free_conversion_context(&ctx);
     return STATUS_SUCCESS;
 #else
     TRACE("%p, %p, %p\n", params->device, params->pInfo, params->pMemoryRequirements);
@@ -9135,22 +8625,26 @@ static NTSTATUS wine_vkInvalidateMappedMemoryRanges(void *args)
 #if defined(USE_STRUCT_CONVERSION)
     VkResult result;
     VkMappedMemoryRange_host *pMemoryRanges_host;
+    struct conversion_context ctx;
     TRACE("%p, %u, %p\n", params->device, params->memoryRangeCount, params->pMemoryRanges);
 
-    pMemoryRanges_host = convert_VkMappedMemoryRange_array_win_to_host(params->pMemoryRanges, params->memoryRangeCount);
+    init_conversion_context(&ctx);
+    pMemoryRanges_host = convert_VkMappedMemoryRange_array_win_to_host(&ctx, params->pMemoryRanges, params->memoryRangeCount);
     result = params->device->funcs.p_vkInvalidateMappedMemoryRanges(params->device->device, params->memoryRangeCount, pMemoryRanges_host);
 
-    free_VkMappedMemoryRange_array(pMemoryRanges_host, params->memoryRangeCount);
+    free_conversion_context(&ctx);
     return result;
 #else
     VkResult result;
     VkMappedMemoryRange *pMemoryRanges_host;
+    struct conversion_context ctx;
     TRACE("%p, %u, %p\n", params->device, params->memoryRangeCount, params->pMemoryRanges);
 
-    pMemoryRanges_host = convert_VkMappedMemoryRange_array_win_to_host(params->pMemoryRanges, params->memoryRangeCount);
+    init_conversion_context(&ctx);
+    pMemoryRanges_host = convert_VkMappedMemoryRange_array_win_to_host(&ctx, params->pMemoryRanges, params->memoryRangeCount);
     result = params->device->funcs.p_vkInvalidateMappedMemoryRanges(params->device->device, params->memoryRangeCount, pMemoryRanges_host);
 
-    free_VkMappedMemoryRange_array(pMemoryRanges_host, params->memoryRangeCount);
+    free_conversion_context(&ctx);
     return result;
 #endif
 }
@@ -9190,22 +8684,26 @@ static NTSTATUS wine_vkQueueBindSparse(void *args)
 #if defined(USE_STRUCT_CONVERSION)
     VkResult result;
     VkBindSparseInfo_host *pBindInfo_host;
+    struct conversion_context ctx;
     TRACE("%p, %u, %p, 0x%s\n", params->queue, params->bindInfoCount, params->pBindInfo, wine_dbgstr_longlong(params->fence));
 
-    pBindInfo_host = convert_VkBindSparseInfo_array_win_to_host(params->pBindInfo, params->bindInfoCount);
+    init_conversion_context(&ctx);
+    pBindInfo_host = convert_VkBindSparseInfo_array_win_to_host(&ctx, params->pBindInfo, params->bindInfoCount);
     result = params->queue->device->funcs.p_vkQueueBindSparse(params->queue->queue, params->bindInfoCount, pBindInfo_host, params->fence);
 
-    free_VkBindSparseInfo_array(pBindInfo_host, params->bindInfoCount);
+    free_conversion_context(&ctx);
     return result;
 #else
     VkResult result;
     VkBindSparseInfo *pBindInfo_host;
+    struct conversion_context ctx;
     TRACE("%p, %u, %p, 0x%s\n", params->queue, params->bindInfoCount, params->pBindInfo, wine_dbgstr_longlong(params->fence));
 
-    pBindInfo_host = convert_VkBindSparseInfo_array_win_to_host(params->pBindInfo, params->bindInfoCount);
+    init_conversion_context(&ctx);
+    pBindInfo_host = convert_VkBindSparseInfo_array_win_to_host(&ctx, params->pBindInfo, params->bindInfoCount);
     result = params->queue->device->funcs.p_vkQueueBindSparse(params->queue->queue, params->bindInfoCount, pBindInfo_host, params->fence);
 
-    free_VkBindSparseInfo_array(pBindInfo_host, params->bindInfoCount);
+    free_conversion_context(&ctx);
     return result;
 #endif
 }
@@ -9238,12 +8736,14 @@ static NTSTATUS wine_vkQueueSubmit(void *args)
     struct vkQueueSubmit_params *params = args;
     VkResult result;
     VkSubmitInfo *pSubmits_host;
+    struct conversion_context ctx;
     TRACE("%p, %u, %p, 0x%s\n", params->queue, params->submitCount, params->pSubmits, wine_dbgstr_longlong(params->fence));
 
-    pSubmits_host = convert_VkSubmitInfo_array_win_to_host(params->pSubmits, params->submitCount);
+    init_conversion_context(&ctx);
+    pSubmits_host = convert_VkSubmitInfo_array_win_to_host(&ctx, params->pSubmits, params->submitCount);
     result = params->queue->device->funcs.p_vkQueueSubmit(params->queue->queue, params->submitCount, pSubmits_host, params->fence);
 
-    free_VkSubmitInfo_array(pSubmits_host, params->submitCount);
+    free_conversion_context(&ctx);
     return result;
 }
 
@@ -9253,22 +8753,26 @@ static NTSTATUS wine_vkQueueSubmit2KHR(void *args)
 #if defined(USE_STRUCT_CONVERSION)
     VkResult result;
     VkSubmitInfo2KHR_host *pSubmits_host;
+    struct conversion_context ctx;
     TRACE("%p, %u, %p, 0x%s\n", params->queue, params->submitCount, params->pSubmits, wine_dbgstr_longlong(params->fence));
 
-    pSubmits_host = convert_VkSubmitInfo2KHR_array_win_to_host(params->pSubmits, params->submitCount);
+    init_conversion_context(&ctx);
+    pSubmits_host = convert_VkSubmitInfo2KHR_array_win_to_host(&ctx, params->pSubmits, params->submitCount);
     result = params->queue->device->funcs.p_vkQueueSubmit2KHR(params->queue->queue, params->submitCount, pSubmits_host, params->fence);
 
-    free_VkSubmitInfo2KHR_array(pSubmits_host, params->submitCount);
+    free_conversion_context(&ctx);
     return result;
 #else
     VkResult result;
     VkSubmitInfo2KHR *pSubmits_host;
+    struct conversion_context ctx;
     TRACE("%p, %u, %p, 0x%s\n", params->queue, params->submitCount, params->pSubmits, wine_dbgstr_longlong(params->fence));
 
-    pSubmits_host = convert_VkSubmitInfo2KHR_array_win_to_host(params->pSubmits, params->submitCount);
+    init_conversion_context(&ctx);
+    pSubmits_host = convert_VkSubmitInfo2KHR_array_win_to_host(&ctx, params->pSubmits, params->submitCount);
     result = params->queue->device->funcs.p_vkQueueSubmit2KHR(params->queue->queue, params->submitCount, pSubmits_host, params->fence);
 
-    free_VkSubmitInfo2KHR_array(pSubmits_host, params->submitCount);
+    free_conversion_context(&ctx);
     return result;
 #endif
 }
@@ -9457,21 +8961,25 @@ static NTSTATUS wine_vkSubmitDebugUtilsMessageEXT(void *args)
     struct vkSubmitDebugUtilsMessageEXT_params *params = args;
 #if defined(USE_STRUCT_CONVERSION)
     VkDebugUtilsMessengerCallbackDataEXT_host pCallbackData_host;
+    struct conversion_context ctx;
     TRACE("%p, %#x, %#x, %p\n", params->instance, params->messageSeverity, params->messageTypes, params->pCallbackData);
 
-    convert_VkDebugUtilsMessengerCallbackDataEXT_win_to_host(params->pCallbackData, &pCallbackData_host);
+    init_conversion_context(&ctx);
+    convert_VkDebugUtilsMessengerCallbackDataEXT_win_to_host(&ctx, params->pCallbackData, &pCallbackData_host);
     params->instance->funcs.p_vkSubmitDebugUtilsMessageEXT(params->instance->instance, params->messageSeverity, params->messageTypes, &pCallbackData_host);
 
-    free_VkDebugUtilsMessengerCallbackDataEXT(&pCallbackData_host);
+    free_conversion_context(&ctx);
     return STATUS_SUCCESS;
 #else
     VkDebugUtilsMessengerCallbackDataEXT pCallbackData_host;
+    struct conversion_context ctx;
     TRACE("%p, %#x, %#x, %p\n", params->instance, params->messageSeverity, params->messageTypes, params->pCallbackData);
 
-    convert_VkDebugUtilsMessengerCallbackDataEXT_win_to_host(params->pCallbackData, &pCallbackData_host);
+    init_conversion_context(&ctx);
+    convert_VkDebugUtilsMessengerCallbackDataEXT_win_to_host(&ctx, params->pCallbackData, &pCallbackData_host);
     params->instance->funcs.p_vkSubmitDebugUtilsMessageEXT(params->instance->instance, params->messageSeverity, params->messageTypes, &pCallbackData_host);
 
-    free_VkDebugUtilsMessengerCallbackDataEXT(&pCallbackData_host);
+    free_conversion_context(&ctx);
     return STATUS_SUCCESS;
 #endif
 }
@@ -9530,14 +9038,15 @@ static NTSTATUS wine_vkUpdateDescriptorSets(void *args)
 #if defined(USE_STRUCT_CONVERSION)
     VkWriteDescriptorSet_host *pDescriptorWrites_host;
     VkCopyDescriptorSet_host *pDescriptorCopies_host;
+    struct conversion_context ctx;
     TRACE("%p, %u, %p, %u, %p\n", params->device, params->descriptorWriteCount, params->pDescriptorWrites, params->descriptorCopyCount, params->pDescriptorCopies);
 
-    pDescriptorWrites_host = convert_VkWriteDescriptorSet_array_win_to_host(params->pDescriptorWrites, params->descriptorWriteCount);
-    pDescriptorCopies_host = convert_VkCopyDescriptorSet_array_win_to_host(params->pDescriptorCopies, params->descriptorCopyCount);
+    init_conversion_context(&ctx);
+    pDescriptorWrites_host = convert_VkWriteDescriptorSet_array_win_to_host(&ctx, params->pDescriptorWrites, params->descriptorWriteCount);
+    pDescriptorCopies_host = convert_VkCopyDescriptorSet_array_win_to_host(&ctx, params->pDescriptorCopies, params->descriptorCopyCount);
     params->device->funcs.p_vkUpdateDescriptorSets(params->device->device, params->descriptorWriteCount, pDescriptorWrites_host, params->descriptorCopyCount, pDescriptorCopies_host);
 
-    free_VkWriteDescriptorSet_array(pDescriptorWrites_host, params->descriptorWriteCount);
-    free_VkCopyDescriptorSet_array(pDescriptorCopies_host, params->descriptorCopyCount);
+    free_conversion_context(&ctx);
     return STATUS_SUCCESS;
 #else
     TRACE("%p, %u, %p, %u, %p\n", params->device, params->descriptorWriteCount, params->pDescriptorWrites, params->descriptorCopyCount, params->pDescriptorCopies);
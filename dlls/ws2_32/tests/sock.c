@@ -2570,6 +2570,104 @@ static void test_UDP(void)
     }
 }
 
+static void test_udp_nonblocking(void)
+{
+    struct sockaddr_in addr = {.sin_family = AF_INET, .sin_addr.s_addr = htonl(INADDR_LOOPBACK)};
+    u_long one = 1, zero = 0;
+    WSANETWORKEVENTS events;
+    SOCKET client, server;
+    HANDLE event, dup;
+    char buffer[64];
+    DWORD timeout;
+    int ret, len, i;
+
+    server = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    ok(server != -1, "failed to create socket, error %u\n", WSAGetLastError());
+    client = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    ok(client != -1, "failed to create socket, error %u\n", WSAGetLastError());
+    event = CreateEventW(NULL, TRUE, FALSE, NULL);
+
+    ret = bind(server, (const struct sockaddr *)&addr, sizeof(addr));
+    ok(!ret, "failed to bind, error %u\n", WSAGetLastError());
+    len = sizeof(addr);
+    ret = getsockname(server, (struct sockaddr *)&addr, &len);
+    ok(!ret, "failed to get address, error %u\n", WSAGetLastError());
+    ret = connect(client, (const struct sockaddr *)&addr, sizeof(addr));
+    ok(!ret, "failed to connect, error %u\n", WSAGetLastError());
+
+    ret = ioctlsocket(server, FIONBIO, &one);
+    ok(!ret, "got error %u\n", WSAGetLastError());
+    ret = ioctlsocket(client, FIONBIO, &one);
+    ok(!ret, "got error %u\n", WSAGetLastError());
+
+    for (i = 0; i < 4; ++i)
+    {
+        memset(buffer, i, sizeof(buffer));
+        ret = send(client, buffer, sizeof(buffer), 0);
+        ok(ret == sizeof(buffer), "got %d, error %u\n", ret, WSAGetLastError());
+        memset(buffer, 0xcc, sizeof(buffer));
+        ret = recv(server, buffer, sizeof(buffer), 0);
+        ok(ret == sizeof(buffer), "got %d, error %u\n", ret, WSAGetLastError());
+        ok(buffer[0] == i && buffer[sizeof(buffer) - 1] == i, "got %#x\n", buffer[0]);
+
+        WSASetLastError(0xdeadbeef);
+        ret = recv(server, buffer, sizeof(buffer), 0);
+        ok(ret == -1, "got %d\n", ret);
+        ok(WSAGetLastError() == WSAEWOULDBLOCK, "got error %u\n", WSAGetLastError());
+    }
+
+    /* selecting events through another handle reports them for this one */
+    ret = DuplicateHandle(GetCurrentProcess(), (HANDLE)server, GetCurrentProcess(), &dup, 0, FALSE, DUPLICATE_SAME_ACCESS);
+    ok(ret, "got error %u\n", GetLastError());
+    ret = WSAEventSelect((SOCKET)dup, event, FD_READ);
+    ok(!ret, "got error %u\n", WSAGetLastError());
+
+    WSASetLastError(0xdeadbeef);
+    ret = recv(server, buffer, sizeof(buffer), 0);
+    ok(ret == -1, "got %d\n", ret);
+    ok(WSAGetLastError() == WSAEWOULDBLOCK, "got error %u\n", WSAGetLastError());
+    ret = WaitForSingleObject(event, 0);
+    ok(ret == WAIT_TIMEOUT, "got %d\n", ret);
+
+    for (i = 0; i < 2; ++i)
+    {
+        ret = send(client, buffer, sizeof(buffer), 0);
+        ok(ret == sizeof(buffer), "got %d, error %u\n", ret, WSAGetLastError());
+        ret = WaitForSingleObject(event, 1000);
+        ok(!ret, "%d: got %d\n", i, ret);
+        ret = WSAEnumNetworkEvents(server, event, &events);
+        ok(!ret, "got error %u\n", WSAGetLastError());
+        ok(events.lNetworkEvents == FD_READ, "%d: got events %#x\n", i, events.lNetworkEvents);
+        ret = recv(server, buffer, sizeof(buffer), 0);
+        ok(ret == sizeof(buffer), "got %d, error %u\n", ret, WSAGetLastError());
+    }
+
+    /* and so does making it blocking through another handle */
+    ret = WSAEventSelect((SOCKET)dup, NULL, 0);
+    ok(!ret, "got error %u\n", WSAGetLastError());
+
+    WSASetLastError(0xdeadbeef);
+    ret = recv(server, buffer, sizeof(buffer), 0);
+    ok(ret == -1, "got %d\n", ret);
+    ok(WSAGetLastError() == WSAEWOULDBLOCK, "got error %u\n", WSAGetLastError());
+
+    ret = ioctlsocket((SOCKET)dup, FIONBIO, &zero);
+    ok(!ret, "got error %u\n", WSAGetLastError());
+    timeout = 100;
+    ret = setsockopt(server, SOL_SOCKET, SO_RCVTIMEO, (char *)&timeout, sizeof(timeout));
+    ok(!ret, "got error %u\n", WSAGetLastError());
+
+    WSASetLastError(0xdeadbeef);
+    ret = recv(server, buffer, sizeof(buffer), 0);
+    ok(ret == -1, "got %d\n", ret);
+    ok(WSAGetLastError() == WSAETIMEDOUT, "got error %u\n", WSAGetLastError());
+
+    CloseHandle(dup);
+    closesocket(client);
+    closesocket(server);
+    CloseHandle(event);
+}
+
 static void test_WSASocket(void)
 {
     SOCKET sock = INVALID_SOCKET;
@@ -11875,6 +11973,122 @@ static void test_timeout(void)
     CloseHandle(overlapped.hEvent);
 }
 
+static void test_wouldblock(void)
+{
+    u_long one = 1, zero = 0;
+    WSANETWORKEVENTS events;
+    SOCKET client, server;
+    HANDLE event, dup;
+    DWORD timeout;
+    char buffer;
+    int ret, i;
+
+    tcp_socketpair(&client, &server);
+    event = CreateEventW(NULL, TRUE, FALSE, NULL);
+
+    ret = ioctlsocket(client, FIONBIO, &one);
+    ok(!ret, "got error %u\n", WSAGetLastError());
+
+    for (i = 0; i < 100; ++i)
+    {
+        WSASetLastError(0xdeadbeef);
+        ret = recv(client, &buffer, 1, 0);
+        ok(ret == -1, "got %d\n", ret);
+        ok(WSAGetLastError() == WSAEWOULDBLOCK, "got error %u\n", WSAGetLastError());
+    }
+
+    /* selecting events afterwards still reports them */
+    ret = WSAEventSelect(client, event, FD_READ);
+    ok(!ret, "got error %u\n", WSAGetLastError());
+
+    ret = WaitForSingleObject(event, 0);
+    ok(ret == WAIT_TIMEOUT, "got %d\n", ret);
+    ret = send(server, "a", 1, 0);
+    ok(ret == 1, "got %d\n", ret);
+    ret = WaitForSingleObject(event, 1000);
+    ok(!ret, "got %d\n", ret);
+    ret = recv(client, &buffer, 1, 0);
+    ok(ret == 1, "got %d\n", ret);
+
+    WSASetLastError(0xdeadbeef);
+    ret = recv(client, &buffer, 1, 0);
+    ok(ret == -1, "got %d\n", ret);
+    ok(WSAGetLastError() == WSAEWOULDBLOCK, "got error %u\n", WSAGetLastError());
+
+    /* so does making the socket blocking again */
+    ret = WSAEventSelect(client, NULL, 0);
+    ok(!ret, "got error %u\n", WSAGetLastError());
+    ret = ioctlsocket(client, FIONBIO, &zero);
+    ok(!ret, "got error %u\n", WSAGetLastError());
+
+    timeout = 100;
+    ret = setsockopt(client, SOL_SOCKET, SO_RCVTIMEO, (char *)&timeout, sizeof(timeout));
+    ok(!ret, "got error %u\n", WSAGetLastError());
+
+    WSASetLastError(0xdeadbeef);
+    ret = recv(client, &buffer, 1, 0);
+    ok(ret == -1, "got %d\n", ret);
+    ok(WSAGetLastError() == WSAETIMEDOUT, "got error %u\n", WSAGetLastError());
+
+    closesocket(client);
+    closesocket(server);
+
+    /* the same has to hold for state changes through another handle */
+    tcp_socketpair(&client, &server);
+    ResetEvent(event);
+
+    ret = ioctlsocket(client, FIONBIO, &one);
+    ok(!ret, "got error %u\n", WSAGetLastError());
+
+    for (i = 0; i < 100; ++i)
+    {
+        WSASetLastError(0xdeadbeef);
+        ret = recv(client, &buffer, 1, 0);
+        ok(ret == -1, "got %d\n", ret);
+        ok(WSAGetLastError() == WSAEWOULDBLOCK, "got error %u\n", WSAGetLastError());
+    }
+
+    ret = DuplicateHandle(GetCurrentProcess(), (HANDLE)client, GetCurrentProcess(), &dup, 0, FALSE, DUPLICATE_SAME_ACCESS);
+    ok(ret, "got error %u\n", GetLastError());
+    ret = WSAEventSelect((SOCKET)dup, event, FD_READ);
+    ok(!ret, "got error %u\n", WSAGetLastError());
+
+    WSASetLastError(0xdeadbeef);
+    ret = recv(client, &buffer, 1, 0);
+    ok(ret == -1, "got %d\n", ret);
+    ok(WSAGetLastError() == WSAEWOULDBLOCK, "got error %u\n", WSAGetLastError());
+
+    for (i = 0; i < 2; ++i)
+    {
+        ret = send(server, "a", 1, 0);
+        ok(ret == 1, "got %d\n", ret);
+        ret = WaitForSingleObject(event, 1000);
+        ok(!ret, "%d: got %d\n", i, ret);
+        ret = WSAEnumNetworkEvents(client, event, &events);
+        ok(!ret, "got error %u\n", WSAGetLastError());
+        ok(events.lNetworkEvents == FD_READ, "%d: got events %#x\n", i, events.lNetworkEvents);
+        ret = recv(client, &buffer, 1, 0);
+        ok(ret == 1, "got %d\n", ret);
+    }
+
+    ret = WSAEventSelect((SOCKET)dup, NULL, 0);
+    ok(!ret, "got error %u\n", WSAGetLastError());
+    ret = ioctlsocket((SOCKET)dup, FIONBIO, &zero);
+    ok(!ret, "got error %u\n", WSAGetLastError());
+    ret = setsockopt(client, SOL_SOCKET, SO_RCVTIMEO, (char *)&timeout, sizeof(timeout));
+    ok(!ret, "got error %u\n", WSAGetLastError());
+
+    WSASetLastError(0xdeadbeef);
+    ret = recv(client, &buffer, 1, 0);
+    ok(ret == -1, "got %d\n", ret);
+    ok(WSAGetLastError() == WSAETIMEDOUT, "got error %u\n", WSAGetLastError());
+
+    CloseHandle(dup);
+    closesocket(client);
+    closesocket(server);
+    CloseHandle(event);
+}
+
 static void test_so_debug(void)
 {
     int ret, len;
@@ -12258,6 +12472,7 @@ START_TEST( sock )
         do_test(&tests[i]);
 
     test_UDP();
+    test_udp_nonblocking();
 
     test_WSASocket();
     test_WSADuplicateSocket();
@@ -12307,6 +12522,7 @@ START_TEST( sock )
     test_simultaneous_async_recv();
     test_empty_recv();
     test_timeout();
+    test_wouldblock();
 
     /* this is an io heavy test, do it at the end so the kernel doesn't start dropping packets */
     test_send();
@@ -831,6 +831,27 @@ typedef struct
     lparam_t info;
 } cursor_pos_t;
 
+typedef struct
+{
+    user_handle_t  handle;
+    user_handle_t  previous;
+    unsigned short swp_flags;
+    unsigned short paint_flags;
+    unsigned int   rect_count;
+    rectangle_t    window;
+    rectangle_t    client;
+    rectangle_t    extra[3];
+} window_pos_t;
+
+typedef struct
+{
+    unsigned int   status;
+    unsigned int   new_style;
+    unsigned int   new_ex_style;
+    user_handle_t  surface_win;
+    int            needs_update;
+} window_pos_result_t;
+
 struct cpu_topology_override
 {
     unsigned int cpu_count;
@@ -880,9 +901,32 @@ struct input_shared_memory
     int                  cursor_count;
     unsigned char        keystate[256];
     int                  keystate_lock;
+    unsigned int         rawinput_count;
+    unsigned int         rawinput_dropped;
+};
+
+struct window_shared_memory
+{
+    unsigned int         seq;
+    user_handle_t        handle;
+    user_handle_t        parent;
+    thread_id_t          tid;
+    process_id_t         pid;
+    unsigned int         style;
+    unsigned int         ex_style;
+    unsigned int         dpi;
+    rectangle_t          window_rect;
+    rectangle_t          client_rect;
 };
 
 
+#define MAX_WINDOW_SHARED_ENTRIES (((LAST_USER_HANDLE - FIRST_USER_HANDLE) >> 1) + 1)
+
+
+
+#define MAX_SOCKET_LOCAL_IO_SERIALS 65536
+
+
 #define SEQUENCE_MASK_BITS  4
 #define SEQUENCE_MASK ((1UL << SEQUENCE_MASK_BITS) - 1)
 
@@ -1830,6 +1874,8 @@ struct recv_socket_reply
     struct reply_header __header;
     obj_handle_t wait;
     unsigned int options;
+    unsigned int local_io;
+    unsigned int local_io_serial;
 };
 
 
@@ -1847,6 +1893,8 @@ struct send_socket_reply
     struct reply_header __header;
     obj_handle_t wait;
     unsigned int options;
+    unsigned int local_io;
+    unsigned int local_io_serial;
 };
 
 
@@ -3314,6 +3362,19 @@ struct set_window_pos_reply
 #define SET_WINPOS_PIXEL_FORMAT  0x02
 
 
+struct set_window_pos_list_request
+{
+    struct request_header __header;
+    /* VARARG(windows,window_positions); */
+    char __pad_12[4];
+};
+struct set_window_pos_list_reply
+{
+    struct reply_header __header;
+    /* VARARG(results,window_pos_results); */
+};
+
+
 struct get_window_rectangles_request
 {
     struct request_header __header;
@@ -5823,6 +5884,7 @@ enum request
     REQ_get_window_children_from_point,
     REQ_get_window_tree,
     REQ_set_window_pos,
+    REQ_set_window_pos_list,
     REQ_get_window_rectangles,
     REQ_get_window_text,
     REQ_set_window_text,
@@ -6116,6 +6178,7 @@ union generic_request
     struct get_window_children_from_point_request get_window_children_from_point_request;
     struct get_window_tree_request get_window_tree_request;
     struct set_window_pos_request set_window_pos_request;
+    struct set_window_pos_list_request set_window_pos_list_request;
     struct get_window_rectangles_request get_window_rectangles_request;
     struct get_window_text_request get_window_text_request;
     struct set_window_text_request set_window_text_request;
@@ -6407,6 +6470,7 @@ union generic_reply
     struct get_window_children_from_point_reply get_window_children_from_point_reply;
     struct get_window_tree_reply get_window_tree_reply;
     struct set_window_pos_reply set_window_pos_reply;
+    struct set_window_pos_list_reply set_window_pos_list_reply;
     struct get_window_rectangles_reply get_window_rectangles_reply;
     struct get_window_text_reply get_window_text_reply;
     struct set_window_text_reply set_window_text_reply;
@@ -6556,7 +6620,7 @@ union generic_reply
 
 /* ### protocol_version begin ### */
 
-#define SERVER_PROTOCOL_VERSION 743
+#define SERVER_PROTOCOL_VERSION 748
 
 /* ### protocol_version end ### */
 
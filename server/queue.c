@@ -50,6 +50,9 @@
 enum message_kind { SEND_MESSAGE, POST_MESSAGE };
 #define NB_MSG_KINDS (POST_MESSAGE+1)
 
+/* maximum number of pending WM_INPUT messages per thread input */
+#define MAX_RAWINPUT_MESSAGES 8192
+
 
 struct message_result
 {
@@ -104,6 +107,7 @@ struct thread_input
     int                    caret_hide;    /* caret hide count */
     int                    caret_state;   /* caret on/off state */
     struct list            msg_list;      /* list of hardware messages */
+    unsigned int           rawinput_count; /* number of WM_INPUT messages in msg_list */
     unsigned char          desktop_keystate[256]; /* desktop keystate when keystate was synced */
     struct object         *shared_mapping; /* thread input shared memory mapping */
     volatile struct input_shared_memory *shared;  /* thread input shared memory ptr */
@@ -236,46 +240,6 @@ static unsigned int last_input_time;
 static cursor_pos_t cursor_history[64];
 static unsigned int cursor_history_latest;
 
-#if defined(__i386__) || defined(__x86_64__)
-
-#define SHARED_WRITE_BEGIN( x )                                  \
-    do {                                                         \
-        volatile unsigned int __seq = *(x);                      \
-        assert( (__seq & SEQUENCE_MASK) != SEQUENCE_MASK );      \
-        *(x) = ++__seq;                                          \
-    } while(0)
-
-#define SHARED_WRITE_END( x )                                    \
-    do {                                                         \
-        volatile unsigned int __seq = *(x);                      \
-        assert( (__seq & SEQUENCE_MASK) != 0 );                  \
-        if ((__seq & SEQUENCE_MASK) > 1) __seq--;                \
-        else __seq += SEQUENCE_MASK;                             \
-        *(x) = __seq;                                            \
-    } while(0)
-
-#else
-
-#define SHARED_WRITE_BEGIN( x )                                         \
-    do {                                                                \
-        assert( (*(x) & SEQUENCE_MASK) != SEQUENCE_MASK );              \
-        if ((__atomic_add_fetch( x, 1, __ATOMIC_RELAXED ) & SEQUENCE_MASK) == 1) \
-            __atomic_thread_fence( __ATOMIC_RELEASE );                  \
-    } while(0)
-
-#define SHARED_WRITE_END( x )                                           \
-    do {                                                                \
-        assert( (*(x) & SEQUENCE_MASK) != 0 );                          \
-        if ((*(x) & SEQUENCE_MASK) > 1)                                 \
-            __atomic_sub_fetch( x, 1, __ATOMIC_RELAXED );               \
-        else {                                                          \
-            __atomic_thread_fence( __ATOMIC_RELEASE );                  \
-            __atomic_add_fetch( x, SEQUENCE_MASK, __ATOMIC_RELAXED );   \
-        }                                                               \
-    } while(0)
-
-#endif
-
 static void queue_hardware_message( struct desktop *desktop, struct message *msg, int always_queue );
 static void free_message( struct message *msg );
 
@@ -314,9 +278,12 @@ static struct thread_input *create_thread_input( struct thread *thread )
         input->shared->cursor       = 0;
         input->shared->cursor_count = 0;
         input->shared->keystate_lock = 0;
+        input->shared->rawinput_count = 0;
+        input->shared->rawinput_dropped = 0;
         memset( (void *)input->shared->keystate, 0, sizeof(input->shared->keystate) );
         SHARED_WRITE_END( &input->shared->seq );
         list_init( &input->msg_list );
+        input->rawinput_count = 0;
         set_caret_window( input, 0 );
 
         if (!(input->desktop = get_thread_desktop( thread, 0 /* FIXME: access rights */ )))
@@ -711,6 +678,49 @@ static inline unsigned int get_unique_post_id(void)
     return id;
 }
 
+/* publish the number of pending WM_INPUT messages of a thread input */
+static void update_rawinput_count( struct thread_input *input, unsigned int dropped )
+{
+    SHARED_WRITE_BEGIN( &input->shared->seq );
+    input->shared->rawinput_count = input->rawinput_count;
+    input->shared->rawinput_dropped += dropped;
+    SHARED_WRITE_END( &input->shared->seq );
+}
+
+/* add a hardware message to a thread input, dropping the oldest WM_INPUT message on overflow */
+static void add_hardware_message( struct thread_input *input, struct message *msg )
+{
+    struct message *oldest;
+    unsigned int dropped = 0;
+
+    if (msg->msg == WM_INPUT && input->rawinput_count >= MAX_RAWINPUT_MESSAGES)
+    {
+        LIST_FOR_EACH_ENTRY( oldest, &input->msg_list, struct message, entry )
+            if (oldest->msg == WM_INPUT) break;
+        list_remove( &oldest->entry );
+        free_message( oldest );
+        input->rawinput_count--;
+        dropped = 1;
+    }
+
+    list_add_tail( &input->msg_list, &msg->entry );
+    if (msg->msg != WM_INPUT) return;
+    input->rawinput_count++;
+    update_rawinput_count( input, dropped );
+}
+
+/* remove a hardware message from a thread input and free it */
+static void remove_hardware_message( struct thread_input *input, struct message *msg )
+{
+    list_remove( &msg->entry );
+    if (msg->msg == WM_INPUT)
+    {
+        input->rawinput_count--;
+        update_rawinput_count( input, 0 );
+    }
+    free_message( msg );
+}
+
 /* try to merge a message with the last in the list; return 1 if successful */
 static int merge_message( struct thread_input *input, const struct message *msg )
 {
@@ -1647,8 +1657,7 @@ static void release_hardware_message( struct msg_queue *queue, unsigned int hw_i
     if (clr_bit) clear_queue_bits( queue, clr_bit );
 
     update_input_key_state( input, msg->msg, msg->wparam );
-    list_remove( &msg->entry );
-    free_message( msg );
+    remove_hardware_message( input, msg );
 }
 
 static int queue_hotkey_message( struct desktop *desktop, struct message *msg )
@@ -1832,7 +1841,7 @@ static void queue_hardware_message( struct desktop *desktop, struct message *msg
     else
     {
         msg->unique_id = 0;  /* will be set once we return it to the app */
-        list_add_tail( &input->msg_list, &msg->entry );
+        add_hardware_message( input, msg );
         set_queue_bits( thread->queue, get_hardware_msg_bit(msg) );
     }
     release_object( thread );
@@ -2438,8 +2447,7 @@ static int get_hardware_message( struct thread *thread, unsigned int hw_id, user
         {
             /* no window at all, remove it */
             update_input_key_state( input, msg->msg, msg->wparam );
-            list_remove( &msg->entry );
-            free_message( msg );
+            remove_hardware_message( input, msg );
             continue;
         }
         if (win_thread != thread)
@@ -2454,8 +2462,7 @@ static int get_hardware_message( struct thread *thread, unsigned int hw_id, user
             {
                 /* for another thread input, drop it */
                 update_input_key_state( input, msg->msg, msg->wparam );
-                list_remove( &msg->entry );
-                free_message( msg );
+                remove_hardware_message( input, msg );
             }
             release_object( win_thread );
             continue;
@@ -3772,8 +3779,7 @@ DECL_HANDLER(get_rawinput_buffer)
         }
 
         memcpy( cur, data, data->size );
-        list_remove( &msg->entry );
-        free_message( msg );
+        remove_hardware_message( input, msg );
 
         size += next_size;
         cur += sizeof(*data);
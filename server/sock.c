@@ -217,6 +217,8 @@ struct sock
     unsigned int        aborted : 1; /* did we get a POLLERR or irregular POLLHUP? */
     unsigned int        nonblocking : 1; /* is the socket nonblocking? */
     unsigned int        bound : 1;   /* is the socket bound? */
+    unsigned int        local_io : 1; /* may the client complete recvs and sends itself? */
+    unsigned int        local_io_index; /* index of the local I/O serial, ~0 if none */
 };
 
 static void sock_dump( struct object *obj, int verbose );
@@ -1427,6 +1429,67 @@ static int sock_close_handle( struct object *obj, struct process *process, obj_h
     return 1;
 }
 
+/* Returns whether synchronous recv and send calls on the socket may complete in
+ * the client without a server call. They only clear the reported read or write
+ * event, which makes no difference unless events are selected for the socket.
+ * Datagram sockets need to be bound already, since send binds them implicitly. */
+static int sock_local_io( const struct sock *sock )
+{
+    if (sock->type == WS_SOCK_DGRAM && !sock->bound) return 0;
+    return sock->nonblocking && !sock->mask && !sock->window && !sock->rd_shutdown && !sock->wr_shutdown;
+}
+
+/* shared memory serials of the sockets which allow recvs and sends in the client */
+static struct object *local_io_mapping;
+static volatile unsigned int *local_io_serials;
+static unsigned int local_io_free[MAX_SOCKET_LOCAL_IO_SERIALS];
+static unsigned int local_io_free_count;
+static unsigned int local_io_used;
+
+static unsigned int alloc_local_io_index(void)
+{
+    static const WCHAR nameW[] = {'s','o','c','k','e','t','s'};
+    static const struct unicode_str name = {nameW, sizeof(nameW)};
+    struct object *dir;
+
+    if (!local_io_mapping)
+    {
+        if (!(dir = create_thread_map_directory())) return ~0u;
+        local_io_mapping = create_shared_mapping( dir, &name,
+                                                  MAX_SOCKET_LOCAL_IO_SERIALS * sizeof(*local_io_serials),
+                                                  NULL, (void **)&local_io_serials );
+        release_object( dir );
+        if (!local_io_mapping) return ~0u;
+        make_object_permanent( local_io_mapping );
+    }
+    if (local_io_free_count) return local_io_free[--local_io_free_count];
+    if (local_io_used < MAX_SOCKET_LOCAL_IO_SERIALS) return local_io_used++;
+    return ~0u;
+}
+
+/* Let the client complete recvs and sends on the socket for as long as the
+ * returned serial doesn't change. Returns the serial index plus one, or 0. */
+static unsigned int sock_grant_local_io( struct sock *sock, unsigned int *serial )
+{
+    *serial = 0;
+    if (!sock_local_io( sock )) return 0;
+    if (sock->local_io_index == ~0u && (sock->local_io_index = alloc_local_io_index()) == ~0u) return 0;
+    sock->local_io = 1;
+    *serial = local_io_serials[sock->local_io_index];
+    return sock->local_io_index + 1;
+}
+
+/* Must be called before changing any of the state checked by sock_local_io(),
+ * through whichever handle of the socket. */
+static void sock_revoke_local_io( struct sock *sock )
+{
+    if (!sock->local_io) return;
+    sock->local_io = 0;
+    local_io_serials[sock->local_io_index]++;
+    /* recvs and sends completed in the client didn't reset the reported events */
+    sock->reported_events &= ~(AFD_POLL_READ | AFD_POLL_WRITE);
+}
+
 static void sock_destroy( struct object *obj )
 {
     struct sock *sock = (struct sock *)obj;
@@ -1447,6 +1510,8 @@ static void sock_destroy( struct object *obj )
     free_async_queue( &sock->connect_q );
     free_async_queue( &sock->poll_q );
     if (sock->event) release_object( sock->event );
+    sock_revoke_local_io( sock );
+    if (sock->local_io_index != ~0u) local_io_free[local_io_free_count++] = sock->local_io_index;
     if (sock->fd)
     {
         /* shut the socket down to force pending poll() calls in the client to return */
@@ -1488,6 +1553,8 @@ static struct sock *create_socket(void)
     sock->aborted = 0;
     sock->nonblocking = 0;
     sock->bound = 0;
+    sock->local_io = 0;
+    sock->local_io_index = ~0u;
     sock->rcvbuf = 0;
     sock->sndbuf = 0;
     sock->rcvtimeo = 0;
@@ -1786,6 +1853,7 @@ static int accept_into_socket( struct sock *sock, struct sock *acceptsock )
             return FALSE;
     }
 
+    sock_revoke_local_io( acceptsock );
     acceptsock->state = SOCK_CONNECTED;
     acceptsock->pending_events = 0;
     acceptsock->reported_events = 0;
@@ -2403,6 +2471,7 @@ static void sock_ioctl( struct fd *fd, ioctl_code_t code, struct async *async )
             return;
         }
 
+        sock_revoke_local_io( sock );
         if (how != SD_SEND)
         {
             sock->rd_shutdown = 1;
@@ -2457,6 +2526,7 @@ static void sock_ioctl( struct fd *fd, ioctl_code_t code, struct async *async )
             set_error( STATUS_BUFFER_TOO_SMALL );
             return;
         }
+        sock_revoke_local_io( sock );
         if (*(int *)get_req_data())
         {
             sock->nonblocking = 1;
@@ -2536,6 +2606,7 @@ static void sock_ioctl( struct fd *fd, ioctl_code_t code, struct async *async )
             return;
         }
 
+        sock_revoke_local_io( sock );
         if (sock->event) release_object( sock->event );
         sock->event = event;
         sock->mask = mask;
@@ -2564,6 +2635,7 @@ static void sock_ioctl( struct fd *fd, ioctl_code_t code, struct async *async )
             return;
         }
 
+        sock_revoke_local_io( sock );
         if (sock->event) release_object( sock->event );
 
         if (params->window)
@@ -3456,6 +3528,7 @@ DECL_HANDLER(recv_socket)
 
         reply->wait = async_handoff( async, NULL, 0 );
         reply->options = get_fd_options( fd );
+        reply->local_io = sock_grant_local_io( sock, &reply->local_io_serial );
         release_object( async );
     }
     release_object( sock );
@@ -3536,6 +3609,7 @@ DECL_HANDLER(send_socket)
 
         reply->wait = async_handoff( async, NULL, 0 );
         reply->options = get_fd_options( fd );
+        reply->local_io = sock_grant_local_io( sock, &reply->local_io_serial );
         release_object( async );
     }
     release_object( sock );
@@ -976,6 +976,46 @@ static void dump_varargs_cursor_positions( const char *prefix, data_size_t size
     remove_data( size );
 }
 
+static void dump_varargs_window_positions( const char *prefix, data_size_t size )
+{
+    const window_pos_t *pos = cur_data;
+    data_size_t len = size / sizeof(*pos);
+
+    fprintf( stderr, "%s{", prefix );
+    while (len > 0)
+    {
+        fprintf( stderr, "{handle=%08x,previous=%08x,swp_flags=%04x,paint_flags=%04x",
+                 pos->handle, pos->previous, pos->swp_flags, pos->paint_flags );
+        dump_rectangle( ",window=", &pos->window );
+        dump_rectangle( ",client=", &pos->client );
+        if (pos->rect_count > 0) dump_rectangle( ",visible=", &pos->extra[0] );
+        if (pos->rect_count > 1) dump_rectangle( ",surface=", &pos->extra[1] );
+        if (pos->rect_count > 2) dump_rectangle( ",valid=", &pos->extra[2] );
+        fputc( '}', stderr );
+        pos++;
+        if (--len) fputc( ',', stderr );
+    }
+    fputc( '}', stderr );
+    remove_data( size );
+}
+
+static void dump_varargs_window_pos_results( const char *prefix, data_size_t size )
+{
+    const window_pos_result_t *res = cur_data;
+    data_size_t len = size / sizeof(*res);
+
+    fprintf( stderr, "%s{", prefix );
+    while (len > 0)
+    {
+        fprintf( stderr, "{status=%08x,new_style=%08x,new_ex_style=%08x,surface_win=%08x,needs_update=%d}",
+                 res->status, res->new_style, res->new_ex_style, res->surface_win, res->needs_update );
+        res++;
+        if (--len) fputc( ',', stderr );
+    }
+    fputc( '}', stderr );
+    remove_data( size );
+}
+
 static void dump_varargs_message_data( const char *prefix, data_size_t size )
 {
     /* FIXME: dump the structured data */
@@ -2060,6 +2100,8 @@ static void dump_recv_socket_reply( const struct recv_socket_reply *req )
 {
     fprintf( stderr, " wait=%04x", req->wait );
     fprintf( stderr, ", options=%08x", req->options );
+    fprintf( stderr, ", local_io=%08x", req->local_io );
+    fprintf( stderr, ", local_io_serial=%08x", req->local_io_serial );
 }
 
 static void dump_send_socket_request( const struct send_socket_request *req )
@@ -2073,6 +2115,8 @@ static void dump_send_socket_reply( const struct send_socket_reply *req )
 {
     fprintf( stderr, " wait=%04x", req->wait );
     fprintf( stderr, ", options=%08x", req->options );
+    fprintf( stderr, ", local_io=%08x", req->local_io );
+    fprintf( stderr, ", local_io_serial=%08x", req->local_io_serial );
 }
 
 static void dump_get_next_console_request_request( const struct get_next_console_request_request *req )
@@ -3034,6 +3078,16 @@ static void dump_set_window_pos_reply( const struct set_window_pos_reply *req )
     fprintf( stderr, ", needs_update=%d", req->needs_update );
 }
 
+static void dump_set_window_pos_list_request( const struct set_window_pos_list_request *req )
+{
+    dump_varargs_window_positions( " windows=", cur_size );
+}
+
+static void dump_set_window_pos_list_reply( const struct set_window_pos_list_reply *req )
+{
+    dump_varargs_window_pos_results( " results=", cur_size );
+}
+
 static void dump_get_window_rectangles_request( const struct get_window_rectangles_request *req )
 {
     fprintf( stderr, " handle=%08x", req->handle );
@@ -4756,6 +4810,7 @@ static const dump_func req_dumpers[REQ_NB_REQUESTS] = {
     (dump_func)dump_get_window_children_from_point_request,
     (dump_func)dump_get_window_tree_request,
     (dump_func)dump_set_window_pos_request,
+    (dump_func)dump_set_window_pos_list_request,
     (dump_func)dump_get_window_rectangles_request,
     (dump_func)dump_get_window_text_request,
     (dump_func)dump_set_window_text_request,
@@ -5045,6 +5100,7 @@ static const dump_func reply_dumpers[REQ_NB_REQUESTS] = {
     (dump_func)dump_get_window_children_from_point_reply,
     (dump_func)dump_get_window_tree_reply,
     (dump_func)dump_set_window_pos_reply,
+    (dump_func)dump_set_window_pos_list_reply,
     (dump_func)dump_get_window_rectangles_reply,
     (dump_func)dump_get_window_text_reply,
     NULL,
@@ -5334,6 +5390,7 @@ static const char * const req_names[REQ_NB_REQUESTS] = {
     "get_window_children_from_point",
     "get_window_tree",
     "set_window_pos",
+    "set_window_pos_list",
     "get_window_rectangles",
     "get_window_text",
     "set_window_text",
@@ -32,6 +32,7 @@
 #include "winternl.h"
 
 #include "object.h"
+#include "file.h"
 #include "request.h"
 #include "thread.h"
 #include "process.h"
@@ -54,6 +55,17 @@ enum property_type
 };
 
 
+/* cached visible region of a window */
+struct visible_region_cache
+{
+    struct region   *region;          /* cached region (relative to window rect) */
+    unsigned int     flags;           /* DCX_* flags used to compute it */
+    unsigned int     tree_gen;        /* clip generation of the top-level window tree */
+    unsigned int     desktop_gen;     /* clip generation of the desktop windows */
+};
+
+#define VISIBLE_REGION_CACHE_SIZE 2
+
 struct window
 {
     struct window   *parent;          /* parent window */
@@ -90,6 +102,8 @@ struct window
     WCHAR           *text;            /* window caption text */
     data_size_t      text_len;        /* length of window caption */
     unsigned int     paint_flags;     /* various painting flags */
+    unsigned int     clip_gen;        /* clip generation of the window tree (top-level windows only) */
+    struct visible_region_cache vis_cache[VISIBLE_REGION_CACHE_SIZE]; /* cached visible regions */
     int              prop_inuse;      /* number of in-use window properties */
     int              prop_alloc;      /* number of allocated window properties */
     struct property *properties;      /* window properties array */
@@ -124,6 +138,16 @@ static struct window *shell_listview;
 static struct window *progman_window;
 static struct window *taskman_window;
 
+/* window state shared with the clients, indexed by user handle */
+static struct object *window_shared_mapping;
+static volatile struct window_shared_memory *window_shared;
+
+/* visible region cache generations and statistics */
+static unsigned int clip_generation;
+static unsigned int desktop_clip_gen;
+static unsigned int vis_cache_hits;
+static unsigned int vis_cache_misses;
+
 /* magic HWND_TOP etc. pointers */
 #define WINPTR_TOP       ((struct window *)1L)
 #define WINPTR_BOTTOM    ((struct window *)2L)
@@ -188,6 +212,85 @@ static unsigned int get_monitor_dpi( struct window *win )
     return win->dpi ? win->dpi : USER_DEFAULT_SCREEN_DPI;
 }
 
+/* retrieve the shared memory entry of a window, creating the mapping if needed */
+static volatile struct window_shared_memory *get_window_shared( user_handle_t handle )
+{
+    static const WCHAR nameW[] = {'w','i','n','d','o','w','s'};
+    static const struct unicode_str name = {nameW, sizeof(nameW)};
+    struct object *dir;
+
+    if (!window_shared_mapping)
+    {
+        if (!(dir = create_thread_map_directory())) return NULL;
+        window_shared_mapping = create_shared_mapping( dir, &name,
+                                                       MAX_WINDOW_SHARED_ENTRIES * sizeof(*window_shared),
+                                                       NULL, (void **)&window_shared );
+        release_object( dir );
+        if (!window_shared_mapping) return NULL;
+        make_object_permanent( window_shared_mapping );
+    }
+    return &window_shared[((handle & 0xffff) - FIRST_USER_HANDLE) >> 1];
+}
+
+/* publish the window state to the shared memory */
+static void update_window_shared( struct window *win )
+{
+    volatile struct window_shared_memory *shared;
+
+    if (!(shared = get_window_shared( win->handle ))) return;
+
+    SHARED_WRITE_BEGIN( &shared->seq );
+    shared->handle      = win->handle;
+    shared->parent      = win->parent ? win->parent->handle : 0;
+    shared->tid         = win->thread ? get_thread_id( win->thread ) : 0;
+    shared->pid         = win->thread ? get_process_id( win->thread->process ) : 0;
+    shared->style       = win->style;
+    shared->ex_style    = win->ex_style;
+    shared->dpi         = win->dpi;
+    shared->window_rect = win->window_rect;
+    shared->client_rect = win->client_rect;
+    SHARED_WRITE_END( &shared->seq );
+}
+
+/* remove a destroyed window from the shared memory */
+static void clear_window_shared( struct window *win )
+{
+    volatile struct window_shared_memory *shared;
+
+    if (!(shared = get_window_shared( win->handle ))) return;
+
+    SHARED_WRITE_BEGIN( &shared->seq );
+    shared->handle = 0;
+    SHARED_WRITE_END( &shared->seq );
+}
+
+/* get the window whose clip generation covers a given window */
+static inline struct window *get_clip_root( struct window *win )
+{
+    while (win->parent && !is_desktop_window( win->parent )) win = win->parent;
+    return win;
+}
+
+/* invalidate the cached visible regions that may depend on the given window */
+/* top-level siblings don't clip each other, so only the window tree is affected */
+static void invalidate_visible_regions( struct window *win )
+{
+    if (is_desktop_window( win )) desktop_clip_gen = ++clip_generation;
+    else get_clip_root( win )->clip_gen = ++clip_generation;
+}
+
+/* free the cached visible regions of a window */
+static void free_visible_region_cache( struct window *win )
+{
+    int i;
+
+    for (i = 0; i < VISIBLE_REGION_CACHE_SIZE; i++)
+    {
+        if (win->vis_cache[i].region) free_region( win->vis_cache[i].region );
+        win->vis_cache[i].region = NULL;
+    }
+}
+
 /* link a window at the right place in the siblings list */
 static void link_window( struct window *win, struct window *previous )
 {
@@ -241,6 +344,8 @@ static void link_window( struct window *win, struct window *previous )
     }
 
     win->is_linked = 1;
+    invalidate_visible_regions( win );
+    update_window_shared( win );
 }
 
 /* change the parent of a window (or unlink the window if the new parent is NULL) */
@@ -258,6 +363,9 @@ static int set_parent_window( struct window *win, struct window *parent )
         }
     }
 
+    /* the window leaves its current tree */
+    if (win->is_linked) invalidate_visible_regions( win );
+
     if (parent)
     {
         win->parent = parent;
@@ -283,6 +391,7 @@ static int set_parent_window( struct window *win, struct window *parent )
         list_add_head( &win->parent->unlinked, &win->entry );
         win->is_linked = 0;
     }
+    update_window_shared( win );
     return 1;
 }
 
@@ -421,6 +530,7 @@ static void detach_window_thread( struct window *win )
     /* destroyed when the desktop ref count reaches zero */
     release_object( win->desktop );
     win->thread = NULL;
+    update_window_shared( win );
 }
 
 /* get the process owning the top window of a given desktop */
@@ -510,11 +620,13 @@ static struct window *create_window( struct window *parent, struct window *owner
     win->text           = NULL;
     win->text_len       = 0;
     win->paint_flags    = 0;
+    win->clip_gen       = 0;
     win->prop_inuse     = 0;
     win->prop_alloc     = 0;
     win->properties     = NULL;
     win->nb_extra_bytes = extra_bytes;
     win->window_rect = win->visible_rect = win->surface_rect = win->client_rect = empty_rect;
+    memset( win->vis_cache, 0, sizeof(win->vis_cache) );
     memset( win->extra_bytes, 0, extra_bytes );
     list_init( &win->children );
     list_init( &win->unlinked );
@@ -549,6 +661,7 @@ static struct window *create_window( struct window *parent, struct window *owner
     }
 
     current->desktop_users++;
+    update_window_shared( win );
     return win;
 
 failed:
@@ -1022,7 +1135,7 @@ static inline struct window *get_top_clipping_window( struct window *win )
 
 
 /* compute the visible region of a window, in window coordinates */
-static struct region *get_visible_region( struct window *win, unsigned int flags )
+static struct region *compute_visible_region( struct window *win, unsigned int flags )
 {
     struct region *tmp = NULL, *region;
     int offset_x, offset_y;
@@ -1101,6 +1214,58 @@ error:
 }
 
 
+/* get the visible region of a window, in window coordinates, using the cache when possible */
+static struct region *get_visible_region( struct window *win, unsigned int flags )
+{
+    struct visible_region_cache *cache, *slot = NULL;
+    unsigned int tree_gen = get_clip_root( win )->clip_gen;
+    struct region *region;
+    int i;
+
+    flags &= DCX_WINDOW | DCX_CLIPCHILDREN | DCX_PARENTCLIP;
+
+    for (i = 0; i < VISIBLE_REGION_CACHE_SIZE; i++)
+    {
+        cache = &win->vis_cache[i];
+        if (!cache->region || cache->tree_gen != tree_gen || cache->desktop_gen != desktop_clip_gen)
+        {
+            if (!slot) slot = cache;  /* stale entry, reuse it */
+            continue;
+        }
+        if (cache->flags != flags) continue;
+
+        vis_cache_hits++;
+        if (!(region = create_empty_region())) return NULL;
+        if (copy_region( region, cache->region )) return region;
+        free_region( region );
+        return NULL;
+    }
+
+    vis_cache_misses++;
+    if (debug_level > 1 && !((vis_cache_hits + vis_cache_misses) % 4096))
+        fprintf( stderr, "%04x: visible region cache: %u hits, %u misses\n",
+                 current ? current->id : 0, vis_cache_hits, vis_cache_misses );
+
+    if (!(region = compute_visible_region( win, flags ))) return NULL;
+
+    /* all the entries are valid, evict the last one */
+    if (!slot) slot = &win->vis_cache[VISIBLE_REGION_CACHE_SIZE - 1];
+    if (slot->region) free_region( slot->region );
+
+    if (!(slot->region = create_empty_region()) || !copy_region( slot->region, region ))
+    {
+        if (slot->region) free_region( slot->region );
+        slot->region = NULL;
+        clear_error();  /* caching is best effort */
+        return region;
+    }
+    slot->flags = flags;
+    slot->tree_gen = tree_gen;
+    slot->desktop_gen = desktop_clip_gen;
+    return region;
+}
+
+
 /* clip all children with a custom pixel format out of the visible region */
 static struct region *clip_pixel_format_children( struct window *parent, struct region *parent_clip,
                                                   struct region *region, int offset_x, int offset_y )
@@ -1633,10 +1798,17 @@ static unsigned int get_window_update_flags( struct window *win, struct window *
 }
 
 
+/* parent area exposed by a batch of window position changes, redrawn once at the end */
+struct parent_expose
+{
+    struct window *parent;
+    struct region *region;   /* in parent client coordinates */
+};
+
 /* expose the areas revealed by a vis region change on the window parent */
 /* returns the region exposed on the window itself (in client coordinates) */
 static struct region *expose_window( struct window *win, const rectangle_t *old_window_rect,
-                                     struct region *old_vis_rgn )
+                                     struct region *old_vis_rgn, struct parent_expose *parent_expose )
 {
     struct region *new_vis_rgn, *exposed_rgn;
 
@@ -1671,48 +1843,78 @@ static struct region *expose_window( struct window *win, const rectangle_t *old_
             {
                 /* make it relative to parent */
                 offset_region( new_vis_rgn, old_window_rect->left, old_window_rect->top );
-                redraw_window( win->parent, new_vis_rgn, 0, RDW_INVALIDATE | RDW_ERASE | RDW_ALLCHILDREN );
+                if (!parent_expose || parent_expose->parent != win->parent)
+                    redraw_window( win->parent, new_vis_rgn, 0, RDW_INVALIDATE | RDW_ERASE | RDW_ALLCHILDREN );
+                else if (!parent_expose->region)
+                {
+                    parent_expose->region = new_vis_rgn;
+                    new_vis_rgn = NULL;
+                }
+                else union_region( parent_expose->region, parent_expose->region, new_vis_rgn );
             }
         }
     }
-    free_region( new_vis_rgn );
+    if (new_vis_rgn) free_region( new_vis_rgn );
     return exposed_rgn;
 }
 
 
-/* set the window and client rectangles, updating the update region if necessary */
-static void set_window_pos( struct window *win, struct window *previous,
-                            unsigned int swp_flags, const rectangle_t *window_rect,
-                            const rectangle_t *client_rect, const rectangle_t *visible_rect,
-                            const rectangle_t *surface_rect, const rectangle_t *valid_rect )
-{
-    struct region *old_vis_rgn = NULL, *exposed_rgn = NULL;
-    const rectangle_t old_window_rect = win->window_rect;
-    const rectangle_t old_visible_rect = win->visible_rect;
-    const rectangle_t old_client_rect = win->client_rect;
-    rectangle_t rect;
-    int client_changed, frame_changed;
-    int visible = (win->style & WS_VISIBLE) || (swp_flags & SWP_SHOWWINDOW);
+/* a window position change; it is applied in stages so that batches can
+ * move all their windows before doing any of the exposure work */
+struct window_pos_change
+{
+    struct window  *win;
+    struct window  *previous;
+    unsigned int    swp_flags;
+    rectangle_t     window_rect;
+    rectangle_t     client_rect;
+    rectangle_t     visible_rect;
+    rectangle_t     surface_rect;
+    rectangle_t     valid_rect;
+    rectangle_t     old_window_rect;
+    rectangle_t     old_visible_rect;
+    rectangle_t     old_client_rect;
+    struct region  *old_vis_rgn;
+    int             visible;
+};
+
+/* save the window state needed to expose the areas revealed by the change */
+static int begin_window_pos( struct window_pos_change *change )
+{
+    struct window *win = change->win;
+
+    change->old_window_rect  = win->window_rect;
+    change->old_visible_rect = win->visible_rect;
+    change->old_client_rect  = win->client_rect;
+    change->old_vis_rgn = NULL;
+    change->visible = (win->style & WS_VISIBLE) || (change->swp_flags & SWP_SHOWWINDOW);
 
-    if (win->parent && !is_visible( win->parent )) visible = 0;
+    if (win->parent && !is_visible( win->parent )) change->visible = 0;
 
-    if (visible && !(old_vis_rgn = get_visible_region( win, DCX_WINDOW ))) return;
+    if (change->visible && !(change->old_vis_rgn = get_visible_region( win, DCX_WINDOW ))) return 0;
+    return 1;
+}
 
-    /* set the new window info before invalidating anything */
+/* set the new window rectangles and Z order */
+static void move_window_pos( struct window_pos_change *change )
+{
+    struct window *win = change->win;
+    unsigned int swp_flags = change->swp_flags;
 
-    win->window_rect  = *window_rect;
-    win->visible_rect = *visible_rect;
-    win->surface_rect = *surface_rect;
-    win->client_rect  = *client_rect;
-    if (!(swp_flags & SWP_NOZORDER) && win->parent) link_window( win, previous );
+    win->window_rect  = change->window_rect;
+    win->visible_rect = change->visible_rect;
+    win->surface_rect = change->surface_rect;
+    win->client_rect  = change->client_rect;
+    if (!(swp_flags & SWP_NOZORDER) && win->parent) link_window( win, change->previous );
     if (swp_flags & SWP_SHOWWINDOW) win->style |= WS_VISIBLE;
     else if (swp_flags & SWP_HIDEWINDOW) win->style &= ~WS_VISIBLE;
+    invalidate_visible_regions( win );
 
     /* keep children at the same position relative to top right corner when the parent is mirrored */
     if (win->ex_style & WS_EX_LAYOUTRTL)
     {
         struct window *child;
-        int old_size = old_client_rect.right - old_client_rect.left;
+        int old_size = change->old_client_rect.right - change->old_client_rect.left;
         int new_size = win->client_rect.right - win->client_rect.left;
 
         if (old_size != new_size) LIST_FOR_EACH_ENTRY( child, &win->children, struct window, entry )
@@ -1721,19 +1923,40 @@ static void set_window_pos( struct window *win, struct window *previous,
             offset_rect( &child->visible_rect, new_size - old_size, 0 );
             offset_rect( &child->surface_rect, new_size - old_size, 0 );
             offset_rect( &child->client_rect, new_size - old_size, 0 );
+            update_window_shared( child );
         }
     }
+    update_window_shared( win );
 
     /* reset cursor clip rectangle when the desktop changes size */
     if (win == win->desktop->top_window) set_clip_rectangle( win->desktop, NULL, 0 );
+}
+
+/* update the update regions once the new window rectangles are set */
+static void end_window_pos( struct window_pos_change *change, struct parent_expose *parent_expose )
+{
+    struct window *win = change->win;
+    struct region *old_vis_rgn = change->old_vis_rgn, *exposed_rgn = NULL;
+    const rectangle_t old_window_rect = change->old_window_rect;
+    const rectangle_t old_visible_rect = change->old_visible_rect;
+    const rectangle_t old_client_rect = change->old_client_rect;
+    const rectangle_t *window_rect = &change->window_rect;
+    const rectangle_t *client_rect = &change->client_rect;
+    const rectangle_t *visible_rect = &change->visible_rect;
+    const rectangle_t *valid_rect = &change->valid_rect;
+    unsigned int swp_flags = change->swp_flags;
+    rectangle_t rect;
+    int client_changed, frame_changed;
+
+    change->old_vis_rgn = NULL;
 
     /* if the window is not visible, everything is easy */
-    if (!visible) return;
+    if (!change->visible) return;
 
     /* expose anything revealed by the change */
 
     if (!(swp_flags & SWP_NOREDRAW))
-        exposed_rgn = expose_window( win, &old_window_rect, old_vis_rgn );
+        exposed_rgn = expose_window( win, &old_window_rect, old_vis_rgn, parent_expose );
 
     if (!(win->style & WS_VISIBLE))
     {
@@ -1849,6 +2072,14 @@ done:
     clear_error();  /* we ignore out of memory errors once the new rects have been set */
 }
 
+/* set the window and client rectangles, updating the update region if necessary */
+static void set_window_pos( struct window_pos_change *change )
+{
+    if (!begin_window_pos( change )) return;
+    move_window_pos( change );
+    end_window_pos( change, NULL );
+}
+
 
 /* set the window region, updating the update region if necessary */
 static void set_window_region( struct window *win, struct region *region, int redraw )
@@ -1862,9 +2093,10 @@ static void set_window_region( struct window *win, struct region *region, int re
 
     if (win->win_region) free_region( win->win_region );
     win->win_region = region;
+    invalidate_visible_regions( win );
 
     /* expose anything revealed by the change */
-    if (old_vis_rgn && ((exposed_rgn = expose_window( win, &win->window_rect, old_vis_rgn ))))
+    if (old_vis_rgn && ((exposed_rgn = expose_window( win, &win->window_rect, old_vis_rgn, NULL ))))
     {
         redraw_window( win, exposed_rgn, 1, RDW_INVALIDATE | RDW_ERASE | RDW_FRAME | RDW_ALLCHILDREN );
         free_region( exposed_rgn );
@@ -1891,9 +2123,10 @@ void destroy_window( struct window *win )
     {
         struct region *vis_rgn = get_visible_region( win, DCX_WINDOW );
         win->style &= ~WS_VISIBLE;
+        invalidate_visible_regions( win );
         if (vis_rgn)
         {
-            struct region *exposed_rgn = expose_window( win, &win->window_rect, vis_rgn );
+            struct region *exposed_rgn = expose_window( win, &win->window_rect, vis_rgn, NULL );
             if (exposed_rgn) free_region( exposed_rgn );
             free_region( vis_rgn );
         }
@@ -1915,8 +2148,11 @@ void destroy_window( struct window *win )
     free_hotkeys( win->desktop, win->handle );
     free_touches( win->desktop, win->handle );
     cleanup_clipboard_window( win->desktop, win->handle );
+    clear_window_shared( win );
     free_user_handle( win->handle );
     destroy_properties( win );
+    if (win->is_linked) invalidate_visible_regions( win );
+    free_visible_region_cache( win );
     list_remove( &win->entry );
     if (is_desktop_window(win))
     {
@@ -1982,6 +2218,8 @@ DECL_HANDLER(create_window)
     }
     win->style = req->style;
     win->ex_style = req->ex_style;
+    invalidate_visible_regions( win );
+    update_window_shared( win );
 
     reply->handle    = win->handle;
     reply->parent    = win->parent ? win->parent->handle : 0;
@@ -2044,6 +2282,8 @@ DECL_HANDLER(get_desktop_window)
         {
             detach_window_thread( desktop->top_window );
             desktop->top_window->style  = WS_POPUP | WS_VISIBLE | WS_CLIPSIBLINGS | WS_CLIPCHILDREN;
+            invalidate_visible_regions( desktop->top_window );
+            update_window_shared( desktop->top_window );
         }
     }
 
@@ -2056,6 +2296,8 @@ DECL_HANDLER(get_desktop_window)
         {
             detach_window_thread( desktop->msg_window );
             desktop->msg_window->style = WS_POPUP | WS_CLIPSIBLINGS | WS_CLIPCHILDREN;
+            invalidate_visible_regions( desktop->msg_window );
+            update_window_shared( desktop->msg_window );
         }
     }
 
@@ -2163,6 +2405,12 @@ DECL_HANDLER(set_window_info)
     if (req->flags & SET_WIN_EXTRA) memcpy( win->extra_bytes + req->extra_offset,
                                             &req->extra_value, req->extra_size );
 
+    if (req->flags & (SET_WIN_STYLE | SET_WIN_EXSTYLE))
+    {
+        invalidate_visible_regions( win );
+        update_window_shared( win );
+    }
+
     /* changing window style triggers a non-client paint */
     if (req->flags & SET_WIN_STYLE) win->paint_flags |= PAINT_NONCLIENT;
 }
@@ -2293,21 +2541,22 @@ DECL_HANDLER(get_window_tree)
 }
 
 
-/* set the position and Z order of a window */
-DECL_HANDLER(set_window_pos)
+/* validate a window position change; helper for set_window_pos and set_window_pos_list */
+static int prepare_window_pos( user_handle_t handle, user_handle_t prev_handle, unsigned int flags,
+                               unsigned int paint_flags, const rectangle_t *window, const rectangle_t *client,
+                               const rectangle_t *extra_rects, unsigned int rect_count,
+                               struct window_pos_change *change )
 {
     rectangle_t window_rect, client_rect, visible_rect, surface_rect, valid_rect;
-    const rectangle_t *extra_rects = get_req_data();
     struct window *previous = NULL;
-    struct window *top, *win = get_window( req->handle );
-    unsigned int flags = req->swp_flags;
+    struct window *win = get_window( handle );
 
-    if (!win) return;
+    if (!win) return 0;
     if (!win->parent) flags |= SWP_NOZORDER;  /* no Z order for the desktop */
 
     if (!(flags & SWP_NOZORDER))
     {
-        switch ((int)req->previous)
+        switch ((int)prev_handle)
         {
         case 0:   /* HWND_TOP */
             previous = WINPTR_TOP;
@@ -2322,12 +2571,12 @@ DECL_HANDLER(set_window_pos)
             previous = WINPTR_NOTOPMOST;
             break;
         default:
-            if (!(previous = get_window( req->previous ))) return;
+            if (!(previous = get_window( prev_handle ))) return 0;
             /* previous must be a sibling */
             if (previous->parent != win->parent)
             {
                 set_error( STATUS_INVALID_PARAMETER );
-                return;
+                return 0;
             }
             break;
         }
@@ -2338,19 +2587,19 @@ DECL_HANDLER(set_window_pos)
     if ((win->ex_style & WS_EX_LAYERED) && !win->is_layered) flags |= SWP_NOREDRAW;
 
     /* window rectangle must be ordered properly */
-    if (req->window.right < req->window.left || req->window.bottom < req->window.top)
+    if (window->right < window->left || window->bottom < window->top)
     {
         set_error( STATUS_INVALID_PARAMETER );
-        return;
+        return 0;
     }
 
-    window_rect = req->window;
-    client_rect = req->client;
-    if (get_req_data_size() >= sizeof(rectangle_t)) visible_rect = extra_rects[0];
+    window_rect = *window;
+    client_rect = *client;
+    if (rect_count >= 1) visible_rect = extra_rects[0];
     else visible_rect = window_rect;
-    if (get_req_data_size() >= 2 * sizeof(rectangle_t)) surface_rect = extra_rects[1];
+    if (rect_count >= 2) surface_rect = extra_rects[1];
     else surface_rect = visible_rect;
-    if (get_req_data_size() >= 3 * sizeof(rectangle_t)) valid_rect = extra_rects[2];
+    if (rect_count >= 3) valid_rect = extra_rects[2];
     else valid_rect = empty_rect;
     if (win->parent && win->parent->ex_style & WS_EX_LAYOUTRTL)
     {
@@ -2361,21 +2610,170 @@ DECL_HANDLER(set_window_pos)
         mirror_rect( &win->parent->client_rect, &valid_rect );
     }
 
-    win->paint_flags = (win->paint_flags & ~PAINT_CLIENT_FLAGS) | (req->paint_flags & PAINT_CLIENT_FLAGS);
+    win->paint_flags = (win->paint_flags & ~PAINT_CLIENT_FLAGS) | (paint_flags & PAINT_CLIENT_FLAGS);
     if (win->paint_flags & PAINT_HAS_PIXEL_FORMAT) update_pixel_format_flags( win );
 
-    set_window_pos( win, previous, flags, &window_rect, &client_rect,
-                    &visible_rect, &surface_rect, &valid_rect );
+    change->win          = win;
+    change->previous     = previous;
+    change->swp_flags    = flags;
+    change->window_rect  = window_rect;
+    change->client_rect  = client_rect;
+    change->visible_rect = visible_rect;
+    change->surface_rect = surface_rect;
+    change->valid_rect   = valid_rect;
+    return 1;
+}
+
 
-    reply->new_style = win->style;
-    reply->new_ex_style = win->ex_style;
+/* fill the result of a window position change */
+static void get_window_pos_result( struct window *win, window_pos_result_t *result )
+{
+    struct window *top;
+
+    result->new_style = win->style;
+    result->new_ex_style = win->ex_style;
 
     top = get_top_clipping_window( win );
     if (is_visible( top ) && (top->paint_flags & PAINT_HAS_SURFACE))
     {
-        reply->surface_win = top->handle;
-        reply->needs_update = !!(top->paint_flags & (PAINT_HAS_PIXEL_FORMAT | PAINT_PIXEL_FORMAT_CHILD));
+        result->surface_win = top->handle;
+        result->needs_update = !!(top->paint_flags & (PAINT_HAS_PIXEL_FORMAT | PAINT_PIXEL_FORMAT_CHILD));
+    }
+}
+
+
+/* check whether a window position change conflicts with the pending changes of a batch */
+static int is_window_pos_pending( const struct window_pos_change *changes, data_size_t count,
+                                  const struct window *win )
+{
+    const struct window *ptr;
+    data_size_t i;
+
+    for (i = 0; i < count; i++)
+    {
+        if (!changes[i].win) continue;
+        if (changes[i].win == win) return 1;
+        /* siblings don't change each other's visibility or position */
+        if (changes[i].win->parent == win->parent) continue;
+        for (ptr = win->parent; ptr; ptr = ptr->parent) if (ptr == changes[i].win) return 1;
+        for (ptr = changes[i].win->parent; ptr; ptr = ptr->parent) if (ptr == win) return 1;
+    }
+    return 0;
+}
+
+
+/* apply a batch of window position changes; all the windows are moved first,
+ * then the exposed areas are computed against the final window tree, and the
+ * areas exposed on their common parent are redrawn once */
+static void apply_window_pos_batch( struct window_pos_change *changes, data_size_t count,
+                                    window_pos_result_t *results )
+{
+    struct parent_expose parent_expose = { NULL, NULL };
+    data_size_t i;
+
+    for (i = 0; i < count; i++)
+        if (changes[i].win) move_window_pos( &changes[i] );
+
+    for (i = 0; i < count; i++)
+    {
+        if (!changes[i].win) continue;
+        if (!parent_expose.parent) parent_expose.parent = changes[i].win->parent;
+        end_window_pos( &changes[i], &parent_expose );
+        get_window_pos_result( changes[i].win, &results[i] );
+    }
+
+    if (parent_expose.region)
+    {
+        redraw_window( parent_expose.parent, parent_expose.region, 0,
+                       RDW_INVALIDATE | RDW_ERASE | RDW_ALLCHILDREN );
+        free_region( parent_expose.region );
+    }
+}
+
+
+/* set the position and Z order of a window */
+DECL_HANDLER(set_window_pos)
+{
+    struct window_pos_change change;
+    window_pos_result_t result;
+
+    memset( &result, 0, sizeof(result) );
+    if (prepare_window_pos( req->handle, req->previous, req->swp_flags, req->paint_flags,
+                            &req->window, &req->client, get_req_data(),
+                            get_req_data_size() / sizeof(rectangle_t), &change ))
+    {
+        set_window_pos( &change );
+        get_window_pos_result( change.win, &result );
+    }
+    reply->new_style    = result.new_style;
+    reply->new_ex_style = result.new_ex_style;
+    reply->surface_win  = result.surface_win;
+    reply->needs_update = result.needs_update;
+}
+
+
+/* set the position and Z order of several windows at once */
+DECL_HANDLER(set_window_pos_list)
+{
+    const window_pos_t *pos = get_req_data();
+    data_size_t i, start = 0, count = get_req_data_size() / sizeof(*pos);
+    struct window_pos_change *changes;
+    window_pos_result_t *results;
+
+    if (!count) return;
+    if (count * sizeof(*results) > get_reply_max_size())
+    {
+        set_error( STATUS_BUFFER_TOO_SMALL );
+        return;
+    }
+    if (!(changes = mem_alloc( count * sizeof(*changes) ))) return;
+    if (!(results = set_reply_data_size( count * sizeof(*results) )))
+    {
+        free( changes );
+        return;
+    }
+    memset( results, 0, count * sizeof(*results) );
+
+    /* each entry succeeds or fails on its own, like a sequence of set_window_pos requests;
+     * consecutive independent entries are applied as one batch */
+    for (i = 0; i < count; i++, pos++)
+    {
+        changes[i].win = NULL;
+        if (!prepare_window_pos( pos->handle, pos->previous, pos->swp_flags, pos->paint_flags,
+                                 &pos->window, &pos->client, pos->extra, min( pos->rect_count, 3 ),
+                                 &changes[i] ))
+        {
+            changes[i].win = NULL;
+            results[i].status = get_error();
+            clear_error();
+            continue;
+        }
+
+        /* a window moved twice, or an ancestor or descendant of a pending window,
+         * must see the pending changes applied first */
+        if (is_window_pos_pending( changes + start, i - start, changes[i].win ))
+        {
+            apply_window_pos_batch( changes + start, i - start, results + start );
+            start = i;
+        }
+
+        if (!begin_window_pos( &changes[i] ))
+        {
+            get_window_pos_result( changes[i].win, &results[i] );
+            changes[i].win = NULL;
+            clear_error();
+            continue;
+        }
+
+        /* showing or hiding a window changes the visibility of its children */
+        if (changes[i].swp_flags & (SWP_SHOWWINDOW | SWP_HIDEWINDOW))
+        {
+            apply_window_pos_batch( changes + start, i + 1 - start, results + start );
+            start = i + 1;
+        }
     }
+    apply_window_pos_batch( changes + start, count - start, results + start );
+    free( changes );
 }
 
 
@@ -2705,6 +3103,7 @@ DECL_HANDLER(update_window_zorder)
         {
             list_remove( &win->entry );
             list_add_before( &ptr->entry, &win->entry );
+            invalidate_visible_regions( win );
         }
         break;
     }